@@ -346,6 +346,9 @@ namespace direct_bt {
             /** creation timestamp in milliseconds */
             const int64_t ts_creation;
 
+            /** kernel receive timestamp in nanoseconds, see getWallClockNanoseconds(), zero if not received */
+            uint64_t ts_received;
+
             /**
              * Return a newly created specialized instance pointer to base class.
              * <p>
@@ -356,14 +359,14 @@ namespace direct_bt {
 
             /** Persistent memory, w/ ownership ..*/
             AttPDUMsg(const uint8_t* source, const int size)
-                : pdu(source, std::max(1, size)), ts_creation(getCurrentMilliseconds())
+                : pdu(source, std::max(1, size)), ts_creation(getCurrentMilliseconds()), ts_received(0)
             {
                 pdu.check_range(0, getPDUMinSize());
             }
 
             /** Persistent memory, w/ ownership ..*/
             AttPDUMsg(const Opcode opc, const int size)
-                : pdu(std::max(1, size)), ts_creation(getCurrentMilliseconds())
+                : pdu(std::max(1, size)), ts_creation(getCurrentMilliseconds()), ts_received(0)
             {
                 pdu.put_uint8(0, opc);
                 pdu.check_range(0, getPDUMinSize());
@@ -793,6 +796,187 @@ namespace direct_bt {
             }
     };
 
+    /**
+     * ATT Protocol PDUs Vol 3, Part F 3.4.4.7 and 3.4.4.11
+     * <p>
+     * ATT_READ_MULTIPLE_REQ or ATT_READ_MULTIPLE_VARIABLE_REQ
+     * </p>
+     * Used in:
+     * <p>
+     * BT Core Spec v5.2: Vol 3, Part G GATT: 4.8.4 Read Multiple Characteristic Values
+     * </p>
+     * <p>
+     * BT Core Spec v5.2: Vol 3, Part G GATT: 4.8.5 Read Multiple Variable Length Characteristic Values
+     * </p>
+     */
+    class AttReadMultipleReq : public AttPDUMsg
+    {
+        public:
+            /** Minimum number of handles, i.e. a set of two or more handles. */
+            static const int MIN_HANDLE_COUNT = 2;
+
+            AttReadMultipleReq(const bool variableLength, const std::vector<uint16_t> & handles)
+            : AttPDUMsg(variableLength ? ATT_READ_MULTIPLE_VARIABLE_REQ : ATT_READ_MULTIPLE_REQ, 1+2*handles.size())
+            {
+                if( MIN_HANDLE_COUNT > (int)handles.size() ) {
+                    throw IllegalArgumentException("Handle count "+std::to_string(handles.size())+" < "+std::to_string(MIN_HANDLE_COUNT), E_FILE_LINE);
+                }
+                for(size_t i=0; i<handles.size(); i++) {
+                    pdu.put_uint16(1+2*i, handles[i]);
+                }
+            }
+
+            /** opcode */
+            int getPDUValueOffset() const override { return 1; }
+
+            bool isVariableLength() const { return ATT_READ_MULTIPLE_VARIABLE_REQ == getOpcode(); }
+
+            int getHandleCount() const { return getPDUValueSize() / 2; }
+
+            uint16_t getHandle(const int i) const {
+                return pdu.get_uint16( 1 + 2*i );
+            }
+
+            std::string getName() const override {
+                return "AttReadMultipleReq";
+            }
+
+        protected:
+            std::string valueString() const override {
+                std::string res = "variable "+std::to_string(isVariableLength())+", handles [";
+                for(int i=0; i<getHandleCount(); i++) {
+                    if( 0 < i ) {
+                        res += ", ";
+                    }
+                    res += uint16HexString(getHandle(i), true);
+                }
+                return res+"]";
+            }
+    };
+
+    /**
+     * ATT Protocol PDUs Vol 3, Part F 3.4.4.8
+     * <p>
+     * ATT_READ_MULTIPLE_RSP
+     * </p>
+     * <p>
+     * The value is the concatenation of all requested values,
+     * hence their sizes must be known by the client.
+     * Values exceeding (ATT_MTU - 1) in total are truncated.
+     * </p>
+     * Used in:
+     * <p>
+     * BT Core Spec v5.2: Vol 3, Part G GATT: 4.8.4 Read Multiple Characteristic Values
+     * </p>
+     */
+    class AttReadMultipleRsp: public AttPDUMsg
+    {
+        private:
+            const TOctetSlice view;
+
+        public:
+            AttReadMultipleRsp(const uint8_t* source, const int length)
+            : AttPDUMsg(source, length), view(pdu, getPDUValueOffset(), getPDUValueSize()) {
+                checkOpcode(ATT_READ_MULTIPLE_RSP);
+            }
+
+            /** opcode */
+            int getPDUValueOffset() const override { return 1; }
+
+            uint8_t const * getValuePtr() const { return pdu.get_ptr(getPDUValueOffset()); }
+
+            TOctetSlice const & getValue() const { return view; }
+
+            std::string getName() const override {
+                return "AttReadMultipleRsp";
+            }
+
+        protected:
+            std::string valueString() const override {
+                return "size "+std::to_string(getPDUValueSize())+", data "+view.toString();
+            }
+    };
+
+    /**
+     * ATT Protocol PDUs Vol 3, Part F 3.4.4.12
+     * <p>
+     * ATT_READ_MULTIPLE_VARIABLE_RSP
+     * </p>
+     * <p>
+     * The value is a list of length value tuples:
+     * <pre>
+     * tuple := { uint16_t length, uint8_t value[length] }
+     * </pre>
+     * If the tuple list exceeds (ATT_MTU - 1), it is truncated,
+     * i.e. the last tuple's value may be partial and following tuples are missing.
+     * </p>
+     * Used in:
+     * <p>
+     * BT Core Spec v5.2: Vol 3, Part G GATT: 4.8.5 Read Multiple Variable Length Characteristic Values
+     * </p>
+     */
+    class AttReadMultipleVariableRsp: public AttPDUMsg
+    {
+        private:
+            /** PDU offset of each tuple */
+            std::vector<int> tupleOffsets;
+
+        public:
+            AttReadMultipleVariableRsp(const uint8_t* source, const int length)
+            : AttPDUMsg(source, length) {
+                checkOpcode(ATT_READ_MULTIPLE_VARIABLE_RSP);
+
+                const int end = getPDUValueOffset() + getPDUValueSize();
+                int i = getPDUValueOffset();
+                while( i + 2 <= end ) {
+                    tupleOffsets.push_back(i);
+                    i += 2 + pdu.get_uint16(i);
+                }
+            }
+
+            /** opcode */
+            int getPDUValueOffset() const override { return 1; }
+
+            /** Returns the number of tuples, including a truncated last tuple. */
+            int getTupleCount() const { return tupleOffsets.size(); }
+
+            /** Returns the full value length of the given tuple, as announced by the server. */
+            int getTupleLength(const int i) const {
+                return pdu.get_uint16( tupleOffsets.at(i) );
+            }
+
+            /** Returns the received value size of the given tuple, less than getTupleLength(int) if truncated. */
+            int getTupleValueSize(const int i) const {
+                const int end = getPDUValueOffset() + getPDUValueSize();
+                return std::min(getTupleLength(i), end - tupleOffsets.at(i) - 2);
+            }
+
+            bool isTupleTruncated(const int i) const {
+                return getTupleValueSize(i) < getTupleLength(i);
+            }
+
+            /** Returns a view of the received value of the given tuple */
+            TOctetSlice getTupleValue(const int i) const {
+                return TOctetSlice(pdu, tupleOffsets.at(i) + 2, getTupleValueSize(i));
+            }
+
+            std::string getName() const override {
+                return "AttReadMultipleVariableRsp";
+            }
+
+        protected:
+            std::string valueString() const override {
+                std::string res = "tuples "+std::to_string(getTupleCount())+" [";
+                for(int i=0; i<getTupleCount(); i++) {
+                    if( 0 < i ) {
+                        res += ", ";
+                    }
+                    res += "[len "+std::to_string(getTupleLength(i))+", "+getTupleValue(i).toString()+"]";
+                }
+                return res+"]";
+            }
+    };
+
     /**
      * ATT Protocol PDUs Vol 3, Part F 3.4.5.1
      * <p>
@@ -914,6 +1098,144 @@ namespace direct_bt {
             }
     };
 
+    /**
+     * ATT Protocol PDUs Vol 3, Part F 3.4.6.1 and 3.4.6.2
+     * <p>
+     * ATT_PREPARE_WRITE_REQ and ATT_PREPARE_WRITE_RSP share the same layout,
+     * the response echoes the request's handle, offset and value.
+     * </p>
+     * Used in:
+     * <p>
+     * BT Core Spec v5.2: Vol 3, Part G GATT: 4.9.4 Write Long Characteristic Values
+     * </p>
+     * <p>
+     * BT Core Spec v5.2: Vol 3, Part G GATT: 4.9.5 Reliable Writes
+     * </p>
+     */
+    class AttPrepareWrite : public AttPDUMsg
+    {
+        private:
+            const TOctetSlice view;
+
+        public:
+            AttPrepareWrite(const uint8_t* source, const int length)
+            : AttPDUMsg(source, length), view(pdu, getPDUValueOffset(), getPDUValueSize())
+            {
+                if( ATT_PREPARE_WRITE_REQ != getOpcode() && ATT_PREPARE_WRITE_RSP != getOpcode() ) {
+                    throw AttOpcodeException("Has opcode "+uint8HexString(getOpcode(), true)+
+                                     ", not matching ATT_PREPARE_WRITE_REQ or ATT_PREPARE_WRITE_RSP", E_FILE_LINE);
+                }
+            }
+
+            /** Creates an ATT_PREPARE_WRITE_REQ for the given part of the value at the given value offset. */
+            AttPrepareWrite(const uint16_t handle, const uint16_t valueOffset, const TROOctets & value)
+            : AttPDUMsg(ATT_PREPARE_WRITE_REQ, 1+2+2+value.getSize()), view(pdu, getPDUValueOffset(), getPDUValueSize())
+            {
+                pdu.put_uint16(1, handle);
+                pdu.put_uint16(3, valueOffset);
+                for(int i=0; i<value.getSize(); i++) {
+                    pdu.put_uint8(5+i, value.get_uint8(i));
+                }
+            }
+
+            /** opcode + handle + offset */
+            int getPDUValueOffset() const override { return 1 + 2 + 2; }
+
+            uint16_t getHandle() const {
+                return pdu.get_uint16( 1 );
+            }
+
+            uint16_t getValueOffset() const {
+                return pdu.get_uint16( 1 + 2 );
+            }
+
+            uint8_t const * getValuePtr() const { return pdu.get_ptr(getPDUValueOffset()); }
+
+            TOctetSlice const & getValue() const { return view; }
+
+            std::string getName() const override {
+                return "AttPrepareWrite";
+            }
+
+        protected:
+            std::string valueString() const override {
+                return "handle "+uint16HexString(getHandle(), true)+", offset "+std::to_string(getValueOffset())+", data "+view.toString();
+            }
+    };
+
+    /**
+     * ATT Protocol PDUs Vol 3, Part F 3.4.6.3
+     * <p>
+     * ATT_EXECUTE_WRITE_REQ
+     * </p>
+     * Used in:
+     * <p>
+     * BT Core Spec v5.2: Vol 3, Part G GATT: 4.9.4 Write Long Characteristic Values
+     * </p>
+     * <p>
+     * BT Core Spec v5.2: Vol 3, Part G GATT: 4.9.5 Reliable Writes
+     * </p>
+     */
+    class AttExecuteWriteReq : public AttPDUMsg
+    {
+        public:
+            enum Flags : uint8_t {
+                /** Cancel all prepared writes */
+                CANCEL_ALL  = 0x00,
+                /** Immediately write all pending prepared values */
+                WRITE_ALL   = 0x01
+            };
+
+            AttExecuteWriteReq(const bool write)
+            : AttPDUMsg(ATT_EXECUTE_WRITE_REQ, 1+1)
+            {
+                pdu.put_uint8(1, write ? WRITE_ALL : CANCEL_ALL);
+            }
+
+            /** opcode */
+            int getPDUValueOffset() const override { return 1; }
+
+            bool isWrite() const { return WRITE_ALL == pdu.get_uint8(1); }
+
+            std::string getName() const override {
+                return "AttExecuteWriteReq";
+            }
+
+        protected:
+            std::string valueString() const override {
+                return std::string( isWrite() ? "write" : "cancel" );
+            }
+    };
+
+    /**
+     * ATT Protocol PDUs Vol 3, Part F 3.4.6.4
+     * <p>
+     * ATT_EXECUTE_WRITE_RSP
+     * </p>
+     * Used in:
+     * <p>
+     * BT Core Spec v5.2: Vol 3, Part G GATT: 4.9.4 Write Long Characteristic Values
+     * </p>
+     * <p>
+     * BT Core Spec v5.2: Vol 3, Part G GATT: 4.9.5 Reliable Writes
+     * </p>
+     */
+    class AttExecuteWriteRsp : public AttPDUMsg
+    {
+        public:
+            AttExecuteWriteRsp(const uint8_t* source, const int length)
+            : AttPDUMsg(source, length) {
+                checkOpcode(ATT_EXECUTE_WRITE_RSP);
+            }
+
+            /** opcode */
+            int getPDUValueOffset() const override { return 1; }
+
+            std::string getName() const override {
+                return "AttExecuteWriteRsp";
+            }
+    };
+
     /**
      * ATT Protocol PDUs Vol 3, Part F 3.4.7.1 and 3.4.7.2
      * <p>
@@ -970,6 +1292,83 @@ namespace direct_bt {
             }
     };
 
+    /**
+     * ATT Protocol PDUs Vol 3, Part F 3.4.7.4
+     * <p>
+     * A received ATT_MULTIPLE_HANDLE_VALUE_NTF from server.
+     * </p>
+     * <p>
+     * The value is a list of handle length value tuples:
+     * <pre>
+     * tuple := { uint16_t handle, uint16_t length, uint8_t value[length] }
+     * </pre>
+     * A truncated last tuple is dropped.
+     * </p>
+     * Used in:
+     * <p>
+     * BT Core Spec v5.2: Vol 3, Part G GATT: 4.10.2 Multiple Variable Length Notifications
+     * </p>
+     */
+    class AttMultipleHandleValueNtf: public AttPDUMsg
+    {
+        private:
+            /** PDU offset of each tuple */
+            std::vector<int> tupleOffsets;
+
+        public:
+            AttMultipleHandleValueNtf(const uint8_t* source, const int length)
+            : AttPDUMsg(source, length) {
+                checkOpcode(ATT_MULTIPLE_HANDLE_VALUE_NTF);
+
+                const int end = getPDUValueOffset() + getPDUValueSize();
+                int i = getPDUValueOffset();
+                while( i + 4 <= end ) {
+                    const int next = i + 4 + pdu.get_uint16(i + 2);
+                    if( next > end ) {
+                        break; // truncated
+                    }
+                    tupleOffsets.push_back(i);
+                    i = next;
+                }
+            }
+
+            /** opcode */
+            int getPDUValueOffset() const override { return 1; }
+
+            int getTupleCount() const { return tupleOffsets.size(); }
+
+            uint16_t getTupleHandle(const int i) const {
+                return pdu.get_uint16( tupleOffsets.at(i) );
+            }
+
+            int getTupleValueSize(const int i) const {
+                return pdu.get_uint16( tupleOffsets.at(i) + 2 );
+            }
+
+            uint8_t const * getTupleValuePtr(const int i) const { return pdu.get_ptr( tupleOffsets.at(i) + 4 ); }
+
+            /** Returns a view of the given tuple's value within this PDU */
+            TOctetSlice getTupleValue(const int i) const {
+                return TOctetSlice(pdu, tupleOffsets.at(i) + 4, getTupleValueSize(i));
+            }
+
+            std::string getName() const override {
+                return "AttMultipleHandleValueNtf";
+            }
+
+        protected:
+            std::string valueString() const override {
+                std::string res = "tuples "+std::to_string(getTupleCount())+" [";
+                for(int i=0; i<getTupleCount(); i++) {
+                    if( 0 < i ) {
+                        res += ", ";
+                    }
+                    res += "[handle "+uint16HexString(getTupleHandle(i), true)+", "+getTupleValue(i).toString()+"]";
+                }
+                return res+"]";
+            }
+    };
+
     /**
      * ATT Protocol PDUs Vol 3, Part F 3.4.7.3
      * <p>
@@ -29,6 +29,7 @@
 #include <cstring>
 #include <string>
 #include <cstdint>
+#include <functional>
 
 namespace direct_bt {
 
@@ -175,4 +176,17 @@ namespace direct_bt {
 
 } // namespace direct_bt
 
+namespace std {
+    /** std::hash specialization of EUI48, allowing its use as a key of unordered containers. */
+    template<> struct hash<direct_bt::EUI48> {
+        std::size_t operator()(const direct_bt::EUI48 & a) const noexcept {
+            uint64_t v = 0;
+            for(int i=0; i<6; i++) {
+                v = ( v << 8 ) | a.b[i];
+            }
+            return std::hash<uint64_t>()(v);
+        }
+    };
+} // namespace std
+
 #endif /* BT_ADDRESS_HPP_ */
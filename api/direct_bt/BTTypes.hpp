@@ -134,6 +134,8 @@ namespace direct_bt {
     };
 
     enum L2CAP_Channels : uint16_t {
+        /* Dynamically allocated channel, e.g. connecting via PSM */
+        L2CAP_CID_UNDEF         = 0x0000,
         L2CAP_CID_SIGNALING     = 0x0001,
         L2CAP_CID_CONN_LESS     = 0x0002,
         L2CAP_CID_A2MP          = 0x0003,
@@ -168,6 +170,8 @@ namespace direct_bt {
         L2CAP_PSM_AVCTP_BROWSING    = 0x001B,
         L2CAP_PSM_UDI_C_PLANE       = 0x001D,
         L2CAP_PSM_ATT               = 0x001F,
+        /* BT Core Spec v5.2: Vol 3, Part G GATT: 5.3.2 Enhanced ATT bearer, L2CAP Enhanced Credit Based Flow Control */
+        L2CAP_PSM_EATT              = 0x0027,
         L2CAP_PSM_LE_DYN_START      = 0x0080,
         L2CAP_PSM_LE_DYN_END        = 0x00FF,
         L2CAP_PSM_DYN_START         = 0x1001,
@@ -478,6 +482,7 @@ namespace direct_bt {
     private:
         Source source = Source::NA;
         uint64_t timestamp = 0;
+        uint64_t rxTimestamp = 0;
         EIRDataType eir_data_mask = static_cast<EIRDataType>(0);
 
         AD_PDU_Type evt_type = AD_PDU_Type::ADV_UNDEFINED;
@@ -531,6 +536,7 @@ namespace direct_bt {
 
         void setSource(Source s) { source = s; }
         void setTimestamp(uint64_t ts) { timestamp = ts; }
+        void setReceiveTimestamp(uint64_t ts) { rxTimestamp = ts; }
         void setEvtType(AD_PDU_Type et) { evt_type = et; set(EIRDataType::EVT_TYPE); }
         void setADAddressType(uint8_t adAddressType);
         void setAddressType(BDAddressType at);
@@ -545,8 +551,10 @@ namespace direct_bt {
          * <p>
          * https://www.bluetooth.com/specifications/archived-specifications/
          * </p>
+         * @param rxTimestamp the kernel receive timestamp of the HCI event in nanoseconds, see getReceiveTimestamp()
          */
-        static std::vector<std::shared_ptr<EInfoReport>> read_ad_reports(uint8_t const * data, uint8_t const data_length);
+        static std::vector<std::shared_ptr<EInfoReport>> read_ad_reports(uint8_t const * data, uint8_t const data_length,
+                                                                         const uint64_t rxTimestamp=0);
 
         /**
          * Reads the Extended Inquiry Response (EIR) or Advertising Data (AD) segments
@@ -576,7 +584,13 @@ namespace direct_bt {
         int read_data(uint8_t const * data, uint8_t const data_length);
 
         Source getSource() const { return source; }
+        /** Returns the monotonic timestamp in milliseconds, see getCurrentMilliseconds(). */
         uint64_t getTimestamp() const { return timestamp; }
+        /**
+         * Returns the kernel receive timestamp of the advertising report in nanoseconds, see getWallClockNanoseconds(),
+         * or zero if not available.
+         */
+        uint64_t getReceiveTimestamp() const { return rxTimestamp; }
         bool isSet(EIRDataType bit) const { return EIRDataType::NONE != (eir_data_mask & bit); }
         EIRDataType getEIRDataMask() const { return eir_data_mask; }
 
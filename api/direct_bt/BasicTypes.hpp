@@ -44,6 +44,12 @@ namespace direct_bt {
      */
     int64_t getCurrentMilliseconds();
 
+    /**
+     * Returns current wall-clock time in nanoseconds since the Unix epoch,
+     * i.e. the clock of kernel socket receive timestamps (SO_TIMESTAMPNS).
+     */
+    uint64_t getWallClockNanoseconds();
+
     #define E_FILE_LINE __FILE__,__LINE__
 
     class RuntimeException : public std::exception {
@@ -207,7 +207,8 @@ namespace direct_bt {
                                                       uint16_t min_interval, uint16_t max_interval,
                                                       uint16_t latency, uint16_t supervision_timeout);
             friend HCIStatusCode DBTDevice::connectBREDR(const uint16_t pkt_type, const uint16_t clock_offset, const uint8_t role_switch);
-            friend std::vector<std::shared_ptr<GATTService>> DBTDevice::getGATTServices();
+            friend std::vector<std::shared_ptr<GATTService>> DBTDevice::getGATTServices(const std::vector<std::shared_ptr<const uuid_t>> & serviceFilter,
+                                                                                       const std::vector<std::shared_ptr<const uuid_t>> & characteristicFilter);
 
             bool addConnectedDevice(const std::shared_ptr<DBTDevice> & device);
             bool removeConnectedDevice(const DBTDevice & device);
@@ -377,9 +378,23 @@ namespace direct_bt {
                                       const uint16_t conn_latency=0x0000, const uint16_t timeout=number(HCIConstInt::LE_CONN_TIMEOUT_MS)/10);
 
 
+            /**
+             * Add the given devices to the adapter's autoconnect whitelist,
+             * uploading each device's given connection parameter to the kernel first.
+             * <p>
+             * See {@link DBTManager::addDevicesToWhitelist(..)} for batching
+             * and host-side whitelisting beyond the controller's capacity.
+             * </p>
+             * @return number of newly added devices
+             */
+            int addDevicesToWhitelist(const std::vector<MgmtConnParam> & devices, const HCIWhitelistConnectType ctype);
+
             /** Remove the given device from the adapter's autoconnect whitelist. */
             bool removeDeviceFromWhitelist(const EUI48 &address, const BDAddressType address_type);
 
+            /** Remove the given devices from the adapter's autoconnect whitelist. Returns number of removed devices. */
+            int removeDevicesFromWhitelist(const std::vector<EUI48> & addresses);
+
             // device discovery aka device scanning
 
             /**
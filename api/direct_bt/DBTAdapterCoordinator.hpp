@@ -0,0 +1,271 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2020 Gothel Software e.K.
+ * Copyright (c) 2020 ZAFENA AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef DBT_ADAPTER_COORDINATOR_HPP_
+#define DBT_ADAPTER_COORDINATOR_HPP_
+
+#include <cstring>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <vector>
+#include <map>
+
+#include <mutex>
+
+#include "DBTTypes.hpp"
+#include "DBTDevice.hpp"
+#include "DBTAdapter.hpp"
+
+/**
+ * - - - - - - - - - - - - - - -
+ *
+ * Module DBTAdapterCoordinator:
+ *
+ * - Merging the discovery of multiple DBTAdapter on one host
+ * - Assigning each device's connection to the least loaded adapter with acceptable signal
+ */
+namespace direct_bt {
+
+    /**
+     * Listener of DBTAdapterCoordinator's merged discovery.
+     */
+    class CoordinatedDeviceListener {
+        public:
+            /**
+             * A device has been discovered for the first time by any of the coordinated adapter.
+             * <p>
+             * Sightings of the same device by further adapter are merged and not reported again.
+             * </p>
+             * <p>
+             * Invoked on the discovering adapter's event thread, hence it must not block.
+             * </p>
+             * @param device the found device instance of the discovering adapter
+             * @param timestamp the time in monotonic milliseconds when this event occurred. See BasicTypes::getCurrentMilliseconds().
+             */
+            virtual void deviceFound(std::shared_ptr<DBTDevice> device, const uint64_t timestamp) = 0;
+
+            virtual ~CoordinatedDeviceListener() {}
+    };
+
+    /**
+     * Coordinates scanning and connections of multiple DBTAdapter on one host.
+     * <p>
+     * Discovery of all adapter is merged, deduplicating the same device address across adapter
+     * while keeping the best RSSI per adapter.
+     * Optionally one adapter is dedicated to continuous scanning, while the others only hold connections.
+     * </p>
+     * <p>
+     * connect(..) assigns a device to the adapter with the least number of assigned devices,
+     * which has recently seen the device with an acceptable signal, i.e. its RSSI &ge; the minimum RSSI.
+     * An adapter's RSSI ages out after the given maximum age, hence an adapter which hasn't seen the device lately
+     * is never assigned, as its signal is unknown.
+     * The dedicated scanning adapter is only used if no other adapter is eligible,
+     * i.e. the other adapter are only eligible if they see the device themselves, e.g. via their own discovery.
+     * </p>
+     * <p>
+     * If the assigned adapter hasn't discovered the device itself,
+     * the device is added to the adapter's whitelist for auto-connect.
+     * </p>
+     * <p>
+     * Devices neither assigned nor connected are removed once they haven't been seen for the RSSI maximum age,
+     * bounding the merged state to the recently advertising devices.
+     * A removed device seen again is reported as newly found.
+     * </p>
+     */
+    class DBTAdapterCoordinator {
+        public:
+            /** RSSI value of an adapter which hasn't seen the device, BT Core Spec v5.2: Vol 4, Part E, 7.7.65.2: 'RSSI is not available' */
+            static const int8_t RSSI_NONE = 127;
+
+            /**
+             * Merged state of one device.
+             */
+            class DeviceInfo {
+                public:
+                    EUI48 address;
+                    BDAddressType addressType;
+                    /** Latest RSSI per adapter index, RSSI_NONE if not seen by the adapter */
+                    std::vector<int8_t> rssi;
+                    /** Time of the latest RSSI per adapter index in monotonic milliseconds, 0 if not seen by the adapter */
+                    std::vector<uint64_t> ts_rssi;
+                    /** Last seen time in monotonic milliseconds */
+                    uint64_t ts_last_seen;
+                    /** Index of the assigned adapter or -1 */
+                    int assignedAdapter;
+                    /** True if added to the assigned adapter's whitelist */
+                    bool whitelisted;
+                    /** True if connected via the assigned adapter */
+                    bool connected;
+                    /** The connected device instance of the assigned adapter */
+                    std::weak_ptr<DBTDevice> device;
+
+                    DeviceInfo(const EUI48 & address, const BDAddressType addressType, const size_t adapterCount)
+                    : address(address), addressType(addressType), rssi(adapterCount, RSSI_NONE), ts_rssi(adapterCount, 0),
+                      ts_last_seen(0), assignedAdapter(-1), whitelisted(false), connected(false) {}
+
+                    /** Returns the best RSSI of all adapter or RSSI_NONE. */
+                    int8_t getBestRSSI() const;
+
+                    /**
+                     * Returns the RSSI per adapter index, RSSI_NONE if not seen by the adapter within the given maximum age.
+                     * @param now current time in monotonic milliseconds
+                     * @param maxAge maximum age of an RSSI in milliseconds
+                     */
+                    std::vector<int8_t> getRecentRSSI(const uint64_t now, const int maxAge) const;
+
+                    /**
+                     * Returns true if neither assigned, whitelisted nor connected and not seen within the given maximum age,
+                     * i.e. the entry holds no state beyond an outdated sighting.
+                     * @param now current time in monotonic milliseconds
+                     * @param maxAge maximum age of the last sighting in milliseconds
+                     */
+                    bool isExpired(const uint64_t now, const int maxAge) const;
+
+                    std::string toString() const;
+            };
+
+        private:
+            class AdapterListener;
+
+            const std::vector<std::shared_ptr<DBTAdapter>> adapters;
+            const int8_t minRSSI;
+            const int maxAssigned;
+            const int rssiMaxAge;
+            std::vector<std::shared_ptr<AdapterListener>> adapterListeners;
+
+            typedef std::pair<EUI48, BDAddressType> DeviceKey;
+            std::map<DeviceKey, DeviceInfo> devices;
+            std::vector<std::shared_ptr<CoordinatedDeviceListener>> listeners;
+            /** Time of the last removal of expired devices in monotonic milliseconds, guarded by mtx_devices */
+            uint64_t ts_last_expiry;
+            std::recursive_mutex mtx_devices; // for devices, listeners and ts_last_expiry
+
+            /** Guarded by mtx_discovery, not held while devices are accessed by the adapter callbacks */
+            int scanningAdapter;
+            bool discovering;
+            std::mutex mtx_discovery;
+
+            void deviceSeen(const int adapterIdx, std::shared_ptr<DBTDevice> device, const uint64_t timestamp);
+            void deviceConnected(const int adapterIdx, std::shared_ptr<DBTDevice> device);
+            void deviceDisconnected(const int adapterIdx, std::shared_ptr<DBTDevice> device);
+
+            std::vector<int> getAssignedCountsLocked() const;
+            size_t removeExpiredDevicesLocked(const uint64_t now);
+            bool startDiscoveryLocked();
+
+        public:
+            /**
+             * @param adapters the adapter to coordinate, referenced by their index herein
+             * @param minRSSI minimum acceptable RSSI of a device at its assigned adapter, defaults to -85 dBm
+             * @param maxAssigned maximum number of devices assigned to one adapter, 0 for unlimited
+             * @param scanningAdapter index of the adapter dedicated to scanning, or -1 to scan with all adapter
+             * @param rssiMaxAge maximum age of an adapter's RSSI of a device in milliseconds to be considered by connect(..), defaults to 10s.
+             *                   Also the maximum age of an unassigned device's last sighting before it is removed.
+             */
+            DBTAdapterCoordinator(const std::vector<std::shared_ptr<DBTAdapter>> & adapters,
+                                  const int8_t minRSSI=-85, const int maxAssigned=0, const int scanningAdapter=-1,
+                                  const int rssiMaxAge=10000);
+
+            /** Removes all internal AdapterStatusListener from the adapter. */
+            ~DBTAdapterCoordinator();
+
+            DBTAdapterCoordinator(const DBTAdapterCoordinator&) = delete;
+            void operator=(const DBTAdapterCoordinator&) = delete;
+
+            int getAdapterCount() const { return adapters.size(); }
+
+            std::shared_ptr<DBTAdapter> getAdapter(const int idx) const;
+
+            /** Returns the index of the adapter dedicated to scanning, or -1 if all adapter scan. */
+            int getScanningAdapter();
+
+            /**
+             * Dedicates the given adapter to scanning, or all adapter if -1.
+             * <p>
+             * If discovering, discovery is stopped on the other adapter and started on the scanning adapter(s).
+             * </p>
+             */
+            void setScanningAdapter(const int idx);
+
+            /** Starts discovery with keepAlive on the scanning adapter(s). Returns true if successful. */
+            bool startDiscovery();
+
+            /** Stops discovery on all adapter. Returns true if no error. */
+            bool stopDiscovery();
+
+            bool addListener(std::shared_ptr<CoordinatedDeviceListener> l);
+            bool removeListener(std::shared_ptr<CoordinatedDeviceListener> l);
+
+            /** Returns a snapshot of all merged devices. */
+            std::vector<DeviceInfo> getDevices();
+
+            /** Returns the number of devices assigned to each adapter. */
+            std::vector<int> getAssignedCounts();
+
+            /**
+             * Selects the adapter for a device.
+             * <p>
+             * Only adapter with a known RSSI are eligible.
+             * </p>
+             * @param assigned number of devices assigned to each adapter
+             * @param rssi the device's recent RSSI per adapter, RSSI_NONE if unknown, see DeviceInfo::getRecentRSSI(..)
+             * @param minRSSI minimum acceptable RSSI
+             * @param maxAssigned maximum number of devices assigned to one adapter, 0 for unlimited
+             * @param scanningAdapter index of the adapter dedicated to scanning, only used as last resort, or -1
+             * @return the selected adapter index or -1 if none is eligible
+             */
+            static int selectAdapter(const std::vector<int> & assigned, const std::vector<int8_t> & rssi,
+                                     const int8_t minRSSI, const int maxAssigned, const int scanningAdapter);
+
+            /**
+             * Assigns the given discovered device to the adapter selected via selectAdapter(..) and connects it.
+             * <p>
+             * If the assigned adapter has discovered the device itself, DBTDevice::connectDefault() is used,
+             * otherwise the device is added to its whitelist using HCIWhitelistConnectType::HCI_AUTO_CONN_ALWAYS.
+             * An already assigned device is connected via its assigned adapter.
+             * </p>
+             * <p>
+             * Method may block, hence must not be called from a listener callback.
+             * </p>
+             * @return HCIStatusCode::SUCCESS if the connection command or whitelisting succeeded,
+             *         HCIStatusCode::UNKNOWN_CONNECTION_IDENTIFIER if the device has not been discovered, no adapter has seen it recently or its signal is not acceptable,
+             *         HCIStatusCode::CONNECTION_LIMIT_EXCEEDED if all eligible adapter have maxAssigned devices,
+             *         otherwise the connection command's error.
+             */
+            HCIStatusCode connect(const EUI48 & address, const BDAddressType addressType);
+
+            /**
+             * Releases the device's assignment, removing it from the whitelist and disconnecting it.
+             * @return true if the device has been assigned, otherwise false
+             */
+            bool release(const EUI48 & address, const BDAddressType addressType);
+
+            std::string toString();
+    };
+
+} // namespace direct_bt
+
+#endif /* DBT_ADAPTER_COORDINATOR_HPP_ */
@@ -92,6 +92,86 @@ namespace direct_bt {
             void notifyDisconnected();
             void notifyConnected(const uint16_t handle);
 
+            /**
+             * Requests the LE Data Length Extension maximum and the LE 2M PHY for this LE connection,
+             * if supported by the local controller and enabled via HCIEnv::HCI_LE_LINK_NEGOTIATE.
+             * <p>
+             * Both are only suggestions, the link layers negotiate the best common parameter
+             * and the HCIHandler tracks the outcome per HCIConnection.
+             * </p>
+             */
+            void negotiateLELink();
+
+            /**
+             * A remembered notification or indication subscription, see subscribe(..).
+             */
+            class Subscription {
+                public:
+                    /** The service's type UUID */
+                    std::shared_ptr<const uuid_t> serviceType;
+                    /** The characteristic's value type UUID */
+                    std::shared_ptr<const uuid_t> valueType;
+                    /** Index within all characteristics of equal service and value type in discovery order, usually 0 */
+                    int instance;
+                    /** The written Client Characteristic Configuration value */
+                    uint16_t cccValue;
+
+                    bool matches(const Subscription & o) const {
+                        return *serviceType == *o.serviceType && *valueType == *o.valueType && instance == o.instance;
+                    }
+            };
+            /** Remembered subscriptions, guarded by mtx_gatt */
+            std::vector<Subscription> subscriptions;
+
+            /** Returns the Subscription identifying the given characteristic within the given services, or false if its service is unknown. */
+            static bool toSubscription(const std::vector<std::shared_ptr<GATTService>> & services, const GATTCharacteristic & c,
+                                       const uint16_t cccValue, Subscription & res);
+
+            /** Returns the characteristic identified by the given Subscription within the given services, or nullptr. */
+            static GATTCharacteristicRef findSubscribed(const std::vector<std::shared_ptr<GATTService>> & services, const Subscription & s);
+
+            /**
+             * Restores all remembered subscriptions on the newly discovered services of a new GATTHandler.
+             * <p>
+             * Invoked after the services have been discovered or loaded from the cache validated by its Database Hash,
+             * resolving each CCCD by its service and characteristic UUID.
+             * </p>
+             * <p>
+             * All CCCD values are read back first with as few requests as possible,
+             * hence only CCCDs not persisted by a bonded peer are written again.
+             * </p>
+             */
+            void restoreSubscriptions(const std::vector<std::shared_ptr<GATTService>> & services);
+
+            /** Opened LE credit based flow control channels, guarded by mtx_gatt */
+            std::vector<std::weak_ptr<L2CAPComm>> l2capChannels;
+
+            /** Disconnects all opened LE credit based flow control channels, see connectL2CAPChannel(..). */
+            void disconnectL2CAPChannels();
+
+            /** Configured LEConnProfile, guarded by mtx_connParam */
+            LEConnProfile connProfile;
+            /** Number of pending bulk transfers, guarded by mtx_connParam */
+            int bulkTransferCount;
+            std::mutex mtx_connParam;
+
+            /**
+             * Switches the LE link to LEConnProfile::BULK_TRANSFER, if not yet done by a pending bulk transfer.
+             * Each call must be paired with endBulkTransfer().
+             * <p>
+             * The GATT round-trip time estimation is not restarted, as the caller is the GATTHandler itself.
+             * </p>
+             * @return true if the connection parameter have been changed
+             */
+            bool beginBulkTransfer();
+            /**
+             * Restores the configured LEConnProfile after the last pending bulk transfer.
+             * @return true if the connection parameter have been changed
+             */
+            bool endBulkTransfer();
+            /** Restarts the GATT round-trip time estimation after the connection parameter have been changed. */
+            void restartGATTRTTStats();
+
             HCIStatusCode disconnect(const bool fromDisconnectCB, const bool ioErrorCause,
                                      const HCIStatusCode reason=HCIStatusCode::REMOTE_USER_TERMINATED_CONNECTION );
 
@@ -345,9 +425,71 @@ namespace direct_bt {
              * and closed @ disconnect() or explicitly @ disconnectGATT().
              * May return nullptr if not connected or failure.
              * </p>
+             * <p>
+             * Before a new GATT connection is established on an LE link,
+             * a larger data length and the LE 2M PHY are requested, see HCIEnv::HCI_LE_LINK_NEGOTIATE.
+             * </p>
              */
             std::shared_ptr<GATTHandler> connectGATT();
 
+            /**
+             * Changes the connection parameter of this established LE connection.
+             * <p>
+             * BT Core Spec v5.2: Vol 4, Part E HCI: 7.8.18 LE Connection Update command
+             * </p>
+             * <p>
+             * The update completes asynchronously, the peer may reject or adjust the given parameter.
+             * </p>
+             * @return HCIStatusCode::SUCCESS if the command has been accepted
+             */
+            HCIStatusCode updateConnectionParameter(const LEConnParam & param);
+
+            /**
+             * Sets and applies the given LEConnProfile for this LE connection.
+             * <p>
+             * The profile is retained across reconnects and applied with connectGATT().
+             * While a bulk transfer is pending, the LE link uses LEConnProfile::BULK_TRANSFER
+             * and the given profile is applied after its completion, see GATTEnv::GATT_BULK_TRANSFER_THRESHOLD.
+             * </p>
+             * @return HCIStatusCode::SUCCESS if applied or deferred, otherwise the failed updateConnectionParameter(..) result
+             */
+            HCIStatusCode setConnectionProfile(const LEConnProfile profile);
+
+            /** Returns the configured LEConnProfile, see setConnectionProfile(..). */
+            LEConnProfile getConnectionProfile();
+
+            /**
+             * Enables notification, or indication if notification is not supported,
+             * for all given characteristics and remembers the subscriptions.
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 3.3.3.3 Client Characteristic Configuration
+             * </p>
+             * <p>
+             * All required CCCD writes are pipelined, see GATTHandler::writeValuesPipelined(..).
+             * Characteristics already enabled are not written again.
+             * </p>
+             * <p>
+             * The remembered subscriptions are restored by getGATTServices() after a reconnect,
+             * once the services have been discovered or loaded from the validated cache.
+             * They are identified by service and characteristic UUID, hence survive a changed GATT database.
+             * </p>
+             * @return number of subscribed characteristics, excluding those without Notify or Indicate property or CCCD
+             * @throws IllegalStateException if not connected via connectGATT()
+             */
+            int subscribe(const std::vector<GATTCharacteristicRef> & characteristics);
+
+            /**
+             * Disables notification and indication for all given characteristics and forgets their subscriptions.
+             * @return number of successfully unsubscribed characteristics
+             */
+            int unsubscribe(const std::vector<GATTCharacteristicRef> & characteristics);
+
+            /** Forgets all remembered subscriptions without writing the CCCDs. */
+            void clearSubscriptions();
+
+            /** Returns the number of remembered subscriptions. */
+            int getSubscriptionCount();
+
             /** Returns already opened GATTHandler, see connectGATT(..) and disconnectGATT(). */
             std::shared_ptr<GATTHandler> getGATTHandler();
 
@@ -355,8 +497,8 @@ namespace direct_bt {
              * Returns a list of shared GATTService available on this device if successful,
              * otherwise returns an empty list if an error occurred.
              * <p>
-             * If this method has been called for the first time or no services has been detected yet,
-             * a list of GATTService will be discovered.
+             * If this method has been called for the first time, no services has been detected yet
+             * or a Service Changed indication has been received, a list of GATTService will be discovered.
              * <br>
              * In case no GATT connection has been established yet or disconnectGATT() has been called thereafter,
              * connectGATT(..) will be performed.
@@ -364,6 +506,38 @@ namespace direct_bt {
              */
             std::vector<std::shared_ptr<GATTService>> getGATTServices();
 
+            /**
+             * Returns a list of shared GATTService available on this device matching the given service UUIDs
+             * if successful, otherwise returns an empty list if an error occurred.
+             * <p>
+             * Only the given services are being discovered including their characteristics and descriptors,
+             * see GATTHandler::discoverCompletePrimaryServices(const std::vector<std::shared_ptr<const uuid_t>> &).
+             * An empty serviceFilter selects all services, same as getGATTServices().
+             * </p>
+             * <p>
+             * If services have been discovered already, the previous discovery result is returned,
+             * unless a Service Changed indication has been received thereafter, see GATTHandler::isServicesChanged().
+             * </p>
+             */
+            std::vector<std::shared_ptr<GATTService>> getGATTServices(const std::vector<std::shared_ptr<const uuid_t>> & serviceFilter);
+
+            /**
+             * Returns a list of shared GATTService available on this device matching the given service UUIDs,
+             * each holding only its characteristics matching the given characteristic UUIDs,
+             * if successful, otherwise returns an empty list if an error occurred.
+             * <p>
+             * Only the descriptors of the given characteristics are being discovered,
+             * see GATTHandler::discoverCompletePrimaryServices(const std::vector<std::shared_ptr<const uuid_t>> &, const std::vector<std::shared_ptr<const uuid_t>> &).
+             * An empty filter selects all services or characteristics respectively.
+             * </p>
+             * <p>
+             * If services have been discovered already, the previous discovery result is returned,
+             * unless a Service Changed indication has been received thereafter, see GATTHandler::isServicesChanged().
+             * </p>
+             */
+            std::vector<std::shared_ptr<GATTService>> getGATTServices(const std::vector<std::shared_ptr<const uuid_t>> & serviceFilter,
+                                                                      const std::vector<std::shared_ptr<const uuid_t>> & characteristicFilter);
+
             /**
              * Returns the matching GATTService for the given uuid.
              * <p>
@@ -392,6 +566,25 @@ namespace direct_bt {
              */
             bool pingGATT();
 
+            /**
+             * Reads the values of all given characteristics with as few requests as possible,
+             * see GATTHandler::readValues(const std::vector<uint16_t> &, std::vector<POctets> &).
+             * @param characteristics the characteristics to read
+             * @param res resulting values, one for each given characteristic in same order
+             * @return {@code true} if all values have been read, otherwise false.
+             */
+            bool readCharacteristicValues(const std::vector<GATTCharacteristicRef> & characteristics, std::vector<POctets> & res);
+
+            /**
+             * Atomically writes the values of all given characteristics, i.e. all or none of them will be written,
+             * see GATTHandler::writeValues(const std::vector<uint16_t> &, const std::vector<POctets> &, const bool).
+             * @param characteristics the characteristics to write
+             * @param values the values to write, one for each given characteristic in same order
+             * @param reliable if true, verify each value part echoed by the server
+             * @return {@code true} if all values have been written, otherwise false.
+             */
+            bool writeCharacteristicValues(const std::vector<GATTCharacteristicRef> & characteristics, const std::vector<POctets> & values, const bool reliable);
+
             /**
              * Explicit disconnecting an open GATTHandler, which is usually performed via disconnect()
              * <p>
@@ -400,6 +593,31 @@ namespace direct_bt {
              */
             void disconnectGATT();
 
+            /**
+             * Opens an LE L2CAP connection-oriented channel using LE Credit Based Flow Control
+             * to the given protocol service multiplexer of this connected device.
+             * <p>
+             * The returned L2CAPComm transfers whole SDUs without GATT's per PDU opcode, handle and response overhead:
+             * L2CAPComm::read(..) receives one SDU into the given buffer and
+             * L2CAPComm::writeStream(..) sends a buffer of any size as consecutive SDUs,
+             * awaiting credits between them.
+             * SDU segmentation, reassembly and credit management are performed by the kernel,
+             * see L2CAPComm::setFlowControlParameter(..).
+             * </p>
+             * <p>
+             * The channel is closed by L2CAPComm::disconnect() or with this device's disconnect().
+             * </p>
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part A: 4.22 L2CAP_LE_CREDIT_BASED_CONNECTION_REQ
+             * </p>
+             * @param psm the LE protocol service multiplexer, i.e. a SIG assigned or dynamic LE_PSM in the range [0x0001..0x00FF]
+             * @param rxMTU the receive MTU, zero for the default, otherwise at least 23
+             * @param rxBufferSize the socket receive buffer size in bytes determining the granted credits, zero for the default
+             * @return the connected channel or nullptr if not connected or the peer rejected the channel
+             * @throws IllegalArgumentException if psm is out of range
+             */
+            std::shared_ptr<L2CAPComm> connectL2CAPChannel(const uint16_t psm, const uint16_t rxMTU=0, const int rxBufferSize=0);
+
             /**
              * Add the given GATTCharacteristicListener to the listener list if not already present.
              * <p>
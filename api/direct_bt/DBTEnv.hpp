@@ -31,9 +31,11 @@
 #include <cstring>
 #include <string>
 #include <cstdio>
+#include <vector>
 
 extern "C" {
     #include <errno.h>
+    #include <pthread.h>
 }
 
 #include "BasicTypes.hpp"
@@ -129,6 +131,39 @@ namespace direct_bt {
             static uint32_t getUint32Property(const std::string & name, const uint32_t default_value,
                                               const uint32_t min_allowed=0, const uint32_t max_allowed=UINT32_MAX);
 
+            /**
+             * Returns the CPU set of the environment's variable 'name',
+             * a comma separated list of CPU indices and ranges, e.g. '0,2-3',
+             * or an empty vector if the environment variable's value is null or invalid.
+             * <p>
+             * Implementation uses {@link #getProperty(const std::string & name)}
+             * </p>
+             */
+            static std::vector<int> getCPUSetProperty(const std::string & name);
+
+            /**
+             * Binds the given thread to the CPU set of the environment's variable 'name',
+             * see {@link #getCPUSetProperty(const std::string & name)}.
+             * <p>
+             * Leaves the thread's affinity untouched if the CPU set is empty.
+             * </p>
+             * @return true if the thread has been bound, otherwise false
+             */
+            static bool setThreadAffinity(const pthread_t thread, const std::string & name);
+
+            /**
+             * Binds the given IO thread of adapter dev_id to the CPU set of the environment's variable
+             * 'direct_bt.adapter.<dev_id>.affinity', e.g. 'direct_bt.adapter.0.affinity=2-3'.
+             * <p>
+             * Applies to the adapter's HCIHandler reader, its DBTManager event loop
+             * and the GATTHandler reader threads of its devices.
+             * </p>
+             * @return true if the thread has been bound, otherwise false
+             */
+            static bool setAdapterThreadAffinity(const pthread_t thread, const int dev_id) {
+                return 0 <= dev_id && setThreadAffinity(thread, "direct_bt.adapter."+std::to_string(dev_id)+".affinity");
+            }
+
             /**
              * Fetches exploding variable-name (prefixDomain) values.
              * <p>
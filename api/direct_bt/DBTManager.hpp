@@ -30,10 +30,14 @@
 #include <string>
 #include <cstdint>
 #include <array>
+#include <deque>
+#include <map>
+#include <unordered_map>
 
 #include <mutex>
 #include <atomic>
 #include <thread>
+#include <condition_variable>
 
 #include "DBTEnv.hpp"
 #include "BTTypes.hpp"
@@ -43,6 +47,7 @@
 #include "JavaUplink.hpp"
 #include "MgmtTypes.hpp"
 #include "LFRingbuffer.hpp"
+#include "DBTWhitelist.hpp"
 
 namespace direct_bt {
 
@@ -89,9 +94,21 @@ namespace direct_bt {
              * <p>
              * Environment variable is 'direct_bt.mgmt.ringsize'.
              * </p>
+             * <p>
+             * Retained for compatibility only, as command replies are matched to their pending command directly,
+             * see MGMT_CMD_INFLIGHT_CAPACITY.
+             * </p>
              */
             const int32_t MGMT_EVT_RING_CAPACITY;
 
+            /**
+             * Maximum number of commands in flight awaiting their reply, defaults to 64 commands.
+             * <p>
+             * Environment variable is 'direct_bt.mgmt.cmd.inflight'.
+             * </p>
+             */
+            const int32_t MGMT_CMD_INFLIGHT_CAPACITY;
+
             /**
              * Debug all Mgmt event communication
              * <p>
@@ -100,9 +117,43 @@ namespace direct_bt {
              */
             const bool DEBUG_EVENT;
 
-        private:
-            /** Maximum number of packets to wait for until matching a sequential command. Won't block as timeout will limit. */
-            const int32_t MGMT_READ_PACKET_MAX_RETRY;
+            /**
+             * Dispatch each adapter's Mgmt events on its own event loop thread, defaults to false.
+             * <p>
+             * If enabled, the mgmt reader thread merely queues the adapter's events,
+             * hence a busy adapter's callbacks no more delay the event handling of other adapter.
+             * Each event loop thread is bound to the adapter's CPU set, see {@link DBTEnv::setAdapterThreadAffinity(..)}.
+             * </p>
+             * <p>
+             * Environment variable is 'direct_bt.mgmt.adapter.loops'.
+             * </p>
+             */
+            const bool MGMT_ADAPTER_EVENT_LOOPS;
+
+            /**
+             * Capacity of each adapter event loop's queue, defaults to 256 events.
+             * <p>
+             * If full, the oldest queued or the new DEVICE_FOUND event is dropped.
+             * Other events are never dropped and may exceed the capacity, keeping the adapter and device state consistent.
+             * </p>
+             * <p>
+             * Environment variable is 'direct_bt.mgmt.adapter.queuesize'.
+             * </p>
+             */
+            const int32_t MGMT_ADAPTER_EVENT_QUEUE_CAPACITY;
+
+            /**
+             * Maximum number of whitelisted devices per adapter added to the controller, defaults to 0 for unlimited.
+             * <p>
+             * Devices beyond this capacity are kept in the local whitelist and matched host-side,
+             * rotating the most recently seen devices into the controller, see {@link DBTManager::whitelistDeviceSeen(..)}.
+             * Should not exceed the controller's filter accept list size.
+             * </p>
+             * <p>
+             * Environment variable is 'direct_bt.mgmt.whitelist.capacity'.
+             * </p>
+             */
+            const int32_t MGMT_WHITELIST_CONTROLLER_CAPACITY;
 
         public:
             static MgmtEnv& get() {
@@ -121,10 +172,24 @@ namespace direct_bt {
             }
     };
 
+    /**
+     * Completion of an asynchronous Mgmt command, see DBTManager::sendAsync(..).
+     * <p>
+     * The reply event is either MgmtEvtCmdComplete or MgmtEvtCmdStatus,
+     * or nullptr on timeout or close.
+     * </p>
+     */
+    typedef FunctionDef<void, std::shared_ptr<MgmtEvent>> MgmtReplyCallback;
+
     /**
      * A thread safe singleton handler of the Linux Kernel's BlueZ manager control channel.
      * <p>
-     * Implementation utilizes a lock free ringbuffer receiving data within its separate thread.
+     * Implementation receives data within its separate thread,
+     * matching command replies by (opcode, dev_id) to the commands in flight.
+     * </p>
+     * <p>
+     * The reader thread may be bound to a CPU set via environment variable 'direct_bt.mgmt.affinity',
+     * see {@link DBTEnv::setThreadAffinity(..)}.
      * </p>
      * <p>
      * Controlling Environment variables, see {@link MgmtEnv}.
@@ -137,50 +202,249 @@ namespace direct_bt {
                 ClientMaxMTU = 512
             };
 
+            /**
+             * Duration of the startup phases in milliseconds, see getStartupTimings().
+             */
+            struct StartupTimings {
+                /** Starting the mgmt reader thread */
+                uint64_t readerStart;
+                /** Reading version, supported commands and adapter index list */
+                uint64_t readInfo;
+                /** Initializing all adapter in parallel */
+                uint64_t initAdapters;
+                /** Total duration of the constructor */
+                uint64_t total;
+                /** Initialization duration of each adapter, indexed by dev_id */
+                std::vector<uint64_t> initAdapter;
+
+                StartupTimings() : readerStart(0), readInfo(0), initAdapters(0), total(0) {}
+
+                std::string toString() const;
+            };
+
             static const pid_t pidSelf;
 
         private:
             static std::mutex mtx_singleton;
 
-            struct WhitelistElem {
-                int dev_id;
-                EUI48 address;
-                BDAddressType address_type;
-                HCIWhitelistConnectType ctype;
-            };
-            std::vector<std::shared_ptr<WhitelistElem>> whitelist;
+            /**
+             * Maximum number of devices per batch of whitelist commands in flight,
+             * bounded by the mgmt socket's frame size for LOAD_CONN_PARAM and {@link MgmtEnv::MGMT_CMD_INFLIGHT_CAPACITY}.
+             */
+            static const int WHITELIST_BATCH_SIZE = 32;
 
             const MgmtEnv & env;
             const BTMode defaultBTMode;
+
+            /** Local whitelist of all adapter, guarded by mtx_whitelist. */
+            DBTWhitelist whitelist;
+            /** Never held while awaiting a reply, as the reply callbacks acquire it on the mgmt reader thread. */
+            std::mutex mtx_whitelist;
             POctets rbuffer;
             HCIComm comm;
 
-            LFRingbuffer<std::shared_ptr<MgmtEvent>, nullptr> mgmtEventRing;
             std::thread mgmtReaderThread;
             std::atomic<bool> mgmtReaderRunning;
             std::atomic<bool> mgmtReaderShallStop;
             std::mutex mtx_mgmtReaderInit;
             std::condition_variable cv_mgmtReaderInit;
-            std::recursive_mutex mtx_sendReply; // for sendWithReply
+            std::mutex mtx_sendReply; // for sendAsync, keeping registration and write order aligned
 
-            /** One MgmtAdapterEventCallbackList per event type, allowing multiple callbacks to be invoked for each event */
-            std::array<MgmtAdapterEventCallbackList, static_cast<uint16_t>(MgmtEvent::Opcode::MGMT_EVENT_TYPE_COUNT)> mgmtAdapterEventCallbackLists;
-            std::recursive_mutex mtx_callbackLists;
+            /**
+             * A command in flight awaiting its reply.
+             */
+            class PendingCommand {
+                public:
+                    const MgmtOpcode opcode;
+                    const uint16_t dev_id;
+                    MgmtReplyCallback callback;
+                    /** Reply deadline in milliseconds */
+                    const int64_t deadline;
+
+                    PendingCommand(const MgmtOpcode opcode, const uint16_t dev_id, const MgmtReplyCallback & callback, const int64_t deadline)
+                    : opcode(opcode), dev_id(dev_id), callback(callback), deadline(deadline) {}
+            };
+            /** Commands in flight in sent order, guarded by mtx_pending. */
+            std::deque<std::shared_ptr<PendingCommand>> pendingCommands;
+            std::mutex mtx_pending;
+
+            /**
+             * Synchronous completion of a command sent via sendAsync(..).
+             */
+            class SyncReply {
+                private:
+                    std::mutex mtx;
+                    std::condition_variable cv;
+                    bool done;
+                    std::shared_ptr<MgmtEvent> res;
+
+                public:
+                    SyncReply() : done(false) {}
+
+                    void complete(std::shared_ptr<MgmtEvent> e);
+
+                    /** Returns the reply, or nullptr with errno ETIMEDOUT if not completed within the given timeout. */
+                    std::shared_ptr<MgmtEvent> await(const int timeoutMS);
+            };
+
+            /** MgmtAdapterEventCallback with its registration sequence number, preserving the registration order across the adapter slots. */
+            struct SequencedEventCallback {
+                uint64_t seq;
+                MgmtAdapterEventCallback acb;
+            };
+            /** SequencedEventCallback list in ascending seq order, shared by the current and older MgmtEventCallbackIndex instances, never modified once published. */
+            typedef std::shared_ptr<std::vector<SequencedEventCallback>> MgmtAdapterEventCallbackListRef;
+            /** One callback list per event type, nullptr if empty */
+            typedef std::array<MgmtAdapterEventCallbackListRef, static_cast<uint16_t>(MgmtEvent::Opcode::MGMT_EVENT_TYPE_COUNT)> MgmtEventCallbackLists;
+            /**
+             * MgmtEventCallbackLists indexed by adapter,
+             * slot 0 holding callbacks for all adapter (dev_id <code>-1</code>) and slot <code>dev_id+1</code> for the given adapter.
+             */
+            typedef std::vector<MgmtEventCallbackLists> MgmtEventCallbackIndex;
+
+            /**
+             * Current immutable MgmtEventCallbackIndex, accessed via std::atomic_load(..) and std::atomic_exchange(..).
+             * <p>
+             * sendMgmtEvent(..) iterates over a snapshot without taking a lock,
+             * visiting only the callbacks for all adapter and the event's adapter in their registration order.
+             * Modifications copy the index and publish it while holding mtx_callbackLists,
+             * retiring the older index, then await all dispatches still holding a retired index, see awaitDispatchQuiescence(..).
+             * </p>
+             */
+            std::shared_ptr<const MgmtEventCallbackIndex> mgmtEventCallbackIndex;
+            /** Version of mgmtEventCallbackIndex, incremented on each publication, guarded by mtx_callbackLists. */
+            uint64_t callbackIndexVersion;
+            /** A replaced MgmtEventCallbackIndex, in use by a sendMgmtEvent(..) while its use count exceeds the retirement's own reference. */
+            struct RetiredCallbackIndex {
+                /** Version of the publication replacing the index */
+                uint64_t version;
+                std::shared_ptr<const MgmtEventCallbackIndex> index;
+            };
+            /** Retired indices possibly still in use, guarded by mtx_dispatch. */
+            std::vector<RetiredCallbackIndex> retiredCallbackIndices;
+            /** Size of retiredCallbackIndices, read by sendMgmtEvent(..) to only notify cv_dispatch if awaited. */
+            std::atomic<int> retiredCallbackIndexCount;
+            std::mutex mtx_dispatch; // for retiredCallbackIndices, only taken by modifications and dispatches of retired indices
+            std::condition_variable cv_dispatch;
+            /** Next registration sequence number, guarded by mtx_callbackLists. */
+            uint64_t callbackSeq;
+            std::mutex mtx_callbackLists; // for modifications of mgmtEventCallbackIndex
+
+            /** Publishes the given index and retires the former, returning its version. mtx_callbackLists must be held. */
+            uint64_t publishCallbackIndex(const std::shared_ptr<const MgmtEventCallbackIndex> & index);
+
+            /**
+             * Removes all retired indices no longer in use, returning true if an index older than the given version is still in use.
+             * mtx_dispatch must be held.
+             */
+            bool pruneRetiredCallbackIndicesLocked(const uint64_t version);
+
+            /**
+             * Blocks until all sendMgmtEvent(..) using an index older than the given version have completed,
+             * i.e. the use count of each such retired index dropped to its retirement's own reference,
+             * hence no removed callback is still in progress.
+             * <p>
+             * Returns immediately if invoked from within a callback on the dispatching thread, avoiding a deadlock.
+             * </p>
+             */
+            void awaitDispatchQuiescence(const uint64_t version);
             inline void checkMgmtEventCallbackListsIndex(const MgmtEvent::Opcode opc) const {
-                if( static_cast<uint16_t>(opc) >= mgmtAdapterEventCallbackLists.size() ) {
-                    throw IndexOutOfBoundsException(static_cast<uint16_t>(opc), 1, mgmtAdapterEventCallbackLists.size(), E_FILE_LINE);
+                if( static_cast<uint16_t>(opc) >= static_cast<uint16_t>(MgmtEvent::Opcode::MGMT_EVENT_TYPE_COUNT) ) {
+                    throw IndexOutOfBoundsException(static_cast<uint16_t>(opc), 1, static_cast<uint16_t>(MgmtEvent::Opcode::MGMT_EVENT_TYPE_COUNT), E_FILE_LINE);
                 }
             }
+            static size_t getCallbackIndexSlot(const int dev_id) { return 0 > dev_id ? 0 : static_cast<size_t>(dev_id) + 1; }
 
             std::vector<std::shared_ptr<AdapterInfo>> adapterInfos;
+            StartupTimings startupTimings;
             void mgmtReaderThreadImpl();
 
             /**
-             * In case response size check or devID and optional opcode validation fails,
-             * function returns NULL.
+             * Event loop dispatching one adapter's Mgmt events, see {@link MgmtEnv::MGMT_ADAPTER_EVENT_LOOPS}.
+             */
+            class AdapterEventLoop {
+                public:
+                    const int dev_id;
+                    std::thread thread;
+                    std::deque<std::shared_ptr<MgmtEvent>> queue;
+                    std::mutex mtx;
+                    std::condition_variable cv;
+                    bool shallStop;
+                    int droppedCount;
+
+                    AdapterEventLoop(const int dev_id) : dev_id(dev_id), shallStop(false), droppedCount(0) {}
+            };
+            typedef std::vector<std::shared_ptr<AdapterEventLoop>> AdapterEventLoops;
+            /** AdapterEventLoops indexed by dev_id, accessed via std::atomic_load and std::atomic_store. */
+            std::shared_ptr<const AdapterEventLoops> adapterEventLoops;
+
+            void adapterEventLoopImpl(AdapterEventLoop & loop);
+            void startAdapterEventLoops();
+            void stopAdapterEventLoops();
+
+            /**
+             * Queues the given event to its adapter's event loop.
+             * @return true if queued, false if the adapter has no event loop
+             */
+            bool queueAdapterEvent(std::shared_ptr<MgmtEvent> event);
+
+            /**
+             * Completes the oldest pending command matching the given reply's (opcode, dev_id).
+             * @return true if a pending command has been completed, otherwise false
+             */
+            bool completePending(std::shared_ptr<MgmtEvent> res);
+
+            /** Completes all pending commands with passed deadline using nullptr. */
+            void expirePending();
+
+            /** Completes all pending commands using nullptr. */
+            void cancelPending();
+
+            /** Removes the given pending command without completing it. */
+            void removePending(const std::shared_ptr<PendingCommand> & cmd);
+
+            /** Returns the reader's poll timeout, limited by the earliest pending command's deadline. */
+            int getPendingPollTimeout();
+
+            std::shared_ptr<PendingCommand> sendAsyncImpl(MgmtCommand &req, const MgmtReplyCallback & callback, const int timeout);
+
+            /**
+             * Sends the given command and blocks until its reply has been received.
+             * <p>
+             * Other commands, including those of other threads, may be in flight concurrently.
+             * </p>
+             * <p>
+             * In case of a timeout or write error, function returns NULL.
+             * </p>
              */
             std::shared_ptr<MgmtEvent> sendWithReply(MgmtCommand &req);
 
+            /** Returns a MgmtReplyCallback completing the given SyncReply. */
+            static MgmtReplyCallback bindSyncReply(const std::shared_ptr<SyncReply> & reply);
+
+            /** Returns true if the given reply is a MgmtEvtCmdComplete or MgmtEvtCmdStatus with MgmtStatus::SUCCESS. */
+            static bool isReplySuccess(const std::shared_ptr<MgmtEvent> & res);
+
+            /**
+             * Asynchronously uploads the element's connection parameter and adds it to the controller's whitelist,
+             * occupying its controller slot until completion and reverting it to host-side on failure.
+             * mtx_whitelist must be held.
+             */
+            void addWhitelistControllerAsyncLocked(DBTWhitelist::Element & wle);
+
+            /**
+             * Asynchronously removes the element from the controller's whitelist,
+             * releasing its controller slot on success only and rotating host-side elements into it.
+             * mtx_whitelist must be held.
+             */
+            void evictWhitelistControllerAsyncLocked(DBTWhitelist::Element & wle);
+
+            /**
+             * Rotates the most recently seen host-side elements of the given adapter into the controller's whitelist,
+             * filling its free capacity. mtx_whitelist must be held.
+             */
+            void rotateWhitelistLocked(const int dev_id);
+
             /**
              * Instantiate singleton.
              * @param btMode default {@link BTMode}, adapters are tried to be initialized.
@@ -257,6 +521,15 @@ namespace direct_bt {
 
             /** retrieve information gathered at startup */
 
+            /**
+             * Returns the duration of the startup phases.
+             * <p>
+             * Adapter are initialized in parallel, each on its own thread,
+             * hence StartupTimings::initAdapters is bound by the slowest adapter.
+             * </p>
+             */
+            const StartupTimings & getStartupTimings() const { return startupTimings; }
+
             /**
              * Returns list of AdapterInfo with index == dev_id.
              */
@@ -287,6 +560,26 @@ namespace direct_bt {
              */
             std::shared_ptr<AdapterInfo> getDefaultAdapterInfo() const { return adapterInfos.size() > 0 ? getAdapterInfo(0) : nullptr; }
 
+            /**
+             * Asynchronously sends the given command, not blocking the caller for its reply.
+             * <p>
+             * The reply is matched by its request opcode and dev_id to the oldest command in flight,
+             * hence multiple commands may be in flight concurrently, up to {@link MgmtEnv::MGMT_CMD_INFLIGHT_CAPACITY}.
+             * </p>
+             * <p>
+             * The callback is invoked exactly once on the mgmt reader thread, passing the reply event,
+             * or nullptr on timeout or close. Hence it must not block, nor issue blocking commands.
+             * </p>
+             * <p>
+             * The timeout of {@link MgmtEnv::MGMT_COMMAND_REPLY_TIMEOUT} is detected by the mgmt reader thread,
+             * which is woken up to shorten its poll timeout if the command's deadline is the earliest pending.
+             * </p>
+             * @param req the command
+             * @param callback invoked with the reply event or nullptr
+             * @return true if sent, false if closed, too many commands are in flight or on write error.
+             */
+            bool sendAsync(MgmtCommand &req, const MgmtReplyCallback & callback);
+
             bool setMode(const int dev_id, const MgmtOpcode opc, const uint8_t mode);
 
             /** Start discovery on given adapter dev_id with a ScanType matching the given BTMode. Returns set ScanType. */
@@ -328,9 +621,60 @@ namespace direct_bt {
              */
             bool addDeviceToWhitelist(const int dev_id, const EUI48 &address, const BDAddressType address_type, const HCIWhitelistConnectType ctype);
 
+            /**
+             * Add the given devices to the adapter's autoconnect whitelist, using their given connection parameter.
+             * <p>
+             * Connection parameter and devices are sent in pipelined batches, i.e. multiple commands in flight,
+             * instead of one blocking command per device.
+             * </p>
+             * <p>
+             * Devices beyond {@link MgmtEnv::MGMT_WHITELIST_CONTROLLER_CAPACITY} are only added to the local whitelist
+             * and matched host-side, see {@link whitelistDeviceSeen(..)}.
+             * </p>
+             * <p>
+             * Duplicate devices are skipped.
+             * </p>
+             * @return number of newly added devices
+             */
+            int addDevicesToWhitelist(const int dev_id, const std::vector<MgmtConnParam> & devices, const HCIWhitelistConnectType ctype);
+
             /** Remove the given device from the adapter's autoconnect whitelist. */
             bool removeDeviceFromWhitelist(const int dev_id, const EUI48 &address, const BDAddressType address_type);
 
+            /**
+             * Remove the given devices from the adapter's autoconnect whitelist,
+             * sending the commands in pipelined batches.
+             * <p>
+             * Freed controller capacity is filled with the most recently seen host-side devices.
+             * </p>
+             * @return number of removed devices of the local whitelist
+             */
+            int removeDevicesFromWhitelist(const int dev_id, const std::vector<EUI48> & addresses);
+
+            /**
+             * Notifies a sighting of the given device by the adapter, e.g. via its discovery.
+             * <p>
+             * If the device is whitelisted host-side only, it is rotated into the controller's whitelist.
+             * If the capacity is exhausted, the least recently seen device neither connected nor connecting is evicted first,
+             * one at a time, and the most recently seen host-side devices are rotated in after its removal succeeded.
+             * Hence host-side whitelisted devices are only connected while discovering.
+             * </p>
+             * <p>
+             * Method doesn't block, the commands are sent asynchronously.
+             * </p>
+             * @return true if the device is whitelisted, otherwise false
+             */
+            bool whitelistDeviceSeen(const int dev_id, const EUI48 &address, const uint64_t timestamp);
+
+            /**
+             * Notifies whether the given device is connected or connecting to the adapter,
+             * exempting it from the eviction of whitelistDeviceSeen(..) while true.
+             */
+            void whitelistDeviceConnected(const int dev_id, const EUI48 &address, const bool connected);
+
+            /** Returns the number of the adapter's whitelisted devices added to the controller. */
+            int getWhitelistControllerCount(const int dev_id);
+
             /** Remove all previously added devices from the autoconnect whitelist. Returns number of removed devices. */
             int removeAllDevicesFromWhitelist();
 
@@ -352,9 +696,21 @@ namespace direct_bt {
              * </p>
              */
             void addMgmtEventCallback(const int dev_id, const MgmtEvent::Opcode opc, const MgmtEventCallback &cb);
-            /** Returns count of removed given MgmtEventCallback from the named MgmtEvent::Opcode list. */
+            /**
+             * Returns count of removed given MgmtEventCallback from the named MgmtEvent::Opcode list.
+             * <p>
+             * Like all removal methods, it returns only after the removed callbacks have completed
+             * on all dispatching threads, unless invoked from within a callback.
+             * </p>
+             */
             int removeMgmtEventCallback(const MgmtEvent::Opcode opc, const MgmtEventCallback &cb);
-            /** Returns count of removed MgmtEventCallback from the named MgmtEvent::Opcode list matching the given adapter dev_id . */
+            /**
+             * Returns count of removed MgmtEventCallback from the named MgmtEvent::Opcode list matching the given adapter dev_id .
+             * <p>
+             * Returns only after the adapter's callbacks in progress have completed, unless invoked from within a callback,
+             * hence the callbacks' owner may be destructed thereafter.
+             * </p>
+             */
             int removeMgmtEventCallback(const int dev_id);
             /** Removes all MgmtEventCallbacks from the to the named MgmtEvent::Opcode list. */
             void clearMgmtEventCallbacks(const MgmtEvent::Opcode opc);
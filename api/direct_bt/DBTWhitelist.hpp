@@ -0,0 +1,223 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2020 Gothel Software e.K.
+ * Copyright (c) 2020 ZAFENA AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef DBT_WHITELIST_HPP_
+#define DBT_WHITELIST_HPP_
+
+#include <cstring>
+#include <string>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "BTAddress.hpp"
+#include "BTTypes.hpp"
+#include "MgmtTypes.hpp"
+
+/**
+ * - - - - - - - - - - - - - - -
+ *
+ * Module DBTWhitelist:
+ *
+ * - Local autoconnect whitelist of all adapter, tracking the controller's limited whitelist capacity
+ */
+namespace direct_bt {
+
+    /**
+     * Local autoconnect whitelist of all adapter, see DBTManager.
+     * <p>
+     * Tracks which devices occupy a slot of their adapter's controller whitelist,
+     * bounded by the given capacity, while all other devices are only matched host-side.
+     * Slots are occupied while their add or remove command is in flight,
+     * hence the controller's whitelist never exceeds the capacity, even if a command fails.
+     * </p>
+     * <p>
+     * Since whitelistDeviceSeen(..) is invoked per advertising report, the per adapter state counts
+     * and the least recently seen eviction candidate are maintained incrementally in O(1).
+     * Therefore Element::state and Element::ts_last_seen shall only be modified via this class.
+     * </p>
+     * <p>
+     * Not thread safe, the owner shall guard all access.
+     * </p>
+     */
+    class DBTWhitelist {
+        public:
+            enum class State : uint8_t {
+                /** Only matched host-side */
+                HOST_SIDE,
+                /** Add to the controller's whitelist in flight, slot occupied */
+                ADDING,
+                /** Added to the controller's whitelist, slot occupied */
+                IN_CONTROLLER,
+                /** Eviction from the controller's whitelist in flight, slot still occupied */
+                EVICTING
+            };
+
+            struct Element {
+                int dev_id;
+                EUI48 address;
+                BDAddressType address_type;
+                HCIWhitelistConnectType ctype;
+                /** True if connParam shall be uploaded before adding the device to the controller */
+                bool hasConnParam;
+                MgmtConnParam connParam;
+                State state;
+                /** Last seen time in monotonic milliseconds, 0 if never seen. See DBTWhitelist::setLastSeen(..) */
+                uint64_t ts_last_seen;
+
+                /** Returns true if occupying a slot of the controller's whitelist. */
+                bool inController() const { return State::HOST_SIDE != state; }
+            };
+
+        private:
+            struct Key {
+                int dev_id;
+                EUI48 address;
+
+                bool operator==(const Key & o) const { return dev_id == o.dev_id && address == o.address; }
+            };
+            struct KeyHash {
+                std::size_t operator()(const Key & k) const noexcept {
+                    return std::hash<EUI48>()(k.address) * 31 + static_cast<std::size_t>(k.dev_id);
+                }
+            };
+            /** Element with its intrusive links within its adapter's eviction list */
+            struct Node {
+                Element element;
+                Node * lruPrev;
+                Node * lruNext;
+                bool inLRU;
+            };
+            /** Per adapter accounting, value-initialized on first use */
+            struct Adapter {
+                /** Number of elements per State */
+                int stateCount[4];
+                /** Eviction candidates ordered by Element::ts_last_seen, least recently seen first */
+                Node * lruHead;
+                Node * lruTail;
+            };
+
+            const int capacity;
+            /** Node addresses are stable until erased, referenced by the eviction lists */
+            std::unordered_map<Key, Node, KeyHash> elements;
+            std::unordered_map<int, Adapter> adapters;
+            /** Connected or connecting devices, never evicted from the controller */
+            std::unordered_set<Key, KeyHash> connected;
+
+            void setState(Element & e, const State s);
+
+            /** Links or unlinks the node to match being an eviction candidate, i.e. State::IN_CONTROLLER and not connected. */
+            void updateLRU(Node & n);
+            void linkLRU(Adapter & a, Node & n);
+            void unlinkLRU(Adapter & a, Node & n);
+
+        public:
+            /**
+             * @param capacity maximum number of devices per adapter occupying its controller's whitelist, 0 for unlimited
+             */
+            DBTWhitelist(const int capacity) : capacity(capacity) {}
+
+            int getCapacity() const { return capacity; }
+
+            size_t size() const { return elements.size(); }
+
+            /** Returns the element or nullptr if not whitelisted. */
+            Element * find(const int dev_id, const EUI48 & address);
+
+            /**
+             * Adds the given element in State::HOST_SIDE, regardless of the given element's state.
+             * <p>
+             * The returned element remains valid until removed.
+             * </p>
+             * @return the added element or nullptr if already whitelisted
+             */
+            Element * add(const Element & e);
+
+            /**
+             * Removes the element, releasing its controller slot.
+             * @return true if the element existed
+             */
+            bool remove(const int dev_id, const EUI48 & address);
+
+            /** Removes all elements of the given adapter. */
+            void removeAll(const int dev_id);
+
+            /** Removes all elements of all adapter. */
+            void clear();
+
+            /** Returns true if the adapter's controller whitelist has a free slot. */
+            bool hasCapacity(const int dev_id) const;
+
+            /** Returns the number of the adapter's elements occupying a controller slot. */
+            int getControllerCount(const int dev_id) const;
+
+            /** Returns the number of the adapter's elements in the given state. */
+            int getCount(const int dev_id, const State s) const;
+
+            /**
+             * Updates the element's last seen time, reordering it within the eviction candidates.
+             * <p>
+             * O(1) for monotonic timestamps, as the most recently seen element is appended.
+             * </p>
+             */
+            void setLastSeen(Element & e, const uint64_t timestamp);
+
+            /** Occupies a controller slot, i.e. State::ADDING. */
+            void setAdding(Element & e) { setState(e, State::ADDING); }
+
+            /** Completes a successful add or a failed eviction, i.e. State::IN_CONTROLLER. */
+            void setInController(Element & e) { setState(e, State::IN_CONTROLLER); }
+
+            /** Marks the element being evicted, keeping its controller slot, i.e. State::EVICTING. */
+            void setEvicting(Element & e) { setState(e, State::EVICTING); }
+
+            /** Releases the controller slot after a failed add or a successful eviction, i.e. State::HOST_SIDE. */
+            void setHostSide(Element & e) { setState(e, State::HOST_SIDE); }
+
+            /** Marks the device as connected or connecting, or neither. Independent of being whitelisted. */
+            void setConnected(const int dev_id, const EUI48 & address, const bool v);
+
+            bool isConnected(const int dev_id, const EUI48 & address) const;
+
+            /**
+             * Returns the least recently seen element of the adapter in State::IN_CONTROLLER
+             * which is neither connected nor connecting, or nullptr if none.
+             * <p>
+             * O(1), the head of the adapter's eviction list.
+             * </p>
+             */
+            Element * getEvictionCandidate(const int dev_id);
+
+            /**
+             * Returns the most recently seen host-side elements of the adapter, most recent first,
+             * limited to the number of free controller slots.
+             */
+            std::vector<Element*> getRotationCandidates(const int dev_id);
+    };
+
+} // namespace direct_bt
+
+#endif /* DBT_WHITELIST_HPP_ */
@@ -0,0 +1,225 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2020 Gothel Software e.K.
+ * Copyright (c) 2020 ZAFENA AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef GATT_CACHE_HPP_
+#define GATT_CACHE_HPP_
+
+#include <cstring>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+#include <mutex>
+
+#include "DBTEnv.hpp"
+#include "BTAddress.hpp"
+#include "OctetTypes.hpp"
+#include "GATTTypes.hpp"
+
+/**
+ * - - - - - - - - - - - - - - -
+ *
+ * Module GATTCache:
+ *
+ * - BT Core Spec v5.2: Vol 3, Part G GATT: 2.5.2 Attribute Caching
+ * - BT Core Spec v5.2: Vol 3, Part G GATT: 7.3 Database Hash
+ */
+namespace direct_bt {
+
+    class DBTDevice; // forward
+
+    /**
+     * GATT Cache runtime environment properties
+     * <p>
+     * Also see {@link DBTEnv::getExplodingProperties(const std::string & prefixDomain)}.
+     * </p>
+     */
+    class GATTCacheEnv : public DBTEnvrionment {
+        private:
+            GATTCacheEnv();
+
+            const bool exploding; // just to trigger exploding properties
+
+        public:
+            /**
+             * Enables the GATT attribute cache, defaults to true.
+             * <p>
+             * Environment variable is 'direct_bt.gatt.cache.enabled'.
+             * </p>
+             */
+            const bool ENABLED;
+
+            /**
+             * Persistent GATT attribute cache directory, defaults to empty, i.e. in-memory cache only.
+             * <p>
+             * Environment variable is 'direct_bt.gatt.cache.dir'.
+             * </p>
+             */
+            const std::string DIRECTORY;
+
+            /**
+             * Also reuse cached databases of devices not exposing a Database Hash characteristic, defaults to false.
+             * <p>
+             * Such entries can only be invalidated by a Service Changed indication,
+             * hence this is only safe for bonded devices or devices with an immutable database.
+             * </p>
+             * <p>
+             * Environment variable is 'direct_bt.gatt.cache.nohash'.
+             * </p>
+             */
+            const bool TRUST_NO_HASH;
+
+        public:
+            static GATTCacheEnv& get() {
+                /**
+                 * Thread safe starting with C++11 6.7:
+                 *
+                 * If control enters the declaration concurrently while the variable is being initialized,
+                 * the concurrent execution shall wait for completion of the initialization.
+                 *
+                 * (Magic Statics)
+                 *
+                 * Avoiding non-working double checked locking.
+                 */
+                static GATTCacheEnv e;
+                return e;
+            }
+    };
+
+    /**
+     * A thread safe singleton GATT attribute cache,
+     * holding the discovered GATTService, GATTCharacteristic and GATTDescriptor declarations
+     * per device address in a compact binary form.
+     * <p>
+     * Entries are kept in memory and optionally persisted within {@link GATTCacheEnv::DIRECTORY},
+     * one file per device.
+     * </p>
+     * <p>
+     * An entry carries the device's Database Hash, if exposed,
+     * allowing a reconnecting client to validate the cached database
+     * with a single ATT_READ_BY_TYPE_REQ instead of a complete discovery.
+     * </p>
+     * <p>
+     * BT Core Spec v5.2: Vol 3, Part G GATT: 2.5.2 Attribute Caching
+     * </p>
+     * <p>
+     * Controlling Environment variables, see {@link GATTCacheEnv}.
+     * </p>
+     */
+    class GATTCache {
+        public:
+            /** Binary format version of serialized entries. */
+            static const uint8_t VERSION;
+
+            /** Size of the Database Hash value, a 128 bit AES-CMAC. */
+            static const int DB_HASH_SIZE = 16;
+
+        private:
+            const GATTCacheEnv & env;
+            std::unordered_map<std::string, POctets> entries;
+            std::recursive_mutex mtx_entries;
+
+            GATTCache();
+
+            GATTCache(const GATTCache&) = delete;
+            void operator=(const GATTCache&) = delete;
+
+            static std::string getKey(const EUI48 & address, const BDAddressType addressType);
+            std::string getFilename(const std::string & key) const;
+
+            bool loadFile(const std::string & key, POctets & data);
+            bool storeFile(const std::string & key, const TROOctets & data);
+
+        public:
+            static GATTCache& get() {
+                /**
+                 * Thread safe starting with C++11 6.7:
+                 *
+                 * If control enters the declaration concurrently while the variable is being initialized,
+                 * the concurrent execution shall wait for completion of the initialization.
+                 *
+                 * (Magic Statics)
+                 *
+                 * Avoiding non-working double checked locking.
+                 */
+                static GATTCache c;
+                return c;
+            }
+
+            bool isEnabled() const { return env.ENABLED; }
+
+            /**
+             * Serializes the given Database Hash and service tree into the given POctets.
+             * <p>
+             * Descriptor values are included, except the volatile Client Characteristic Configuration value.
+             * </p>
+             */
+            static void write(POctets & out, const TROOctets & dbHash, const std::vector<GATTServiceRef> & services);
+
+            /**
+             * Deserializes the given data into a new service tree associated to the given device.
+             * <p>
+             * Returns false if the data is malformed or of a different version, otherwise true.
+             * </p>
+             */
+            static bool read(const TROOctets & in, const std::shared_ptr<DBTDevice> & device,
+                             POctets & dbHash, std::vector<GATTServiceRef> & services);
+
+            /**
+             * Stores the given service tree for the given device, replacing any previous entry.
+             * <p>
+             * An empty dbHash denotes a device not exposing a Database Hash,
+             * which entry will only be restored if {@link GATTCacheEnv::TRUST_NO_HASH} is enabled.
+             * </p>
+             */
+            void put(const EUI48 & address, const BDAddressType addressType,
+                     const TROOctets & dbHash, const std::vector<GATTServiceRef> & services);
+
+            /**
+             * Restores a new service tree of the given device from the cache, if available.
+             * <p>
+             * The cached Database Hash is returned in dbHash, being empty if none has been stored.
+             * The caller shall validate it against the device's current Database Hash.
+             * </p>
+             * @return true if an entry has been found and restored, otherwise false.
+             */
+            bool get(const std::shared_ptr<DBTDevice> & device, POctets & dbHash, std::vector<GATTServiceRef> & services);
+
+            /**
+             * Removes the entry of the given device from memory and persistent storage,
+             * e.g. after a Service Changed indication or a Database Hash mismatch.
+             * @return true if an entry has been removed, otherwise false.
+             */
+            bool invalidate(const EUI48 & address, const BDAddressType addressType);
+
+            /** Removes all in-memory entries, leaving the persistent storage untouched. */
+            void clear();
+    };
+
+} // namespace direct_bt
+
+#endif /* GATT_CACHE_HPP_ */
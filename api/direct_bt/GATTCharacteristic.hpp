@@ -57,6 +57,7 @@
 namespace direct_bt {
 
     class GATTCharacteristicListener; // forward
+    class GATTWriteStreamStats; // forward
 
     class GATTService; // forward
     typedef std::shared_ptr<GATTService> GATTServiceRef;
@@ -74,6 +75,8 @@ namespace direct_bt {
      * </p>
      */
     class GATTCharacteristic : public DBTObject {
+        friend DBTDevice; // tracks the enabled state of its subscriptions
+
         private:
             /** Characteristics's service weak back-reference */
             std::weak_ptr<GATTService> wbr_service;
@@ -380,6 +383,18 @@ namespace direct_bt {
              * </p>
              */
             bool writeValueNoResp(const TROOctets & value);
+
+            /**
+             * Streams the given data via a sequence of ATT_WRITE_CMD packets with backpressure,
+             * see GATTHandler::writeValueStream(const uint16_t, const TROOctets &, GATTWriteStreamStats &).
+             * <p>
+             * Convenience delegation call to GATTHandler via DBTDevice
+             * <p>
+             * </p>
+             * If the DBTDevice's GATTHandler is null, i.e. not connected, an IllegalStateException is thrown.
+             * </p>
+             */
+            bool writeValueStream(const TROOctets & data, GATTWriteStreamStats & stats);
     };
     typedef std::shared_ptr<GATTCharacteristic> GATTCharacteristicRef;
 
@@ -436,6 +451,47 @@ namespace direct_bt {
             virtual void notificationReceived(GATTCharacteristicRef charDecl,
                                               std::shared_ptr<TROOctets> charValue, const uint64_t timestamp) = 0;
 
+            /**
+             * Called from native BLE stack, initiated by a received notification associated
+             * with the given {@link GATTCharacteristic}, passing its kernel receive timestamp.
+             * <p>
+             * Default implementation calls notificationReceived(GATTCharacteristicRef, std::shared_ptr<TROOctets>, const uint64_t).
+             * </p>
+             * @param charDecl {@link GATTCharacteristic} related to this notification
+             * @param charValue the notification value
+             * @param timestamp the notification monotonic timestamp, see getCurrentMilliseconds()
+             * @param rxTimestamp the kernel receive timestamp in nanoseconds, see getWallClockNanoseconds()
+             */
+            virtual void notificationReceived(GATTCharacteristicRef charDecl,
+                                              std::shared_ptr<TROOctets> charValue, const uint64_t timestamp,
+                                              const uint64_t rxTimestamp) {
+                (void)rxTimestamp;
+                notificationReceived(charDecl, charValue, timestamp);
+            }
+
+            /**
+             * Called from native BLE stack, initiated by a received ATT_MULTIPLE_HANDLE_VALUE_NTF
+             * with all values of matching characteristics within one batch.
+             * <p>
+             * The values are views into the received PDU without copy, only valid while this method runs.
+             * </p>
+             * <p>
+             * Default implementation returns false,
+             * causing delivery of each value via notificationReceived(..).
+             * </p>
+             * @param charDecls {@link GATTCharacteristic}s related to this notification, in received order
+             * @param charValues the notification values, one for each charDecls element
+             * @param timestamp the notification monotonic timestamp, see getCurrentMilliseconds()
+             * @return true if the batch has been consumed, otherwise false.
+             */
+            virtual bool notificationsReceived(const std::vector<GATTCharacteristicRef> & charDecls,
+                                               const std::vector<TROOctets> & charValues, const uint64_t timestamp) {
+                (void)charDecls;
+                (void)charValues;
+                (void)timestamp;
+                return false;
+            }
+
             /**
              * Called from native BLE stack, initiated by a received indication associated
              * with the given {@link GATTCharacteristic}.
@@ -448,6 +504,25 @@ namespace direct_bt {
                                             std::shared_ptr<TROOctets> charValue, const uint64_t timestamp,
                                             const bool confirmationSent) = 0;
 
+            /**
+             * Called from native BLE stack, initiated by a received indication associated
+             * with the given {@link GATTCharacteristic}, passing its kernel receive timestamp.
+             * <p>
+             * Default implementation calls indicationReceived(GATTCharacteristicRef, std::shared_ptr<TROOctets>, const uint64_t, const bool).
+             * </p>
+             * @param charDecl {@link GATTCharacteristic} related to this indication
+             * @param charValue the indication value
+             * @param timestamp the indication monotonic timestamp, see getCurrentMilliseconds()
+             * @param confirmationSent if true, the native stack has sent the confirmation, otherwise user is required to do so.
+             * @param rxTimestamp the kernel receive timestamp in nanoseconds, see getWallClockNanoseconds()
+             */
+            virtual void indicationReceived(GATTCharacteristicRef charDecl,
+                                            std::shared_ptr<TROOctets> charValue, const uint64_t timestamp,
+                                            const bool confirmationSent, const uint64_t rxTimestamp) {
+                (void)rxTimestamp;
+                indicationReceived(charDecl, charValue, timestamp, confirmationSent);
+            }
+
             virtual ~GATTCharacteristicListener() {}
 
             /**
@@ -31,14 +31,17 @@
 #include <memory>
 #include <cstdint>
 #include <vector>
+#include <deque>
 
 #include <mutex>
 #include <atomic>
 #include <thread>
+#include <condition_variable>
 
 #include "DBTEnv.hpp"
 #include "UUID.hpp"
 #include "BTTypes.hpp"
+#include "FunctionDef.hpp"
 #include "L2CAPComm.hpp"
 #include "ATTPDUTypes.hpp"
 #include "GATTTypes.hpp"
@@ -78,6 +81,35 @@ namespace direct_bt {
              */
             const int32_t L2CAP_READER_THREAD_POLL_TIMEOUT;
 
+            /**
+             * Service all L2CAP connections via the shared L2CAPReactor, defaults to false.
+             * <p>
+             * If enabled, the unenhanced ATT bearer and all EATT bearers of all connections are read
+             * by the L2CAPReactor's fixed number of epoll threads, see 'direct_bt.gatt.reactor.threads'.
+             * Otherwise each bearer uses its own blocking reader thread.
+             * </p>
+             * <p>
+             * The reactor threads do not invoke the GATTCharacteristicListener, as a slow listener would stall all sockets of their shard.
+             * Instead each listener gets decorated by a QueuedGATTCharacteristicListener, see GATT_REACTOR_LISTENER_QUEUE_CAPACITY.
+             * </p>
+             * <p>
+             * Environment variable is 'direct_bt.gatt.reactor'.
+             * </p>
+             */
+            const bool GATT_REACTOR;
+
+            /**
+             * Event queue capacity of each GATTCharacteristicListener in GATT_REACTOR mode, defaults to 64.
+             * <p>
+             * Listener already being a QueuedGATTCharacteristicListener are used as is.
+             * Otherwise the oldest event is dropped if full, see QueuedGATTCharacteristicListener::QueuePolicy::DROP_OLDEST.
+             * </p>
+             * <p>
+             * Environment variable is 'direct_bt.gatt.reactor.queue'.
+             * </p>
+             */
+            const int32_t GATT_REACTOR_LISTENER_QUEUE_CAPACITY;
+
             /**
              * Timeout for GATT read command replies, defaults to 500ms.
              * <p>
@@ -102,6 +134,47 @@ namespace direct_bt {
              */
             const int32_t GATT_INITIAL_COMMAND_REPLY_TIMEOUT;
 
+            /**
+             * Adaptive GATT command reply timeouts, defaults to true.
+             * <p>
+             * If enabled, the reply timeout of each request is derived from the connection's measured
+             * round-trip time, see GATTRTTStats::getTimeout(..), bounded by
+             * GATT_MIN_COMMAND_REPLY_TIMEOUT and GATT_MAX_COMMAND_REPLY_TIMEOUT.
+             * The fixed read and write timeouts above are used until enough samples have been measured
+             * and after each connection parameter update, which restarts the estimation.
+             * They are not exceeded until the estimation has converged, see GATTRTTStats::CONVERGED_SAMPLES.
+             * The initial MTU exchange always uses GATT_INITIAL_COMMAND_REPLY_TIMEOUT and is not measured.
+             * </p>
+             * <p>
+             * Environment variable is 'direct_bt.gatt.cmd.adaptive'.
+             * </p>
+             */
+            const bool GATT_ADAPTIVE_COMMAND_REPLY_TIMEOUT;
+
+            /**
+             * Lower bound of an adaptive GATT command reply timeout, defaults to 200ms.
+             * <p>
+             * Well below the fixed read and write timeouts, allowing fast links to detect a lost reply early,
+             * while covering a few connection intervals. RFC 6298 2.4's 1s minimum targets internet paths.
+             * </p>
+             * <p>
+             * Environment variable is 'direct_bt.gatt.cmd.min.timeout'.
+             * </p>
+             */
+            const int32_t GATT_MIN_COMMAND_REPLY_TIMEOUT;
+
+            /**
+             * Upper bound of an adaptive GATT command reply timeout, defaults to 30s,
+             * i.e. the ATT transaction timeout.
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part F ATT: 3.3.3 Transaction
+             * </p>
+             * <p>
+             * Environment variable is 'direct_bt.gatt.cmd.max.timeout'.
+             * </p>
+             */
+            const int32_t GATT_MAX_COMMAND_REPLY_TIMEOUT;
+
             /**
              * Medium ringbuffer capacity, defaults to 128 messages.
              * <p>
@@ -110,6 +183,67 @@ namespace direct_bt {
              */
             const int32_t ATTPDU_RING_CAPACITY;
 
+            /**
+             * Maximum number of pooled receive buffers, defaults to 64.
+             * <p>
+             * Notification and indication values are delivered as views into these buffers without copy,
+             * a buffer is recycled once all listeners released their value reference.
+             * If all buffers are in use, additional unpooled buffers are allocated.
+             * </p>
+             * <p>
+             * Environment variable is 'direct_bt.gatt.poolsize'.
+             * </p>
+             */
+            const int32_t ATTPDU_POOL_SIZE;
+
+            /**
+             * Number of Enhanced ATT (EATT) bearers to establish in addition to the unenhanced ATT bearer, defaults to 0.
+             * <p>
+             * If non zero and the server supports EATT, additional L2CAP Enhanced Credit Based Flow Control channels
+             * are connected after service discovery, allowing concurrent GATT requests from different threads.
+             * Requires kernel support for L2CAP mode BT_MODE_EXT_FLOWCTL.
+             * </p>
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 5.3 Enhanced ATT bearer
+             * </p>
+             * <p>
+             * Environment variable is 'direct_bt.gatt.eatt.bearers'.
+             * </p>
+             */
+            const int32_t GATT_EATT_BEARER_COUNT;
+
+            /**
+             * Batched discovery of characteristics and descriptors, defaults to true.
+             * <p>
+             * If enabled, characteristics and descriptors are discovered over the complete handle range
+             * of consecutive services, using as few large range ATT_READ_BY_TYPE_REQ and ATT_FIND_INFORMATION_REQ
+             * as the used MTU allows. Results are assigned to their services and characteristics locally.
+             * </p>
+             * <p>
+             * Otherwise the discovery is performed per service and per characteristic.
+             * </p>
+             * <p>
+             * Environment variable is 'direct_bt.gatt.discovery.batch'.
+             * </p>
+             */
+            const bool GATT_BATCH_DISCOVERY;
+
+            /**
+             * Minimum size in bytes of a GATT transfer to temporarily switch the LE link
+             * to the LEConnProfile::BULK_TRANSFER connection parameter, defaults to 2048 bytes.
+             * <p>
+             * Applies to writeValueStream(..), writeLongValue(..) and readValue(..) with a known expected length.
+             * The device's configured LEConnProfile is restored after the transfer, see DBTDevice::setConnectionProfile(..).
+             * </p>
+             * <p>
+             * Zero disables the automatic switching.
+             * </p>
+             * <p>
+             * Environment variable is 'direct_bt.gatt.bulk.threshold'.
+             * </p>
+             */
+            const int32_t GATT_BULK_TRANSFER_THRESHOLD;
+
             /**
              * Debug all GATT Data communication
              * <p>
@@ -135,23 +269,147 @@ namespace direct_bt {
             }
     };
 
+    /**
+     * Statistics of one GATTHandler::writeValueStream(..) transfer.
+     */
+    class GATTWriteStreamStats {
+        public:
+            /** Number of sent ATT_WRITE_CMD packets */
+            int packetCount = 0;
+            /** Number of sent value bytes */
+            int byteCount = 0;
+            /** Number of times the writer had to wait for the socket's send queue to drain */
+            int backpressureCount = 0;
+            /** Duration of the complete transfer in milliseconds */
+            int64_t durationMS = 0;
+
+            /** Returns the achieved value throughput in bytes per second. */
+            double getThroughput() const {
+                return 0 < durationMS ? ( byteCount * 1000.0 ) / durationMS : 0.0;
+            }
+
+            std::string toString() const {
+                return "WriteStream[packets "+std::to_string(packetCount)+", bytes "+std::to_string(byteCount)+
+                       ", backpressure "+std::to_string(backpressureCount)+", "+std::to_string(durationMS)+" ms, "+
+                       std::to_string(getThroughput())+" bytes/s]";
+            }
+    };
+
+    /**
+     * Round-trip time statistics of GATT requests of one connection,
+     * see GATTHandler::getRTTStats().
+     * <p>
+     * The smoothed RTT and its variance are estimated as specified for TCP's retransmission timer,
+     * see RFC 6298, hence reflecting the connection interval, slave latency and link layer retransmissions.
+     * </p>
+     * <p>
+     * The estimation shall be restarted whenever the connection parameter change, see restart().
+     * </p>
+     */
+    class GATTRTTStats {
+        public:
+            /** Minimum number of samples before getTimeout(..) adapts. */
+            static const int MIN_SAMPLES = 4;
+
+            /** Number of samples after which getTimeout(..) may exceed the fallback timeout. */
+            static const int CONVERGED_SAMPLES = 16;
+
+            /** Maximum timeout multiplier applied after consecutive timeouts. */
+            static const int MAX_BACKOFF = 64;
+
+            /** Number of measured request replies */
+            int sampleCount = 0;
+            /** Number of measured request replies since the last restart() */
+            int estimatedCount = 0;
+            /** Number of timed out requests */
+            int timeoutCount = 0;
+            /** Minimum measured RTT in milliseconds */
+            int64_t minRTT = 0;
+            /** Maximum measured RTT in milliseconds */
+            int64_t maxRTT = 0;
+            /** Last measured RTT in milliseconds */
+            int64_t lastRTT = 0;
+            /** Smoothed RTT in milliseconds */
+            double smoothedRTT = 0.0;
+            /** RTT variation in milliseconds */
+            double varianceRTT = 0.0;
+            /** Timeout multiplier, doubled on each timeout and reset by the next sample, see RFC 6298 5.5. */
+            int backoff = 1;
+
+            /** Adds the given measured RTT in milliseconds and resets the backoff. */
+            void addSample(const int64_t rtt);
+
+            /** Counts a timed out request and doubles the backoff up to MAX_BACKOFF. */
+            void addTimeout();
+
+            /**
+             * Restarts the estimation, e.g. after a connection parameter update,
+             * i.e. the fallback timeout is used until MIN_SAMPLES have been measured again.
+             * The sample and timeout counter are kept.
+             */
+            void restart();
+
+            /**
+             * Returns the reply timeout in milliseconds derived from the measured RTT,
+             * i.e. smoothedRTT + 4 * varianceRTT bounded by the given minimum and maximum.
+             * <p>
+             * Returns the given fallback timeout while less than MIN_SAMPLES have been measured since the last restart().
+             * Until CONVERGED_SAMPLES have been measured, the derived timeout does not exceed the fallback timeout.
+             * </p>
+             * <p>
+             * The derived timeout is multiplied by the backoff, bounded by the given maximum
+             * or the fallback timeout, whichever is greater.
+             * The fallback timeout is not backed off, as a timeout on the unenhanced ATT bearer disconnects anyway.
+             * </p>
+             */
+            int getTimeout(const int fallback, const int minTimeout, const int maxTimeout) const;
+
+            std::string toString() const;
+    };
+
+    /**
+     * Completion of an asynchronous GATT request, see GATTHandler::sendAsync(..).
+     * <p>
+     * The reply PDU is nullptr on timeout or disconnect.
+     * </p>
+     */
+    typedef FunctionDef<void, std::shared_ptr<const AttPDUMsg>> GATTReplyCallback;
+
+    /**
+     * Completion of GATTHandler::readValueAsync(..), passing the success state and the read value.
+     * <p>
+     * The value is nullptr if not successful.
+     * </p>
+     */
+    typedef FunctionDef<void, bool, std::shared_ptr<TROOctets>> GATTReadValueCallback;
+
+    /** Completion of GATTHandler::writeValueAsync(..), passing the success state. */
+    typedef FunctionDef<void, bool> GATTWriteValueCallback;
+
     /**
      * A thread safe GATT handler associated to one device via one L2CAP connection.
      * <p>
-     * Implementation utilizes a lock free ringbuffer receiving data within its separate thread.
+     * Implementation utilizes a lock free ringbuffer receiving data within its separate thread,
+     * or within the shared L2CAPReactor's thread if GATTEnv::GATT_REACTOR is enabled.
+     * </p>
+     * <p>
+     * Instances must be created as a std::shared_ptr.
      * </p>
      * <p>
      * Controlling Environment variables, see {@link GATTEnv}.
      * </p>
      */
-    class GATTHandler {
+    class GATTHandler : public std::enable_shared_from_this<GATTHandler> {
         public:
             enum class Defaults : int32_t {
                 /* BT Core Spec v5.2: Vol 3, Part F 3.2.8: Maximum length of an attribute value. */
                 MAX_ATT_MTU = 512,
 
                 /* BT Core Spec v5.2: Vol 3, Part G GATT: 5.2.1 ATT_MTU */
-                MIN_ATT_MTU = 23
+                MIN_ATT_MTU = 23,
+
+                /* BT Core Spec v5.2: Vol 3, Part G GATT: 5.3.1 ATT_MTU of an Enhanced ATT bearer */
+                MIN_EATT_MTU = 64
             };
             static inline int number(const Defaults d) { return static_cast<int>(d); }
 
@@ -161,18 +419,25 @@ namespace direct_bt {
             /** GATTHandle's device weak back-reference */
             std::weak_ptr<DBTDevice> wbr_device;
 
+            /** The device's adapter dev_id, binding the reader threads, see DBTEnv::setAdapterThreadAffinity(..). */
+            const int adapterDevId;
             const std::string deviceString;
             std::recursive_mutex mtx_command;
-            POctets rbuffer;
+            std::recursive_mutex mtx_stream;
+            /** Pool of receive buffers, see GATTEnv::ATTPDU_POOL_SIZE. Acquired by the l2cap reader thread only. */
+            OctetsPool rbufferPool;
 
             L2CAPComm l2cap;
             std::atomic<bool> isConnected; // reflects state
             std::atomic<bool> hasIOError;  // reflects state
 
             LFRingbuffer<std::shared_ptr<const AttPDUMsg>, nullptr> attPDURing;
-            std::atomic<pthread_t> l2capReaderThreadId;
+            /** The l2cap reader thread of thread mode, guarded by mtx_l2capReaderInit and joined by disconnect() or the destructor. */
+            std::thread l2capReaderThread;
             std::atomic<bool> l2capReaderRunning;
             std::atomic<bool> l2capReaderShallStop;
+            /** The socket registered with the L2CAPReactor, or -1 */
+            std::atomic<int> reactorFd;
             std::mutex mtx_l2capReaderInit;
             std::condition_variable cv_l2capReaderInit;
 
@@ -181,18 +446,313 @@ namespace direct_bt {
             std::vector<std::shared_ptr<GATTCharacteristicListener>> characteristicListenerList;
             std::recursive_mutex mtx_eventListenerList;
 
+            /**
+             * Immutable handle table entry, replaced as a whole on change.
+             */
+            class HandleEntry {
+                public:
+                    /** The characteristic owning the handle */
+                    const GATTCharacteristicRef characteristic;
+                    /** The descriptor of the handle, nullptr for the characteristic's value handle */
+                    const GATTDescriptorRef descriptor;
+                    /** Listener pre-resolved via GATTCharacteristicListener::match(..) against the characteristic */
+                    const std::vector<std::shared_ptr<GATTCharacteristicListener>> listener;
+
+                    HandleEntry(const GATTCharacteristicRef & c, const GATTDescriptorRef & d,
+                                const std::vector<std::shared_ptr<GATTCharacteristicListener>> & l)
+                    : characteristic(c), descriptor(d), listener(l) {}
+            };
+            /**
+             * Attribute table indexed by handle, covering all characteristic value and descriptor handles,
+             * allowing O(1) notification and indication routing.
+             * <p>
+             * Built after service discovery, re-resolved on listener changes
+             * and cleared on Service Changed. Guarded by mtx_eventListenerList.
+             * </p>
+             */
+            std::vector<std::shared_ptr<const HandleEntry>> handleTable;
+
+            /**
+             * The Service Changed characteristic of the last discovery or nullptr, guarded by mtx_eventListenerList.
+             * <p>
+             * Retained while the handleTable is cleared, detecting each Service Changed indication independently.
+             * </p>
+             */
+            GATTCharacteristicRef serviceChangedChar;
+            /** True if a Service Changed indication has been received since the last discovery, see isServicesChanged(). */
+            std::atomic<bool> servicesChanged;
+
             uint16_t serverMTU;
             uint16_t usedMTU;
+
+            /** Round-trip time statistics, guarded by mtx_rttStats */
+            GATTRTTStats rttStats;
+            mutable std::mutex mtx_rttStats;
+
+            void addRTTSample(const int64_t rtt);
+            void addRTTTimeout();
+
+            /**
+             * Returns the reply timeout for a request, adapted to the measured RTT
+             * if GATTEnv::GATT_ADAPTIVE_COMMAND_REPLY_TIMEOUT is enabled.
+             * @param fallback the fixed timeout used without adaptation or sufficient samples
+             */
+            int getReplyTimeout(const int fallback) const;
+
+            /**
+             * Asynchronous request on the unenhanced ATT bearer.
+             */
+            class AsyncRequest {
+                public:
+                    const std::shared_ptr<const AttPDUMsg> req;
+                    GATTReplyCallback callback;
+                    const int timeout;
+                    /** Send time in milliseconds */
+                    int64_t sent;
+                    /** Reply deadline in milliseconds, set when sent */
+                    int64_t deadline;
+
+                    AsyncRequest(const std::shared_ptr<const AttPDUMsg> & req, const GATTReplyCallback & callback, const int timeout)
+                    : req(req), callback(callback), timeout(timeout), sent(0), deadline(0) {}
+            };
+            /** Queued asynchronous requests, guarded by mtx_async. */
+            std::deque<std::shared_ptr<AsyncRequest>> asyncQueue;
+            /** The sent asynchronous request awaiting its reply, guarded by mtx_async. */
+            std::shared_ptr<AsyncRequest> asyncInFlight;
+            /** True while a blocking request owns the unenhanced ATT bearer, guarded by mtx_async. */
+            bool syncInFlight;
+            std::mutex mtx_async;
+            std::condition_variable cv_async;
+
+            /** True if server rejected ATT_READ_MULTIPLE_VARIABLE_REQ, guarded by mtx_command. */
+            bool readMultipleVariableUnsupported;
+            /** True if the Client Supported Features have been negotiated for this connection. */
+            std::atomic<bool> featuresConfigured;
+            /** True if client and server support EATT, negotiated once per connection. */
+            std::atomic<bool> eattSupported;
+            /** The Database Hash read during this connection's discovery, if dbHashRead. Accessed under the discovery's BearerLock. */
+            POctets dbHash;
+            bool dbHashRead;
             std::vector<GATTServiceRef> services;
 
             std::shared_ptr<DBTDevice> getDevice() const { return wbr_device.lock(); }
 
             bool validateConnected();
 
-            void l2capReaderThreadImpl();
+            /**
+             * Returns the end index of the run of consecutive services starting at the given index,
+             * i.e. without handle gaps in between.
+             */
+            static size_t getConsecutiveServicesEnd(const std::vector<GATTServiceRef> & services, const size_t start);
+
+            /** Returns true if the given filter is empty or contains the given type. */
+            static bool isSelected(const std::vector<std::shared_ptr<const uuid_t>> & filter, const uuid_t & type);
+
+            GATTCharacteristicRef createCharacteristic(GATTServiceRef & service, const AttReadByTypeRsp & p, const int e_iter);
 
-            void send(const AttPDUMsg & msg);
-            std::shared_ptr<const AttPDUMsg> sendWithReply(const AttPDUMsg & msg, const int timeout);
+            /**
+             * Enhanced ATT bearer, an additional L2CAP Enhanced Credit Based Flow Control channel
+             * with its own reader thread, reply ringbuffer, receive buffer pool and ATT_MTU.
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 5.3 Enhanced ATT bearer
+             * </p>
+             */
+            class EATTBearer {
+                public:
+                    L2CAPComm l2cap;
+                    /** Serializes this bearer's request/response transactions */
+                    std::recursive_mutex mtx_command;
+                    /** Pool of receive buffers, acquired by this bearer's reader thread only. */
+                    OctetsPool rbufferPool;
+                    LFRingbuffer<std::shared_ptr<const AttPDUMsg>, nullptr> attPDURing;
+                    /** ATT_MTU of this bearer, i.e. the L2CAP channel's MTU */
+                    uint16_t mtu;
+                    std::atomic<bool> readerRunning;
+                    std::atomic<bool> readerShallStop;
+                    /** The socket registered with the L2CAPReactor, or -1 */
+                    std::atomic<int> reactorFd;
+
+                    EATTBearer(const std::shared_ptr<DBTDevice> & device, const GATTEnv & env);
+
+                    /** Adopting the given connected socket, see addEATTBearer(..). */
+                    EATTBearer(const int socket, const std::string & deviceString, const GATTEnv & env);
+            };
+            std::vector<std::shared_ptr<EATTBearer>> eattBearers;
+            /** The EATT bearer reader threads of thread mode, including ended ones, joined by disconnectEATT(). */
+            std::vector<std::thread> eattReaderThreads;
+            std::mutex mtx_eattBearers;
+            /** Round robin start index for the EATT bearer selection */
+            std::atomic<unsigned int> eattBearerNext;
+
+            /** The GATTHandler owning the bearer locked by the current thread via BearerLock, if any. */
+            static thread_local const GATTHandler * currentHandler;
+            /** The EATT bearer locked by the current thread via BearerLock, nullptr for the unenhanced ATT bearer. */
+            static thread_local EATTBearer * currentBearer;
+
+            /**
+             * RAII-style selection and locking of an ATT bearer for one or more request/response transactions.
+             * <p>
+             * Nested use within the same thread keeps the already selected bearer.
+             * Otherwise the first idle bearer is used, starting with the unenhanced ATT bearer
+             * and then the EATT bearers in round robin order.
+             * If all bearers are busy, blocks on the unenhanced ATT bearer.
+             * </p>
+             */
+            class BearerLock {
+                private:
+                    const GATTHandler * prevHandler;
+                    EATTBearer * prevBearer;
+                    std::shared_ptr<EATTBearer> bearer;
+                    std::unique_lock<std::recursive_mutex> lock;
+
+                public:
+                    BearerLock(GATTHandler & handler);
+                    ~BearerLock();
+
+                    BearerLock(const BearerLock&) = delete;
+                    void operator=(const BearerLock&) = delete;
+            };
+
+            /**
+             * RAII-style bulk transfer scope, switching the device's LE link
+             * to the LEConnProfile::BULK_TRANSFER connection parameter for the scope's duration,
+             * if the given transfer size reaches GATTEnv::GATT_BULK_TRANSFER_THRESHOLD.
+             * <p>
+             * Must be constructed before the BearerLock, as the connection update blocks for its HCI round trip.
+             * Within a BearerLock of the same thread, the scope is a no-op.
+             * </p>
+             */
+            class BulkTransferScope {
+                private:
+                    GATTHandler & handler;
+                    std::shared_ptr<DBTDevice> device;
+
+                public:
+                    BulkTransferScope(GATTHandler & handler, const int size);
+                    ~BulkTransferScope();
+
+                    BulkTransferScope(const BulkTransferScope&) = delete;
+                    void operator=(const BulkTransferScope&) = delete;
+            };
+
+            /** Returns the EATT bearer selected by the current thread for this instance, or nullptr for the unenhanced ATT bearer. */
+            EATTBearer * getCurrentBearer() const {
+                return this == currentHandler ? currentBearer : nullptr;
+            }
+
+            /** Returns the ATT_MTU of the bearer selected by the current thread. */
+            uint16_t getBearerMTU() const {
+                const EATTBearer * b = getCurrentBearer();
+                return nullptr != b ? b->mtu : usedMTU;
+            }
+
+            void eattReaderThreadImpl(std::shared_ptr<EATTBearer> bearer);
+
+            /** L2CAPReactor readable callback of the given EATT bearer, returns false if its reader has ended. */
+            bool eattReactorReadable(std::shared_ptr<EATTBearer> bearer);
+
+            /** Releases the given EATT bearer after its reader has ended, keeping the unenhanced ATT bearer. */
+            void eattReaderEnded(std::shared_ptr<EATTBearer> bearer);
+
+            /**
+             * Sends the next queued asynchronous request if the unenhanced ATT bearer is idle, while holding mtx_async.
+             * <p>
+             * Returns false on l2cap write error.
+             * </p>
+             */
+            bool sendNextAsyncLocked();
+
+            /**
+             * Completes the asynchronous request awaiting the given reply, if any,
+             * sending the next queued request before invoking its callback.
+             * <p>
+             * Called by the l2cap reader thread, returns false if no asynchronous request was awaiting a reply.
+             * </p>
+             */
+            bool completeAsync(const std::shared_ptr<const AttPDUMsg> & reply);
+
+            /** Completes all queued and awaiting asynchronous requests with a nullptr reply. */
+            void cancelAsyncRequests();
+
+            /** Returns the l2cap reader's poll timeout, bounded by the awaiting asynchronous request's deadline. */
+            int getAsyncPollTimeout();
+
+            /** Returns true if the awaiting asynchronous request's deadline has passed. */
+            bool isAsyncTimedOut();
+
+            /** Waits until no asynchronous request awaits a reply and blocks sending further ones, see endSyncTransaction(). */
+            void beginSyncTransaction();
+
+            /** Resumes sending queued asynchronous requests, see beginSyncTransaction(). */
+            void endSyncTransaction();
+
+            /** Continues readValueAsync(..) with the given reply, reading the remaining value parts via ATT_READ_BLOB_REQ. */
+            void readValueAsyncReply(const uint16_t handle, std::shared_ptr<POctets> value, GATTReadValueCallback callback,
+                                     std::shared_ptr<const AttPDUMsg> reply);
+
+            /** Removes the given EATT bearer from the selectable bearers and disconnects it, waking up its reader thread. */
+            void stopEATTBearer(EATTBearer & bearer);
+
+            /** Disconnects all EATT bearers and joins their reader threads, see joinReaderThread(..). */
+            void disconnectEATT();
+
+            /** Reads the server's supported features, returns false if not available. */
+            bool readServerSupportedFeatures(uint8_t & res);
+
+            /** Reads the value of the given newly discovered descriptor and adds it to its characteristic. */
+            bool addDescriptor(GATTCharacteristic & charDecl, GATTDescriptorRef & cd);
+
+            /**
+             * The l2cap reader thread of thread mode.
+             * @param wself weak reference to this instance, keeping it alive while disconnecting after an I/O error
+             */
+            void l2capReaderThreadImpl(std::weak_ptr<GATTHandler> wself);
+
+            /**
+             * Joins the given reader thread, which must be woken up before, i.e. via L2CAPComm::disconnect().
+             * @return false if called from the given reader thread itself, which is left to the destructor
+             */
+            static bool joinReaderThread(std::thread & t);
+
+            /** Joins the l2cap reader thread of thread mode, see joinReaderThread(..). */
+            void joinL2CAPReaderThread();
+
+            /** L2CAPReactor readable callback of the unenhanced ATT bearer, returns false if its reader has ended. */
+            bool reactorReadable();
+
+            /** L2CAPReactor tick callback detecting an asynchronous reply timeout, returns false if its reader has ended. */
+            bool reactorTick();
+
+            /**
+             * Deregisters the unenhanced ATT bearer from L2CAPReactor after its reader has ended
+             * and disconnects like the end of l2capReaderThreadImpl(), however on the single thread
+             * of the reactor's disconnect executor not to block the reactor thread.
+             * <p>
+             * Skipped if disconnect() has deregistered the bearer already, hence queued once per connection at most.
+             * </p>
+             */
+            void reactorReaderEnded(const bool ioErrorCause);
+
+            /**
+             * Processes the given received PDU from the given bearer's reader thread,
+             * dispatching notifications and indications or queuing replies into the bearer's ringbuffer.
+             * @param rxTimestamp the kernel receive timestamp in nanoseconds
+             * @param bearer the receiving EATT bearer, nullptr for the unenhanced ATT bearer
+             */
+            void processReceivedPDU(std::shared_ptr<PooledOctets> & rbuffer, const int len, const uint64_t rxTimestamp, EATTBearer * bearer);
+
+            /** Sends the given PDU via the given EATT bearer, or the unenhanced ATT bearer if nullptr. */
+            void send(const AttPDUMsg & msg, EATTBearer * bearer);
+
+            /** Sends the given PDU via the bearer selected by the current thread. */
+            void send(const AttPDUMsg & msg) { send(msg, getCurrentBearer()); }
+
+            /**
+             * Sends the given request via the bearer selected by the current thread and returns its reply.
+             * @param fixedTimeout the fixed reply timeout, which may be adapted to the measured RTT, see getReplyTimeout(..)
+             * @param adaptive if false, fixedTimeout is used as is and the RTT is not measured, e.g. for the initial MTU exchange
+             */
+            std::shared_ptr<const AttPDUMsg> sendWithReply(const AttPDUMsg & msg, const int fixedTimeout, const bool adaptive=true);
 
             /**
              * BT Core Spec v5.2: Vol 3, Part G GATT: 3.4.2 MTU Exchange
@@ -202,9 +762,120 @@ namespace direct_bt {
              */
             uint16_t exchangeMTU(const uint16_t clientMaxMTU);
 
+            /**
+             * Reads the device's Database Hash via a single ATT_READ_BY_TYPE_REQ over the whole handle range.
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 4.8.2 Read Using Characteristic UUID
+             * </p>
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 7.3 Database Hash
+             * </p>
+             * Returns false if the device does not expose a Database Hash, otherwise true.
+             */
+            bool readDatabaseHash(POctets & res);
+
+            /**
+             * Returns the device's Database Hash, read via readDatabaseHash(..) only once per connection.
+             * <p>
+             * Returns false if the device does not expose a Database Hash, otherwise true.
+             * </p>
+             */
+            bool getDatabaseHash(POctets & res);
+
+            /**
+             * Restores the internal service list from the GATTCache, if available and still valid.
+             * <p>
+             * Returns true if the cached services are in use, otherwise false.
+             * </p>
+             */
+            bool restoreCachedServices();
+
+            /**
+             * Stores the internal service list including the device's Database Hash within the GATTCache.
+             * <p>
+             * Reuses the Database Hash read by restoreCachedServices(), saving a round trip.
+             * </p>
+             */
+            void storeCachedServices();
+
+            /** Dispatches all tuples of the given PDU to the matching listener, locking mtx_eventListenerList. */
+            void dispatchMultipleNotification(const AttMultipleHandleValueNtf & a, OctetsPool & pool);
+
+            /**
+             * Writes this client's supported features to the server, if it exposes the Client Supported Features characteristic.
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 7.2 Client Supported Features
+             * </p>
+             */
+            bool writeClientSupportedFeatures(const uint8_t features);
+
+            /**
+             * Negotiates the optional GATT features after service discovery,
+             * i.e. writes the Client Supported Features and connects the EATT bearers if supported by the server.
+             * <p>
+             * The Client Supported Features are written once per connection.
+             * ROBUST_CACHING is set if the GATTCache is enabled,
+             * as the cached declarations rely on the server reporting database changes via the Database Hash.
+             * </p>
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 2.5.2.1 Robust Caching
+             * </p>
+             */
+            void configureFeatures();
+
+            /** Builds the handleTable from the current services, locking mtx_eventListenerList. */
+            void buildHandleTable();
+
+            /** Re-resolves the listener of all handleTable entries, locking mtx_eventListenerList. */
+            void updateHandleTableListener();
+
+            /** Clears the handleTable, locking mtx_eventListenerList. */
+            void clearHandleTable();
+
+            /** Sets serviceChangedChar from the current services if contained, locking mtx_eventListenerList. */
+            void updateServiceChangedCharacteristic();
+
+            /**
+             * Returns the Service Changed characteristic if the given handle is its value handle, otherwise nullptr,
+             * while holding mtx_eventListenerList.
+             */
+            GATTCharacteristicRef getServiceChangedCharacteristic(const uint16_t handle) const {
+                return nullptr != serviceChangedChar && handle == serviceChangedChar->value_handle ? serviceChangedChar : nullptr;
+            }
+
+            /** Returns the handleTable entry of the given handle or nullptr, while holding mtx_eventListenerList. */
+            std::shared_ptr<const HandleEntry> getHandleEntry(const uint16_t handle) const {
+                return handle < handleTable.size() ? handleTable[handle] : nullptr;
+            }
+
+            /** Queues the given value via ATT_PREPARE_WRITE_REQ, returns false on error or mismatching response. */
+            bool prepareWriteValue(const uint16_t handle, const TROOctets & value, const bool reliable);
+
+            /** Issues ATT_EXECUTE_WRITE_REQ to commit or cancel all prepared writes. */
+            bool executeWrite(const bool write);
+
+            /** readValue(..) continuing at the given value offset, e.g. after a truncated Read Multiple response. */
+            bool readValue(const uint16_t handle, POctets & res, int expectedLength, const int initialOffset);
+
+            /** Adds the given connected EATT bearer and starts its reader, returns false on failure. */
+            bool startEATTBearer(std::shared_ptr<EATTBearer> bearer);
+
         public:
             GATTHandler(const std::shared_ptr<DBTDevice> & device);
 
+            /**
+             * Constructs an instance adopting the given connected ATT socket without a DBTDevice,
+             * e.g. one end of a local socketpair for testing against a mock ATT server.
+             * <p>
+             * connect() starts reading and exchanges the MTU as usual, addEATTBearer(..) adopts further sockets as EATT bearers.
+             * The GATTCache, bulk transfers and the device disconnect are not applicable.
+             * </p>
+             * <p>
+             * Instances must be created as a std::shared_ptr.
+             * </p>
+             */
+            GATTHandler(const int attSocket, const std::string & deviceString);
+
             ~GATTHandler();
 
             bool getIsConnected() const { return isConnected; }
@@ -230,10 +901,126 @@ namespace direct_bt {
             uint16_t getServerMTU() const { return serverMTU; }
             uint16_t getUsedMTU()  const { return usedMTU; }
 
+            /**
+             * Returns a snapshot of this connection's round-trip time statistics,
+             * see GATTEnv::GATT_ADAPTIVE_COMMAND_REPLY_TIMEOUT.
+             */
+            GATTRTTStats getRTTStats() const;
+
+            /**
+             * Restarts the round-trip time estimation, see GATTRTTStats::restart().
+             * <p>
+             * Shall be called after the connection parameter have been changed,
+             * as the previously measured RTT no more reflects the connection interval and slave latency.
+             * </p>
+             */
+            void restartRTTStats();
+
+            /**
+             * Connects up to the given number of Enhanced ATT bearers, in addition to the unenhanced ATT bearer.
+             * <p>
+             * GATT requests issued concurrently from different threads are distributed
+             * across all bearers, see {@link GATTEnv::GATT_EATT_BEARER_COUNT}.
+             * </p>
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 5.3 Enhanced ATT bearer
+             * </p>
+             * @return the number of newly connected EATT bearers
+             */
+            int connectEATT(const int count);
+
+            /**
+             * Adds the given connected socket as an Enhanced ATT bearer, like connectEATT(..) without connecting,
+             * e.g. one end of a local socketpair for testing against a mock ATT server.
+             * @param socket the connected socket, closed by this instance
+             * @param mtu the bearer's ATT_MTU, at least 64
+             * @return true if added
+             */
+            bool addEATTBearer(const int socket, const uint16_t mtu);
+
+            /** Returns the number of connected Enhanced ATT bearers. */
+            int getEATTBearerCount();
+
+            /**
+             * Queues the given request PDU for asynchronous transmission on the unenhanced ATT bearer.
+             * <p>
+             * Requests are sent one at a time as required by ATT, the next queued request is sent
+             * by the l2cap reader thread as soon as the previous reply arrived, without thread hand-off.
+             * Blocking requests on the unenhanced ATT bearer are interleaved between asynchronous ones.
+             * </p>
+             * <p>
+             * The callback is invoked exactly once on the l2cap reader thread, passing the reply PDU,
+             * or nullptr on timeout or disconnect. Hence it must not block, nor issue blocking GATT requests;
+             * use further asynchronous requests for chaining.
+             * </p>
+             * <p>
+             * A timed out reply causes disconnect as for blocking requests.
+             * The timeout is detected by the l2cap reader thread, i.e. up to
+             * {@link GATTEnv::L2CAP_READER_THREAD_POLL_TIMEOUT} late if the request was queued while idle.
+             * </p>
+             * @param req the request PDU
+             * @param callback invoked with the reply PDU or nullptr
+             * @param timeout reply timeout in milliseconds
+             * @return true if queued, false if not connected
+             */
+            bool sendAsync(const std::shared_ptr<const AttPDUMsg> & req, const GATTReplyCallback & callback, const int timeout);
+
+            /**
+             * Asynchronously reads the complete value of the given handle,
+             * using ATT_READ_REQ and ATT_READ_BLOB_REQ for long values.
+             * <p>
+             * See sendAsync(..) for details.
+             * </p>
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 4.8.1 Read Characteristic Value
+             * </p>
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 4.8.3 Read Long Characteristic Value
+             * </p>
+             * @return true if queued, false if not connected
+             */
+            bool readValueAsync(const uint16_t handle, const GATTReadValueCallback & callback);
+
+            /**
+             * Asynchronously writes the given value to the given handle via ATT_WRITE_REQ.
+             * <p>
+             * The value must fit into a single PDU, i.e. ATT_MTU-3 bytes, see getUsedMTU().
+             * </p>
+             * <p>
+             * See sendAsync(..) for details.
+             * </p>
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 4.9.3 Write Characteristic Value
+             * </p>
+             * @return true if queued, false if not connected
+             */
+            bool writeValueAsync(const uint16_t handle, const TROOctets & value, const GATTWriteValueCallback & callback);
+
+            /**
+             * Writes the given values to the given handles via pipelined writeValueAsync(..) requests
+             * and blocks until all replies have been received.
+             * <p>
+             * Each subsequent request is sent by the l2cap reader thread immediately after the previous reply,
+             * avoiding a caller thread round trip per value.
+             * </p>
+             * <p>
+             * Shall not be called from a GATTCharacteristicListener or an asynchronous callback,
+             * as their l2cap reader thread would wait for itself.
+             * </p>
+             * @param handles the value handles to write
+             * @param values the values to write, one for each handle in same order, each fitting into a single PDU
+             * @param res resulting success state, one for each handle in same order
+             * @return true if all values have been written, otherwise false.
+             */
+            bool writeValuesPipelined(const std::vector<uint16_t> & handles, const std::vector<POctets> & values, std::vector<bool> & res);
+
             /**
              * Find and return the GATTCharacterisicsDecl within internal primary services
              * via given characteristic value handle.
              * <p>
+             * Uses the handle indexed attribute table if available, otherwise searches all services.
+             * </p>
+             * <p>
              * Returns nullptr if not found.
              * </p>
              */
@@ -263,10 +1050,49 @@ namespace direct_bt {
              * <p>
              * BT Core Spec v5.2: Vol 3, Part G GATT: 4.4.1 Discover All Primary Services
              * </p>
+             * <p>
+             * If the GATTCache holds an entry for this device with a matching Database Hash,
+             * the cached declarations are used and no discovery is performed.
+             * Otherwise the discovery result is stored in the GATTCache, see {@link GATTCacheEnv}.
+             * </p>
              * Method returns reference to GATTHandler internal data.
              */
             std::vector<GATTServiceRef> & discoverCompletePrimaryServices();
 
+            /**
+             * Discover all primary services matching the given service UUIDs _and_ all their characteristics declarations
+             * including their client config.
+             * <p>
+             * Only the given services will be kept and their characteristics and descriptors discovered,
+             * saving the round trips for unused services. An empty list selects all services.
+             * </p>
+             * <p>
+             * A selective result is not stored within the GATTCache.
+             * </p>
+             * Method returns reference to GATTHandler internal data.
+             */
+            std::vector<GATTServiceRef> & discoverCompletePrimaryServices(const std::vector<std::shared_ptr<const uuid_t>> & serviceFilter);
+
+            /**
+             * Discover all primary services matching the given service UUIDs _and_ their characteristics matching the given
+             * characteristic UUIDs including their client config.
+             * <p>
+             * Only the given services will be kept and their characteristics discovered.
+             * Of those, only the given characteristics will be kept and their descriptors discovered,
+             * saving the descriptor value reads for unused characteristics. An empty list selects all services or characteristics respectively.
+             * </p>
+             * <p>
+             * All characteristic declarations of the selected services are still enumerated,
+             * as their handles are required to delimit the descriptors of the selected characteristics.
+             * </p>
+             * <p>
+             * A selective result is not stored within the GATTCache.
+             * </p>
+             * Method returns reference to GATTHandler internal data.
+             */
+            std::vector<GATTServiceRef> & discoverCompletePrimaryServices(const std::vector<std::shared_ptr<const uuid_t>> & serviceFilter,
+                                                                           const std::vector<std::shared_ptr<const uuid_t>> & characteristicFilter);
+
             /**
              * Returns a reference of the internal kept GATTService list.
              * <p>
@@ -275,6 +1101,19 @@ namespace direct_bt {
              */
             std::vector<GATTServiceRef> & getServices() { return services; }
 
+            /**
+             * Returns true if a Service Changed indication has been received since the last discovery,
+             * i.e. the list returned by getServices() is stale and shall be rediscovered.
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 7.1 Service Changed
+             * </p>
+             * <p>
+             * Until then, notifications and indications are not delivered, except the Service Changed indication itself.
+             * DBTDevice::getGATTServices() rediscovers the services if changed.
+             * </p>
+             */
+            bool isServicesChanged() const { return servicesChanged; }
+
             /**
              * Discover all primary services _only_.
              * <p>
@@ -294,11 +1133,54 @@ namespace direct_bt {
              */
             bool discoverCharacteristics(GATTServiceRef & service);
 
+            /**
+             * Discover all characteristics of the given services, sorted by handle, in batches.
+             * <p>
+             * Consecutive services are covered by large range ATT_READ_BY_TYPE_REQ over their complete handle range,
+             * assigning each discovered characteristic to its service.
+             * </p>
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 4.6.1 Discover All Characteristics of a Service
+             * </p>
+             */
+            bool discoverCharacteristics(std::vector<GATTServiceRef> & services);
+
             /**
              * BT Core Spec v5.2: Vol 3, Part G GATT: 4.7.1 Discover All Characteristic Descriptors
              */
             bool discoverDescriptors(GATTServiceRef & service);
 
+            /**
+             * Discover the characteristic descriptors of the given service's characteristics matching the given UUIDs,
+             * an empty filter selects all characteristics.
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 4.7.1 Discover All Characteristic Descriptors
+             * </p>
+             */
+            bool discoverDescriptors(GATTServiceRef & service, const std::vector<std::shared_ptr<const uuid_t>> & characteristicFilter);
+
+            /**
+             * Discover all characteristic descriptors of the given services, sorted by handle, in batches.
+             * <p>
+             * Consecutive services are covered by large range ATT_FIND_INFORMATION_REQ over their complete handle range,
+             * assigning each discovered descriptor to its characteristic.
+             * </p>
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 4.7.1 Discover All Characteristic Descriptors
+             * </p>
+             */
+            bool discoverDescriptors(std::vector<GATTServiceRef> & services);
+
+            /**
+             * Discover the characteristic descriptors of the given services' characteristics matching the given UUIDs in batches,
+             * an empty filter selects all characteristics.
+             * <p>
+             * Runs of consecutive services without a selected characteristic are skipped,
+             * as are the descriptors of unselected characteristics within the covered handle range.
+             * </p>
+             */
+            bool discoverDescriptors(std::vector<GATTServiceRef> & services, const std::vector<std::shared_ptr<const uuid_t>> & characteristicFilter);
+
             /**
              * Generic read GATT value and long value
              * <p>
@@ -334,6 +1216,49 @@ namespace direct_bt {
              */
             bool readCharacteristicValue(const GATTCharacteristic & c, POctets & res, int expectedLength=-1);
 
+            /**
+             * Generic read of multiple GATT values and long values with as few requests as possible.
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 4.8.5 Read Multiple Variable Length Characteristic Values
+             * </p>
+             * <p>
+             * The handles are packed into as few ATT_READ_MULTIPLE_VARIABLE_REQ as the used MTU allows.
+             * Values truncated in the response are completed via ATT_READ_BLOB_REQ.
+             * </p>
+             * <p>
+             * If the server does not support ATT_READ_MULTIPLE_VARIABLE_REQ
+             * or reports an error for a set of handles, their values are read one by one
+             * via readValue(const uint16_t, POctets &, int).
+             * </p>
+             * @param handles the value handles to read
+             * @param res resulting values, one for each given handle in same order. A failed read leaves its value empty.
+             * @return true if all values have been read, otherwise false.
+             */
+            bool readValues(const std::vector<uint16_t> & handles, std::vector<POctets> & res);
+
+            /**
+             * Generic read of multiple GATT values of known fixed size with as few requests as possible.
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 4.8.4 Read Multiple Characteristic Values
+             * </p>
+             * <p>
+             * The handles are packed into as few ATT_READ_MULTIPLE_REQ as the used MTU allows,
+             * i.e. the summed value sizes of one request shall not exceed (ATT_MTU - 1).
+             * Values too large for a batch are read one by one.
+             * </p>
+             * @param handles the value handles to read
+             * @param valueSizes the known value size of each handle in same order
+             * @param res resulting values, one for each given handle in same order. A failed read leaves its value empty.
+             * @return true if all values have been read, otherwise false.
+             */
+            bool readValues(const std::vector<uint16_t> & handles, const std::vector<int> & valueSizes, std::vector<POctets> & res);
+
+            /**
+             * Reads the values of all given characteristics with as few requests as possible,
+             * see readValues(const std::vector<uint16_t> &, std::vector<POctets> &).
+             */
+            bool readCharacteristicValues(const std::vector<GATTCharacteristicRef> & characteristics, std::vector<POctets> & res);
+
             /**
              * BT Core Spec v5.2: Vol 3, Part G GATT: 4.12.1 Read Characteristic Descriptor
              * <p>
@@ -355,9 +1280,56 @@ namespace direct_bt {
 
             /**
              * Generic write GATT value and long value
+             * <p>
+             * A value with response exceeding (ATT_MTU - 3) is written as a long value,
+             * see writeLongValue(const uint16_t, const TROOctets &, const bool).
+             * </p>
              */
             bool writeValue(const uint16_t handle, const TROOctets & value, const bool withResponse);
 
+            /**
+             * Write a long GATT value via a sequence of ATT_PREPARE_WRITE_REQ, committed by one ATT_EXECUTE_WRITE_REQ.
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 4.9.4 Write Long Characteristic Values
+             * </p>
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 4.9.5 Reliable Writes
+             * </p>
+             * <p>
+             * Each ATT_PREPARE_WRITE_RSP's handle and value offset is verified.
+             * In reliable mode, the echoed value is verified as well.
+             * On any mismatch or error, all prepared writes are cancelled.
+             * </p>
+             * @param handle the value handle
+             * @param value the value to write
+             * @param reliable if true, verify each echoed value part
+             * @return true if the value has been written, otherwise false.
+             */
+            bool writeLongValue(const uint16_t handle, const TROOctets & value, const bool reliable);
+
+            /**
+             * Atomically write multiple GATT values, i.e. all or none of them will be written.
+             * <p>
+             * All values are queued on the server via ATT_PREPARE_WRITE_REQ
+             * and committed together by one ATT_EXECUTE_WRITE_REQ,
+             * see writeLongValue(const uint16_t, const TROOctets &, const bool).
+             * </p>
+             * <p>
+             * The server's prepare queue is limited, it may reject the request with a Prepare Queue Full error.
+             * </p>
+             * @param handles the value handles to write
+             * @param values the values to write, one for each given handle in same order
+             * @param reliable if true, verify each echoed value part
+             * @return true if all values have been written, otherwise false and none has been written.
+             */
+            bool writeValues(const std::vector<uint16_t> & handles, const std::vector<POctets> & values, const bool reliable);
+
+            /**
+             * Atomically write the values of all given characteristics,
+             * see writeValues(const std::vector<uint16_t> &, const std::vector<POctets> &, const bool).
+             */
+            bool writeCharacteristicValues(const std::vector<GATTCharacteristicRef> & characteristics, const std::vector<POctets> & values, const bool reliable);
+
             /**
              * BT Core Spec v5.2: Vol 3, Part G GATT: 4.12.3 Write Characteristic Descriptors
              * <p>
@@ -379,6 +1351,33 @@ namespace direct_bt {
              */
             bool writeCharacteristicValueNoResp(const GATTCharacteristic & c, const TROOctets & value);
 
+            /**
+             * Streams the given data to the given value handle as a sequence of ATT_WRITE_CMD packets,
+             * each carrying up to (ATT_MTU - 3) bytes.
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part G GATT: 4.9.1 Write Characteristic Value Without Response
+             * </p>
+             * <p>
+             * Packets are sent back to back without any round trip.
+             * Backpressure is applied by waiting for the L2CAP socket's send queue to drain,
+             * whenever its free space falls below one packet.
+             * </p>
+             * <p>
+             * Concurrent streams are serialized, while other requests may be interleaved.
+             * </p>
+             * @param handle the value handle
+             * @param data the data to stream
+             * @param stats resulting transfer statistics
+             * @return true if all data has been sent, otherwise false.
+             */
+            bool writeValueStream(const uint16_t handle, const TROOctets & data, GATTWriteStreamStats & stats);
+
+            /**
+             * Streams the given data to the given characteristic,
+             * see writeValueStream(const uint16_t, const TROOctets &, GATTWriteStreamStats &).
+             */
+            bool writeCharacteristicValueStream(const GATTCharacteristic & c, const TROOctets & data, GATTWriteStreamStats & stats);
+
             /**
              * BT Core Spec v5.2: Vol 3, Part G GATT: 3.3.3.3 Client Characteristic Configuration
              * <p>
@@ -0,0 +1,238 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2020 Gothel Software e.K.
+ * Copyright (c) 2020 ZAFENA AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef GATT_LISTENER_QUEUE_HPP_
+#define GATT_LISTENER_QUEUE_HPP_
+
+#include <cstring>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <functional>
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+
+#include "DBTEnv.hpp"
+#include "OctetTypes.hpp"
+#include "GATTCharacteristic.hpp"
+
+/**
+ * - - - - - - - - - - - - - - -
+ *
+ * Module GATTListenerQueue:
+ *
+ * - Asynchronous delivery of GATT notifications and indications,
+ *   decoupling slow GATTCharacteristicListener from the GATTHandler's l2cap reader thread.
+ */
+namespace direct_bt {
+
+    /**
+     * Shared executor running the queued listener's delivery,
+     * using a fixed number of worker threads.
+     * <p>
+     * Environment variable 'direct_bt.gatt.executor.threads' defines the number of threads, defaults to 2.
+     * </p>
+     */
+    class GATTListenerExecutor {
+        private:
+            std::vector<std::thread> threads;
+            std::deque<std::function<void()>> tasks;
+            std::mutex mtx_tasks;
+            std::condition_variable cv_tasks;
+            bool shallStop;
+
+            GATTListenerExecutor(const GATTListenerExecutor&) = delete;
+            void operator=(const GATTListenerExecutor&) = delete;
+
+            void workerThreadImpl();
+
+        public:
+            /**
+             * Creates a dedicated executor, usually the shared instance via get() shall be used.
+             * @param threadCount number of worker threads, at least one
+             */
+            GATTListenerExecutor(const int threadCount);
+
+            static GATTListenerExecutor& get() {
+                /**
+                 * Thread safe starting with C++11 6.7:
+                 *
+                 * If control enters the declaration concurrently while the variable is being initialized,
+                 * the concurrent execution shall wait for completion of the initialization.
+                 *
+                 * (Magic Statics)
+                 *
+                 * Avoiding non-working double checked locking.
+                 */
+                static GATTListenerExecutor e( DBTEnv::getInt32Property("direct_bt.gatt.executor.threads", 2, 1 /* min */, 64 /* max */) );
+                return e;
+            }
+
+            /** Stops and joins all worker threads, dropping pending tasks. */
+            ~GATTListenerExecutor();
+
+            int getThreadCount() const { return threads.size(); }
+
+            /** Queues the given task for execution by one of the worker threads. */
+            void execute(std::function<void()> task);
+    };
+
+    /**
+     * A GATTCharacteristicListener decorator, delivering events to its delegate
+     * via a bounded queue on the shared GATTListenerExecutor.
+     * <p>
+     * The GATTHandler's l2cap reader thread merely enqueues an event,
+     * hence a slow delegate no more delays reading of subsequent PDUs,
+     * including replies awaited by GATT requests.
+     * </p>
+     * <p>
+     * Events are delivered in received order by at most one executor thread at a time.
+     * If the queue is full, events are dropped or coalesced according to the QueuePolicy.
+     * </p>
+     * <p>
+     * After removal from the GATTHandler, the queue shall be cancelled via cancel()
+     * to release pending events and references, as it may hold the delegate busy on an executor thread otherwise.
+     * </p>
+     * <p>
+     * Instances must be created as a std::shared_ptr.
+     * </p>
+     */
+    class QueuedGATTCharacteristicListener : public GATTCharacteristicListener,
+                                             public std::enable_shared_from_this<QueuedGATTCharacteristicListener> {
+        public:
+            enum class QueuePolicy : int {
+                /** Drop the oldest queued event if full. */
+                DROP_OLDEST = 0,
+                /** Drop the new event if full. */
+                DROP_NEWEST = 1,
+                /**
+                 * Replace a queued event of the same characteristic with the new one, keeping its queue position.
+                 * Otherwise drop the oldest queued event if full.
+                 */
+                KEEP_LATEST = 2
+            };
+
+        private:
+            class Event {
+                public:
+                    GATTCharacteristicRef charDecl;
+                    std::shared_ptr<TROOctets> charValue;
+                    uint64_t timestamp;
+                    uint64_t rxTimestamp;
+                    bool indication;
+                    bool confirmationSent;
+
+                    Event(const GATTCharacteristicRef & c, const std::shared_ptr<TROOctets> & v, const uint64_t ts,
+                          const uint64_t rxTs, const bool ind, const bool cfm)
+                    : charDecl(c), charValue(v), timestamp(ts), rxTimestamp(rxTs), indication(ind), confirmationSent(cfm) {}
+            };
+
+            const std::shared_ptr<GATTCharacteristicListener> delegate;
+            const int capacity;
+            const QueuePolicy policy;
+            GATTListenerExecutor & executor;
+
+            std::deque<Event> queue;
+            std::mutex mtx_queue;
+            std::condition_variable cv_queue;
+            /** True while a delivery task is pending or running, guarded by mtx_queue */
+            bool scheduled;
+            /** True if cancelled, guarded by mtx_queue */
+            bool cancelled;
+
+            std::atomic<int> droppedCount;
+            std::atomic<int> coalescedCount;
+
+            void enqueue(Event && e);
+            void deliver();
+
+        public:
+            /**
+             * @param delegate the listener receiving all events asynchronously
+             * @param capacity maximum number of queued events
+             * @param policy the policy to apply if the queue is full
+             * @param executor the executor delivering the events
+             */
+            QueuedGATTCharacteristicListener(const std::shared_ptr<GATTCharacteristicListener> & delegate,
+                                             const int capacity, const QueuePolicy policy,
+                                             GATTListenerExecutor & executor=GATTListenerExecutor::get());
+
+            std::shared_ptr<GATTCharacteristicListener> getDelegate() const { return delegate; }
+
+            /** Returns the number of currently queued events. */
+            int getQueueSize();
+
+            /** Returns the number of dropped events. */
+            int getDroppedCount() const { return droppedCount; }
+
+            /** Returns the number of events replaced by a newer one, see QueuePolicy::KEEP_LATEST. */
+            int getCoalescedCount() const { return coalescedCount; }
+
+            /**
+             * Waits until all queued events have been delivered.
+             * @param timeoutMS maximum time to wait in milliseconds, 0 for infinite
+             * @return true if all events have been delivered, false on timeout
+             */
+            bool waitUntilDelivered(const int timeoutMS);
+
+            /**
+             * Drops all queued events and all events received hereafter.
+             * <p>
+             * An event currently being delivered completes.
+             * </p>
+             * @return the number of dropped queued events, also added to getDroppedCount()
+             */
+            int cancel();
+
+            bool isCancelled();
+
+            bool match(const GATTCharacteristic & characteristic) override {
+                return delegate->match(characteristic);
+            }
+
+            void notificationReceived(GATTCharacteristicRef charDecl,
+                                      std::shared_ptr<TROOctets> charValue, const uint64_t timestamp) override;
+
+            void indicationReceived(GATTCharacteristicRef charDecl,
+                                    std::shared_ptr<TROOctets> charValue, const uint64_t timestamp,
+                                    const bool confirmationSent) override;
+
+            void notificationReceived(GATTCharacteristicRef charDecl,
+                                      std::shared_ptr<TROOctets> charValue, const uint64_t timestamp,
+                                      const uint64_t rxTimestamp) override;
+
+            void indicationReceived(GATTCharacteristicRef charDecl,
+                                    std::shared_ptr<TROOctets> charValue, const uint64_t timestamp,
+                                    const bool confirmationSent, const uint64_t rxTimestamp) override;
+    };
+
+} // namespace direct_bt
+
+#endif /* GATT_LISTENER_QUEUE_HPP_ */
@@ -75,6 +75,13 @@ namespace direct_bt {
         CHARACTERISTIC_PERIPHERAL_PREF_CONN         = 0x2A04,
         CHARACTERISTIC_SERVICE_CHANGED              = 0x2A05,
 
+        /* BT Core Spec v5.2: Vol 3, Part G GATT: 7.2 Client Supported Features */
+        CHARACTERISTIC_CLIENT_SUPPORTED_FEATURES    = 0x2B29,
+        /* BT Core Spec v5.2: Vol 3, Part G GATT: 7.3 Database Hash */
+        CHARACTERISTIC_DATABASE_HASH                = 0x2B2A,
+        /* BT Core Spec v5.2: Vol 3, Part G GATT: 7.4 Server Supported Features */
+        CHARACTERISTIC_SERVER_SUPPORTED_FEATURES    = 0x2B3A,
+
         /* BT Core Spec v5.2: Vol 3, Part G GATT: 3.3.3.1 Characteristic Extended Properties */
         CHARACTERISTIC_EXTENDED_PROPERTIES          = 0x2900,
         /* BT Core Spec v5.2: Vol 3, Part G GATT: 3.3.3.2 Characteristic User Description (Characteristic Descriptor, optional, single, string) */
@@ -89,6 +96,30 @@ namespace direct_bt {
 
     };
 
+    /**
+     * Client Supported Features bits, written to the server's
+     * {@link GattAttributeType::CHARACTERISTIC_CLIENT_SUPPORTED_FEATURES} characteristic.
+     * <p>
+     * BT Core Spec v5.2: Vol 3, Part G GATT: 7.2 Client Supported Features
+     * </p>
+     */
+    enum GattClientSupportedFeatures : uint8_t {
+        ROBUST_CACHING                  = 0x01,
+        ENHANCED_ATT_BEARER             = 0x02,
+        MULTIPLE_HANDLE_VALUE_NTF       = 0x04
+    };
+
+    /**
+     * Server Supported Features bits, read from the server's
+     * {@link GattAttributeType::CHARACTERISTIC_SERVER_SUPPORTED_FEATURES} characteristic.
+     * <p>
+     * BT Core Spec v5.2: Vol 3, Part G GATT: 7.4 Server Supported Features
+     * </p>
+     */
+    enum GattServerSupportedFeatures : uint8_t {
+        EATT_SUPPORTED                  = 0x01
+    };
+
 } // namespace direct_bt
 
 #endif /* GATT_TYPES_HPP_ */
@@ -58,22 +58,37 @@ namespace direct_bt {
             const uint16_t dev_id;
             const uint16_t channel;
             int _dd; // the hci socket
+            int _efd; // eventfd waking up a pending read on close
+            int _ifd; // eventfd interrupting a pending read
 
         public:
             /** Constructing a new HCI communication channel instance */
-            HCIComm(const uint16_t dev_id, const uint16_t channel)
-            : dev_id(dev_id), channel(channel), _dd(-1) {
-                _dd = hci_open_dev(dev_id, channel);
-            }
+            HCIComm(const uint16_t dev_id, const uint16_t channel);
 
             /**
              * Releases this instance after issuing {@link #close()}.
              */
-            ~HCIComm() { close(); }
+            ~HCIComm();
+
+            HCIComm(const HCIComm&) = delete;
+            void operator=(const HCIComm&) = delete;
 
-            /** Closing the HCI channel, locking {@link #mutex_write()}. */
+            /**
+             * Closing the HCI channel, locking {@link #mutex_write()}.
+             * <p>
+             * A pending {@link #read(uint8_t*, const int, const int32_t)} of another thread is woken up
+             * before acquiring the lock and fails with errno ECANCELED,
+             * allowing its reader thread to stop without awaiting its poll timeout.
+             * </p>
+             */
             void close();
 
+            /**
+             * Interrupts a pending or the next {@link #read(uint8_t*, const int, const int32_t)} of another thread,
+             * which fails with errno EINTR, e.g. to let the reader shorten its poll timeout.
+             */
+            void interrupt();
+
             bool isOpen() const { return 0 <= _dd; }
 
             /** Return this HCI device descriptor, for multithreading access use {@link #dd()}. */
@@ -82,8 +97,18 @@ namespace direct_bt {
             /** Return the recursive write mutex for multithreading access. */
             std::recursive_mutex & mutex_write() { return mtx_write; }
 
+            /**
+             * Generic read w/ own timeoutMS, w/o locking suitable for a unique ringbuffer sink.
+             * @param rxTimestamp set to the kernel receive timestamp in nanoseconds, see getWallClockNanoseconds(),
+             *        or the current wall-clock time if not supported by the kernel
+             */
+            int read(uint8_t* buffer, const int capacity, const int32_t timeoutMS, uint64_t & rxTimestamp);
+
             /** Generic read w/ own timeoutMS, w/o locking suitable for a unique ringbuffer sink. */
-            int read(uint8_t* buffer, const int capacity, const int32_t timeoutMS);
+            int read(uint8_t* buffer, const int capacity, const int32_t timeoutMS) {
+                uint64_t rxTimestamp;
+                return read(buffer, capacity, timeoutMS, rxTimestamp);
+            }
 
             /** Generic write, locking {@link #mutex_write()}. */
             int write(const uint8_t* buffer, const int size);
@@ -59,10 +59,19 @@ namespace direct_bt {
             EUI48 address; // immutable
             BDAddressType addressType; // immutable
             uint16_t handle; // mutable
+            uint16_t txOctets; // mutable, LE data length
+            uint16_t rxOctets; // mutable, LE data length
+            LE_PHYs txPhy; // mutable
+            LE_PHYs rxPhy; // mutable
+            uint16_t connInterval; // mutable
+            uint16_t connLatency; // mutable
+            uint16_t supervisionTimeout; // mutable
 
         public:
             HCIConnection(const EUI48 &address, const BDAddressType addressType, const uint16_t handle)
-            : address(address), addressType(addressType), handle(handle) {}
+            : address(address), addressType(addressType), handle(handle),
+              txOctets(0), rxOctets(0), txPhy(LE_PHYs::NONE), rxPhy(LE_PHYs::NONE),
+              connInterval(0), connLatency(0), supervisionTimeout(0) {}
 
             HCIConnection(const HCIConnection &o) = default;
             HCIConnection(HCIConnection &&o) = default;
@@ -75,6 +84,28 @@ namespace direct_bt {
 
             void setHandle(uint16_t newHandle) { handle = newHandle; }
 
+            /** Returns the negotiated maximum LE transmit payload octets, zero if not yet reported. */
+            uint16_t getTxOctets() const { return txOctets; }
+            /** Returns the negotiated maximum LE receive payload octets, zero if not yet reported. */
+            uint16_t getRxOctets() const { return rxOctets; }
+            void setDataLength(const uint16_t tx, const uint16_t rx) { txOctets = tx; rxOctets = rx; }
+
+            /** Returns the current LE transmitter PHY, LE_PHYs::NONE if not yet reported. */
+            LE_PHYs getTxPhy() const { return txPhy; }
+            /** Returns the current LE receiver PHY, LE_PHYs::NONE if not yet reported. */
+            LE_PHYs getRxPhy() const { return rxPhy; }
+            void setPhy(const LE_PHYs tx, const LE_PHYs rx) { txPhy = tx; rxPhy = rx; }
+
+            /** Returns the current LE connection interval in units of 1.25ms, zero if not yet reported. */
+            uint16_t getConnInterval() const { return connInterval; }
+            /** Returns the current LE slave latency in units of connection events. */
+            uint16_t getConnLatency() const { return connLatency; }
+            /** Returns the current LE supervision timeout in units of 10ms, zero if not yet reported. */
+            uint16_t getSupervisionTimeout() const { return supervisionTimeout; }
+            void setConnParam(const uint16_t interval, const uint16_t latency, const uint16_t timeout) {
+                connInterval = interval; connLatency = latency; supervisionTimeout = timeout;
+            }
+
             bool equals(const EUI48 & otherAddress, const BDAddressType otherAddressType) const
             { return address == otherAddress && addressType == otherAddressType; }
 
@@ -86,7 +117,11 @@ namespace direct_bt {
 
             std::string toString() const {
                 return "HCIConnection[handle "+uint16HexString(handle)+
-                       ", address="+address.toString()+", addressType "+getBDAddressTypeString(addressType)+"]";
+                       ", address="+address.toString()+", addressType "+getBDAddressTypeString(addressType)+
+                       ", octets[tx "+std::to_string(txOctets)+", rx "+std::to_string(rxOctets)+
+                       "], phy[tx "+getLE_PHYsString(txPhy)+", rx "+getLE_PHYsString(rxPhy)+
+                       "], param[interval "+std::to_string(connInterval)+", latency "+std::to_string(connLatency)+
+                       ", timeout "+std::to_string(supervisionTimeout)+"]]";
             }
     };
     typedef std::shared_ptr<HCIConnection> HCIConnectionRef;
@@ -149,6 +184,19 @@ namespace direct_bt {
              */
             const bool DEBUG_EVENT;
 
+            /**
+             * Negotiate LE Data Length Extension and the LE 2M PHY after connecting,
+             * if supported by the local controller, defaults to true.
+             * <p>
+             * The peer's link layer settles on the best common parameter,
+             * legacy peers simply keep the 27 octets payload and the LE 1M PHY.
+             * </p>
+             * <p>
+             * Environment variable is 'direct_bt.hci.le.link.negotiate'.
+             * </p>
+             */
+            const bool HCI_LE_LINK_NEGOTIATE;
+
         private:
             /** Maximum number of packets to wait for until matching a sequential command. Won't block as timeout will limit. */
             const int32_t HCI_READ_PACKET_MAX_RETRY;
@@ -222,6 +270,11 @@ namespace direct_bt {
             std::condition_variable cv_hciReaderInit;
             std::recursive_mutex mtx_sendReply; // for sendWith*Reply, process*Command, ..
 
+            /** Local LE features as read at construction. */
+            LE_Features leFeatures;
+            /** Local maximum supported LE data length, zero if LE Data Length Extension is not supported. */
+            uint16_t leMaxTxOctets, leMaxTxTime;
+
             std::vector<HCIConnectionRef> connectionList;
             std::recursive_mutex mtx_connectionList;
             /**
@@ -377,6 +430,99 @@ namespace direct_bt {
                                      const uint16_t conn_handle, const EUI48 &peer_bdaddr, const BDAddressType peer_mac_type,
                                      const HCIStatusCode reason=HCIStatusCode::REMOTE_USER_TERMINATED_CONNECTION);
 
+            /**
+             * Changes the connection parameter of the given established LE connection.
+             * <p>
+             * BT Core Spec v5.2: Vol 4, Part E HCI: 7.8.18 LE Connection Update command
+             * </p>
+             * <p>
+             * Completion is reported via HCIMetaEventType::LE_CONN_UPDATE_COMPLETE,
+             * updating the tracked HCIConnection, see getTrackedConnection(..).
+             * </p>
+             * @param conn_handle the connection handle
+             * @param conn_interval_min in units of 1.25ms, min value 6 for 7.5ms -> 3200 for 4s
+             * @param conn_interval_max in units of 1.25ms, min value 6 for 7.5ms -> 3200 for 4s
+             * @param conn_latency slave latency in units of connection events
+             * @param supervision_timeout in units of 10ms
+             * @return HCIStatusCode::SUCCESS if the command has been accepted
+             */
+            HCIStatusCode le_conn_update(const uint16_t conn_handle,
+                                         const uint16_t conn_interval_min, const uint16_t conn_interval_max,
+                                         const uint16_t conn_latency, const uint16_t supervision_timeout);
+
+            /**
+             * Returns the local LE features, as read at construction.
+             * <p>
+             * BT Core Spec v5.2: Vol 4, Part E HCI: 7.8.3 LE Read Local Supported Features command
+             * </p>
+             */
+            LE_Features getLEFeatures() const { return leFeatures; }
+
+            /**
+             * Returns the local maximum supported LE transmit payload octets,
+             * zero if LE Data Length Extension is not supported.
+             * <p>
+             * BT Core Spec v5.2: Vol 4, Part E HCI: 7.8.46 LE Read Maximum Data Length command
+             * </p>
+             */
+            uint16_t getLEMaxTxOctets() const { return leMaxTxOctets; }
+
+            /** Returns the local maximum supported LE transmit time in microseconds, see getLEMaxTxOctets(). */
+            uint16_t getLEMaxTxTime() const { return leMaxTxTime; }
+
+            /**
+             * Suggests the maximum LE transmit payload octets and time for the given connection.
+             * <p>
+             * BT Core Spec v5.2: Vol 4, Part E HCI: 7.8.33 LE Set Data Length command
+             * </p>
+             * <p>
+             * Completion is reported via HCIMetaEventType::LE_DATA_LENGTH_CHANGE,
+             * if the negotiated data length has changed.
+             * </p>
+             * @param conn_handle the connection handle
+             * @param tx_octets maximum transmit payload octets, 27 - 251
+             * @param tx_time maximum transmit time in microseconds, 328 - 17040
+             */
+            HCIStatusCode le_set_data_len(const uint16_t conn_handle, const uint16_t tx_octets, const uint16_t tx_time);
+
+            /**
+             * Sets the preferred LE PHYs for all subsequent connections.
+             * <p>
+             * BT Core Spec v5.2: Vol 4, Part E HCI: 7.8.48 LE Set Default PHY command
+             * </p>
+             * @param tx_phys preferred transmitter PHYs, LE_PHYs::NONE for no preference
+             * @param rx_phys preferred receiver PHYs, LE_PHYs::NONE for no preference
+             */
+            HCIStatusCode le_set_default_phy(const LE_PHYs tx_phys, const LE_PHYs rx_phys);
+
+            /**
+             * Requests the given preferred LE PHYs for the given connection.
+             * <p>
+             * BT Core Spec v5.2: Vol 4, Part E HCI: 7.8.49 LE Set PHY command
+             * </p>
+             * <p>
+             * Completion is reported via HCIMetaEventType::LE_PHY_UPDATE_COMPLETE.
+             * </p>
+             * @param conn_handle the connection handle
+             * @param tx_phys preferred transmitter PHYs, LE_PHYs::NONE for no preference
+             * @param rx_phys preferred receiver PHYs, LE_PHYs::NONE for no preference
+             */
+            HCIStatusCode le_set_phy(const uint16_t conn_handle, const LE_PHYs tx_phys, const LE_PHYs rx_phys);
+
+            /**
+             * Reads the current LE PHYs of the given connection.
+             * <p>
+             * BT Core Spec v5.2: Vol 4, Part E HCI: 7.8.47 LE Read PHY command
+             * </p>
+             */
+            HCIStatusCode le_read_phy(const uint16_t conn_handle, LE_PHYs & resTx, LE_PHYs & resRx);
+
+            /**
+             * Returns a copy of the tracked connection of the given handle, including its
+             * negotiated LE data length and PHYs, or nullptr if not tracked.
+             */
+            std::shared_ptr<HCIConnection> getTrackedConnection(const uint16_t conn_handle);
+
             /** MgmtEventCallback handling  */
 
             /**
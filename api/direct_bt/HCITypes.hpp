@@ -338,7 +338,12 @@ namespace direct_bt {
         LE_DEL_FROM_WHITE_LIST      = 0x2012,
         LE_CONN_UPDATE              = 0x2013,
         LE_READ_REMOTE_FEATURES     = 0x2016,
-        LE_START_ENC                = 0x2019
+        LE_START_ENC                = 0x2019,
+        LE_SET_DATA_LEN             = 0x2022,
+        LE_READ_MAX_DATA_LEN        = 0x202f,
+        LE_READ_PHY                 = 0x2030,
+        LE_SET_DEFAULT_PHY          = 0x2031,
+        LE_SET_PHY                  = 0x2032
         // etc etc - incomplete
     };
     inline uint16_t number(const HCIOpcode rhs) {
@@ -372,13 +377,110 @@ namespace direct_bt {
         LE_DEL_FROM_WHITE_LIST      = 36,
         LE_CONN_UPDATE              = 37,
         LE_READ_REMOTE_FEATURES     = 38,
-        LE_START_ENC                = 39
+        LE_START_ENC                = 39,
+        LE_SET_DATA_LEN             = 40,
+        LE_READ_MAX_DATA_LEN        = 41,
+        LE_READ_PHY                 = 42,
+        LE_SET_DEFAULT_PHY          = 43,
+        LE_SET_PHY                  = 44
         // etc etc - incomplete
     };
     inline uint8_t number(const HCIOpcodeBit rhs) {
         return static_cast<uint8_t>(rhs);
     }
 
+    /**
+     * LE Link Layer feature bits, as reported by the controller.
+     * <p>
+     * BT Core Spec v5.2: Vol 6, Part B LL: 4.6 Feature support
+     * </p>
+     */
+    enum class LE_Features : uint64_t {
+        NONE                        = 0,
+        LE_ENCRYPTION               = 1ULL << 0,
+        CONN_PARAM_REQ_PROC         = 1ULL << 1,
+        EXT_REJECT_IND              = 1ULL << 2,
+        SLAVE_FEAT_EXCHANGE         = 1ULL << 3,
+        LE_PING                     = 1ULL << 4,
+        LE_DATA_PACKET_LENGTH_EXT   = 1ULL << 5,
+        LL_PRIVACY                  = 1ULL << 6,
+        EXT_SCANNER_FILTER_POLICIES = 1ULL << 7,
+        LE_2M_PHY                   = 1ULL << 8,
+        LE_CODED_PHY                = 1ULL << 11
+    };
+    inline uint64_t number(const LE_Features rhs) {
+        return static_cast<uint64_t>(rhs);
+    }
+    inline bool isLEFeaturesBitSet(const LE_Features mask, const LE_Features bit) {
+        return 0 != ( static_cast<uint64_t>(mask) & static_cast<uint64_t>(bit) );
+    }
+
+    /**
+     * LE Transmitter and Receiver PHY bit mask.
+     * <p>
+     * BT Core Spec v5.2: Vol 4, Part E HCI: 7.8.48 LE Set Default PHY command
+     * </p>
+     * <p>
+     * BT Core Spec v5.2: Vol 4, Part E HCI: 7.8.49 LE Set PHY command
+     * </p>
+     */
+    enum class LE_PHYs : uint8_t {
+        NONE                        = 0,
+        LE_1M                       = 0x01,
+        LE_2M                       = 0x02,
+        LE_CODED                    = 0x04
+    };
+    inline uint8_t number(const LE_PHYs rhs) {
+        return static_cast<uint8_t>(rhs);
+    }
+    inline LE_PHYs operator |(const LE_PHYs lhs, const LE_PHYs rhs) {
+        return static_cast<LE_PHYs> ( static_cast<uint8_t>(lhs) | static_cast<uint8_t>(rhs) );
+    }
+    /**
+     * Returns the LE_PHYs bit of a single PHY value as used in events,
+     * i.e. 0x01 for LE 1M, 0x02 for LE 2M and 0x03 for LE Coded.
+     */
+    inline LE_PHYs getLE_PHYs(const uint8_t phy) {
+        return 1 <= phy && phy <= 3 ? static_cast<LE_PHYs>( 1 << ( phy - 1 ) ) : LE_PHYs::NONE;
+    }
+    std::string getLE_PHYsString(const LE_PHYs phys);
+
+    /**
+     * LE connection parameter as used by LE Create Connection and LE Connection Update.
+     * <p>
+     * BT Core Spec v5.2: Vol 4, Part E HCI: 7.8.18 LE Connection Update command
+     * </p>
+     */
+    struct LEConnParam {
+        /** in units of 1.25ms, min value 6 for 7.5ms -> 3200 for 4s */
+        uint16_t conn_interval_min;
+        /** in units of 1.25ms, min value 6 for 7.5ms -> 3200 for 4s */
+        uint16_t conn_interval_max;
+        /** slave latency in units of connection events, max value 499 */
+        uint16_t conn_latency;
+        /** in units of 10ms, min value 10 for 100ms -> 3200 for 32s */
+        uint16_t supervision_timeout;
+
+        std::string toString() const;
+    };
+
+    /**
+     * Named LE connection parameter profiles, trading latency and throughput against radio time.
+     */
+    enum class LEConnProfile : uint8_t {
+        /** The connectLE(..) default: 18.75ms interval, no slave latency, 10s supervision timeout. */
+        DEFAULT             = 0,
+        /** Minimum 7.5ms interval without slave latency for large GATT transfers. */
+        BULK_TRANSFER       = 1,
+        /** 100ms - 200ms interval with slave latency 4 for sporadic, latency tolerant telemetry. */
+        IDLE_TELEMETRY      = 2
+    };
+    inline uint8_t number(const LEConnProfile rhs) {
+        return static_cast<uint8_t>(rhs);
+    }
+    std::string getLEConnProfileString(const LEConnProfile p);
+    LEConnParam getLEConnParam(const LEConnProfile p);
+
     /**
      * BT Core Spec v5.2: Vol 4, Part E HCI: 5.4 Exchange of HCI-specific information
      * <p>
@@ -556,6 +658,8 @@ namespace direct_bt {
     {
         protected:
             uint64_t ts_creation;
+            /** kernel receive timestamp in nanoseconds, zero if not received */
+            uint64_t ts_received;
 
             inline static void checkEventType(const HCIEventType has, const HCIEventType min, const HCIEventType max)
             {
@@ -597,7 +701,7 @@ namespace direct_bt {
 
             /** Persistent memory, w/ ownership ..*/
             HCIEvent(const uint8_t* buffer, const int buffer_len)
-            : HCIPacket(buffer, buffer_len), ts_creation(getCurrentMilliseconds())
+            : HCIPacket(buffer, buffer_len), ts_creation(getCurrentMilliseconds()), ts_received(0)
             {
                 checkEventType(getEventType(), HCIEventType::INQUIRY_COMPLETE, HCIEventType::AMP_Receiver_Report);
                 pdu.check_range(0, number(HCIConstU8::EVENT_HDR_SIZE)+getBaseParamSize());
@@ -605,7 +709,7 @@ namespace direct_bt {
 
             /** Enabling manual construction of event without given value.  */
             HCIEvent(const HCIEventType evt, const uint16_t param_size=0)
-            : HCIPacket(HCIPacketType::EVENT, number(HCIConstU8::EVENT_HDR_SIZE)+param_size), ts_creation(getCurrentMilliseconds())
+            : HCIPacket(HCIPacketType::EVENT, number(HCIConstU8::EVENT_HDR_SIZE)+param_size), ts_creation(getCurrentMilliseconds()), ts_received(0)
             {
                 checkEventType(evt, HCIEventType::INQUIRY_COMPLETE, HCIEventType::AMP_Receiver_Report);
                 pdu.put_uint8(1, number(evt));
@@ -623,8 +727,16 @@ namespace direct_bt {
 
             virtual ~HCIEvent() {}
 
+            /** Returns the monotonic creation timestamp in milliseconds, see getCurrentMilliseconds(). */
             uint64_t getTimestamp() const { return ts_creation; }
 
+            /**
+             * Returns the kernel receive timestamp in nanoseconds, see getWallClockNanoseconds(),
+             * or zero if not received.
+             */
+            uint64_t getReceiveTimestamp() const { return ts_received; }
+            void setReceiveTimestamp(const uint64_t ts) { ts_received = ts; }
+
             HCIEventType getEventType() const { return static_cast<HCIEventType>( pdu.get_uint8(1) ); }
             std::string getEventTypeString() const { return getHCIEventTypeString(getEventType()); }
             bool isEvent(HCIEventType t) const { return t == getEventType(); }
@@ -37,6 +37,7 @@
 
 #include "UUID.hpp"
 #include "BTTypes.hpp"
+#include "BTIoctl.hpp"
 
 /**
  * - - - - - - - - - - - - - - -
@@ -59,12 +60,28 @@ namespace direct_bt {
             };
             static inline int number(const Defaults d) { return static_cast<int>(d); }
 
+            /**
+             * L2CAP channel mode, see BT_MODE socket option.
+             * <p>
+             * The BT_MODE socket option is only set for EXT_FLOWCTL,
+             * as LE_FLOWCTL is the kernel's default mode of a LE PSM socket.
+             * </p>
+             */
+            enum class Mode : uint8_t {
+                /** Basic mode, e.g. for fixed channels like ATT */
+                BASIC = BT_MODE_BASIC,
+                /** LE Credit Based Flow Control mode */
+                LE_FLOWCTL = BT_MODE_LE_FLOWCTL,
+                /** Enhanced Credit Based Flow Control mode, e.g. for EATT */
+                EXT_FLOWCTL = BT_MODE_EXT_FLOWCTL
+            };
+
             static std::string getStateString(bool isConnected, bool hasIOError) {
                 return "State[connected "+std::to_string(isConnected)+", ioError "+std::to_string(hasIOError)+"]";
             }
 
         private:
-            static int l2cap_open_dev(const EUI48 & adapterAddress, const uint16_t psm, const uint16_t cid, const bool pubaddr);
+            static int l2cap_open_dev(const EUI48 & adapterAddress, const uint16_t psm, const uint16_t cid, const bool pubaddr, const Mode mode);
             static int l2cap_close_dev(int dd);
 
             std::recursive_mutex mtx_write;
@@ -72,17 +89,74 @@ namespace direct_bt {
             const std::string deviceString;
             const uint16_t psm;
             const uint16_t cid;
+            const Mode mode;
             std::atomic<int> _dd; // the l2cap socket
             std::atomic<bool> isConnected; // reflects state
             std::atomic<bool> hasIOError;  // reflects state
-            std::atomic<bool> interruptFlag; // for forced disconnect
-            std::atomic<pthread_t> tid_connect;
+            /** Incremented by each forced disconnect, cancelling operations of a connection established before. */
+            std::atomic<uint32_t> cancelGen;
+            /** The cancelGen at the start of the last connect(), see isInterrupted(). */
+            std::atomic<uint32_t> connectGen;
+            uint16_t rxMTU; // requested receive MTU of a credit based channel, 0 for default
+            int rxBufferSize; // requested socket receive buffer size, 0 for default
+            int _efd; // eventfd waking up a pending connect, read or waitWritable on forced disconnect
+
+            /** Signals _efd, waking up all pending poll operations. */
+            void wakeup();
+
+            /** Resets _efd after a forced disconnect. */
+            void clearWakeup();
+
+            /** Returns true if a disconnect has been issued since the start of the last connect(). */
+            bool isInterrupted() const { return cancelGen != connectGen; }
+
+            /**
+             * Polls the socket for the given events or a wakeup via _efd.
+             * @return 1 if ready, 0 on timeout and -1 on error or wakeup, the latter setting errno to ECANCELED.
+             */
+            int pollOrWakeup(const short events, const int32_t timeoutMS, short & revents);
 
         public:
             /** Constructing a closed L2CAP channel, use {@link #connect()} to open. */
-            L2CAPComm(std::shared_ptr<DBTDevice> device, const uint16_t psm, const uint16_t cid);
+            L2CAPComm(std::shared_ptr<DBTDevice> device, const uint16_t psm, const uint16_t cid, const Mode mode=Mode::BASIC);
+
+            /**
+             * Constructing a connected channel adopting the given socket without a DBTDevice,
+             * e.g. one end of a local socketpair for testing against a mock peer.
+             * <p>
+             * The socket is closed by {@link #disconnect()}, thereafter {@link #connect()} fails.
+             * </p>
+             */
+            L2CAPComm(const int dd, const std::string & deviceString, const Mode mode=Mode::BASIC);
+
+            /**
+             * Releases this instance after issuing {@link #disconnect()}.
+             */
+            ~L2CAPComm();
+
+            L2CAPComm(const L2CAPComm&) = delete;
+            void operator=(const L2CAPComm&) = delete;
 
             std::shared_ptr<DBTDevice> getDevice() { return device; }
+            Mode getMode() const { return mode; }
+            uint16_t getPSM() const { return psm; }
+
+            /**
+             * Sets the receive parameter of a credit based flow control channel, to be applied by {@link #connect()}.
+             * <p>
+             * The receive MTU limits the size of a received SDU.
+             * The receive buffer size determines the number of credits granted to the peer,
+             * i.e. the number of PDUs the peer may send without awaiting new credits.
+             * SDU segmentation into PDUs of the MPS, reassembly and credit management are performed by the kernel,
+             * which also selects the MPS according to the ACL link.
+             * </p>
+             * <p>
+             * BT Core Spec v5.2: Vol 3, Part A: 10.1 LE Credit Based Flow Control Mode
+             * </p>
+             * @param rxMTU the receive MTU, zero for the default, otherwise at least 23
+             * @param rxBufferSize the socket receive buffer size in bytes, zero for the default
+             */
+            void setFlowControlParameter(const uint16_t rxMTU, const int rxBufferSize);
 
             bool getIsConnected() const { return isConnected; }
             bool getHasIOError() const { return hasIOError; }
@@ -93,10 +167,21 @@ namespace direct_bt {
              * <p>
              * BT Core Spec v5.2: Vol 3, Part A: L2CAP_CONNECTION_REQ
              * </p>
+             * <p>
+             * The connection is established via a non-blocking socket,
+             * which can be cancelled instantly by {@link #disconnect()} from another thread.
+             * </p>
              */
             bool connect();
 
-            /** Closing the L2CAP channel, locking {@link #mutex_write()}. */
+            /**
+             * Closing the L2CAP channel, locking {@link #mutex_write()}.
+             * <p>
+             * A pending {@link #connect()}, {@link #read(uint8_t*, const int, const int32_t)} with timeout
+             * or {@link #waitWritable(const int32_t)} of another thread is woken up before acquiring the lock,
+             * the interrupted read fails with errno ECANCELED.
+             * </p>
+             */
             bool disconnect();
 
             bool isOpen() const { return 0 <= _dd; }
@@ -105,11 +190,62 @@ namespace direct_bt {
             /** Return the recursive write mutex for multithreading access. */
             std::recursive_mutex & mutex_write() { return mtx_write; }
 
-            /** Generic read w/ own timeoutMS, w/o locking suitable for a unique ringbuffer sink. */
-            int read(uint8_t* buffer, const int capacity, const int32_t timeoutMS);
+            /**
+             * Generic read w/ own timeoutMS, w/o locking suitable for a unique ringbuffer sink.
+             * <p>
+             * A zero timeoutMS reads without polling, e.g. if the socket is known to be readable.
+             * Returns -1 with errno ECANCELED if interrupted by {@link #disconnect()}.
+             * </p>
+             * @param rxTimestamp set to the kernel receive timestamp in nanoseconds, see getWallClockNanoseconds(),
+             *        or the current wall-clock time if not supported by the kernel
+             */
+            int read(uint8_t* buffer, const int capacity, const int32_t timeoutMS, uint64_t & rxTimestamp);
+
+            /** Generic read w/ own timeoutMS, see {@link #read(uint8_t*, const int, const int32_t, uint64_t&)}. */
+            int read(uint8_t* buffer, const int capacity, const int32_t timeoutMS) {
+                uint64_t rxTimestamp;
+                return read(buffer, capacity, timeoutMS, rxTimestamp);
+            }
 
             /** Generic write, locking {@link #mutex_write()}. */
             int write(const uint8_t *buffer, const int length);
+
+            /**
+             * Returns the free space of the socket's send buffer in bytes, or -1 on error.
+             * <p>
+             * Allows a writer to apply backpressure before the kernel's send queue is exhausted.
+             * </p>
+             */
+            int getWriteSpace() const;
+
+            /**
+             * Returns the negotiated MTU of a credit based flow control channel,
+             * i.e. the minimum of the local receive and remote receive MTU, or -1 on error.
+             */
+            int getMTU() const;
+
+            /** Returns the transmit MTU of a credit based flow control channel, i.e. the peer's receive MTU, or -1 on error. */
+            int getTxMTU() const;
+
+            /** Returns the local receive MTU of a credit based flow control channel, or -1 on error. */
+            int getRxMTU() const;
+
+            /**
+             * Writes the given data as consecutive SDUs of at most the transmit MTU,
+             * waiting for send buffer space between SDUs, i.e. until the peer granted new credits.
+             * <p>
+             * Locks {@link #mutex_write()} for the whole stream, hence the SDUs are not interleaved with other writes.
+             * </p>
+             * @param timeoutMS maximum time to wait for send buffer space per SDU
+             * @return number of written bytes, which is less than length on timeout or interruption, or -1 on error
+             */
+            int writeStream(const uint8_t *buffer, const int length, const int32_t timeoutMS);
+
+            /**
+             * Waits until the socket is writable, i.e. its send queue has drained sufficiently.
+             * @return 1 if writable, 0 on timeout or interruption and -1 on error.
+             */
+            int waitWritable(const int32_t timeoutMS);
     };
 
 } // namespace direct_bt
@@ -0,0 +1,164 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2020 Gothel Software e.K.
+ * Copyright (c) 2020 ZAFENA AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#ifndef L2CAP_REACTOR_HPP_
+#define L2CAP_REACTOR_HPP_
+
+#include <cstring>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+
+#include "DBTEnv.hpp"
+
+/**
+ * - - - - - - - - - - - - - - -
+ *
+ * Module L2CAPReactor:
+ *
+ * - Servicing many L2CAP sockets with a fixed number of epoll threads,
+ *   instead of one blocking reader thread per socket.
+ */
+namespace direct_bt {
+
+    /**
+     * Shared epoll reactor dispatching readable L2CAP sockets to their registered callbacks,
+     * using a fixed number of threads, each servicing its own shard of sockets.
+     * <p>
+     * Environment variable 'direct_bt.gatt.reactor.threads' defines the number of threads, defaults to 1.
+     * </p>
+     * <p>
+     * All callbacks of one socket are invoked sequentially by the same thread,
+     * hence shall not block longer than necessary as they delay all other sockets of their shard.
+     * </p>
+     */
+    class L2CAPReactor {
+        public:
+            /**
+             * Invoked if the socket is readable or reports an error or hangup.
+             * Returns false to deregister the socket.
+             */
+            typedef std::function<bool()> ReadableCallback;
+
+            /**
+             * Invoked periodically every TICK_MS milliseconds, e.g. to detect reply timeouts.
+             * Returns false to deregister the socket.
+             */
+            typedef std::function<bool()> TickCallback;
+
+            /** Period of the TickCallback in milliseconds */
+            static const int TICK_MS = 100;
+
+        private:
+            class Entry {
+                public:
+                    ReadableCallback readable;
+                    TickCallback tick;
+
+                    Entry(const ReadableCallback & r, const TickCallback & t)
+                    : readable(r), tick(t) {}
+            };
+            class Shard {
+                public:
+                    int epollFd;
+                    int eventFd;
+                    std::thread thread;
+                    std::mutex mtx_entries;
+                    std::unordered_map<int, std::shared_ptr<Entry>> entries;
+
+                    Shard() : epollFd(-1), eventFd(-1) {}
+            };
+            std::vector<std::shared_ptr<Shard>> shards;
+            std::atomic<bool> shallStop;
+
+            L2CAPReactor(const int threadCount);
+
+            L2CAPReactor(const L2CAPReactor&) = delete;
+            void operator=(const L2CAPReactor&) = delete;
+
+            Shard & getShard(const int fd) { return *shards[ fd % shards.size() ]; }
+
+            void reactorThreadImpl(Shard & shard);
+
+            /** Invokes the readable or tick callback of the given socket, deregistering it if returning false. */
+            void dispatch(Shard & shard, const int fd, const bool tick);
+
+            /** Removes the given socket from the given shard, the caller holds its mtx_entries lock. */
+            void removeLocked(Shard & shard, const int fd);
+
+        public:
+            static L2CAPReactor& get() {
+                /**
+                 * Thread safe starting with C++11 6.7:
+                 *
+                 * If control enters the declaration concurrently while the variable is being initialized,
+                 * the concurrent execution shall wait for completion of the initialization.
+                 *
+                 * (Magic Statics)
+                 *
+                 * Avoiding non-working double checked locking.
+                 */
+                static L2CAPReactor r( DBTEnv::getInt32Property("direct_bt.gatt.reactor.threads", 1, 1 /* min */, 64 /* max */) );
+                return r;
+            }
+
+            /** Stops and joins all threads, dropping all registered sockets. */
+            ~L2CAPReactor();
+
+            int getThreadCount() const { return shards.size(); }
+
+            /**
+             * Registers the given socket with its callbacks.
+             * @param fd the socket descriptor
+             * @param readable callback invoked if the socket is readable
+             * @param tick optional periodic callback, may be nullptr
+             * @return true if registered, otherwise false, e.g. if already registered
+             */
+            bool add(const int fd, const ReadableCallback & readable, const TickCallback & tick);
+
+            /**
+             * Deregisters the given socket, its callbacks will not be invoked anymore.
+             * <p>
+             * Does not wait for a callback currently in progress on the reactor thread,
+             * hence the callbacks shall hold a weak reference to their target only.
+             * </p>
+             * <p>
+             * Shall be called before the socket is closed.
+             * </p>
+             */
+            void remove(const int fd);
+    };
+
+} // namespace direct_bt
+
+#endif /* L2CAP_REACTOR_HPP_ */
@@ -468,6 +468,139 @@ namespace direct_bt {
             }
     };
 
+    /**
+     * Read-only view into an owned fixed capacity buffer, recycled by an OctetsPool.
+     * <p>
+     * Data is received directly into the buffer, see get_buffer(),
+     * while the view exposes the relevant part, see setView(int, int).
+     * </p>
+     */
+    class PooledOctets : public TROOctets
+    {
+        private:
+            POctets buffer;
+
+        public:
+            PooledOctets(const int capacity)
+            : TROOctets(nullptr, 0), buffer(capacity, capacity) {}
+
+            PooledOctets(const PooledOctets &o) = delete;
+            PooledOctets& operator=(const PooledOctets &o) = delete;
+
+            int getCapacity() const { return buffer.getSize(); }
+
+            uint8_t * get_buffer() { return buffer.get_wptr(); }
+
+            /** Sets the view to the given buffer range. */
+            void setView(const int offset, const int size) {
+                buffer.check_range(offset, size);
+                setData(buffer.get_wptr() + offset, size);
+            }
+    };
+
+    /**
+     * Pool of PooledOctets, recycling each buffer once all its references have been released.
+     * <p>
+     * The last released reference returns its buffer to the pool's free list under the pool's mutex,
+     * hence all accesses via the released references happen before the buffer's reuse.
+     * acquire() and the release of acquired references may be performed by any thread.
+     * </p>
+     * <p>
+     * If all buffers are in use and the pool reached its maximum size,
+     * a new unpooled buffer is returned.
+     * </p>
+     * <p>
+     * Acquired references may outlive the pool, their buffers are deleted when released.
+     * </p>
+     */
+    class OctetsPool
+    {
+        private:
+            /** State shared with all acquired references */
+            struct State {
+                std::mutex mtx;
+                std::vector<PooledOctets*> free;
+                size_t created = 0;
+                bool closed = false;
+
+                ~State() {
+                    for(size_t i=0; i<free.size(); i++) {
+                        delete free[i];
+                    }
+                }
+            };
+
+            /** Returns the released buffer to the pool's free list, or deletes it if the pool has been destroyed. */
+            struct Recycler {
+                std::shared_ptr<State> state;
+
+                void operator()(PooledOctets * b) const {
+                    {
+                        const std::lock_guard<std::mutex> lock(state->mtx); // RAII-style acquire and relinquish via destructor
+                        if( !state->closed ) {
+                            state->free.push_back(b);
+                            return;
+                        }
+                    }
+                    delete b;
+                }
+            };
+
+            const int capacity;
+            const size_t maxSize;
+            std::shared_ptr<State> state;
+
+        public:
+            OctetsPool(const int capacity, const int maxSize)
+            : capacity(capacity), maxSize(maxSize), state(std::make_shared<State>()) {
+                state->free.reserve(maxSize);
+            }
+
+            ~OctetsPool() {
+                const std::lock_guard<std::mutex> lock(state->mtx); // RAII-style acquire and relinquish via destructor
+                state->closed = true;
+            }
+
+            OctetsPool(const OctetsPool &o) = delete;
+            OctetsPool& operator=(const OctetsPool &o) = delete;
+
+            int getCapacity() const { return capacity; }
+
+            /** Returns the number of pooled buffers, free or in use. */
+            size_t getSize() {
+                const std::lock_guard<std::mutex> lock(state->mtx); // RAII-style acquire and relinquish via destructor
+                return state->created;
+            }
+
+            /** Returns the number of free pooled buffers. */
+            size_t getFreeCount() {
+                const std::lock_guard<std::mutex> lock(state->mtx); // RAII-style acquire and relinquish via destructor
+                return state->free.size();
+            }
+
+            /** Returns a free buffer with an empty view. */
+            std::shared_ptr<PooledOctets> acquire() {
+                PooledOctets * b = nullptr;
+                {
+                    const std::lock_guard<std::mutex> lock(state->mtx); // RAII-style acquire and relinquish via destructor
+                    if( !state->free.empty() ) {
+                        // most recently released first, likely still cached
+                        b = state->free.back();
+                        state->free.pop_back();
+                    } else if( state->created >= maxSize ) {
+                        return std::shared_ptr<PooledOctets>( new PooledOctets(capacity) );
+                    } else {
+                        state->created++;
+                    }
+                }
+                if( nullptr == b ) {
+                    b = new PooledOctets(capacity);
+                } else {
+                    b->setView(0, 0);
+                }
+                return std::shared_ptr<PooledOctets>( b, Recycler{state} );
+            }
+    };
 
 }
 
@@ -133,19 +133,19 @@ AttPDUMsg* AttPDUMsg::getSpecialized(const uint8_t * buffer, int const buffer_si
         case ATT_READ_BLOB_REQ: res = new AttPDUMsg(buffer, buffer_size); break;
         case ATT_READ_BLOB_RSP: res = new AttReadBlobRsp(buffer, buffer_size); break;
         case ATT_READ_MULTIPLE_REQ: res = new AttPDUMsg(buffer, buffer_size); break;
-        case ATT_READ_MULTIPLE_RSP: res = new AttPDUMsg(buffer, buffer_size); break;
+        case ATT_READ_MULTIPLE_RSP: res = new AttReadMultipleRsp(buffer, buffer_size); break;
         case ATT_READ_BY_GROUP_TYPE_REQ: res = new AttPDUMsg(buffer, buffer_size); break;
         case ATT_READ_BY_GROUP_TYPE_RSP: res = new AttReadByGroupTypeRsp(buffer, buffer_size); break;
         case ATT_WRITE_REQ: res = new AttPDUMsg(buffer, buffer_size); break;
         case ATT_WRITE_RSP: res = new AttWriteRsp(buffer, buffer_size); break;
         case ATT_WRITE_CMD: res = new AttPDUMsg(buffer, buffer_size); break;
-        case ATT_PREPARE_WRITE_REQ: res = new AttPDUMsg(buffer, buffer_size); break;
-        case ATT_PREPARE_WRITE_RSP: res = new AttPDUMsg(buffer, buffer_size); break;
+        case ATT_PREPARE_WRITE_REQ: res = new AttPrepareWrite(buffer, buffer_size); break;
+        case ATT_PREPARE_WRITE_RSP: res = new AttPrepareWrite(buffer, buffer_size); break;
         case ATT_EXECUTE_WRITE_REQ: res = new AttPDUMsg(buffer, buffer_size); break;
-        case ATT_EXECUTE_WRITE_RSP: res = new AttPDUMsg(buffer, buffer_size); break;
+        case ATT_EXECUTE_WRITE_RSP: res = new AttExecuteWriteRsp(buffer, buffer_size); break;
         case ATT_READ_MULTIPLE_VARIABLE_REQ: res = new AttPDUMsg(buffer, buffer_size); break;
-        case ATT_READ_MULTIPLE_VARIABLE_RSP: res = new AttPDUMsg(buffer, buffer_size); break;
-        case ATT_MULTIPLE_HANDLE_VALUE_NTF: res = new AttPDUMsg(buffer, buffer_size); break;
+        case ATT_READ_MULTIPLE_VARIABLE_RSP: res = new AttReadMultipleVariableRsp(buffer, buffer_size); break;
+        case ATT_MULTIPLE_HANDLE_VALUE_NTF: res = new AttMultipleHandleValueNtf(buffer, buffer_size); break;
         case ATT_HANDLE_VALUE_NTF: res = new AttHandleValueRcv(buffer, buffer_size); break;
         case ATT_HANDLE_VALUE_IND: res = new AttHandleValueRcv(buffer, buffer_size); break;
         case ATT_HANDLE_VALUE_CFM: res = new AttPDUMsg(buffer, buffer_size); break;
@@ -646,7 +646,8 @@ int EInfoReport::read_data(uint8_t const * data, uint8_t const data_length) {
     return count;
 }
 
-std::vector<std::shared_ptr<EInfoReport>> EInfoReport::read_ad_reports(uint8_t const * data, uint8_t const data_length) {
+std::vector<std::shared_ptr<EInfoReport>> EInfoReport::read_ad_reports(uint8_t const * data, uint8_t const data_length,
+                                                                       const uint64_t rxTimestamp) {
     int const num_reports = (int) data[0];
     std::vector<std::shared_ptr<EInfoReport>> ad_reports;
 
@@ -666,6 +667,7 @@ std::vector<std::shared_ptr<EInfoReport>> EInfoReport::read_ad_reports(uint8_t c
         ad_reports.push_back(std::shared_ptr<EInfoReport>(new EInfoReport()));
         ad_reports[i]->setSource(Source::AD);
         ad_reports[i]->setTimestamp(timestamp);
+        ad_reports[i]->setReceiveTimestamp(rxTimestamp);
         ad_reports[i]->setEvtType(static_cast<AD_PDU_Type>(*i_octets++));
         read_segments++;
     }
@@ -57,6 +57,12 @@ int64_t direct_bt::getCurrentMilliseconds() {
     return t.tv_sec * MilliPerOne + t.tv_nsec / NanoPerMilli;
 }
 
+uint64_t direct_bt::getWallClockNanoseconds() {
+    struct timespec t;
+    clock_gettime(CLOCK_REALTIME, &t);
+    return (uint64_t)t.tv_sec * NanoPerMilli * MilliPerOne + (uint64_t)t.tv_nsec;
+}
+
 const char* direct_bt::RuntimeException::what() const noexcept {
 #if    _USE_BACKTRACE_
     // std::string out(std::runtime_error::what());
@@ -90,6 +90,7 @@ bool DBTAdapter::addConnectedDevice(const std::shared_ptr<DBTDevice> & device) {
         return false;
     }
     connectedDevices.push_back(device);
+    mgmt.whitelistDeviceConnected(dev_id, device->getAddress(), true);
     return true;
 }
 
@@ -98,6 +99,7 @@ bool DBTAdapter::removeConnectedDevice(const DBTDevice & device) {
     for (auto it = connectedDevices.begin(); it != connectedDevices.end(); ) {
         if ( nullptr != *it && device == **it ) {
             it = connectedDevices.erase(it);
+            mgmt.whitelistDeviceConnected(dev_id, device.getAddress(), false);
             return true;
         } else {
             ++it;
@@ -136,7 +138,9 @@ std::shared_ptr<HCIHandler> DBTAdapter::getHCI()
     checkValidAdapter();
     const std::lock_guard<std::recursive_mutex> lock(mtx_hci); // RAII-style acquire and relinquish via destructor
     if( nullptr == hci ) {
+        const uint64_t t0 = getCurrentMilliseconds();
         hci = std::shared_ptr<HCIHandler>( new HCIHandler(btMode, dev_id) );
+        DBG_PRINT("DBTAdapter::getHCI: Opened HCIHandler on dev_id %d in %" PRIu64 " ms", dev_id, getCurrentMilliseconds() - t0);
         if( !hci->isOpen() ) {
             ERR_PRINT("Could not open HCIHandler: %s of %s", hci->toString().c_str(), toString().c_str());
             hci = nullptr;
@@ -299,11 +303,17 @@ bool DBTAdapter::addDeviceToWhitelist(const EUI48 &address, const BDAddressType
         return true;
     }
 
-    if( !mgmt.uploadConnParam(dev_id, address, address_type, conn_interval_min, conn_interval_max, conn_latency, timeout) ) {
-        ERR_PRINT("DBTAdapter::addDeviceToWhitelist: uploadConnParam(dev_id %d, address %s, interval[%u..%u], latency %u, timeout %u): Failed",
-                dev_id, address.toString().c_str(), conn_interval_min, conn_interval_max, conn_latency, timeout);
+    // Keeps the connection parameter with the device, uploaded again if rotated into the controller's whitelist.
+    const std::vector<MgmtConnParam> devices { MgmtConnParam{ address, address_type, conn_interval_min, conn_interval_max, conn_latency, timeout } };
+    return 1 == mgmt.addDevicesToWhitelist(dev_id, devices, ctype);
+}
+
+int DBTAdapter::addDevicesToWhitelist(const std::vector<MgmtConnParam> & devices, const HCIWhitelistConnectType ctype) {
+    if( !isEnabled() ) {
+        ERR_PRINT("DBTAdapter::addDevicesToWhitelist: Adapter not enabled/powered: %s", toString().c_str());
+        return 0;
     }
-    return mgmt.addDeviceToWhitelist(dev_id, address, address_type, ctype);
+    return mgmt.addDevicesToWhitelist(dev_id, devices, ctype);
 }
 
 bool DBTAdapter::removeDeviceFromWhitelist(const EUI48 &address, const BDAddressType address_type) {
@@ -311,6 +321,11 @@ bool DBTAdapter::removeDeviceFromWhitelist(const EUI48 &address, const BDAddress
     return mgmt.removeDeviceFromWhitelist(dev_id, address, address_type);
 }
 
+int DBTAdapter::removeDevicesFromWhitelist(const std::vector<EUI48> & addresses) {
+    checkValidAdapter();
+    return mgmt.removeDevicesFromWhitelist(dev_id, addresses);
+}
+
 bool DBTAdapter::addStatusListener(std::shared_ptr<AdapterStatusListener> l) {
     checkValidAdapter();
     if( nullptr == l ) {
@@ -826,6 +841,8 @@ bool DBTAdapter::mgmtEvDeviceConnectedHCI(std::shared_ptr<MgmtEvent> e) {
 bool DBTAdapter::mgmtEvConnectFailedHCI(std::shared_ptr<MgmtEvent> e) {
     COND_PRINT(debug_event, "DBTAdapter::EventHCI:ConnectFailed: %s", e->toString().c_str());
     const MgmtEvtDeviceConnectFailed &event = *static_cast<const MgmtEvtDeviceConnectFailed *>(e.get());
+    // Also ends a connecting state of an untracked device, see DBTDevice::connectLE(..)
+    mgmt.whitelistDeviceConnected(dev_id, event.getAddress(), false);
     std::shared_ptr<DBTDevice> device = findConnectedDevice(event.getAddress(), event.getAddressType());
     if( nullptr != device ) {
         const uint16_t handle = device->getConnectionHandle();
@@ -918,6 +935,9 @@ bool DBTAdapter::mgmtEvDeviceFoundHCI(std::shared_ptr<MgmtEvent> e) {
         eir->read_data(deviceFoundEvent.getData(), deviceFoundEvent.getDataSize());
     } // else: Sourced from HCIHandler via LE_ADVERTISING_REPORT (default!)
 
+    // Rotates a host-side whitelisted device into the controller's whitelist
+    mgmt.whitelistDeviceSeen(dev_id, eir->getAddress(), eir->getTimestamp());
+
     // std::shared_ptr<DBTDevice> dev = findDiscoveredDevice(ad_report.getAddress());
     std::shared_ptr<DBTDevice> dev;
     {
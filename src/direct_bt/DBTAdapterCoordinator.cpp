@@ -0,0 +1,462 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2020 Gothel Software e.K.
+ * Copyright (c) 2020 ZAFENA AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <vector>
+#include <cstdio>
+
+#include <algorithm>
+
+#include <dbt_debug.hpp>
+
+#include "DBTAdapterCoordinator.hpp"
+
+using namespace direct_bt;
+
+const int8_t DBTAdapterCoordinator::RSSI_NONE;
+
+int8_t DBTAdapterCoordinator::DeviceInfo::getBestRSSI() const {
+    int8_t best = RSSI_NONE;
+    for(size_t i=0; i<rssi.size(); i++) {
+        if( RSSI_NONE != rssi[i] && ( RSSI_NONE == best || rssi[i] > best ) ) {
+            best = rssi[i];
+        }
+    }
+    return best;
+}
+
+std::vector<int8_t> DBTAdapterCoordinator::DeviceInfo::getRecentRSSI(const uint64_t now, const int maxAge) const {
+    std::vector<int8_t> res(rssi.size(), RSSI_NONE);
+    for(size_t i=0; i<rssi.size(); i++) {
+        if( 0 < ts_rssi[i] && ts_rssi[i] <= now && now - ts_rssi[i] <= static_cast<uint64_t>(maxAge) ) {
+            res[i] = rssi[i];
+        }
+    }
+    return res;
+}
+
+bool DBTAdapterCoordinator::DeviceInfo::isExpired(const uint64_t now, const int maxAge) const {
+    return 0 > assignedAdapter && !whitelisted && !connected &&
+           ts_last_seen <= now && now - ts_last_seen > static_cast<uint64_t>(maxAge);
+}
+
+std::string DBTAdapterCoordinator::DeviceInfo::toString() const {
+    std::string rssiStr;
+    for(size_t i=0; i<rssi.size(); i++) {
+        rssiStr += ( 0 < i ? ", " : "" ) + std::to_string(rssi[i]);
+    }
+    return "DeviceInfo["+address.toString()+", "+getBDAddressTypeString(addressType)+", rssi ["+rssiStr+"], assigned "+
+           std::to_string(assignedAdapter)+", whitelisted "+std::to_string(whitelisted)+", connected "+std::to_string(connected)+"]";
+}
+
+class DBTAdapterCoordinator::AdapterListener : public AdapterStatusListener {
+    private:
+        DBTAdapterCoordinator & coordinator;
+        const int adapterIdx;
+
+    public:
+        AdapterListener(DBTAdapterCoordinator & coordinator, const int adapterIdx)
+        : coordinator(coordinator), adapterIdx(adapterIdx) {}
+
+        void adapterSettingsChanged(DBTAdapter const &a, const AdapterSetting oldmask, const AdapterSetting newmask,
+                                    const AdapterSetting changedmask, const uint64_t timestamp) override {
+            (void)a; (void)oldmask; (void)newmask; (void)changedmask; (void)timestamp;
+        }
+
+        void discoveringChanged(DBTAdapter const &a, const bool enabled, const bool keepAlive, const uint64_t timestamp) override {
+            (void)a; (void)enabled; (void)keepAlive; (void)timestamp;
+        }
+
+        void deviceFound(std::shared_ptr<DBTDevice> device, const uint64_t timestamp) override {
+            coordinator.deviceSeen(adapterIdx, device, timestamp);
+        }
+
+        void deviceUpdated(std::shared_ptr<DBTDevice> device, const EIRDataType updateMask, const uint64_t timestamp) override {
+            (void)updateMask;
+            coordinator.deviceSeen(adapterIdx, device, timestamp);
+        }
+
+        void deviceConnected(std::shared_ptr<DBTDevice> device, const uint16_t handle, const uint64_t timestamp) override {
+            (void)handle; (void)timestamp;
+            coordinator.deviceConnected(adapterIdx, device);
+        }
+
+        void deviceDisconnected(std::shared_ptr<DBTDevice> device, const HCIStatusCode reason, const uint16_t handle, const uint64_t timestamp) override {
+            (void)reason; (void)handle; (void)timestamp;
+            coordinator.deviceDisconnected(adapterIdx, device);
+        }
+
+        std::string toString() const override {
+            return "DBTAdapterCoordinator::AdapterListener[adapter "+std::to_string(adapterIdx)+"]";
+        }
+};
+
+DBTAdapterCoordinator::DBTAdapterCoordinator(const std::vector<std::shared_ptr<DBTAdapter>> & adapters,
+                                             const int8_t minRSSI, const int maxAssigned, const int scanningAdapter,
+                                             const int rssiMaxAge)
+: adapters(adapters), minRSSI(minRSSI), maxAssigned(maxAssigned), rssiMaxAge(rssiMaxAge), ts_last_expiry(0), scanningAdapter(-1), discovering(false)
+{
+    for(size_t i=0; i<adapters.size(); i++) {
+        if( nullptr == adapters[i] ) {
+            throw IllegalArgumentException("Adapter "+std::to_string(i)+" is null", E_FILE_LINE);
+        }
+    }
+    if( -1 > scanningAdapter || scanningAdapter >= static_cast<int>(adapters.size()) ) {
+        throw IllegalArgumentException("Scanning adapter "+std::to_string(scanningAdapter)+" not in [-1.."+std::to_string(adapters.size())+")", E_FILE_LINE);
+    }
+    if( 0 >= rssiMaxAge ) {
+        throw IllegalArgumentException("RSSI max age "+std::to_string(rssiMaxAge)+" not > 0", E_FILE_LINE);
+    }
+    this->scanningAdapter = scanningAdapter;
+    for(size_t i=0; i<adapters.size(); i++) {
+        std::shared_ptr<AdapterListener> l = std::make_shared<AdapterListener>(*this, i);
+        adapterListeners.push_back(l);
+        adapters[i]->addStatusListener(l);
+    }
+}
+
+DBTAdapterCoordinator::~DBTAdapterCoordinator() {
+    for(size_t i=0; i<adapters.size(); i++) {
+        adapters[i]->removeStatusListener(adapterListeners[i]);
+    }
+}
+
+std::shared_ptr<DBTAdapter> DBTAdapterCoordinator::getAdapter(const int idx) const {
+    if( 0 > idx || idx >= static_cast<int>(adapters.size()) ) {
+        throw IndexOutOfBoundsException(idx, adapters.size(), 1, E_FILE_LINE);
+    }
+    return adapters[idx];
+}
+
+int DBTAdapterCoordinator::getScanningAdapter() {
+    const std::lock_guard<std::mutex> lock(mtx_discovery); // RAII-style acquire and relinquish via destructor
+    return scanningAdapter;
+}
+
+void DBTAdapterCoordinator::setScanningAdapter(const int idx) {
+    if( -1 > idx || idx >= static_cast<int>(adapters.size()) ) {
+        throw IllegalArgumentException("Scanning adapter "+std::to_string(idx)+" not in [-1.."+std::to_string(adapters.size())+")", E_FILE_LINE);
+    }
+    const std::lock_guard<std::mutex> lock(mtx_discovery); // RAII-style acquire and relinquish via destructor
+    if( idx == scanningAdapter ) {
+        return;
+    }
+    scanningAdapter = idx;
+    if( discovering ) {
+        startDiscoveryLocked();
+    }
+}
+
+bool DBTAdapterCoordinator::startDiscoveryLocked() {
+    bool res = true;
+    for(size_t i=0; i<adapters.size(); i++) {
+        DBTAdapter & a = *adapters[i];
+        if( 0 > scanningAdapter || static_cast<int>(i) == scanningAdapter ) {
+            if( !a.getDiscovering() && !a.startDiscovery(true /* keepAlive */) ) {
+                ERR_PRINT("DBTAdapterCoordinator::startDiscovery: Failed on adapter %zu: %s", i, a.toString().c_str());
+                res = false;
+            }
+        } else if( a.getDiscovering() ) {
+            a.stopDiscovery();
+        }
+    }
+    return res;
+}
+
+bool DBTAdapterCoordinator::startDiscovery() {
+    const std::lock_guard<std::mutex> lock(mtx_discovery); // RAII-style acquire and relinquish via destructor
+    discovering = true;
+    return startDiscoveryLocked();
+}
+
+bool DBTAdapterCoordinator::stopDiscovery() {
+    const std::lock_guard<std::mutex> lock(mtx_discovery); // RAII-style acquire and relinquish via destructor
+    discovering = false;
+    bool res = true;
+    for(size_t i=0; i<adapters.size(); i++) {
+        if( adapters[i]->getDiscovering() && !adapters[i]->stopDiscovery() ) {
+            res = false;
+        }
+    }
+    return res;
+}
+
+bool DBTAdapterCoordinator::addListener(std::shared_ptr<CoordinatedDeviceListener> l) {
+    if( nullptr == l ) {
+        throw IllegalArgumentException("CoordinatedDeviceListener ref is null", E_FILE_LINE);
+    }
+    const std::lock_guard<std::recursive_mutex> lock(mtx_devices); // RAII-style acquire and relinquish via destructor
+    if( std::find(listeners.begin(), listeners.end(), l) != listeners.end() ) {
+        return false;
+    }
+    listeners.push_back(l);
+    return true;
+}
+
+bool DBTAdapterCoordinator::removeListener(std::shared_ptr<CoordinatedDeviceListener> l) {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_devices); // RAII-style acquire and relinquish via destructor
+    auto it = std::find(listeners.begin(), listeners.end(), l);
+    if( it == listeners.end() ) {
+        return false;
+    }
+    listeners.erase(it);
+    return true;
+}
+
+void DBTAdapterCoordinator::deviceSeen(const int adapterIdx, std::shared_ptr<DBTDevice> device, const uint64_t timestamp) {
+    std::vector<std::shared_ptr<CoordinatedDeviceListener>> notify;
+    {
+        const std::lock_guard<std::recursive_mutex> lock(mtx_devices); // RAII-style acquire and relinquish via destructor
+        if( timestamp >= ts_last_expiry + static_cast<uint64_t>(rssiMaxAge) ) {
+            // Throttled to once per maximum age, keeping the full scan off most advertising reports
+            removeExpiredDevicesLocked(timestamp);
+            ts_last_expiry = timestamp;
+        }
+        const DeviceKey key(device->getAddress(), device->getAddressType());
+        auto it = devices.find(key);
+        const bool isNew = it == devices.end();
+        if( isNew ) {
+            it = devices.insert( std::make_pair(key, DeviceInfo(key.first, key.second, adapters.size())) ).first;
+        }
+        DeviceInfo & info = it->second;
+        const int8_t rssi = device->getRSSI();
+        if( RSSI_NONE != rssi ) {
+            // Latest value only, a stale RSSI ages out via its timestamp
+            info.rssi[adapterIdx] = rssi;
+            info.ts_rssi[adapterIdx] = timestamp;
+        }
+        info.ts_last_seen = timestamp;
+        if( isNew ) {
+            notify = listeners;
+        }
+    }
+    for(size_t i=0; i<notify.size(); i++) {
+        try {
+            notify[i]->deviceFound(device, timestamp);
+        } catch (std::exception &e) {
+            ERR_PRINT("DBTAdapterCoordinator::deviceFound: CoordinatedDeviceListener %zu/%zu: Caught exception %s",
+                    i+1, notify.size(), e.what());
+        }
+    }
+}
+
+void DBTAdapterCoordinator::deviceConnected(const int adapterIdx, std::shared_ptr<DBTDevice> device) {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_devices); // RAII-style acquire and relinquish via destructor
+    const DeviceKey key(device->getAddress(), device->getAddressType());
+    auto it = devices.find(key);
+    if( it == devices.end() ) {
+        it = devices.insert( std::make_pair(key, DeviceInfo(key.first, key.second, adapters.size())) ).first;
+    }
+    DeviceInfo & info = it->second;
+    if( 0 <= info.assignedAdapter && adapterIdx != info.assignedAdapter ) {
+        WARN_PRINT("DBTAdapterCoordinator::deviceConnected: Device assigned to adapter %d, connected via %d: %s",
+                info.assignedAdapter, adapterIdx, device->toString().c_str());
+    }
+    // The connection counts for the adapter holding it
+    info.assignedAdapter = adapterIdx;
+    info.connected = true;
+    info.device = device;
+}
+
+void DBTAdapterCoordinator::deviceDisconnected(const int adapterIdx, std::shared_ptr<DBTDevice> device) {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_devices); // RAII-style acquire and relinquish via destructor
+    auto it = devices.find( DeviceKey(device->getAddress(), device->getAddressType()) );
+    if( it == devices.end() ) {
+        return;
+    }
+    DeviceInfo & info = it->second;
+    if( adapterIdx == info.assignedAdapter ) {
+        info.connected = false;
+        info.device.reset();
+        if( !info.whitelisted ) {
+            // Whitelisted devices remain assigned for the kernel's auto-connect
+            info.assignedAdapter = -1;
+        }
+    } else if( 0 > info.assignedAdapter ) {
+        // released
+        info.connected = false;
+        info.device.reset();
+    }
+}
+
+std::vector<DBTAdapterCoordinator::DeviceInfo> DBTAdapterCoordinator::getDevices() {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_devices); // RAII-style acquire and relinquish via destructor
+    std::vector<DeviceInfo> res;
+    for(auto it = devices.begin(); it != devices.end(); it++) {
+        res.push_back(it->second);
+    }
+    return res;
+}
+
+std::vector<int> DBTAdapterCoordinator::getAssignedCountsLocked() const {
+    std::vector<int> res(adapters.size(), 0);
+    for(auto it = devices.begin(); it != devices.end(); it++) {
+        if( 0 <= it->second.assignedAdapter ) {
+            res[it->second.assignedAdapter]++;
+        }
+    }
+    return res;
+}
+
+size_t DBTAdapterCoordinator::removeExpiredDevicesLocked(const uint64_t now) {
+    size_t count = 0;
+    for(auto it = devices.begin(); it != devices.end(); ) {
+        if( it->second.isExpired(now, rssiMaxAge) ) {
+            it = devices.erase(it);
+            count++;
+        } else {
+            it++;
+        }
+    }
+    if( 0 < count ) {
+        DBG_PRINT("DBTAdapterCoordinator::removeExpiredDevices: Removed %zu, remaining %zu", count, devices.size());
+    }
+    return count;
+}
+
+std::vector<int> DBTAdapterCoordinator::getAssignedCounts() {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_devices); // RAII-style acquire and relinquish via destructor
+    return getAssignedCountsLocked();
+}
+
+int DBTAdapterCoordinator::selectAdapter(const std::vector<int> & assigned, const std::vector<int8_t> & rssi,
+                                         const int8_t minRSSI, const int maxAssigned, const int scanningAdapter)
+{
+    int res = -1;
+    int8_t resRSSI = RSSI_NONE;
+    for(int pass=0; pass<2 && 0 > res; pass++) {
+        // First pass excludes the scanning adapter, used as last resort in the second pass
+        for(int i=0; i<static_cast<int>(assigned.size()) && i<static_cast<int>(rssi.size()); i++) {
+            if( ( 0 == pass ) == ( i == scanningAdapter ) ) {
+                continue;
+            }
+            const int8_t r = rssi[i];
+            if( RSSI_NONE == r || r < minRSSI || ( 0 < maxAssigned && assigned[i] >= maxAssigned ) ) {
+                continue;
+            }
+            if( 0 > res || assigned[i] < assigned[res] || ( assigned[i] == assigned[res] && r > resRSSI ) ) {
+                res = i;
+                resRSSI = r;
+            }
+        }
+    }
+    return res;
+}
+
+HCIStatusCode DBTAdapterCoordinator::connect(const EUI48 & address, const BDAddressType addressType) {
+    const int scanner = getScanningAdapter();
+    int idx;
+    bool assignedNow = false;
+    {
+        const std::lock_guard<std::recursive_mutex> lock(mtx_devices); // RAII-style acquire and relinquish via destructor
+        auto it = devices.find( DeviceKey(address, addressType) );
+        if( it == devices.end() ) {
+            return HCIStatusCode::UNKNOWN_CONNECTION_IDENTIFIER;
+        }
+        DeviceInfo & info = it->second;
+        if( info.connected ) {
+            return HCIStatusCode::SUCCESS;
+        }
+        idx = info.assignedAdapter;
+        if( 0 > idx ) {
+            const std::vector<int> assigned = getAssignedCountsLocked();
+            const std::vector<int8_t> rssi = info.getRecentRSSI(getCurrentMilliseconds(), rssiMaxAge);
+            idx = selectAdapter(assigned, rssi, minRSSI, maxAssigned, scanner);
+            if( 0 > idx ) {
+                const bool limited = 0 < maxAssigned &&
+                                     -1 != selectAdapter(assigned, rssi, minRSSI, 0 /* maxAssigned */, scanner);
+                DBG_PRINT("DBTAdapterCoordinator::connect: No adapter (limited %d): %s", limited, info.toString().c_str());
+                return limited ? HCIStatusCode::CONNECTION_LIMIT_EXCEEDED : HCIStatusCode::UNKNOWN_CONNECTION_IDENTIFIER;
+            }
+            info.assignedAdapter = idx;
+            assignedNow = true;
+        }
+        DBG_PRINT("DBTAdapterCoordinator::connect: Adapter %d: %s", idx, info.toString().c_str());
+    }
+    // Connect without holding the lock, as adapter callbacks are issued concurrently
+    DBTAdapter & adapter = *adapters[idx];
+    HCIStatusCode res;
+    bool whitelisted = false;
+    std::shared_ptr<DBTDevice> device = adapter.findDiscoveredDevice(address, addressType);
+    if( nullptr != device ) {
+        res = device->connectDefault();
+    } else {
+        whitelisted = adapter.addDeviceToWhitelist(address, addressType, HCIWhitelistConnectType::HCI_AUTO_CONN_ALWAYS);
+        res = whitelisted ? HCIStatusCode::SUCCESS : HCIStatusCode::INTERNAL_FAILURE;
+    }
+    {
+        const std::lock_guard<std::recursive_mutex> lock(mtx_devices); // RAII-style acquire and relinquish via destructor
+        auto it = devices.find( DeviceKey(address, addressType) );
+        if( it != devices.end() && idx == it->second.assignedAdapter ) {
+            DeviceInfo & info = it->second;
+            info.whitelisted = info.whitelisted || whitelisted;
+            if( HCIStatusCode::SUCCESS != res && assignedNow && !info.connected && !info.whitelisted ) {
+                info.assignedAdapter = -1;
+            }
+        }
+    }
+    return res;
+}
+
+bool DBTAdapterCoordinator::release(const EUI48 & address, const BDAddressType addressType) {
+    int idx;
+    bool whitelisted;
+    std::shared_ptr<DBTDevice> device;
+    {
+        const std::lock_guard<std::recursive_mutex> lock(mtx_devices); // RAII-style acquire and relinquish via destructor
+        auto it = devices.find( DeviceKey(address, addressType) );
+        if( it == devices.end() || 0 > it->second.assignedAdapter ) {
+            return false;
+        }
+        DeviceInfo & info = it->second;
+        idx = info.assignedAdapter;
+        whitelisted = info.whitelisted;
+        device = info.device.lock();
+        info.assignedAdapter = -1;
+        info.whitelisted = false;
+    }
+    if( whitelisted ) {
+        adapters[idx]->removeDeviceFromWhitelist(address, addressType);
+    }
+    if( nullptr != device ) {
+        device->disconnect();
+    }
+    return true;
+}
+
+std::string DBTAdapterCoordinator::toString() {
+    const int scanner = getScanningAdapter();
+    const std::lock_guard<std::recursive_mutex> lock(mtx_devices); // RAII-style acquire and relinquish via destructor
+    const std::vector<int> assigned = getAssignedCountsLocked();
+    std::string assignedStr;
+    for(size_t i=0; i<assigned.size(); i++) {
+        assignedStr += ( 0 < i ? ", " : "" ) + std::to_string(assigned[i]);
+    }
+    return "DBTAdapterCoordinator["+std::to_string(adapters.size())+" adapter, scanning "+std::to_string(scanner)+
+           ", "+std::to_string(devices.size())+" devices, assigned ["+assignedStr+"]]";
+}
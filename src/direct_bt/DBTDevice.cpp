@@ -51,6 +51,8 @@ DBTDevice::DBTDevice(DBTAdapter & a, EInfoReport const & r)
     hciConnHandle = 0;
     isConnected = false;
     allowDisconnect = false;
+    connProfile = LEConnProfile::DEFAULT;
+    bulkTransferCount = 0;
     if( !r.isSet(EIRDataType::BDADDR) ) {
         throw IllegalArgumentException("Address not set: "+r.toString(), E_FILE_LINE);
     }
@@ -324,6 +326,10 @@ HCIStatusCode DBTDevice::connectLE(uint16_t le_scan_interval, uint16_t le_scan_w
                                       le_scan_interval, le_scan_window, conn_interval_min, conn_interval_max,
                                       conn_latency, supervision_timeout);
     allowDisconnect = true;
+    if( HCIStatusCode::SUCCESS == status ) {
+        // Connecting, exempt from the whitelist's controller eviction
+        adapter.getManager().whitelistDeviceConnected(adapter.dev_id, address, true);
+    }
 #if 0
     if( HCIStatusCode::CONNECTION_ALREADY_EXISTS == status ) {
         INFO_PRINT("DBTDevice::connectLE: Connection already exists: status 0x%2.2X (%s) on %s",
@@ -373,6 +379,10 @@ HCIStatusCode DBTDevice::connectBREDR(const uint16_t pkt_type, const uint16_t cl
     }
     HCIStatusCode status = hci->create_conn(address, pkt_type, clock_offset, role_switch);
     allowDisconnect = true;
+    if( HCIStatusCode::SUCCESS == status ) {
+        // Connecting, exempt from the whitelist's controller eviction
+        adapter.getManager().whitelistDeviceConnected(adapter.dev_id, address, true);
+    }
     if ( HCIStatusCode::SUCCESS != status ) {
         ERR_PRINT("DBTDevice::connectBREDR: Could not create connection: status 0x%2.2X (%s), errno %d %s on %s",
                 static_cast<uint8_t>(status), getHCIStatusCodeString(status).c_str(), errno, strerror(errno), toString().c_str());
@@ -417,6 +427,100 @@ void DBTDevice::notifyDisconnected() {
     hciConnHandle = 0;
 }
 
+void DBTDevice::negotiateLELink() {
+    if( BDAddressType::BDADDR_BREDR == addressType || 0 == hciConnHandle ) {
+        return;
+    }
+    std::shared_ptr<HCIHandler> hci = adapter.getHCI();
+    if( nullptr == hci || !hci->isOpen() || !HCIEnv::get().HCI_LE_LINK_NEGOTIATE ) {
+        return;
+    }
+    const uint16_t handle = hciConnHandle;
+    if( 0 < hci->getLEMaxTxOctets() ) {
+        const HCIStatusCode status = hci->le_set_data_len(handle, hci->getLEMaxTxOctets(), hci->getLEMaxTxTime());
+        if( HCIStatusCode::SUCCESS != status ) {
+            INFO_PRINT("DBTDevice::negotiateLELink: le_set_data_len %u octets: 0x%X (%s), %s",
+                    hci->getLEMaxTxOctets(), static_cast<uint8_t>(status), getHCIStatusCodeString(status).c_str(), toString().c_str());
+        }
+    }
+    if( isLEFeaturesBitSet(hci->getLEFeatures(), LE_Features::LE_2M_PHY) ) {
+        const HCIStatusCode status = hci->le_set_phy(handle, LE_PHYs::LE_2M, LE_PHYs::LE_2M);
+        if( HCIStatusCode::SUCCESS != status ) {
+            INFO_PRINT("DBTDevice::negotiateLELink: le_set_phy: 0x%X (%s), %s",
+                    static_cast<uint8_t>(status), getHCIStatusCodeString(status).c_str(), toString().c_str());
+        }
+    }
+}
+
+HCIStatusCode DBTDevice::updateConnectionParameter(const LEConnParam & param) {
+    if( BDAddressType::BDADDR_BREDR == addressType ) {
+        ERR_PRINT("DBTDevice::updateConnectionParameter: Not an LE device: %s", toString().c_str());
+        return HCIStatusCode::UNSUPPORTED_FEATURE_OR_PARAM_VALUE;
+    }
+    const uint16_t handle = hciConnHandle;
+    if( !isConnected || 0 == handle ) {
+        DBG_PRINT("DBTDevice::updateConnectionParameter: Not connected: %s", toString().c_str());
+        return HCIStatusCode::UNKNOWN_CONNECTION_IDENTIFIER;
+    }
+    std::shared_ptr<HCIHandler> hci = adapter.getHCI();
+    if( nullptr == hci || !hci->isOpen() ) {
+        ERR_PRINT("DBTDevice::updateConnectionParameter: HCI not available: %s", toString().c_str());
+        return HCIStatusCode::INTERNAL_FAILURE;
+    }
+    const HCIStatusCode status = hci->le_conn_update(handle, param.conn_interval_min, param.conn_interval_max,
+                                                     param.conn_latency, param.supervision_timeout);
+    if( HCIStatusCode::SUCCESS != status ) {
+        INFO_PRINT("DBTDevice::updateConnectionParameter: %s: 0x%X (%s), %s", param.toString().c_str(),
+                static_cast<uint8_t>(status), getHCIStatusCodeString(status).c_str(), toString().c_str());
+    }
+    return status;
+}
+
+HCIStatusCode DBTDevice::setConnectionProfile(const LEConnProfile profile) {
+    HCIStatusCode status;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_connParam); // RAII-style acquire and relinquish via destructor
+        connProfile = profile;
+        if( 0 < bulkTransferCount || !isConnected ) {
+            return HCIStatusCode::SUCCESS; // deferred
+        }
+        status = updateConnectionParameter( getLEConnParam(profile) );
+    }
+    if( HCIStatusCode::SUCCESS == status ) {
+        restartGATTRTTStats();
+    }
+    return status;
+}
+
+LEConnProfile DBTDevice::getConnectionProfile() {
+    const std::lock_guard<std::mutex> lock(mtx_connParam); // RAII-style acquire and relinquish via destructor
+    return connProfile;
+}
+
+bool DBTDevice::beginBulkTransfer() {
+    const std::lock_guard<std::mutex> lock(mtx_connParam); // RAII-style acquire and relinquish via destructor
+    if( 0 == bulkTransferCount++ && LEConnProfile::BULK_TRANSFER != connProfile && isConnected ) {
+        return HCIStatusCode::SUCCESS == updateConnectionParameter( getLEConnParam(LEConnProfile::BULK_TRANSFER) );
+    }
+    return false;
+}
+
+bool DBTDevice::endBulkTransfer() {
+    const std::lock_guard<std::mutex> lock(mtx_connParam); // RAII-style acquire and relinquish via destructor
+    if( 0 < bulkTransferCount && 0 == --bulkTransferCount && LEConnProfile::BULK_TRANSFER != connProfile && isConnected ) {
+        return HCIStatusCode::SUCCESS == updateConnectionParameter( getLEConnParam(connProfile) );
+    }
+    return false;
+}
+
+void DBTDevice::restartGATTRTTStats() {
+    // Not under mtx_connParam, as connectGATT() acquires mtx_gatt before mtx_connParam
+    const std::lock_guard<std::recursive_mutex> lock(mtx_gatt); // RAII-style acquire and relinquish via destructor
+    if( nullptr != gattHandler ) {
+        gattHandler->restartRTTStats();
+    }
+}
+
 HCIStatusCode DBTDevice::disconnect(const bool fromDisconnectCB, const bool ioErrorCause, const HCIStatusCode reason) {
     // Avoid disconnect re-entry -> potential deadlock
     bool expConn = true; // C++11, exp as value since C++20
@@ -435,6 +539,7 @@ HCIStatusCode DBTDevice::disconnect(const bool fromDisconnectCB, const bool ioEr
             allowDisconnect.load(), isConnected.load(), fromDisconnectCB, ioErrorCause,
             static_cast<uint8_t>(reason), getHCIStatusCodeString(reason).c_str(),
             (nullptr != gattHandler), uint16HexString(hciConnHandle).c_str());
+    disconnectL2CAPChannels();
     disconnectGATT();
 
     std::shared_ptr<HCIHandler> hci = adapter.getHCI();
@@ -476,6 +581,7 @@ exit:
 void DBTDevice::remove() {
     disconnect(false /* fromDisconnectCB */, false /* ioErrorCause */, HCIStatusCode::REMOTE_USER_TERMINATED_CONNECTION);
     adapter.removeConnectedDevice(*this); // usually done in DBTAdapter::mgmtEvDeviceDisconnectedHCI
+    adapter.getManager().whitelistDeviceConnected(adapter.dev_id, address, false); // a pending connect may not be tracked yet
     adapter.removeDiscoveredDevice(*this); // usually done in DBTAdapter::mgmtEvDeviceDisconnectedHCI
     releaseSharedInstance();
 }
@@ -499,6 +605,14 @@ std::shared_ptr<GATTHandler> DBTDevice::connectGATT() {
         return nullptr;
     }
 
+    negotiateLELink();
+    {
+        const std::lock_guard<std::mutex> lockParam(mtx_connParam); // RAII-style acquire and relinquish via destructor
+        if( LEConnProfile::DEFAULT != connProfile && 0 == bulkTransferCount ) {
+            updateConnectionParameter( getLEConnParam(connProfile) );
+        }
+    }
+
     gattHandler = std::shared_ptr<GATTHandler>(new GATTHandler(sharedInstance));
     if( !gattHandler->connect() ) {
         DBG_PRINT("DBTDevice::connectGATT: Connection failed");
@@ -513,6 +627,15 @@ std::shared_ptr<GATTHandler> DBTDevice::getGATTHandler() {
 }
 
 std::vector<std::shared_ptr<GATTService>> DBTDevice::getGATTServices() {
+    return getGATTServices(std::vector<std::shared_ptr<const uuid_t>>());
+}
+
+std::vector<std::shared_ptr<GATTService>> DBTDevice::getGATTServices(const std::vector<std::shared_ptr<const uuid_t>> & serviceFilter) {
+    return getGATTServices(serviceFilter, std::vector<std::shared_ptr<const uuid_t>>());
+}
+
+std::vector<std::shared_ptr<GATTService>> DBTDevice::getGATTServices(const std::vector<std::shared_ptr<const uuid_t>> & serviceFilter,
+                                                                     const std::vector<std::shared_ptr<const uuid_t>> & characteristicFilter) {
     const std::lock_guard<std::recursive_mutex> lock(mtx_gatt); // RAII-style acquire and relinquish via destructor
     try {
         if( nullptr == gattHandler || !gattHandler->isOpen() ) {
@@ -523,13 +646,20 @@ std::vector<std::shared_ptr<GATTService>> DBTDevice::getGATTServices() {
             }
         }
         std::vector<std::shared_ptr<GATTService>> & gattServices = gattHandler->getServices(); // reference of the GATTHandler's list
-        if( gattServices.size() > 0 ) { // reuse previous discovery result
-            return gattServices;
+        if( gattServices.size() > 0 ) {
+            if( !gattHandler->isServicesChanged() ) { // reuse previous discovery result
+                return gattServices;
+            }
+            // Service Changed, previous discovery result is stale
+            INFO_PRINT("DBTDevice::getGATTServices: Service Changed -> rediscover: %s", toString().c_str());
+            gattServices.clear();
+            gattGenericAccess = nullptr;
         }
-        gattServices = gattHandler->discoverCompletePrimaryServices(); // same reference of the GATTHandler's list
+        gattServices = gattHandler->discoverCompletePrimaryServices(serviceFilter, characteristicFilter); // same reference of the GATTHandler's list
         if( gattServices.size() == 0 ) { // nothing discovered
             return gattServices;
         }
+        restoreSubscriptions(gattServices);
         // discovery success, retrieve and parse GenericAccess
         gattGenericAccess = gattHandler->getGenericAccess(gattServices);
         if( nullptr != gattGenericAccess ) {
@@ -587,6 +717,34 @@ bool DBTDevice::pingGATT() {
     return false;
 }
 
+bool DBTDevice::readCharacteristicValues(const std::vector<GATTCharacteristicRef> & characteristics, std::vector<POctets> & res) {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_gatt); // RAII-style acquire and relinquish via destructor
+    try {
+        if( nullptr == gattHandler || !gattHandler->isOpen() ) {
+            INFO_PRINT("DBTDevice::readCharacteristicValues: GATTHandler not connected on %s", toString().c_str());
+            return false;
+        }
+        return gattHandler->readCharacteristicValues(characteristics, res);
+    } catch (std::exception &e) {
+        INFO_PRINT("DBTDevice::readCharacteristicValues: Potential disconnect, exception: '%s' on %s", e.what(), toString().c_str());
+    }
+    return false;
+}
+
+bool DBTDevice::writeCharacteristicValues(const std::vector<GATTCharacteristicRef> & characteristics, const std::vector<POctets> & values, const bool reliable) {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_gatt); // RAII-style acquire and relinquish via destructor
+    try {
+        if( nullptr == gattHandler || !gattHandler->isOpen() ) {
+            INFO_PRINT("DBTDevice::writeCharacteristicValues: GATTHandler not connected on %s", toString().c_str());
+            return false;
+        }
+        return gattHandler->writeCharacteristicValues(characteristics, values, reliable);
+    } catch (std::exception &e) {
+        INFO_PRINT("DBTDevice::writeCharacteristicValues: Potential disconnect, exception: '%s' on %s", e.what(), toString().c_str());
+    }
+    return false;
+}
+
 std::shared_ptr<GenericAccess> DBTDevice::getGATTGenericAccess() {
     const std::lock_guard<std::recursive_mutex> lock(mtx_gatt); // RAII-style acquire and relinquish via destructor
     return gattGenericAccess;
@@ -608,6 +766,50 @@ void DBTDevice::disconnectGATT() {
     DBG_PRINT("DBTDevice::disconnectGATT: End");
 }
 
+std::shared_ptr<L2CAPComm> DBTDevice::connectL2CAPChannel(const uint16_t psm, const uint16_t rxMTU, const int rxBufferSize) {
+    if( L2CAP_PSM_UNDEF == psm || L2CAP_PSM_LE_DYN_END < psm ) {
+        throw IllegalArgumentException("DBTDevice::connectL2CAPChannel: LE_PSM "+uint16HexString(psm)+" out of range: "+toString(), E_FILE_LINE);
+    }
+    std::shared_ptr<DBTDevice> sharedInstance = getSharedInstance();
+    if( nullptr == sharedInstance ) {
+        throw InternalError("DBTDevice::connectL2CAPChannel: Device unknown to adapter and not tracked: "+toString(), E_FILE_LINE);
+    }
+    if( !isConnected ) {
+        ERR_PRINT("DBTDevice::connectL2CAPChannel: Device not connected: %s", toString().c_str());
+        return nullptr;
+    }
+    std::shared_ptr<L2CAPComm> channel = std::make_shared<L2CAPComm>(sharedInstance, psm, L2CAP_CID_UNDEF, L2CAPComm::Mode::LE_FLOWCTL);
+    channel->setFlowControlParameter(rxMTU, rxBufferSize);
+    if( !channel->connect() ) {
+        ERR_PRINT("DBTDevice::connectL2CAPChannel: Could not connect LE_PSM %s: %s", uint16HexString(psm).c_str(), toString().c_str());
+        return nullptr;
+    }
+    DBG_PRINT("DBTDevice::connectL2CAPChannel: LE_PSM %s, MTU tx %d, rx %d: %s",
+              uint16HexString(psm).c_str(), channel->getTxMTU(), channel->getRxMTU(), toString().c_str());
+
+    const std::lock_guard<std::recursive_mutex> lock(mtx_gatt); // RAII-style acquire and relinquish via destructor
+    // drop released channels
+    l2capChannels.erase(std::remove_if(l2capChannels.begin(), l2capChannels.end(),
+                                       [](const std::weak_ptr<L2CAPComm> & c) { return c.expired(); }),
+                        l2capChannels.end());
+    l2capChannels.push_back(channel);
+    return channel;
+}
+
+void DBTDevice::disconnectL2CAPChannels() {
+    std::vector<std::weak_ptr<L2CAPComm>> channels;
+    {
+        const std::lock_guard<std::recursive_mutex> lock(mtx_gatt); // RAII-style acquire and relinquish via destructor
+        channels.swap(l2capChannels);
+    }
+    for(size_t i=0; i<channels.size(); i++) {
+        std::shared_ptr<L2CAPComm> channel = channels[i].lock();
+        if( nullptr != channel ) {
+            channel->disconnect();
+        }
+    }
+}
+
 bool DBTDevice::addCharacteristicListener(std::shared_ptr<GATTCharacteristicListener> l) {
     std::shared_ptr<GATTHandler> gatt = getGATTHandler();
     if( nullptr == gatt ) {
@@ -646,3 +848,239 @@ int DBTDevice::removeAllCharacteristicListener() {
     }
     return gatt->removeAllCharacteristicListener();
 }
+
+bool DBTDevice::toSubscription(const std::vector<std::shared_ptr<GATTService>> & services, const GATTCharacteristic & c,
+                               const uint16_t cccValue, Subscription & res) {
+    std::shared_ptr<GATTService> service = c.getServiceUnchecked();
+    if( nullptr == service ) {
+        return false;
+    }
+    int instance = 0;
+    for(size_t i=0; i<services.size(); i++) {
+        if( nullptr == services[i] || *services[i]->type != *service->type ) {
+            continue;
+        }
+        const std::vector<GATTCharacteristicRef> & characteristics = services[i]->characteristicList;
+        for(size_t j=0; j<characteristics.size(); j++) {
+            if( characteristics[j].get() == &c ) {
+                res = Subscription { service->type, c.value_type, instance, cccValue };
+                return true;
+            }
+            if( *characteristics[j]->value_type == *c.value_type ) {
+                instance++;
+            }
+        }
+    }
+    return false;
+}
+
+GATTCharacteristicRef DBTDevice::findSubscribed(const std::vector<std::shared_ptr<GATTService>> & services, const Subscription & s) {
+    int instance = 0;
+    for(size_t i=0; i<services.size(); i++) {
+        if( nullptr == services[i] || *services[i]->type != *s.serviceType ) {
+            continue;
+        }
+        const std::vector<GATTCharacteristicRef> & characteristics = services[i]->characteristicList;
+        for(size_t j=0; j<characteristics.size(); j++) {
+            if( *characteristics[j]->value_type == *s.valueType ) {
+                if( instance == s.instance ) {
+                    return characteristics[j];
+                }
+                instance++;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void DBTDevice::restoreSubscriptions(const std::vector<std::shared_ptr<GATTService>> & services) {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_gatt); // RAII-style acquire and relinquish via destructor
+    if( 0 == subscriptions.size() || nullptr == gattHandler || !gattHandler->isOpen() ) {
+        return;
+    }
+    try {
+        std::vector<GATTCharacteristicRef> resolved;
+        std::vector<uint16_t> cccValues;
+        std::vector<uint16_t> readHandles;
+        std::vector<int> readSizes;
+        for(size_t i=0; i<subscriptions.size(); i++) {
+            const Subscription & s = subscriptions[i];
+            GATTCharacteristicRef c = findSubscribed(services, s);
+            GATTDescriptorRef cccd = nullptr != c ? c->getClientCharacteristicConfig() : nullptr;
+            if( nullptr == cccd ) {
+                // Remembered for a later discovery, e.g. using another service filter
+                DBG_PRINT("DBTDevice::restoreSubscriptions: Unresolved characteristic %s of service %s on %s",
+                        s.valueType->toString().c_str(), s.serviceType->toString().c_str(), toString().c_str());
+                continue;
+            }
+            resolved.push_back(c);
+            cccValues.push_back(s.cccValue);
+            readHandles.push_back(cccd->handle);
+            readSizes.push_back(2);
+        }
+        std::vector<POctets> current;
+        gattHandler->readValues(readHandles, readSizes, current);
+
+        std::vector<GATTCharacteristicRef> pending;
+        std::vector<uint16_t> writeHandles;
+        std::vector<POctets> writeValues;
+        for(size_t i=0; i<resolved.size(); i++) {
+            GATTCharacteristic & c = *resolved[i];
+            if( i < current.size() && 2 <= current[i].getSize() && current[i].get_uint16(0) == cccValues[i] ) {
+                // persisted by the bonded peer
+                c.enabledNotifyState = 0 != ( cccValues[i] & 0x0001 );
+                c.enabledIndicateState = 0 != ( cccValues[i] & 0x0002 );
+                continue;
+            }
+            POctets value(2, 2);
+            value.put_uint16(0, cccValues[i]);
+            pending.push_back(resolved[i]);
+            writeHandles.push_back(readHandles[i]);
+            writeValues.push_back(value);
+        }
+        std::vector<bool> res;
+        const bool ok = gattHandler->writeValuesPipelined(writeHandles, writeValues, res);
+        for(size_t i=0; i<pending.size(); i++) {
+            if( i < res.size() && res[i] ) {
+                GATTCharacteristic & c = *pending[i];
+                const uint16_t cccValue = writeValues[i].get_uint16(0);
+                c.getClientCharacteristicConfig()->value.resize(2, 2);
+                c.getClientCharacteristicConfig()->value.put_uint16(0, cccValue);
+                c.enabledNotifyState = 0 != ( cccValue & 0x0001 );
+                c.enabledIndicateState = 0 != ( cccValue & 0x0002 );
+            }
+        }
+        DBG_PRINT("DBTDevice::restoreSubscriptions: %zu subscriptions, %zu resolved, %zu written, ok %d on %s",
+                subscriptions.size(), resolved.size(), writeHandles.size(), ok, toString().c_str());
+    } catch (std::exception &e) {
+        INFO_PRINT("DBTDevice::restoreSubscriptions: Potential disconnect, exception: '%s' on %s", e.what(), toString().c_str());
+    }
+}
+
+int DBTDevice::subscribe(const std::vector<GATTCharacteristicRef> & characteristics) {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_gatt); // RAII-style acquire and relinquish via destructor
+    if( nullptr == gattHandler || !gattHandler->isOpen() ) {
+        throw IllegalStateException("Device's GATTHandle not connected: "+toString(), E_FILE_LINE);
+    }
+    int count = 0;
+    std::vector<GATTCharacteristicRef> pending;
+    std::vector<uint16_t> handles;
+    std::vector<POctets> values;
+    for(size_t i=0; i<characteristics.size(); i++) {
+        GATTCharacteristic & c = *characteristics[i];
+        const bool enableNotification = c.hasProperties(GATTCharacteristic::PropertyBitVal::Notify);
+        const bool enableIndication = !enableNotification && c.hasProperties(GATTCharacteristic::PropertyBitVal::Indicate);
+        GATTDescriptorRef cccd = c.getClientCharacteristicConfig();
+        if( ( !enableNotification && !enableIndication ) || nullptr == cccd ) {
+            DBG_PRINT("DBTDevice::subscribe: Neither Notify nor Indicate property or no CCCD: %s", c.toString().c_str());
+            continue;
+        }
+        const uint16_t cccValue = enableNotification | ( enableIndication << 1 );
+        Subscription sub;
+        if( toSubscription(gattHandler->getServices(), c, cccValue, sub) ) {
+            bool known = false;
+            for(size_t k=0; k<subscriptions.size(); k++) {
+                if( subscriptions[k].matches(sub) ) {
+                    subscriptions[k].cccValue = cccValue;
+                    known = true;
+                    break;
+                }
+            }
+            if( !known ) {
+                subscriptions.push_back( sub );
+            }
+        } else {
+            WARN_PRINT("DBTDevice::subscribe: Not remembered, service unknown: %s", c.toString().c_str());
+        }
+        if( enableNotification == c.enabledNotifyState && enableIndication == c.enabledIndicateState ) {
+            count++; // unchanged
+            continue;
+        }
+        POctets value(2, 2);
+        value.put_uint16(0, cccValue);
+        pending.push_back(characteristics[i]);
+        handles.push_back(cccd->handle);
+        values.push_back(value);
+    }
+    std::vector<bool> res;
+    try {
+        gattHandler->writeValuesPipelined(handles, values, res);
+    } catch (std::exception &e) {
+        INFO_PRINT("DBTDevice::subscribe: Potential disconnect, exception: '%s' on %s", e.what(), toString().c_str());
+    }
+    for(size_t i=0; i<pending.size(); i++) {
+        if( i < res.size() && res[i] ) {
+            GATTCharacteristic & c = *pending[i];
+            GATTDescriptorRef cccd = c.getClientCharacteristicConfig();
+            cccd->value.resize(2, 2);
+            cccd->value.put_uint16(0, values[i].get_uint16(0));
+            c.enabledNotifyState = 0 != ( values[i].get_uint16(0) & 0x0001 );
+            c.enabledIndicateState = 0 != ( values[i].get_uint16(0) & 0x0002 );
+            count++;
+        }
+    }
+    return count;
+}
+
+int DBTDevice::unsubscribe(const std::vector<GATTCharacteristicRef> & characteristics) {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_gatt); // RAII-style acquire and relinquish via destructor
+    std::vector<GATTCharacteristicRef> pending;
+    std::vector<uint16_t> handles;
+    std::vector<POctets> values;
+    for(size_t i=0; i<characteristics.size(); i++) {
+        GATTCharacteristic & c = *characteristics[i];
+        Subscription sub;
+        const std::vector<std::shared_ptr<GATTService>> services = nullptr != gattHandler ? gattHandler->getServices() :
+                std::vector<std::shared_ptr<GATTService>> { c.getServiceUnchecked() }; // best effort while disconnected
+        if( toSubscription(services, c, 0, sub) ) {
+            for(auto it = subscriptions.begin(); it != subscriptions.end(); ) {
+                if( it->matches(sub) ) {
+                    it = subscriptions.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        GATTDescriptorRef cccd = c.getClientCharacteristicConfig();
+        if( nullptr == cccd ) {
+            continue;
+        }
+        pending.push_back(characteristics[i]);
+        handles.push_back(cccd->handle);
+        values.push_back(POctets(2, 2));
+        values.back().put_uint16(0, 0);
+    }
+    if( nullptr == gattHandler || !gattHandler->isOpen() ) {
+        // OK to have GATTHandler being shutdown @ disable
+        DBG_PRINT("DBTDevice::unsubscribe: GATTHandler not connected on %s", toString().c_str());
+        return 0;
+    }
+    int count = 0;
+    std::vector<bool> res;
+    try {
+        gattHandler->writeValuesPipelined(handles, values, res);
+    } catch (std::exception &e) {
+        INFO_PRINT("DBTDevice::unsubscribe: Potential disconnect, exception: '%s' on %s", e.what(), toString().c_str());
+    }
+    for(size_t i=0; i<pending.size(); i++) {
+        if( i < res.size() && res[i] ) {
+            GATTCharacteristic & c = *pending[i];
+            c.getClientCharacteristicConfig()->value.resize(2, 2);
+            c.getClientCharacteristicConfig()->value.put_uint16(0, 0);
+            c.enabledNotifyState = false;
+            c.enabledIndicateState = false;
+            count++;
+        }
+    }
+    return count;
+}
+
+void DBTDevice::clearSubscriptions() {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_gatt); // RAII-style acquire and relinquish via destructor
+    subscriptions.clear();
+}
+
+int DBTDevice::getSubscriptionCount() {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_gatt); // RAII-style acquire and relinquish via destructor
+    return subscriptions.size();
+}
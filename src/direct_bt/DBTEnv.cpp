@@ -29,6 +29,12 @@
 #include <cstdint>
 #include <vector>
 #include <cstdio>
+#include <algorithm>
+
+extern "C" {
+    #include <unistd.h>
+    #include <sched.h>
+}
 
 #include "direct_bt/DBTEnv.hpp"
 #include "direct_bt/dbt_debug.hpp"
@@ -153,6 +159,63 @@ uint32_t DBTEnv::getUint32Property(const std::string & name, const uint32_t defa
     }
 }
 
+std::vector<int> DBTEnv::getCPUSetProperty(const std::string & name) {
+    std::vector<int> res;
+    const std::string value = getProperty(name);
+    if( 0 == value.length() ) {
+        return res;
+    }
+    const int cpuCount = std::max<int>(1, sysconf(_SC_NPROCESSORS_CONF));
+    size_t start = 0;
+    while( start <= value.length() ) {
+        size_t end = value.find(',', start);
+        if( std::string::npos == end ) {
+            end = value.length();
+        }
+        std::string elem = value.substr(start, end-start);
+        trimInPlace(elem);
+        start = end + 1;
+        if( 0 == elem.length() ) {
+            continue;
+        }
+        char *endptr = NULL;
+        const long first = strtol(elem.c_str(), &endptr, 10);
+        long last = first;
+        if( '-' == *endptr ) {
+            last = strtol(endptr+1, &endptr, 10);
+        }
+        if( *endptr != '\0' || elem.c_str() == endptr || 0 > first || first > last || last >= cpuCount ) {
+            ERR_PRINT("DBTEnv::getCPUSetProperty %s: %s (invalid element '%s' of %d cpus) -> none",
+                    name.c_str(), value.c_str(), elem.c_str(), cpuCount);
+            return std::vector<int>();
+        }
+        for(long i=first; i<=last; i++) {
+            res.push_back( (int)i );
+        }
+    }
+    COND_PRINT(debug, "DBTEnv::getCPUSetProperty %s: %s -> %zd cpus", name.c_str(), value.c_str(), res.size());
+    return res;
+}
+
+bool DBTEnv::setThreadAffinity(const pthread_t thread, const std::string & name) {
+    const std::vector<int> cpus = getCPUSetProperty(name);
+    if( 0 == cpus.size() ) {
+        return false;
+    }
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for(size_t i=0; i<cpus.size(); i++) {
+        CPU_SET(cpus[i], &cpuset);
+    }
+    const int err = pthread_setaffinity_np(thread, sizeof(cpuset), &cpuset);
+    if( 0 != err ) {
+        ERR_PRINT("DBTEnv::setThreadAffinity %s: Could not bind thread to %zd cpus, error %d", name.c_str(), cpus.size(), err);
+        return false;
+    }
+    DBG_PRINT("DBTEnv::setThreadAffinity %s: Bound thread to %zd cpus", name.c_str(), cpus.size());
+    return true;
+}
+
 void DBTEnv::envSet(std::string prefixDomain, std::string basepair) {
     trimInPlace(basepair);
     if( basepair.length() > 0 ) {
@@ -31,6 +31,7 @@
 #include <cstdio>
 
 #include <algorithm>
+#include <exception>
 
 // #define PERF_PRINT_ON 1
 #include <dbt_debug.hpp>
@@ -57,12 +58,27 @@ MgmtEnv::MgmtEnv()
   MGMT_READER_THREAD_POLL_TIMEOUT( DBTEnv::getInt32Property("direct_bt.mgmt.reader.timeout", 10000, 1500 /* min */, INT32_MAX /* max */) ),
   MGMT_COMMAND_REPLY_TIMEOUT( DBTEnv::getInt32Property("direct_bt.mgmt.cmd.timeout", 3000, 1500 /* min */, INT32_MAX /* max */) ),
   MGMT_EVT_RING_CAPACITY( DBTEnv::getInt32Property("direct_bt.mgmt.ringsize", 64, 64 /* min */, 1024 /* max */) ),
+  MGMT_CMD_INFLIGHT_CAPACITY( DBTEnv::getInt32Property("direct_bt.mgmt.cmd.inflight", 64, 1 /* min */, 1024 /* max */) ),
   DEBUG_EVENT( DBTEnv::getBooleanProperty("direct_bt.debug.mgmt.event", false) ),
-  MGMT_READ_PACKET_MAX_RETRY( MGMT_EVT_RING_CAPACITY )
+  MGMT_ADAPTER_EVENT_LOOPS( DBTEnv::getBooleanProperty("direct_bt.mgmt.adapter.loops", false) ),
+  MGMT_ADAPTER_EVENT_QUEUE_CAPACITY( DBTEnv::getInt32Property("direct_bt.mgmt.adapter.queuesize", 256, 64 /* min */, 8192 /* max */) ),
+  MGMT_WHITELIST_CONTROLLER_CAPACITY( DBTEnv::getInt32Property("direct_bt.mgmt.whitelist.capacity", 0, 0 /* min */, INT32_MAX /* max */) )
 {
 }
 
 const pid_t DBTManager::pidSelf = getpid();
+
+std::string DBTManager::StartupTimings::toString() const {
+    std::string adapterStr;
+    for(size_t i=0; i<initAdapter.size(); i++) {
+        if( 0 < i ) {
+            adapterStr.append(", ");
+        }
+        adapterStr.append(std::to_string(initAdapter[i]));
+    }
+    return "StartupTimings[total "+std::to_string(total)+" ms: reader "+std::to_string(readerStart)+
+           ", info "+std::to_string(readInfo)+", adapter "+std::to_string(initAdapters)+" ["+adapterStr+"] ms]";
+}
 std::mutex DBTManager::mtx_singleton;
 
 void DBTManager::mgmtReaderThreadImpl() {
@@ -83,7 +99,7 @@ void DBTManager::mgmtReaderThreadImpl() {
             break;
         }
 
-        len = comm.read(rbuffer.get_wptr(), rbuffer.getSize(), env.MGMT_READER_THREAD_POLL_TIMEOUT);
+        len = comm.read(rbuffer.get_wptr(), rbuffer.getSize(), getPendingPollTimeout());
         if( 0 < len ) {
             const uint16_t paramSize = len >= 6 ? rbuffer.get_uint16(4) : 0;
             if( len < 6 + paramSize ) {
@@ -94,119 +110,418 @@ void DBTManager::mgmtReaderThreadImpl() {
             const MgmtEvent::Opcode opc = event->getOpcode();
             if( MgmtEvent::Opcode::CMD_COMPLETE == opc || MgmtEvent::Opcode::CMD_STATUS == opc ) {
                 COND_PRINT(env.DEBUG_EVENT, "DBTManager-IO RECV (CMD) %s", event->toString().c_str());
-                if( mgmtEventRing.isFull() ) {
-                    const int dropCount = mgmtEventRing.capacity()/4;
-                    mgmtEventRing.drop(dropCount);
-                    WARN_PRINT("DBTManager-IO RECV Drop (%d oldest elements of %d capacity, ring full)", dropCount, mgmtEventRing.capacity());
+                if( !completePending(event) ) {
+                    // This could occur due to an earlier timeout, i.e. the late reply naturally not-matching.
+                    COND_PRINT(env.DEBUG_EVENT, "DBTManager-IO RECV (CMD) no pending command (drop evt): %s", event->toString().c_str());
                 }
-                mgmtEventRing.putBlocking( event );
             } else {
                 // issue a callback
                 COND_PRINT(env.DEBUG_EVENT, "DBTManager-IO RECV (CB) %s", event->toString().c_str());
-                sendMgmtEvent(event);
+                if( !queueAdapterEvent(event) ) {
+                    sendMgmtEvent(event);
+                }
             }
-        } else if( ETIMEDOUT != errno && !mgmtReaderShallStop ) { // expected exits
+        } else if( ETIMEDOUT != errno && EINTR != errno && !mgmtReaderShallStop ) { // expected exits
             ERR_PRINT("DBTManager::reader: HCIComm read error");
         }
+        expirePending();
     }
 
-    INFO_PRINT("DBTManager::reader: Ended. Ring has %d entries flushed", mgmtEventRing.getSize());
+    INFO_PRINT("DBTManager::reader: Ended");
     mgmtReaderRunning = false;
-    mgmtEventRing.clear();
+    cancelPending();
+}
+
+void DBTManager::adapterEventLoopImpl(AdapterEventLoop & loop) {
+    DBG_PRINT("DBTManager::adapterEventLoop[%d]: Started", loop.dev_id);
+    while( true ) {
+        std::shared_ptr<MgmtEvent> event;
+        {
+            std::unique_lock<std::mutex> lock(loop.mtx); // RAII-style acquire and relinquish via destructor
+            while( !loop.shallStop && loop.queue.empty() ) {
+                loop.cv.wait(lock);
+            }
+            if( loop.shallStop ) {
+                break;
+            }
+            event = loop.queue.front();
+            loop.queue.pop_front();
+        }
+        sendMgmtEvent(event);
+    }
+    DBG_PRINT("DBTManager::adapterEventLoop[%d]: Ended", loop.dev_id);
+}
+
+void DBTManager::startAdapterEventLoops() {
+    std::shared_ptr<AdapterEventLoops> loops = std::make_shared<AdapterEventLoops>();
+    for(size_t i=0; i<adapterInfos.size(); i++) {
+        if( nullptr == adapterInfos[i] ) {
+            loops->push_back(nullptr);
+            continue;
+        }
+        std::shared_ptr<AdapterEventLoop> loop = std::make_shared<AdapterEventLoop>(adapterInfos[i]->dev_id);
+        loop->thread = std::thread(&DBTManager::adapterEventLoopImpl, this, std::ref(*loop));
+        DBTEnv::setAdapterThreadAffinity(loop->thread.native_handle(), loop->dev_id);
+        loops->push_back(loop);
+    }
+    std::atomic_store(&adapterEventLoops, std::shared_ptr<const AdapterEventLoops>(loops));
+}
+
+void DBTManager::stopAdapterEventLoops() {
+    const std::shared_ptr<const AdapterEventLoops> loops = std::atomic_load(&adapterEventLoops);
+    std::atomic_store(&adapterEventLoops, std::shared_ptr<const AdapterEventLoops>());
+    if( nullptr == loops ) {
+        return;
+    }
+    for(size_t i=0; i<loops->size(); i++) {
+        AdapterEventLoop * loop = (*loops)[i].get();
+        if( nullptr == loop ) {
+            continue;
+        }
+        {
+            const std::lock_guard<std::mutex> lock(loop->mtx); // RAII-style acquire and relinquish via destructor
+            loop->shallStop = true;
+            loop->queue.clear();
+            loop->cv.notify_all();
+        }
+        if( loop->thread.joinable() ) {
+            loop->thread.join();
+        }
+    }
+}
+
+bool DBTManager::queueAdapterEvent(std::shared_ptr<MgmtEvent> event) {
+    const std::shared_ptr<const AdapterEventLoops> loops = std::atomic_load(&adapterEventLoops);
+    const uint16_t dev_id = event->getDevID();
+    if( nullptr == loops || dev_id >= loops->size() || nullptr == (*loops)[dev_id] ) {
+        return false;
+    }
+    AdapterEventLoop & loop = *(*loops)[dev_id];
+    const std::lock_guard<std::mutex> lock(loop.mtx); // RAII-style acquire and relinquish via destructor
+    if( loop.shallStop ) {
+        return false;
+    }
+    if( static_cast<int32_t>(loop.queue.size()) >= env.MGMT_ADAPTER_EVENT_QUEUE_CAPACITY ) {
+        // Only DEVICE_FOUND events are dropped, state events like connection, settings and discovering must pass.
+        bool dropped = false;
+        if( MgmtEvent::Opcode::DEVICE_FOUND == event->getOpcode() ) {
+            dropped = true; // the new one, if no older one is queued
+            for(auto it = loop.queue.begin(); it != loop.queue.end(); it++) {
+                if( MgmtEvent::Opcode::DEVICE_FOUND == (*it)->getOpcode() ) {
+                    loop.queue.erase(it);
+                    dropped = false; // the oldest one
+                    break;
+                }
+            }
+            if( 0 == ( loop.droppedCount++ % env.MGMT_ADAPTER_EVENT_QUEUE_CAPACITY ) ) {
+                WARN_PRINT("DBTManager::adapterEventLoop[%d]: Queue full, dropped %d DEVICE_FOUND events", dev_id, loop.droppedCount);
+            }
+        }
+        if( dropped ) {
+            return true;
+        }
+    }
+    loop.queue.push_back(event);
+    loop.cv.notify_one();
+    return true;
 }
 
+/** Depth of sendMgmtEvent(..) on the current thread, allowing callbacks to modify the callbacks without awaiting themselves. */
+static thread_local int mgmtDispatchDepth = 0;
+
 void DBTManager::sendMgmtEvent(std::shared_ptr<MgmtEvent> event) {
-    const std::lock_guard<std::recursive_mutex> lock(mtx_callbackLists); // RAII-style acquire and relinquish via destructor
-    const int dev_id = event->getDevID();
-    MgmtAdapterEventCallbackList & mgmtEventCallbackList = mgmtAdapterEventCallbackLists[static_cast<uint16_t>(event->getOpcode())];
+    const uint16_t opc = static_cast<uint16_t>(event->getOpcode());
+    if( opc >= static_cast<uint16_t>(MgmtEvent::Opcode::MGMT_EVENT_TYPE_COUNT) ) {
+        return;
+    }
+    // Holding the snapshot marks it in use, see awaitDispatchQuiescence(..)
+    std::shared_ptr<const MgmtEventCallbackIndex> index = std::atomic_load(&mgmtEventCallbackIndex);
     int invokeCount = 0;
-    for (auto it = mgmtEventCallbackList.begin(); it != mgmtEventCallbackList.end(); ++it) {
-        if( 0 > it->getDevID() || dev_id == it->getDevID() ) {
+    if( nullptr != index ) {
+        const size_t slotAll = getCallbackIndexSlot(-1);
+        const size_t slotDev = getCallbackIndexSlot(event->getDevID());
+        const MgmtAdapterEventCallbackListRef lAll = slotAll < index->size() ? (*index)[slotAll][opc] : nullptr;
+        const MgmtAdapterEventCallbackListRef lDev = slotDev < index->size() ? (*index)[slotDev][opc] : nullptr;
+        const size_t sizeAll = nullptr != lAll ? lAll->size() : 0;
+        const size_t sizeDev = nullptr != lDev ? lDev->size() : 0;
+        size_t iAll = 0, iDev = 0;
+        mgmtDispatchDepth++;
+        // Merge both lists by their sequence number, i.e. invoke in registration order
+        while( iAll < sizeAll || iDev < sizeDev ) {
+            SequencedEventCallback & scb = ( iDev >= sizeDev || ( iAll < sizeAll && (*lAll)[iAll].seq < (*lDev)[iDev].seq ) ) ?
+                                           (*lAll)[iAll++] : (*lDev)[iDev++];
             try {
-                it->getCallback().invoke(event);
+                scb.acb.getCallback().invoke(event);
             } catch (std::exception &e) {
-                ERR_PRINT("DBTManager::sendMgmtEvent-CBs %d/%zd: MgmtAdapterEventCallback %s : Caught exception %s",
-                        invokeCount+1, mgmtEventCallbackList.size(),
-                        it->toString().c_str(), e.what());
+                ERR_PRINT("DBTManager::sendMgmtEvent-CBs %d: MgmtAdapterEventCallback %s : Caught exception %s",
+                        invokeCount+1, scb.acb.toString().c_str(), e.what());
             }
             invokeCount++;
         }
+        mgmtDispatchDepth--;
     }
-    COND_PRINT(env.DEBUG_EVENT, "DBTManager::sendMgmtEvent: Event %s -> %d/%zd callbacks", event->toString().c_str(), invokeCount, mgmtEventCallbackList.size());
+    if( nullptr != index && 0 < retiredCallbackIndexCount ) {
+        // A modification may await this index, release it while holding the lock to notify
+        const std::lock_guard<std::mutex> lock(mtx_dispatch); // RAII-style acquire and relinquish via destructor
+        index = nullptr;
+        cv_dispatch.notify_all();
+    }
+    COND_PRINT(env.DEBUG_EVENT, "DBTManager::sendMgmtEvent: Event %s -> %d callbacks", event->toString().c_str(), invokeCount);
     (void)invokeCount;
 }
 
-static void mgmthandler_sigaction(int sig, siginfo_t *info, void *ucontext) {
-    bool pidMatch = info->si_pid == DBTManager::pidSelf;
-    INFO_PRINT("DBTManager.sigaction: sig %d, info[code %d, errno %d, signo %d, pid %d, uid %d, fd %d], pid-self %d (match %d)",
-            sig, info->si_code, info->si_errno, info->si_signo,
-            info->si_pid, info->si_uid, info->si_fd,
-            DBTManager::pidSelf, pidMatch);
-    (void)ucontext;
+uint64_t DBTManager::publishCallbackIndex(const std::shared_ptr<const MgmtEventCallbackIndex> & index) {
+    std::shared_ptr<const MgmtEventCallbackIndex> old = std::atomic_exchange(&mgmtEventCallbackIndex, index);
+    const uint64_t version = ++callbackIndexVersion;
+    const std::lock_guard<std::mutex> lock(mtx_dispatch); // RAII-style acquire and relinquish via destructor
+    if( nullptr != old ) {
+        retiredCallbackIndices.push_back( RetiredCallbackIndex{ version, std::move(old) } );
+    }
+    pruneRetiredCallbackIndicesLocked(version);
+    return version;
+}
 
-    if( !pidMatch || SIGALRM != sig ) {
+bool DBTManager::pruneRetiredCallbackIndicesLocked(const uint64_t version) {
+    bool inUse = false;
+    for(auto it = retiredCallbackIndices.begin(); it != retiredCallbackIndices.end(); ) {
+        if( 1 == it->index.use_count() ) {
+            // Only referenced by its retirement, a dispatch can no longer load it
+            it = retiredCallbackIndices.erase(it);
+        } else {
+            inUse = inUse || it->version <= version;
+            ++it;
+        }
+    }
+    retiredCallbackIndexCount = static_cast<int>( retiredCallbackIndices.size() );
+    return inUse;
+}
+
+void DBTManager::awaitDispatchQuiescence(const uint64_t version) {
+    if( 0 < mgmtDispatchDepth ) {
+        // Invoked from within a callback, which would await itself
         return;
     }
-#if 0
-    // We do not de-install the handler on single use,
-    // as we act for multiple SIGALRM events within direct-bt
+    std::unique_lock<std::mutex> lock(mtx_dispatch); // RAII-style acquire and relinquish via destructor
+    while( pruneRetiredCallbackIndicesLocked(version) ) {
+        // A dispatch reading retiredCallbackIndexCount before its publication releases the index without notification,
+        // hence wait bounded.
+        cv_dispatch.wait_for(lock, std::chrono::milliseconds(10));
+    }
+}
+
+void DBTManager::SyncReply::complete(std::shared_ptr<MgmtEvent> e) {
+    const std::lock_guard<std::mutex> lock(mtx); // RAII-style acquire and relinquish via destructor
+    res = e;
+    done = true;
+    cv.notify_all();
+}
+
+std::shared_ptr<MgmtEvent> DBTManager::SyncReply::await(const int timeoutMS) {
+    std::unique_lock<std::mutex> lock(mtx); // RAII-style acquire and relinquish via destructor
+    if( !cv.wait_for(lock, std::chrono::milliseconds(timeoutMS), [&]{ return done; }) ) {
+        errno = ETIMEDOUT;
+        return nullptr;
+    }
+    if( nullptr == res ) {
+        errno = ETIMEDOUT;
+    }
+    return res;
+}
+
+static MgmtOpcode getReplyReqOpcode(const MgmtEvent & res) {
+    if( MgmtEvent::Opcode::CMD_COMPLETE == res.getOpcode() ) {
+        return static_cast<const MgmtEvtCmdComplete &>(res).getReqOpcode();
+    } else {
+        return static_cast<const MgmtEvtCmdStatus &>(res).getReqOpcode();
+    }
+}
+
+bool DBTManager::completePending(std::shared_ptr<MgmtEvent> res) {
+    const MgmtOpcode reqOpcode = getReplyReqOpcode(*res);
+    const uint16_t dev_id = res->getDevID();
+    std::shared_ptr<PendingCommand> done;
     {
-        struct sigaction sa_setup;
-        bzero(&sa_setup, sizeof(sa_setup));
-        sa_setup.sa_handler = SIG_DFL;
-        sigemptyset(&(sa_setup.sa_mask));
-        sa_setup.sa_flags = 0;
-        if( 0 != sigaction( SIGALRM, &sa_setup, NULL ) ) {
-            ERR_PRINT("DBTManager.sigaction: Resetting sighandler");
+        const std::lock_guard<std::mutex> lock(mtx_pending); // RAII-style acquire and relinquish via destructor
+        for(auto it = pendingCommands.begin(); it != pendingCommands.end(); it++) {
+            if( (*it)->opcode == reqOpcode && (*it)->dev_id == dev_id ) {
+                done = *it;
+                pendingCommands.erase(it);
+                break;
+            }
         }
     }
-#endif
+    if( nullptr == done ) {
+        return false;
+    }
+    try {
+        done->callback.invoke(res);
+    } catch (std::exception &e) {
+        ERR_PRINT("DBTManager::completePending: %s: Caught exception %s", res->toString().c_str(), e.what());
+    }
+    return true;
 }
 
-std::shared_ptr<MgmtEvent> DBTManager::sendWithReply(MgmtCommand &req) {
-    const std::lock_guard<std::recursive_mutex> lock(mtx_sendReply); // RAII-style acquire and relinquish via destructor
+void DBTManager::expirePending() {
+    std::vector<std::shared_ptr<PendingCommand>> expired;
     {
-        COND_PRINT(env.DEBUG_EVENT, "DBTManager-IO SENT %s", req.toString().c_str());
-        TROOctets & pdu = req.getPDU();
-        if ( comm.write( pdu.get_ptr(), pdu.getSize() ) < 0 ) {
-            ERR_PRINT("DBTManager::sendWithReply: HCIComm write error, req %s", req.toString().c_str());
-            return nullptr;
+        const std::lock_guard<std::mutex> lock(mtx_pending); // RAII-style acquire and relinquish via destructor
+        if( pendingCommands.empty() ) {
+            return;
+        }
+        const int64_t now = getCurrentMilliseconds();
+        for(auto it = pendingCommands.begin(); it != pendingCommands.end(); ) {
+            if( now >= (*it)->deadline ) {
+                expired.push_back(*it);
+                it = pendingCommands.erase(it);
+            } else {
+                ++it;
+            }
         }
     }
+    for(size_t i=0; i<expired.size(); i++) {
+        ERR_PRINT("DBTManager::expirePending: nullptr result (timeout -> abort): opcode %s, dev_id %d",
+                getMgmtOpcodeString(expired[i]->opcode).c_str(), expired[i]->dev_id);
+        try {
+            expired[i]->callback.invoke(nullptr);
+        } catch (std::exception &e) {
+            ERR_PRINT("DBTManager::expirePending: Caught exception %s", e.what());
+        }
+    }
+}
 
-    // Ringbuffer read is thread safe
-    int32_t retryCount = 0;
-    while( retryCount < env.MGMT_READ_PACKET_MAX_RETRY ) {
-        std::shared_ptr<MgmtEvent> res = mgmtEventRing.getBlocking(env.MGMT_COMMAND_REPLY_TIMEOUT);
-        // std::shared_ptr<MgmtEvent> res = receiveNext();
-        if( nullptr == res ) {
-            errno = ETIMEDOUT;
-            ERR_PRINT("DBTManager::sendWithReply.X: nullptr result (timeout -> abort): req %s", req.toString().c_str());
+void DBTManager::cancelPending() {
+    std::deque<std::shared_ptr<PendingCommand>> cancelled;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_pending); // RAII-style acquire and relinquish via destructor
+        cancelled.swap(pendingCommands);
+    }
+    for(size_t i=0; i<cancelled.size(); i++) {
+        try {
+            cancelled[i]->callback.invoke(nullptr);
+        } catch (std::exception &e) {
+            ERR_PRINT("DBTManager::cancelPending: Caught exception %s", e.what());
+        }
+    }
+}
+
+void DBTManager::removePending(const std::shared_ptr<PendingCommand> & cmd) {
+    const std::lock_guard<std::mutex> lock(mtx_pending); // RAII-style acquire and relinquish via destructor
+    auto it = std::find(pendingCommands.begin(), pendingCommands.end(), cmd);
+    if( it != pendingCommands.end() ) {
+        pendingCommands.erase(it);
+    }
+}
+
+int DBTManager::getPendingPollTimeout() {
+    const std::lock_guard<std::mutex> lock(mtx_pending); // RAII-style acquire and relinquish via destructor
+    int64_t deadline = INT64_MAX;
+    for(auto it = pendingCommands.begin(); it != pendingCommands.end(); it++) {
+        deadline = std::min(deadline, (*it)->deadline);
+    }
+    if( INT64_MAX == deadline ) {
+        return env.MGMT_READER_THREAD_POLL_TIMEOUT;
+    }
+    const int64_t left = std::max<int64_t>(1, deadline - getCurrentMilliseconds());
+    return (int) std::min<int64_t>(left, env.MGMT_READER_THREAD_POLL_TIMEOUT);
+}
+
+std::shared_ptr<DBTManager::PendingCommand> DBTManager::sendAsyncImpl(MgmtCommand &req, const MgmtReplyCallback & callback, const int timeout) {
+    if( !mgmtReaderRunning ) {
+        ERR_PRINT("DBTManager::sendAsync: Not open, req %s", req.toString().c_str());
+        return nullptr;
+    }
+    std::shared_ptr<PendingCommand> cmd = std::make_shared<PendingCommand>(req.getOpcode(), req.getDevID(), callback,
+                                                                           getCurrentMilliseconds() + timeout);
+    // Registration and write in one step, keeping the sent order of equal (opcode, dev_id) commands
+    const std::lock_guard<std::mutex> lock(mtx_sendReply); // RAII-style acquire and relinquish via destructor
+    bool earliest = true;
+    {
+        const std::lock_guard<std::mutex> lockPending(mtx_pending); // RAII-style acquire and relinquish via destructor
+        if( static_cast<int32_t>(pendingCommands.size()) >= env.MGMT_CMD_INFLIGHT_CAPACITY ) {
+            ERR_PRINT("DBTManager::sendAsync: %zd commands in flight, req %s", pendingCommands.size(), req.toString().c_str());
             return nullptr;
-        } else if( !res->validate(req) ) {
-            // This could occur due to an earlier timeout w/ a nullptr == res (see above),
-            // i.e. the pending reply processed here and naturally not-matching.
-            COND_PRINT(env.DEBUG_EVENT, "DBTManager-IO RECV sendWithReply: res mismatch (drop evt, retryCount %d): res %s; req %s",
-                    retryCount, res->toString().c_str(), req.toString().c_str());
-            retryCount++;
-        } else {
-            COND_PRINT(env.DEBUG_EVENT, "DBTManager-IO RECV sendWithReply: res %s; req %s", res->toString().c_str(), req.toString().c_str());
-            return res;
         }
+        for(auto it = pendingCommands.begin(); earliest && it != pendingCommands.end(); it++) {
+            earliest = cmd->deadline < (*it)->deadline;
+        }
+        pendingCommands.push_back(cmd);
     }
-    return nullptr;
+    if( earliest ) {
+        // The reader's poll timeout has been computed w/o this deadline
+        comm.interrupt();
+    }
+    COND_PRINT(env.DEBUG_EVENT, "DBTManager-IO SENT %s", req.toString().c_str());
+    TROOctets & pdu = req.getPDU();
+    if ( comm.write( pdu.get_ptr(), pdu.getSize() ) < 0 ) {
+        ERR_PRINT("DBTManager::sendAsync: HCIComm write error, req %s", req.toString().c_str());
+        removePending(cmd);
+        return nullptr;
+    }
+    return cmd;
+}
+
+bool DBTManager::sendAsync(MgmtCommand &req, const MgmtReplyCallback & callback) {
+    return nullptr != sendAsyncImpl(req, callback, env.MGMT_COMMAND_REPLY_TIMEOUT);
+}
+
+MgmtReplyCallback DBTManager::bindSyncReply(const std::shared_ptr<SyncReply> & reply) {
+    return bindStdFunc(reinterpret_cast<uint64_t>(reply.get()), std::function<void(std::shared_ptr<MgmtEvent>)>(
+                [reply](std::shared_ptr<MgmtEvent> res) { reply->complete(res); } ));
+}
+
+std::shared_ptr<MgmtEvent> DBTManager::sendWithReply(MgmtCommand &req) {
+    std::shared_ptr<SyncReply> reply = std::make_shared<SyncReply>();
+    std::shared_ptr<PendingCommand> cmd = sendAsyncImpl(req, bindSyncReply(reply), env.MGMT_COMMAND_REPLY_TIMEOUT);
+    if( nullptr == cmd ) {
+        return nullptr;
+    }
+    std::shared_ptr<MgmtEvent> res = reply->await(env.MGMT_COMMAND_REPLY_TIMEOUT);
+    if( nullptr == res ) {
+        removePending(cmd);
+        ERR_PRINT("DBTManager::sendWithReply.X: nullptr result (timeout -> abort): req %s", req.toString().c_str());
+        errno = ETIMEDOUT;
+        return nullptr;
+    }
+    COND_PRINT(env.DEBUG_EVENT, "DBTManager-IO RECV sendWithReply: res %s; req %s", res->toString().c_str(), req.toString().c_str());
+    return res;
+}
+
+bool DBTManager::isReplySuccess(const std::shared_ptr<MgmtEvent> & res) {
+    if( nullptr != res ) {
+        if( res->getOpcode() == MgmtEvent::Opcode::CMD_COMPLETE ) {
+            const MgmtEvtCmdComplete &res1 = *static_cast<const MgmtEvtCmdComplete *>(res.get());
+            return MgmtStatus::SUCCESS == res1.getStatus();
+        } else if( res->getOpcode() == MgmtEvent::Opcode::CMD_STATUS ) {
+            const MgmtEvtCmdStatus &res1 = *static_cast<const MgmtEvtCmdStatus *>(res.get());
+            return MgmtStatus::SUCCESS == res1.getStatus();
+        }
+    }
+    return false;
 }
 
 void DBTManager::setAdapterMode(const uint16_t dev_id, const uint8_t ssp, const uint8_t bredr, const uint8_t le) {
+    // Pipelined: All three commands are in flight at once, awaiting their replies thereafter.
+    MgmtUint8Cmd req_ssp(MgmtOpcode::SET_SSP, dev_id, ssp);
+    MgmtUint8Cmd req_bredr(MgmtOpcode::SET_BREDR, dev_id, bredr);
+    MgmtUint8Cmd req_le(MgmtOpcode::SET_LE, dev_id, le);
+    std::shared_ptr<SyncReply> res_ssp = std::make_shared<SyncReply>();
+    std::shared_ptr<SyncReply> res_bredr = std::make_shared<SyncReply>();
+    std::shared_ptr<SyncReply> res_le = std::make_shared<SyncReply>();
+    const bool sent_ssp = sendAsync(req_ssp, bindSyncReply(res_ssp));
+    const bool sent_bredr = sendAsync(req_bredr, bindSyncReply(res_bredr));
+    const bool sent_le = sendAsync(req_le, bindSyncReply(res_le));
+
+    // Pending commands are completed or expired by the reader, bounding the waits below.
     bool res;
-    res = setMode(dev_id, MgmtOpcode::SET_SSP, ssp);
+    res = sent_ssp && isReplySuccess( res_ssp->await(env.MGMT_COMMAND_REPLY_TIMEOUT) );
     DBG_PRINT("setAdapterMode[%d]: SET_SSP(%d): result %d", dev_id, ssp, res);
 
-    res = setMode(dev_id, MgmtOpcode::SET_BREDR, bredr);
+    res = sent_bredr && isReplySuccess( res_bredr->await(env.MGMT_COMMAND_REPLY_TIMEOUT) );
     DBG_PRINT("setAdapterMode[%d]: SET_BREDR(%d): result %d", dev_id, bredr, res);
 
-    res = setMode(dev_id, MgmtOpcode::SET_LE, le);
+    res = sent_le && isReplySuccess( res_le->await(env.MGMT_COMMAND_REPLY_TIMEOUT) );
     DBG_PRINT("setAdapterMode[%d]: SET_LE(%d): result %d", dev_id, le, res);
+    (void)res;
 }
 
 std::shared_ptr<AdapterInfo> DBTManager::initAdapter(const uint16_t dev_id, const BTMode btMode) {
@@ -244,10 +559,30 @@ std::shared_ptr<AdapterInfo> DBTManager::initAdapter(const uint16_t dev_id, cons
             break;
     }
 
-    setMode(dev_id, MgmtOpcode::SET_CONNECTABLE, 0);
-    setMode(dev_id, MgmtOpcode::SET_FAST_CONNECTABLE, 0);
-
-    removeDeviceFromWhitelist(dev_id, EUI48_ANY_DEVICE, BDAddressType::BDADDR_BREDR); // flush whitelist!
+    {
+        // Pipelined: All three commands are in flight at once, awaiting their replies thereafter.
+        MgmtUint8Cmd req_conn(MgmtOpcode::SET_CONNECTABLE, dev_id, 0);
+        MgmtUint8Cmd req_fconn(MgmtOpcode::SET_FAST_CONNECTABLE, dev_id, 0);
+        MgmtRemoveDeviceFromWhitelistCmd req_wl(dev_id, EUI48_ANY_DEVICE, BDAddressType::BDADDR_BREDR); // flush whitelist!
+        std::shared_ptr<SyncReply> res_conn = std::make_shared<SyncReply>();
+        std::shared_ptr<SyncReply> res_fconn = std::make_shared<SyncReply>();
+        std::shared_ptr<SyncReply> res_wl = std::make_shared<SyncReply>();
+        const bool sent_conn = sendAsync(req_conn, bindSyncReply(res_conn));
+        const bool sent_fconn = sendAsync(req_fconn, bindSyncReply(res_fconn));
+        const bool sent_wl = sendAsync(req_wl, bindSyncReply(res_wl));
+
+        const int timeout = env.MGMT_COMMAND_REPLY_TIMEOUT;
+        bool res;
+        res = sent_conn && isReplySuccess( res_conn->await(timeout) );
+        DBG_PRINT("initAdapter[%d]: SET_CONNECTABLE(0): result %d", dev_id, res);
+
+        res = sent_fconn && isReplySuccess( res_fconn->await(timeout) );
+        DBG_PRINT("initAdapter[%d]: SET_FAST_CONNECTABLE(0): result %d", dev_id, res);
+
+        res = sent_wl && isReplySuccess( res_wl->await(timeout) );
+        DBG_PRINT("initAdapter[%d]: REMOVE_DEVICE_FROM_WHITELIST(any): result %d", dev_id, res);
+        (void)res;
+    }
 
     powered = setMode(dev_id, MgmtOpcode::SET_POWERED, 1);
     DBG_PRINT("setAdapterMode[%d]: SET_POWERED(1): result %d", dev_id, powered);
@@ -288,40 +623,54 @@ void DBTManager::shutdownAdapter(const uint16_t dev_id) {
 DBTManager::DBTManager(const BTMode _defaultBTMode)
 : env(MgmtEnv::get()),
   defaultBTMode(BTMode::NONE != _defaultBTMode ? _defaultBTMode : BTMode::LE),
+  whitelist(env.MGMT_WHITELIST_CONTROLLER_CAPACITY),
   rbuffer(ClientMaxMTU), comm(HCI_DEV_NONE, HCI_CHANNEL_CONTROL),
-  mgmtEventRing(env.MGMT_EVT_RING_CAPACITY), mgmtReaderRunning(false), mgmtReaderShallStop(false)
+  mgmtReaderRunning(false), mgmtReaderShallStop(false),
+  callbackIndexVersion(0), retiredCallbackIndexCount(0), callbackSeq(0)
 {
+    const uint64_t t0 = getCurrentMilliseconds();
+    uint64_t t1;
     INFO_PRINT("DBTManager.ctor: pid %d", DBTManager::pidSelf);
     if( !comm.isOpen() ) {
         ERR_PRINT("DBTManager::open: Could not open mgmt control channel");
         return;
     }
 
-    {
-        struct sigaction sa_setup;
-        bzero(&sa_setup, sizeof(sa_setup));
-        sa_setup.sa_sigaction = mgmthandler_sigaction;
-        sigemptyset(&(sa_setup.sa_mask));
-        sa_setup.sa_flags = SA_SIGINFO;
-        if( 0 != sigaction( SIGALRM, &sa_setup, NULL ) ) {
-            ERR_PRINT("DBTManager::ctor: Setting sighandler");
-        }
-    }
     {
         std::unique_lock<std::mutex> lock(mtx_mgmtReaderInit); // RAII-style acquire and relinquish via destructor
         mgmtReaderThread = std::thread(&DBTManager::mgmtReaderThreadImpl, this);
+        DBTEnv::setThreadAffinity(mgmtReaderThread.native_handle(), "direct_bt.mgmt.affinity");
         while( false == mgmtReaderRunning ) {
             cv_mgmtReaderInit.wait(lock);
         }
     }
 
     PERF_TS_T0();
+    t1 = getCurrentMilliseconds();
+    startupTimings.readerStart = t1 - t0;
 
     bool ok = true;
+    std::shared_ptr<MgmtEvent> resVersion, resCommands, resIndexList;
+    {
+        // Pipelined: All three commands are in flight at once, awaiting their replies thereafter.
+        MgmtCommand req_version(MgmtOpcode::READ_VERSION, MgmtConstU16::MGMT_INDEX_NONE);
+        MgmtCommand req_commands(MgmtOpcode::READ_COMMANDS, MgmtConstU16::MGMT_INDEX_NONE);
+        MgmtCommand req_indexList(MgmtOpcode::READ_INDEX_LIST, MgmtConstU16::MGMT_INDEX_NONE);
+        std::shared_ptr<SyncReply> res_version = std::make_shared<SyncReply>();
+        std::shared_ptr<SyncReply> res_commands = std::make_shared<SyncReply>();
+        std::shared_ptr<SyncReply> res_indexList = std::make_shared<SyncReply>();
+        const bool sent_version = sendAsync(req_version, bindSyncReply(res_version));
+        const bool sent_commands = sendAsync(req_commands, bindSyncReply(res_commands));
+        const bool sent_indexList = sendAsync(req_indexList, bindSyncReply(res_indexList));
+
+        const int timeout = env.MGMT_COMMAND_REPLY_TIMEOUT;
+        resVersion = sent_version ? res_version->await(timeout) : nullptr;
+        resCommands = sent_commands ? res_commands->await(timeout) : nullptr;
+        resIndexList = sent_indexList ? res_indexList->await(timeout) : nullptr;
+    }
     // Mandatory
     {
-        MgmtCommand req0(MgmtOpcode::READ_VERSION, MgmtConstU16::MGMT_INDEX_NONE);
-        std::shared_ptr<MgmtEvent> res = sendWithReply(req0);
+        std::shared_ptr<MgmtEvent> res = resVersion;
         if( nullptr == res ) {
             goto fail;
         }
@@ -340,8 +689,7 @@ DBTManager::DBTManager(const BTMode _defaultBTMode)
     }
     // Optional
     {
-        MgmtCommand req0(MgmtOpcode::READ_COMMANDS, MgmtConstU16::MGMT_INDEX_NONE);
-        std::shared_ptr<MgmtEvent> res = sendWithReply(req0);
+        std::shared_ptr<MgmtEvent> res = resCommands;
         if( nullptr == res ) {
             goto next1;
         }
@@ -369,8 +717,7 @@ next1:
 
     // Mandatory
     {
-        MgmtCommand req0(MgmtOpcode::READ_INDEX_LIST, MgmtConstU16::MGMT_INDEX_NONE);
-        std::shared_ptr<MgmtEvent> res = sendWithReply(req0);
+        std::shared_ptr<MgmtEvent> res = resIndexList;
         if( nullptr == res ) {
             goto fail;
         }
@@ -387,17 +734,56 @@ next1:
             ERR_PRINT("Insufficient data for %d adapter indices: res %s", num_adapter, res->toString().c_str());
             goto fail;
         }
+        t1 = getCurrentMilliseconds();
+        startupTimings.readInfo = t1 - t0 - startupTimings.readerStart;
+
         adapterInfos.resize(num_adapter, nullptr);
-        for(int i=0; ok && i < num_adapter; i++) {
+        startupTimings.initAdapter.resize(num_adapter, 0);
+        std::vector<uint16_t> dev_ids;
+        for(int i=0; i < num_adapter; i++) {
             const uint16_t dev_id = get_uint16(data, 2+i*2, true /* littleEndian */);
             if( dev_id >= num_adapter ) {
                 throw InternalError("dev_id "+std::to_string(dev_id)+" >= num_adapter "+std::to_string(num_adapter), E_FILE_LINE);
             }
-            if( adapterInfos[dev_id] != nullptr ) {
-                throw InternalError("adapters[dev_id="+std::to_string(dev_id)+"] != nullptr: "+adapterInfos[dev_id]->toString(), E_FILE_LINE);
+            if( dev_ids.end() != std::find(dev_ids.begin(), dev_ids.end(), dev_id) ) {
+                throw InternalError("adapters[dev_id="+std::to_string(dev_id)+"] listed twice", E_FILE_LINE);
+            }
+            dev_ids.push_back(dev_id);
+        }
+
+        // Parallel: Each adapter's blocking initialization on its own thread,
+        // as commands are matched by (opcode, dev_id) and hence may be in flight for all adapter.
+        std::vector<std::exception_ptr> initErrors(num_adapter);
+        auto initAdapterImpl = [&](const uint16_t dev_id) {
+            const uint64_t ti0 = getCurrentMilliseconds();
+            try {
+                adapterInfos[dev_id] = initAdapter(dev_id, defaultBTMode);
+            } catch (...) {
+                initErrors[dev_id] = std::current_exception();
+            }
+            startupTimings.initAdapter[dev_id] = getCurrentMilliseconds() - ti0;
+        };
+        if( 1 == num_adapter ) {
+            initAdapterImpl(dev_ids[0]);
+        } else {
+            std::vector<std::thread> initThreads;
+            for(int i=0; i < num_adapter; i++) {
+                initThreads.push_back( std::thread(initAdapterImpl, dev_ids[i]) );
+            }
+            for(int i=0; i < num_adapter; i++) {
+                initThreads[i].join();
             }
-            std::shared_ptr<AdapterInfo> adapterInfo = initAdapter(dev_id, defaultBTMode);
-            adapterInfos[dev_id] = adapterInfo;
+        }
+        startupTimings.initAdapters = getCurrentMilliseconds() - t1;
+
+        for(int i=0; i < num_adapter; i++) {
+            if( nullptr != initErrors[dev_ids[i]] ) {
+                std::rethrow_exception(initErrors[dev_ids[i]]);
+            }
+        }
+        for(int i=0; ok && i < num_adapter; i++) {
+            const uint16_t dev_id = dev_ids[i];
+            std::shared_ptr<AdapterInfo> adapterInfo = adapterInfos[dev_id];
             if( nullptr != adapterInfo ) {
                 DBG_PRINT("DBTManager::adapters %d/%d: dev_id %d: %s", i, num_adapter, dev_id, adapterInfo->toString().c_str());
                 ok = true;
@@ -409,6 +795,9 @@ next1:
     }
 
     if( ok ) {
+        if( env.MGMT_ADAPTER_EVENT_LOOPS ) {
+            startAdapterEventLoops();
+        }
         if( env.DEBUG_EVENT ) {
             addMgmtEventCallback(-1, MgmtEvent::Opcode::CLASS_OF_DEV_CHANGED, bindMemberFunc(this, &DBTManager::mgmtEvClassOfDeviceChangedCB));
             addMgmtEventCallback(-1, MgmtEvent::Opcode::DISCOVERING, bindMemberFunc(this, &DBTManager::mgmtEvDeviceDiscoveringCB));
@@ -425,6 +814,8 @@ next1:
             addMgmtEventCallback(-1, MgmtEvent::Opcode::PIN_CODE_REQUEST, bindMemberFunc(this, &DBTManager::mgmtEvPinCodeRequestCB));
             addMgmtEventCallback(-1, MgmtEvent::Opcode::USER_PASSKEY_REQUEST, bindMemberFunc(this, &DBTManager::mgmtEvUserPasskeyRequestCB));
         }
+        startupTimings.total = getCurrentMilliseconds() - t0;
+        INFO_PRINT("DBTManager::open: %s", startupTimings.toString().c_str());
         PERF_TS_TD("DBTManager::open.ok");
         return;
     }
@@ -449,10 +840,8 @@ void DBTManager::close() {
 
     if( mgmtReaderRunning && mgmtReaderThread.joinable() ) {
         mgmtReaderShallStop = true;
-        pthread_t tid = mgmtReaderThread.native_handle();
-        pthread_kill(tid, SIGALRM);
     }
-    comm.close();
+    comm.close(); // wakes up mgmtReaderThread
 
     if( mgmtReaderRunning && mgmtReaderThread.joinable() ) {
         // still running ..
@@ -460,16 +849,8 @@ void DBTManager::close() {
         mgmtReaderThread.join();
     }
     mgmtReaderThread = std::thread(); // empty
-    {
-        struct sigaction sa_setup;
-        bzero(&sa_setup, sizeof(sa_setup));
-        sa_setup.sa_handler = SIG_DFL;
-        sigemptyset(&(sa_setup.sa_mask));
-        sa_setup.sa_flags = 0;
-        if( 0 != sigaction( SIGALRM, &sa_setup, NULL ) ) {
-            ERR_PRINT("DBTManager.sigaction: Resetting sighandler");
-        }
-    }
+    cancelPending();
+    stopAdapterEventLoops();
     DBG_PRINT("DBTManager::close: End");
 }
 
@@ -505,17 +886,7 @@ std::shared_ptr<AdapterInfo> DBTManager::getAdapterInfo(const int idx) const {
 
 bool DBTManager::setMode(const int dev_id, const MgmtOpcode opc, const uint8_t mode) {
     MgmtUint8Cmd req(opc, dev_id, mode);
-    std::shared_ptr<MgmtEvent> res = sendWithReply(req);
-    if( nullptr != res ) {
-        if( res->getOpcode() == MgmtEvent::Opcode::CMD_COMPLETE ) {
-            const MgmtEvtCmdComplete &res1 = *static_cast<const MgmtEvtCmdComplete *>(res.get());
-            return MgmtStatus::SUCCESS == res1.getStatus();
-        } else if( res->getOpcode() == MgmtEvent::Opcode::CMD_STATUS ) {
-            const MgmtEvtCmdStatus &res1 = *static_cast<const MgmtEvtCmdStatus *>(res.get());
-            return MgmtStatus::SUCCESS == res1.getStatus();
-        }
-    }
-    return false;
+    return isReplySuccess( sendWithReply(req) );
 }
 
 ScanType DBTManager::startDiscovery(const int dev_id, const BTMode btMode) {
@@ -557,86 +928,331 @@ bool DBTManager::uploadConnParam(const int dev_id, const EUI48 &address, const B
     return false;
 }
 
+void DBTManager::addWhitelistControllerAsyncLocked(DBTWhitelist::Element & wle) {
+    const int dev_id = wle.dev_id;
+    const EUI48 address = wle.address;
+    whitelist.setAdding(wle);
+
+    if( wle.hasConnParam ) {
+        MgmtLoadConnParamCmd req0(dev_id, wle.connParam);
+        sendAsync(req0, bindStdFunc(0, std::function<void(std::shared_ptr<MgmtEvent>)>(
+                [dev_id, address](std::shared_ptr<MgmtEvent> res) {
+                    if( !isReplySuccess(res) ) {
+                        WARN_PRINT("DBTManager::rotateWhitelist: uploadConnParam(dev_id %d, address %s): Failed",
+                                dev_id, address.toString().c_str());
+                    }
+                } )));
+    }
+    MgmtAddDeviceToWhitelistCmd req(dev_id, address, wle.address_type, wle.ctype);
+    const bool sent = sendAsync(req, bindStdFunc(0, std::function<void(std::shared_ptr<MgmtEvent>)>(
+            [this, dev_id, address](std::shared_ptr<MgmtEvent> res) {
+                const bool success = isReplySuccess(res);
+                if( !success ) {
+                    WARN_PRINT("DBTManager::rotateWhitelist: addDeviceToWhitelist(dev_id %d, address %s): Failed, keep host-side",
+                            dev_id, address.toString().c_str());
+                }
+                const std::lock_guard<std::mutex> lock(mtx_whitelist); // RAII-style acquire and relinquish via destructor
+                DBTWhitelist::Element * e = whitelist.find(dev_id, address);
+                if( nullptr != e && DBTWhitelist::State::ADDING == e->state ) {
+                    if( success ) {
+                        whitelist.setInController(*e);
+                    } else {
+                        whitelist.setHostSide(*e);
+                    }
+                }
+            } )));
+    if( !sent ) {
+        whitelist.setHostSide(wle);
+    }
+}
+
+void DBTManager::evictWhitelistControllerAsyncLocked(DBTWhitelist::Element & wle) {
+    const int dev_id = wle.dev_id;
+    const EUI48 address = wle.address;
+    whitelist.setEvicting(wle);
+
+    MgmtRemoveDeviceFromWhitelistCmd req(dev_id, address, wle.address_type);
+    const bool sent = sendAsync(req, bindStdFunc(0, std::function<void(std::shared_ptr<MgmtEvent>)>(
+            [this, dev_id, address](std::shared_ptr<MgmtEvent> res) {
+                const bool success = isReplySuccess(res);
+                if( !success ) {
+                    WARN_PRINT("DBTManager::rotateWhitelist: removeDeviceFromWhitelist(dev_id %d, address %s): Failed, keep in controller",
+                            dev_id, address.toString().c_str());
+                }
+                const std::lock_guard<std::mutex> lock(mtx_whitelist); // RAII-style acquire and relinquish via destructor
+                DBTWhitelist::Element * e = whitelist.find(dev_id, address);
+                if( nullptr != e && DBTWhitelist::State::EVICTING == e->state ) {
+                    if( success ) {
+                        whitelist.setHostSide(*e);
+                    } else {
+                        whitelist.setInController(*e);
+                    }
+                }
+                if( success ) {
+                    rotateWhitelistLocked(dev_id);
+                }
+            } )));
+    if( !sent ) {
+        whitelist.setInController(wle);
+    }
+}
+
+void DBTManager::rotateWhitelistLocked(const int dev_id) {
+    if( 0 == env.MGMT_WHITELIST_CONTROLLER_CAPACITY ) {
+        return;
+    }
+    std::vector<DBTWhitelist::Element*> hostSide = whitelist.getRotationCandidates(dev_id);
+    for(size_t i=0; i<hostSide.size(); i++) {
+        addWhitelistControllerAsyncLocked(*hostSide[i]);
+    }
+}
+
 bool DBTManager::isDeviceWhitelisted(const int dev_id, const EUI48 &address) {
-    for(auto it = whitelist.begin(); it != whitelist.end(); ) {
-        std::shared_ptr<WhitelistElem> wle = *it;
-        if( wle->dev_id == dev_id && wle->address == address ) {
+    const std::lock_guard<std::mutex> lock(mtx_whitelist); // RAII-style acquire and relinquish via destructor
+    return nullptr != whitelist.find(dev_id, address);
+}
+
+int DBTManager::getWhitelistControllerCount(const int dev_id) {
+    const std::lock_guard<std::mutex> lock(mtx_whitelist); // RAII-style acquire and relinquish via destructor
+    return whitelist.getControllerCount(dev_id);
+}
+
+bool DBTManager::addDeviceToWhitelist(const int dev_id, const EUI48 &address, const BDAddressType address_type, const HCIWhitelistConnectType ctype) {
+    MgmtAddDeviceToWhitelistCmd req(dev_id, address, address_type, ctype);
+    {
+        const std::lock_guard<std::mutex> lock(mtx_whitelist); // RAII-style acquire and relinquish via destructor
+
+        // Check if already exist in our local whitelist first, reject if so ..
+        DBTWhitelist::Element * e = whitelist.add( DBTWhitelist::Element{dev_id, address, address_type, ctype,
+                false /* hasConnParam */, MgmtConnParam(), DBTWhitelist::State::HOST_SIDE, 0} );
+        if( nullptr == e ) {
+            ERR_PRINT("DBTManager::addDeviceToWhitelist: Already in local whitelist, remove first: %s", req.toString().c_str());
+            return false;
+        }
+        if( !whitelist.hasCapacity(dev_id) ) {
+            DBG_PRINT("DBTManager::addDeviceToWhitelist: Controller capacity %d reached, host-side: %s",
+                    env.MGMT_WHITELIST_CONTROLLER_CAPACITY, req.toString().c_str());
             return true;
-        } else {
-            ++it;
         }
+        // Reserve the controller slot while the command is in flight
+        whitelist.setAdding(*e);
     }
-    return false;
+    const bool res = isReplySuccess( sendWithReply(req) );
+    {
+        const std::lock_guard<std::mutex> lock(mtx_whitelist); // RAII-style acquire and relinquish via destructor
+        DBTWhitelist::Element * e = whitelist.find(dev_id, address);
+        if( nullptr != e && DBTWhitelist::State::ADDING == e->state ) {
+            if( res ) {
+                whitelist.setInController(*e);
+            } else {
+                whitelist.remove(dev_id, address);
+            }
+        }
+    }
+    return res;
 }
 
-bool DBTManager::addDeviceToWhitelist(const int dev_id, const EUI48 &address, const BDAddressType address_type, const HCIWhitelistConnectType ctype) {
-    MgmtAddDeviceToWhitelistCmd req(dev_id, address, address_type, ctype);
+int DBTManager::addDevicesToWhitelist(const int dev_id, const std::vector<MgmtConnParam> & devices, const HCIWhitelistConnectType ctype) {
+    int count = 0;
+    std::vector<DBTWhitelist::Element> toController;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_whitelist); // RAII-style acquire and relinquish via destructor
+        for(size_t i=0; i<devices.size(); i++) {
+            const MgmtConnParam & d = devices[i];
+            DBTWhitelist::Element * e = whitelist.add( DBTWhitelist::Element{dev_id, d.address, static_cast<BDAddressType>(d.address_type), ctype,
+                    true /* hasConnParam */, d, DBTWhitelist::State::HOST_SIDE, 0} );
+            if( nullptr == e ) {
+                DBG_PRINT("DBTManager::addDevicesToWhitelist: Already in local whitelist, skipped: dev_id %d, address %s",
+                        dev_id, d.address.toString().c_str());
+                continue;
+            }
+            if( whitelist.hasCapacity(dev_id) ) {
+                whitelist.setAdding(*e);
+                toController.push_back(*e);
+            }
+            count++;
+        }
+    }
+    DBG_PRINT("DBTManager::addDevicesToWhitelist: dev_id %d, added %d of %zd devices, %zd to controller",
+            dev_id, count, devices.size(), toController.size());
+
+    // Pipelined: Each batch's LOAD_CONN_PARAM and ADD_DEVICE commands are in flight at once, awaiting their replies thereafter.
+    // A batch is completed before the next, as LOAD_CONN_PARAM drops the parameter of devices not yet added.
+    const int timeout = env.MGMT_COMMAND_REPLY_TIMEOUT;
+    std::vector<EUI48> failed;
+    std::vector<EUI48> added;
+    for(size_t i=0; i<toController.size(); i+=WHITELIST_BATCH_SIZE) {
+        const size_t end = std::min<size_t>(toController.size(), i+WHITELIST_BATCH_SIZE);
+
+        std::vector<std::shared_ptr<MgmtConnParam>> connParams;
+        for(size_t j=i; j<end; j++) {
+            connParams.push_back( std::make_shared<MgmtConnParam>(toController[j].connParam) );
+        }
+        MgmtLoadConnParamCmd req0(dev_id, connParams);
+        std::shared_ptr<SyncReply> res0 = std::make_shared<SyncReply>();
+        const bool sent0 = sendAsync(req0, bindSyncReply(res0));
+
+        std::vector<std::shared_ptr<SyncReply>> res;
+        std::vector<bool> sent;
+        for(size_t j=i; j<end; j++) {
+            MgmtAddDeviceToWhitelistCmd req(dev_id, toController[j].address, toController[j].address_type, ctype);
+            res.push_back( std::make_shared<SyncReply>() );
+            sent.push_back( sendAsync(req, bindSyncReply(res.back())) );
+        }
 
-    // Check if already exist in our local whitelist first, reject if so ..
-    if( isDeviceWhitelisted(dev_id, address) ) {
-        ERR_PRINT("DBTManager::addDeviceToWhitelist: Already in local whitelist, remove first: %s", req.toString().c_str());
-        return false;
+        // Pending commands are completed or expired by the reader, bounding the waits below.
+        if( !sent0 || !isReplySuccess( res0->await(timeout) ) ) {
+            ERR_PRINT("DBTManager::addDevicesToWhitelist: uploadConnParam(dev_id %d, %zd devices): Failed", dev_id, connParams.size());
+        }
+        for(size_t j=i; j<end; j++) {
+            if( !sent[j-i] || !isReplySuccess( res[j-i]->await(timeout) ) ) {
+                ERR_PRINT("DBTManager::addDevicesToWhitelist: addDeviceToWhitelist(dev_id %d, address %s): Failed",
+                        dev_id, toController[j].address.toString().c_str());
+                failed.push_back(toController[j].address);
+            } else {
+                added.push_back(toController[j].address);
+            }
+        }
     }
-    std::shared_ptr<MgmtEvent> res = sendWithReply(req);
-    if( nullptr != res && res->getOpcode() == MgmtEvent::Opcode::CMD_COMPLETE ) {
-        const MgmtEvtCmdComplete &res1 = *static_cast<const MgmtEvtCmdComplete *>(res.get());
-        if( MgmtStatus::SUCCESS == res1.getStatus() ) {
-            std::shared_ptr<WhitelistElem> wle( new WhitelistElem{dev_id, address, address_type, ctype} );
-            whitelist.push_back(wle);
-            return true;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_whitelist); // RAII-style acquire and relinquish via destructor
+        for(size_t i=0; i<added.size(); i++) {
+            DBTWhitelist::Element * e = whitelist.find(dev_id, added[i]);
+            if( nullptr != e && DBTWhitelist::State::ADDING == e->state ) {
+                whitelist.setInController(*e);
+            }
+        }
+        for(size_t i=0; i<failed.size(); i++) {
+            DBTWhitelist::Element * e = whitelist.find(dev_id, failed[i]);
+            if( nullptr != e && DBTWhitelist::State::ADDING == e->state ) {
+                whitelist.remove(dev_id, failed[i]);
+                count--;
+            }
         }
     }
-    return false;
+    return count;
 }
 
-int DBTManager::removeAllDevicesFromWhitelist() {
-#if 0
-    std::vector<std::shared_ptr<WhitelistElem>> whitelist_copy = whitelist;
-    int count = 0;
-    DBG_PRINT("DBTManager::removeAllDevicesFromWhitelist.A: Start %zd elements", whitelist_copy.size());
+bool DBTManager::whitelistDeviceSeen(const int dev_id, const EUI48 &address, const uint64_t timestamp) {
+    const std::lock_guard<std::mutex> lock(mtx_whitelist); // RAII-style acquire and relinquish via destructor
+    DBTWhitelist::Element * wle = whitelist.find(dev_id, address);
+    if( nullptr == wle ) {
+        return false;
+    }
+    whitelist.setLastSeen(*wle, timestamp);
+    if( wle->inController() ) {
+        return true;
+    }
+    if( whitelist.hasCapacity(dev_id) ) {
+        addWhitelistControllerAsyncLocked(*wle);
+        return true;
+    }
+    // One eviction at a time, its completion rotates in the most recently seen devices
+    if( 0 < whitelist.getCount(dev_id, DBTWhitelist::State::EVICTING) ) {
+        return true;
+    }
+    DBTWhitelist::Element * lru = whitelist.getEvictionCandidate(dev_id);
+    if( nullptr == lru ) {
+        DBG_PRINT("DBTManager::whitelistDeviceSeen: dev_id %d, no device to evict for %s",
+                dev_id, address.toString().c_str());
+        return true;
+    }
+    DBG_PRINT("DBTManager::whitelistDeviceSeen: dev_id %d, evict %s for %s",
+            dev_id, lru->address.toString().c_str(), address.toString().c_str());
+    evictWhitelistControllerAsyncLocked(*lru);
+    return true;
+}
+
+void DBTManager::whitelistDeviceConnected(const int dev_id, const EUI48 &address, const bool connected) {
+    const std::lock_guard<std::mutex> lock(mtx_whitelist); // RAII-style acquire and relinquish via destructor
+    whitelist.setConnected(dev_id, address, connected);
+}
 
-    for(auto it = whitelist_copy.begin(); it != whitelist_copy.end(); ++it) {
-        std::shared_ptr<WhitelistElem> wle = *it;
-        removeDeviceFromWhitelist(wle->dev_id, wle->address, wle->address_type);
-        count++;
+int DBTManager::removeAllDevicesFromWhitelist() {
+    int count;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_whitelist); // RAII-style acquire and relinquish via destructor
+        count = whitelist.size();
+        whitelist.clear();
     }
-#else
-    int count = whitelist.size();
-    DBG_PRINT("DBTManager::removeAllDevicesFromWhitelist.B: Start %d elements", count);
-    whitelist.clear();
+    DBG_PRINT("DBTManager::removeAllDevicesFromWhitelist: Start %d elements", count);
     for (auto it = adapterInfos.begin(); it != adapterInfos.end(); it++) {
         removeDeviceFromWhitelist((*it)->dev_id, EUI48_ANY_DEVICE, BDAddressType::BDADDR_BREDR); // flush whitelist!
     }
-#endif
-
-    DBG_PRINT("DBTManager::removeAllDevicesFromWhitelist: End: Removed %d elements, remaining %zd elements",
-            count, whitelist.size());
+    DBG_PRINT("DBTManager::removeAllDevicesFromWhitelist: End: Removed %d elements", count);
     return count;
 }
 
 bool DBTManager::removeDeviceFromWhitelist(const int dev_id, const EUI48 &address, const BDAddressType address_type) {
     // Remove from our local whitelist first
+    bool freed = false;
     {
-        for(auto it = whitelist.begin(); it != whitelist.end(); ) {
-            std::shared_ptr<WhitelistElem> wle = *it;
-            if( wle->dev_id == dev_id && wle->address == address ) {
-                it = whitelist.erase(it);
-            } else {
-                ++it;
+        const std::lock_guard<std::mutex> lock(mtx_whitelist); // RAII-style acquire and relinquish via destructor
+        if( EUI48_ANY_DEVICE == address ) {
+            whitelist.removeAll(dev_id);
+        } else {
+            DBTWhitelist::Element * e = whitelist.find(dev_id, address);
+            if( nullptr != e ) {
+                freed = e->inController();
+                whitelist.remove(dev_id, address);
             }
         }
     }
 
     // Actual removal
     MgmtRemoveDeviceFromWhitelistCmd req(dev_id, address, address_type);
-    std::shared_ptr<MgmtEvent> res = sendWithReply(req);
-    if( nullptr != res && res->getOpcode() == MgmtEvent::Opcode::CMD_COMPLETE ) {
-        const MgmtEvtCmdComplete &res1 = *static_cast<const MgmtEvtCmdComplete *>(res.get());
-        if( MgmtStatus::SUCCESS == res1.getStatus() ) {
-            return true;
+    const bool res = isReplySuccess( sendWithReply(req) );
+
+    if( freed ) {
+        const std::lock_guard<std::mutex> lock(mtx_whitelist); // RAII-style acquire and relinquish via destructor
+        rotateWhitelistLocked(dev_id);
+    }
+    return res;
+}
+
+int DBTManager::removeDevicesFromWhitelist(const int dev_id, const std::vector<EUI48> & addresses) {
+    int count = 0;
+    std::vector<DBTWhitelist::Element> fromController;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_whitelist); // RAII-style acquire and relinquish via destructor
+        for(size_t i=0; i<addresses.size(); i++) {
+            DBTWhitelist::Element * e = whitelist.find(dev_id, addresses[i]);
+            if( nullptr != e ) {
+                if( e->inController() ) {
+                    fromController.push_back(*e);
+                }
+                whitelist.remove(dev_id, addresses[i]);
+                count++;
+            }
         }
     }
-    return false;
+
+    // Pipelined: Each batch's REMOVE_DEVICE commands are in flight at once, awaiting their replies thereafter.
+    const int timeout = env.MGMT_COMMAND_REPLY_TIMEOUT;
+    for(size_t i=0; i<fromController.size(); i+=WHITELIST_BATCH_SIZE) {
+        const size_t end = std::min<size_t>(fromController.size(), i+WHITELIST_BATCH_SIZE);
+        std::vector<std::shared_ptr<SyncReply>> res;
+        std::vector<bool> sent;
+        for(size_t j=i; j<end; j++) {
+            MgmtRemoveDeviceFromWhitelistCmd req(dev_id, fromController[j].address, fromController[j].address_type);
+            res.push_back( std::make_shared<SyncReply>() );
+            sent.push_back( sendAsync(req, bindSyncReply(res.back())) );
+        }
+        for(size_t j=i; j<end; j++) {
+            if( !sent[j-i] || !isReplySuccess( res[j-i]->await(timeout) ) ) {
+                ERR_PRINT("DBTManager::removeDevicesFromWhitelist: removeDeviceFromWhitelist(dev_id %d, address %s): Failed",
+                        dev_id, fromController[j].address.toString().c_str());
+            }
+        }
+    }
+    DBG_PRINT("DBTManager::removeDevicesFromWhitelist: dev_id %d, removed %d of %zd devices, %zd from controller",
+            dev_id, count, addresses.size(), fromController.size());
+
+    if( fromController.size() > 0 ) {
+        const std::lock_guard<std::mutex> lock(mtx_whitelist); // RAII-style acquire and relinquish via destructor
+        rotateWhitelistLocked(dev_id);
+    }
+    return count;
 }
 
 bool DBTManager::disconnect(const bool ioErrorCause,
@@ -698,58 +1314,114 @@ std::shared_ptr<NameAndShortName> DBTManager::setLocalName(const int dev_id, con
  */
 
 void DBTManager::addMgmtEventCallback(const int dev_id, const MgmtEvent::Opcode opc, const MgmtEventCallback &cb) {
-    const std::lock_guard<std::recursive_mutex> lock(mtx_callbackLists); // RAII-style acquire and relinquish via destructor
+    const std::lock_guard<std::mutex> lock(mtx_callbackLists); // RAII-style acquire and relinquish via destructor
     checkMgmtEventCallbackListsIndex(opc);
-    MgmtAdapterEventCallbackList &l = mgmtAdapterEventCallbackLists[static_cast<uint16_t>(opc)];
-    for (auto it = l.begin(); it != l.end(); ++it) {
-        if ( it->getDevID() == dev_id && it->getCallback() == cb ) {
+    const size_t slot = getCallbackIndexSlot(dev_id);
+    const MgmtAdapterEventCallback acb(0 > dev_id ? -1 : dev_id, cb);
+    std::shared_ptr<const MgmtEventCallbackIndex> index = std::atomic_load(&mgmtEventCallbackIndex);
+    std::shared_ptr<MgmtEventCallbackIndex> index2 = nullptr != index ? std::make_shared<MgmtEventCallbackIndex>(*index) :
+                                                                          std::make_shared<MgmtEventCallbackIndex>();
+    if( slot >= index2->size() ) {
+        index2->resize(slot+1);
+    }
+    MgmtAdapterEventCallbackListRef & l = (*index2)[slot][static_cast<uint16_t>(opc)];
+    MgmtAdapterEventCallbackListRef l2 = nullptr != l ? std::make_shared<std::vector<SequencedEventCallback>>(*l) :
+                                                        std::make_shared<std::vector<SequencedEventCallback>>();
+    for (auto it = l2->begin(); it != l2->end(); ++it) {
+        if ( it->acb == acb ) {
             // already exists for given adapter
             return;
         }
     }
-    l.push_back( MgmtAdapterEventCallback(dev_id, cb) );
+    l2->push_back( SequencedEventCallback{ callbackSeq++, acb } );
+    l = l2;
+    publishCallbackIndex(index2);
 }
 int DBTManager::removeMgmtEventCallback(const MgmtEvent::Opcode opc, const MgmtEventCallback &cb) {
-    const std::lock_guard<std::recursive_mutex> lock(mtx_callbackLists); // RAII-style acquire and relinquish via destructor
-    checkMgmtEventCallbackListsIndex(opc);
     int count = 0;
-    MgmtAdapterEventCallbackList &l = mgmtAdapterEventCallbackLists[static_cast<uint16_t>(opc)];
-    for (auto it = l.begin(); it != l.end(); ) {
-        if ( it->getCallback() == cb ) {
-            it = l.erase(it);
-            count++;
-        } else {
-            ++it;
+    uint64_t version = 0;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_callbackLists); // RAII-style acquire and relinquish via destructor
+        checkMgmtEventCallbackListsIndex(opc);
+        std::shared_ptr<const MgmtEventCallbackIndex> index = std::atomic_load(&mgmtEventCallbackIndex);
+        if( nullptr == index ) {
+            return 0;
         }
+        std::shared_ptr<MgmtEventCallbackIndex> index2 = std::make_shared<MgmtEventCallbackIndex>(*index);
+        for(size_t i=0; i<index2->size(); i++) {
+            MgmtAdapterEventCallbackListRef & l = (*index2)[i][static_cast<uint16_t>(opc)];
+            if( nullptr == l ) {
+                continue;
+            }
+            MgmtAdapterEventCallbackListRef l2 = std::make_shared<std::vector<SequencedEventCallback>>(*l);
+            for (auto it = l2->begin(); it != l2->end(); ) {
+                if ( it->acb.getCallback() == cb ) {
+                    it = l2->erase(it);
+                    count++;
+                } else {
+                    ++it;
+                }
+            }
+            l = l2->empty() ? nullptr : l2;
+        }
+        if( 0 == count ) {
+            return 0;
+        }
+        version = publishCallbackIndex(index2);
     }
+    awaitDispatchQuiescence(version);
     return count;
 }
 int DBTManager::removeMgmtEventCallback(const int dev_id) {
-    const std::lock_guard<std::recursive_mutex> lock(mtx_callbackLists); // RAII-style acquire and relinquish via destructor
     int count = 0;
-    for(size_t i=0; i<mgmtAdapterEventCallbackLists.size(); i++) {
-        MgmtAdapterEventCallbackList &l = mgmtAdapterEventCallbackLists[i];
-        for (auto it = l.begin(); it != l.end(); ) {
-            if ( it->getDevID() == dev_id ) {
-                it = l.erase(it);
-                count++;
-            } else {
-                ++it;
+    uint64_t version = 0;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_callbackLists); // RAII-style acquire and relinquish via destructor
+        const size_t slot = getCallbackIndexSlot(dev_id);
+        std::shared_ptr<const MgmtEventCallbackIndex> index = std::atomic_load(&mgmtEventCallbackIndex);
+        if( nullptr == index || slot >= index->size() ) {
+            return 0;
+        }
+        const MgmtEventCallbackLists & lists = (*index)[slot];
+        for(size_t i=0; i<lists.size(); i++) {
+            if( nullptr != lists[i] ) {
+                count += lists[i]->size();
             }
         }
+        if( 0 == count ) {
+            return 0;
+        }
+        std::shared_ptr<MgmtEventCallbackIndex> index2 = std::make_shared<MgmtEventCallbackIndex>(*index);
+        (*index2)[slot] = MgmtEventCallbackLists();
+        version = publishCallbackIndex(index2);
     }
+    awaitDispatchQuiescence(version);
     return count;
 }
 void DBTManager::clearMgmtEventCallbacks(const MgmtEvent::Opcode opc) {
-    const std::lock_guard<std::recursive_mutex> lock(mtx_callbackLists); // RAII-style acquire and relinquish via destructor
-    checkMgmtEventCallbackListsIndex(opc);
-    mgmtAdapterEventCallbackLists[static_cast<uint16_t>(opc)].clear();
+    uint64_t version = 0;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_callbackLists); // RAII-style acquire and relinquish via destructor
+        checkMgmtEventCallbackListsIndex(opc);
+        std::shared_ptr<const MgmtEventCallbackIndex> index = std::atomic_load(&mgmtEventCallbackIndex);
+        if( nullptr == index ) {
+            return;
+        }
+        std::shared_ptr<MgmtEventCallbackIndex> index2 = std::make_shared<MgmtEventCallbackIndex>(*index);
+        for(size_t i=0; i<index2->size(); i++) {
+            (*index2)[i][static_cast<uint16_t>(opc)] = nullptr;
+        }
+        version = publishCallbackIndex(index2);
+    }
+    awaitDispatchQuiescence(version);
 }
 void DBTManager::clearAllMgmtEventCallbacks() {
-    const std::lock_guard<std::recursive_mutex> lock(mtx_callbackLists); // RAII-style acquire and relinquish via destructor
-    for(size_t i=0; i<mgmtAdapterEventCallbackLists.size(); i++) {
-        mgmtAdapterEventCallbackLists[i].clear();
+    uint64_t version = 0;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_callbackLists); // RAII-style acquire and relinquish via destructor
+        version = publishCallbackIndex(std::shared_ptr<const MgmtEventCallbackIndex>());
     }
+    awaitDispatchQuiescence(version);
 }
 
 bool DBTManager::mgmtEvClassOfDeviceChangedCB(std::shared_ptr<MgmtEvent> e) {
@@ -0,0 +1,225 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2020 Gothel Software e.K.
+ * Copyright (c) 2020 ZAFENA AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <vector>
+#include <cstdio>
+
+#include <algorithm>
+
+#include "DBTWhitelist.hpp"
+
+using namespace direct_bt;
+
+void DBTWhitelist::linkLRU(Adapter & a, Node & n) {
+    // Insert after the last node seen no later, i.e. appended for the most recently seen
+    Node * prev = a.lruTail;
+    while( nullptr != prev && prev->element.ts_last_seen > n.element.ts_last_seen ) {
+        prev = prev->lruPrev;
+    }
+    n.lruPrev = prev;
+    n.lruNext = nullptr != prev ? prev->lruNext : a.lruHead;
+    if( nullptr != n.lruNext ) {
+        n.lruNext->lruPrev = &n;
+    } else {
+        a.lruTail = &n;
+    }
+    if( nullptr != prev ) {
+        prev->lruNext = &n;
+    } else {
+        a.lruHead = &n;
+    }
+    n.inLRU = true;
+}
+
+void DBTWhitelist::unlinkLRU(Adapter & a, Node & n) {
+    if( nullptr != n.lruPrev ) {
+        n.lruPrev->lruNext = n.lruNext;
+    } else {
+        a.lruHead = n.lruNext;
+    }
+    if( nullptr != n.lruNext ) {
+        n.lruNext->lruPrev = n.lruPrev;
+    } else {
+        a.lruTail = n.lruPrev;
+    }
+    n.lruPrev = nullptr;
+    n.lruNext = nullptr;
+    n.inLRU = false;
+}
+
+void DBTWhitelist::updateLRU(Node & n) {
+    const Element & e = n.element;
+    const bool candidate = State::IN_CONTROLLER == e.state && !isConnected(e.dev_id, e.address);
+    if( candidate != n.inLRU ) {
+        Adapter & a = adapters[e.dev_id];
+        if( candidate ) {
+            linkLRU(a, n);
+        } else {
+            unlinkLRU(a, n);
+        }
+    }
+}
+
+void DBTWhitelist::setState(Element & e, const State s) {
+    auto it = elements.find(Key{e.dev_id, e.address});
+    if( it == elements.end() || &it->second.element != &e ) {
+        return; // not owned
+    }
+    Adapter & a = adapters[e.dev_id];
+    a.stateCount[static_cast<int>(e.state)]--;
+    a.stateCount[static_cast<int>(s)]++;
+    e.state = s;
+    updateLRU(it->second);
+}
+
+DBTWhitelist::Element * DBTWhitelist::find(const int dev_id, const EUI48 & address) {
+    auto it = elements.find(Key{dev_id, address});
+    return it != elements.end() ? &it->second.element : nullptr;
+}
+
+DBTWhitelist::Element * DBTWhitelist::add(const Element & e) {
+    auto res = elements.emplace(Key{e.dev_id, e.address}, Node{e, nullptr, nullptr, false});
+    if( !res.second ) {
+        return nullptr;
+    }
+    Element & added = res.first->second.element;
+    added.state = State::HOST_SIDE;
+    adapters[e.dev_id].stateCount[static_cast<int>(State::HOST_SIDE)]++;
+    return &added;
+}
+
+bool DBTWhitelist::remove(const int dev_id, const EUI48 & address) {
+    auto it = elements.find(Key{dev_id, address});
+    if( it == elements.end() ) {
+        return false;
+    }
+    Node & n = it->second;
+    Adapter & a = adapters[dev_id];
+    if( n.inLRU ) {
+        unlinkLRU(a, n);
+    }
+    a.stateCount[static_cast<int>(n.element.state)]--;
+    elements.erase(it);
+    return true;
+}
+
+void DBTWhitelist::removeAll(const int dev_id) {
+    for(auto it = elements.begin(); it != elements.end(); ) {
+        if( it->second.element.dev_id == dev_id ) {
+            it = elements.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    adapters.erase(dev_id);
+}
+
+void DBTWhitelist::clear() {
+    elements.clear();
+    adapters.clear();
+}
+
+bool DBTWhitelist::hasCapacity(const int dev_id) const {
+    return 0 == capacity || getControllerCount(dev_id) < capacity;
+}
+
+int DBTWhitelist::getControllerCount(const int dev_id) const {
+    auto it = adapters.find(dev_id);
+    if( it == adapters.end() ) {
+        return 0;
+    }
+    const int * c = it->second.stateCount;
+    return c[static_cast<int>(State::ADDING)] + c[static_cast<int>(State::IN_CONTROLLER)] + c[static_cast<int>(State::EVICTING)];
+}
+
+int DBTWhitelist::getCount(const int dev_id, const State s) const {
+    auto it = adapters.find(dev_id);
+    return it != adapters.end() ? it->second.stateCount[static_cast<int>(s)] : 0;
+}
+
+void DBTWhitelist::setLastSeen(Element & e, const uint64_t timestamp) {
+    auto it = elements.find(Key{e.dev_id, e.address});
+    if( it == elements.end() || &it->second.element != &e ) {
+        e.ts_last_seen = timestamp;
+        return; // not owned
+    }
+    Node & n = it->second;
+    if( n.inLRU ) {
+        Adapter & a = adapters[e.dev_id];
+        unlinkLRU(a, n);
+        e.ts_last_seen = timestamp;
+        linkLRU(a, n);
+    } else {
+        e.ts_last_seen = timestamp;
+    }
+}
+
+void DBTWhitelist::setConnected(const int dev_id, const EUI48 & address, const bool v) {
+    if( v ) {
+        connected.insert(Key{dev_id, address});
+    } else {
+        connected.erase(Key{dev_id, address});
+    }
+    auto it = elements.find(Key{dev_id, address});
+    if( it != elements.end() ) {
+        updateLRU(it->second);
+    }
+}
+
+bool DBTWhitelist::isConnected(const int dev_id, const EUI48 & address) const {
+    return connected.end() != connected.find(Key{dev_id, address});
+}
+
+DBTWhitelist::Element * DBTWhitelist::getEvictionCandidate(const int dev_id) {
+    auto it = adapters.find(dev_id);
+    if( it == adapters.end() || nullptr == it->second.lruHead ) {
+        return nullptr;
+    }
+    return &it->second.lruHead->element;
+}
+
+std::vector<DBTWhitelist::Element*> DBTWhitelist::getRotationCandidates(const int dev_id) {
+    std::vector<Element*> hostSide;
+    for(auto it = elements.begin(); it != elements.end(); it++) {
+        if( it->second.element.dev_id == dev_id && State::HOST_SIDE == it->second.element.state ) {
+            hostSide.push_back(&it->second.element);
+        }
+    }
+    // most recently seen first
+    std::sort(hostSide.begin(), hostSide.end(), [](const Element *a, const Element *b) {
+        return a->ts_last_seen > b->ts_last_seen;
+    });
+    if( 0 < capacity ) {
+        const size_t free = static_cast<size_t>( std::max(0, capacity - getControllerCount(dev_id)) );
+        if( hostSide.size() > free ) {
+            hostSide.resize(free);
+        }
+    }
+    return hostSide;
+}
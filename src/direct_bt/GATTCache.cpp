@@ -0,0 +1,334 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2020 Gothel Software e.K.
+ * Copyright (c) 2020 ZAFENA AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <vector>
+#include <cstdio>
+
+extern "C" {
+    #include <unistd.h>
+}
+
+#include <dbt_debug.hpp>
+
+#include "GATTCache.hpp"
+#include "DBTDevice.hpp"
+
+using namespace direct_bt;
+
+GATTCacheEnv::GATTCacheEnv()
+: exploding( DBTEnv::getExplodingProperties("direct_bt.gatt.cache") ),
+  ENABLED( DBTEnv::getBooleanProperty("direct_bt.gatt.cache.enabled", true) ),
+  DIRECTORY( DBTEnv::getProperty("direct_bt.gatt.cache.dir", "") ),
+  TRUST_NO_HASH( DBTEnv::getBooleanProperty("direct_bt.gatt.cache.nohash", false) )
+{
+}
+
+/**
+ * Serialized entry, all values in little endian:
+ * <pre>
+ * header      := { uint8_t magic[4] = "DBGC", uint8_t version, uint8_t hash_size, uint8_t hash[hash_size], uint16_t service_count }
+ * service     := { uint8_t is_primary, uint16_t start_handle, uint16_t end_handle, uuid type, uint16_t characteristic_count }
+ * char        := { uint16_t service_handle, uint16_t handle, uint8_t properties, uint16_t value_handle, uuid value_type, uint16_t descriptor_count }
+ * descriptor  := { uint16_t handle, uuid type, uint16_t value_size, uint8_t value[value_size] }
+ * uuid        := { uint8_t type_size, uint8_t value[type_size] }
+ * </pre>
+ */
+const uint8_t GATTCache::VERSION = 1;
+
+static const uint8_t MAGIC[] = { 'D', 'B', 'G', 'C' };
+
+static int getUUIDSize(const uuid_t & uuid) {
+    return 1 + uuid.getTypeSize();
+}
+
+static int getDescriptorValueSize(const GATTDescriptor & d) {
+    return d.isClientCharacteristicConfiguration() ? 0 : d.value.getSize();
+}
+
+static void putUUID(POctets & out, int & i, const uuid_t & uuid) {
+    out.put_uint8(i, uuid.getTypeSize()); i+=1;
+    out.put_uuid(i, uuid); i+=uuid.getTypeSize();
+}
+
+static std::shared_ptr<const uuid_t> getUUID(const TROOctets & in, int & i) {
+    const uuid_t::TypeSize tsize = uuid_t::toTypeSize( in.get_uint8(i) ); i+=1;
+    std::shared_ptr<const uuid_t> uuid = in.get_uuid(i, tsize); i+=tsize;
+    return uuid;
+}
+
+void GATTCache::write(POctets & out, const TROOctets & dbHash, const std::vector<GATTServiceRef> & services) {
+    int size = sizeof(MAGIC) + 1 + 1 + dbHash.getSize() + 2;
+    for(size_t s=0; s<services.size(); s++) {
+        const GATTService & service = *services.at(s);
+        size += 1 + 2 + 2 + getUUIDSize(*service.type) + 2;
+        for(size_t c=0; c<service.characteristicList.size(); c++) {
+            const GATTCharacteristic & characteristic = *service.characteristicList.at(c);
+            size += 2 + 2 + 1 + 2 + getUUIDSize(*characteristic.value_type) + 2;
+            for(size_t d=0; d<characteristic.descriptorList.size(); d++) {
+                const GATTDescriptor & descriptor = *characteristic.descriptorList.at(d);
+                size += 2 + getUUIDSize(*descriptor.type) + 2 + getDescriptorValueSize(descriptor);
+            }
+        }
+    }
+    out.resize(size, size);
+
+    int i=0;
+    for(size_t m=0; m<sizeof(MAGIC); m++) {
+        out.put_uint8(i++, MAGIC[m]);
+    }
+    out.put_uint8(i, VERSION); i+=1;
+    out.put_uint8(i, dbHash.getSize()); i+=1;
+    out.put_octets(i, dbHash); i+=dbHash.getSize();
+    out.put_uint16(i, services.size()); i+=2;
+
+    for(size_t s=0; s<services.size(); s++) {
+        const GATTService & service = *services.at(s);
+        out.put_uint8(i, service.isPrimary ? 1 : 0); i+=1;
+        out.put_uint16(i, service.startHandle); i+=2;
+        out.put_uint16(i, service.endHandle); i+=2;
+        putUUID(out, i, *service.type);
+        out.put_uint16(i, service.characteristicList.size()); i+=2;
+
+        for(size_t c=0; c<service.characteristicList.size(); c++) {
+            const GATTCharacteristic & characteristic = *service.characteristicList.at(c);
+            out.put_uint16(i, characteristic.service_handle); i+=2;
+            out.put_uint16(i, characteristic.handle); i+=2;
+            out.put_uint8(i, characteristic.properties); i+=1;
+            out.put_uint16(i, characteristic.value_handle); i+=2;
+            putUUID(out, i, *characteristic.value_type);
+            out.put_uint16(i, characteristic.descriptorList.size()); i+=2;
+
+            for(size_t d=0; d<characteristic.descriptorList.size(); d++) {
+                const GATTDescriptor & descriptor = *characteristic.descriptorList.at(d);
+                const int vsize = getDescriptorValueSize(descriptor);
+                out.put_uint16(i, descriptor.handle); i+=2;
+                putUUID(out, i, *descriptor.type);
+                out.put_uint16(i, vsize); i+=2;
+                if( 0 < vsize ) {
+                    out.put_octets(i, descriptor.value); i+=vsize;
+                }
+            }
+        }
+    }
+}
+
+bool GATTCache::read(const TROOctets & in, const std::shared_ptr<DBTDevice> & device,
+                     POctets & dbHash, std::vector<GATTServiceRef> & services)
+{
+    services.clear();
+    try {
+        int i=0;
+        for(size_t m=0; m<sizeof(MAGIC); m++) {
+            if( MAGIC[m] != in.get_uint8(i++) ) {
+                WARN_PRINT("GATTCache::read: Invalid magic");
+                return false;
+            }
+        }
+        const uint8_t version = in.get_uint8(i); i+=1;
+        if( VERSION != version ) {
+            WARN_PRINT("GATTCache::read: Version %u != %u", version, VERSION);
+            return false;
+        }
+        const int hashSize = in.get_uint8(i); i+=1;
+        in.check_range(i, hashSize);
+        dbHash.resize(hashSize, hashSize);
+        if( 0 < hashSize ) {
+            dbHash.put_octets(0, TROOctets(in.get_ptr(i), hashSize)); i+=hashSize;
+        }
+        const int serviceCount = in.get_uint16(i); i+=2;
+        services.reserve(serviceCount);
+
+        for(int s=0; s<serviceCount; s++) {
+            const bool isPrimary = 0 != in.get_uint8(i); i+=1;
+            const uint16_t startHandle = in.get_uint16(i); i+=2;
+            const uint16_t endHandle = in.get_uint16(i); i+=2;
+            std::shared_ptr<const uuid_t> type = getUUID(in, i);
+            GATTServiceRef service( new GATTService(device, isPrimary, startHandle, endHandle, type) );
+            const int charCount = in.get_uint16(i); i+=2;
+
+            for(int c=0; c<charCount; c++) {
+                const uint16_t service_handle = in.get_uint16(i); i+=2;
+                const uint16_t handle = in.get_uint16(i); i+=2;
+                const GATTCharacteristic::PropertyBitVal properties = static_cast<GATTCharacteristic::PropertyBitVal>(in.get_uint8(i)); i+=1;
+                const uint16_t value_handle = in.get_uint16(i); i+=2;
+                std::shared_ptr<const uuid_t> value_type = getUUID(in, i);
+                GATTCharacteristicRef characteristic( new GATTCharacteristic(service, service_handle, handle,
+                                                                             properties, value_handle, value_type) );
+                const int descCount = in.get_uint16(i); i+=2;
+
+                for(int d=0; d<descCount; d++) {
+                    const uint16_t dhandle = in.get_uint16(i); i+=2;
+                    std::shared_ptr<const uuid_t> dtype = getUUID(in, i);
+                    GATTDescriptorRef descriptor( new GATTDescriptor(characteristic, dtype, dhandle) );
+                    const int vsize = in.get_uint16(i); i+=2;
+                    in.check_range(i, vsize);
+                    if( descriptor->isClientCharacteristicConfiguration() ) {
+                        // Volatile state, initially disabled for a new connection
+                        descriptor->value.resize(2, 2);
+                        descriptor->value.put_uint16(0, 0);
+                        characteristic->clientCharacteristicsConfigIndex = characteristic->descriptorList.size();
+                    } else if( 0 < vsize ) {
+                        descriptor->value = TROOctets(in.get_ptr(i), vsize);
+                    }
+                    i+=vsize;
+                    characteristic->descriptorList.push_back(descriptor);
+                }
+                service->characteristicList.push_back(characteristic);
+            }
+            services.push_back(service);
+        }
+        if( i != in.getSize() ) {
+            WARN_PRINT("GATTCache::read: Trailing data, read %d of %d bytes", i, in.getSize());
+            services.clear();
+            return false;
+        }
+        return true;
+    } catch (std::exception &e) {
+        WARN_PRINT("GATTCache::read: Caught exception: '%s'", e.what());
+    }
+    services.clear();
+    return false;
+}
+
+GATTCache::GATTCache()
+: env(GATTCacheEnv::get())
+{ }
+
+std::string GATTCache::getKey(const EUI48 & address, const BDAddressType addressType) {
+    return address.toString()+"-"+std::to_string(addressType);
+}
+
+std::string GATTCache::getFilename(const std::string & key) const {
+    return env.DIRECTORY+"/"+key+".gatt";
+}
+
+bool GATTCache::loadFile(const std::string & key, POctets & data) {
+    if( 0 == env.DIRECTORY.size() ) {
+        return false;
+    }
+    const std::string fname = getFilename(key);
+    FILE * f = fopen(fname.c_str(), "rb");
+    if( nullptr == f ) {
+        return false; // not cached
+    }
+    bool res = false;
+    if( 0 == fseek(f, 0, SEEK_END) ) {
+        const long size = ftell(f);
+        if( 0 < size && size <= UINT16_MAX * 16 && 0 == fseek(f, 0, SEEK_SET) ) {
+            data.resize(size, size);
+            res = 1 == fread(data.get_wptr(), size, 1, f);
+        }
+    }
+    fclose(f);
+    if( !res ) {
+        WARN_PRINT("GATTCache::loadFile: Failed reading %s", fname.c_str());
+    }
+    return res;
+}
+
+bool GATTCache::storeFile(const std::string & key, const TROOctets & data) {
+    if( 0 == env.DIRECTORY.size() ) {
+        return false;
+    }
+    const std::string fname = getFilename(key);
+    const std::string fname_tmp = fname+".tmp";
+    FILE * f = fopen(fname_tmp.c_str(), "wb");
+    if( nullptr == f ) {
+        WARN_PRINT("GATTCache::storeFile: Failed opening %s", fname_tmp.c_str());
+        return false;
+    }
+    const bool written = 1 == fwrite(data.get_ptr(), data.getSize(), 1, f);
+    const bool closed = 0 == fclose(f);
+    // atomic replacement, never leaving a truncated entry behind
+    if( !written || !closed || 0 != rename(fname_tmp.c_str(), fname.c_str()) ) {
+        WARN_PRINT("GATTCache::storeFile: Failed writing %s", fname.c_str());
+        unlink(fname_tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+void GATTCache::put(const EUI48 & address, const BDAddressType addressType,
+                    const TROOctets & dbHash, const std::vector<GATTServiceRef> & services)
+{
+    if( !env.ENABLED || ( 0 == dbHash.getSize() && !env.TRUST_NO_HASH ) ) {
+        return;
+    }
+    const std::string key = getKey(address, addressType);
+    POctets data(0);
+    write(data, dbHash, services);
+
+    const std::lock_guard<std::recursive_mutex> lock(mtx_entries); // RAII-style acquire and relinquish via destructor
+    entries.erase(key);
+    entries.emplace(key, data);
+    storeFile(key, data);
+    DBG_PRINT("GATTCache::put: %s, hash %d bytes, %zd services, %d bytes", key.c_str(), dbHash.getSize(), services.size(), data.getSize());
+}
+
+bool GATTCache::get(const std::shared_ptr<DBTDevice> & device, POctets & dbHash, std::vector<GATTServiceRef> & services) {
+    if( !env.ENABLED || nullptr == device ) {
+        return false;
+    }
+    const std::string key = getKey(device->getAddress(), device->getAddressType());
+    const std::lock_guard<std::recursive_mutex> lock(mtx_entries); // RAII-style acquire and relinquish via destructor
+    auto it = entries.find(key);
+    if( it == entries.end() ) {
+        POctets data(0);
+        if( !loadFile(key, data) ) {
+            return false;
+        }
+        it = entries.emplace(key, data).first;
+    }
+    if( !read(it->second, device, dbHash, services) ) {
+        invalidate(device->getAddress(), device->getAddressType());
+        return false;
+    }
+    if( 0 == dbHash.getSize() && !env.TRUST_NO_HASH ) {
+        services.clear();
+        return false;
+    }
+    DBG_PRINT("GATTCache::get: %s, hash %d bytes, %zd services", key.c_str(), dbHash.getSize(), services.size());
+    return true;
+}
+
+bool GATTCache::invalidate(const EUI48 & address, const BDAddressType addressType) {
+    const std::string key = getKey(address, addressType);
+    const std::lock_guard<std::recursive_mutex> lock(mtx_entries); // RAII-style acquire and relinquish via destructor
+    bool res = 0 < entries.erase(key);
+    if( 0 < env.DIRECTORY.size() ) {
+        res = 0 == unlink(getFilename(key).c_str()) || res;
+    }
+    DBG_PRINT("GATTCache::invalidate: %s: %d", key.c_str(), res);
+    return res;
+}
+
+void GATTCache::clear() {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_entries); // RAII-style acquire and relinquish via destructor
+    entries.clear();
+}
@@ -295,3 +295,12 @@ bool GATTCharacteristic::writeValueNoResp(const TROOctets & value) {
     }
     return gatt->writeCharacteristicValueNoResp(*this, value);
 }
+
+bool GATTCharacteristic::writeValueStream(const TROOctets & data, GATTWriteStreamStats & stats) {
+    std::shared_ptr<DBTDevice> device = getDeviceChecked();
+    std::shared_ptr<GATTHandler> gatt = device->getGATTHandler();
+    if( nullptr == gatt ) {
+        throw IllegalStateException("Characteristic's device GATTHandle not connected: "+toSafeString(), E_FILE_LINE);
+    }
+    return gatt->writeCharacteristicValueStream(*this, data, stats);
+}
@@ -29,6 +29,7 @@
 #include <cstdint>
 #include <vector>
 #include <cstdio>
+#include <cmath>
 
 #include  <algorithm>
 
@@ -58,26 +59,177 @@ extern "C" {
 #include "GATTNumbers.hpp"
 
 #include "GATTHandler.hpp"
+#include "GATTCache.hpp"
+#include "GATTListenerQueue.hpp"
+#include "L2CAPReactor.hpp"
 
 #include "HCIComm.hpp"
 #include "DBTTypes.hpp"
 #include "DBTDevice.hpp"
+#include "DBTAdapter.hpp"
 
 using namespace direct_bt;
 
 GATTEnv::GATTEnv()
 : exploding( DBTEnv::getExplodingProperties("direct_bt.gatt") ),
   L2CAP_READER_THREAD_POLL_TIMEOUT( DBTEnv::getInt32Property("direct_bt.gatt.reader.timeout", 10000, 1500 /* min */, INT32_MAX /* max */) ),
+  GATT_REACTOR( DBTEnv::getBooleanProperty("direct_bt.gatt.reactor", false) ),
+  GATT_REACTOR_LISTENER_QUEUE_CAPACITY( DBTEnv::getInt32Property("direct_bt.gatt.reactor.queue", 64, 1 /* min */, 4096 /* max */) ),
   GATT_READ_COMMAND_REPLY_TIMEOUT( DBTEnv::getInt32Property("direct_bt.gatt.cmd.read.timeout", 500, 250 /* min */, INT32_MAX /* max */) ),
   GATT_WRITE_COMMAND_REPLY_TIMEOUT(  DBTEnv::getInt32Property("direct_bt.gatt.cmd.write.timeout", 500, 250 /* min */, INT32_MAX /* max */) ),
   GATT_INITIAL_COMMAND_REPLY_TIMEOUT( DBTEnv::getInt32Property("direct_bt.gatt.cmd.init.timeout", 2500, 2000 /* min */, INT32_MAX /* max */) ),
+  GATT_ADAPTIVE_COMMAND_REPLY_TIMEOUT( DBTEnv::getBooleanProperty("direct_bt.gatt.cmd.adaptive", true) ),
+  GATT_MIN_COMMAND_REPLY_TIMEOUT( DBTEnv::getInt32Property("direct_bt.gatt.cmd.min.timeout", 200, 50 /* min */, INT32_MAX /* max */) ),
+  GATT_MAX_COMMAND_REPLY_TIMEOUT( DBTEnv::getInt32Property("direct_bt.gatt.cmd.max.timeout", 30000, 250 /* min */, INT32_MAX /* max */) ),
   ATTPDU_RING_CAPACITY( DBTEnv::getInt32Property("direct_bt.gatt.ringsize", 128, 64 /* min */, 1024 /* max */) ),
+  ATTPDU_POOL_SIZE( DBTEnv::getInt32Property("direct_bt.gatt.poolsize", 64, 8 /* min */, 1024 /* max */) ),
+  GATT_EATT_BEARER_COUNT( DBTEnv::getInt32Property("direct_bt.gatt.eatt.bearers", 0, 0 /* min */, 8 /* max */) ),
+  GATT_BATCH_DISCOVERY( DBTEnv::getBooleanProperty("direct_bt.gatt.discovery.batch", true) ),
+  GATT_BULK_TRANSFER_THRESHOLD( DBTEnv::getInt32Property("direct_bt.gatt.bulk.threshold", 2048, 0 /* min */, INT32_MAX /* max */) ),
   DEBUG_DATA( DBTEnv::getBooleanProperty("direct_bt.debug.gatt.data", false) )
 {
 }
 
 #define CASE_TO_STRING(V) case V: return #V;
 
+void GATTRTTStats::addSample(const int64_t rtt) {
+    if( 0 == sampleCount ) {
+        minRTT = rtt;
+        maxRTT = rtt;
+    } else {
+        minRTT = std::min(minRTT, rtt);
+        maxRTT = std::max(maxRTT, rtt);
+    }
+    if( 0 == estimatedCount ) {
+        // RFC 6298 2.2: First measurement
+        smoothedRTT = rtt;
+        varianceRTT = rtt / 2.0;
+    } else {
+        // RFC 6298 2.3: beta = 1/4, alpha = 1/8
+        varianceRTT = 0.75 * varianceRTT + 0.25 * std::abs(smoothedRTT - rtt);
+        smoothedRTT = 0.875 * smoothedRTT + 0.125 * rtt;
+    }
+    lastRTT = rtt;
+    sampleCount++;
+    estimatedCount++;
+    backoff = 1;
+}
+
+void GATTRTTStats::addTimeout() {
+    timeoutCount++;
+    if( MAX_BACKOFF > backoff ) {
+        backoff *= 2;
+    }
+}
+
+void GATTRTTStats::restart() {
+    estimatedCount = 0;
+    smoothedRTT = 0.0;
+    varianceRTT = 0.0;
+    backoff = 1;
+}
+
+int GATTRTTStats::getTimeout(const int fallback, const int minTimeout, const int maxTimeout) const {
+    if( MIN_SAMPLES > estimatedCount ) {
+        return fallback;
+    }
+    double timeout = std::max<double>(minTimeout, smoothedRTT + 4.0 * varianceRTT);
+    if( CONVERGED_SAMPLES > estimatedCount ) {
+        // Never wait longer than the fixed timeout based on a few samples only
+        timeout = std::min<double>(timeout, fallback);
+    }
+    // RFC 6298 5.5: Back off the timer, bounded by the maximum
+    const double upper = std::max<double>(fallback, maxTimeout);
+    return (int) std::min<double>(upper, timeout * backoff);
+}
+
+std::string GATTRTTStats::toString() const {
+    return "RTT[samples "+std::to_string(sampleCount)+", timeouts "+std::to_string(timeoutCount)+
+           ", min "+std::to_string(minRTT)+", max "+std::to_string(maxRTT)+", last "+std::to_string(lastRTT)+
+           ", srtt "+std::to_string(smoothedRTT)+", var "+std::to_string(varianceRTT)+" ms, backoff "+std::to_string(backoff)+"]";
+}
+
+thread_local const GATTHandler * GATTHandler::currentHandler = nullptr;
+thread_local GATTHandler::EATTBearer * GATTHandler::currentBearer = nullptr;
+
+GATTHandler::EATTBearer::EATTBearer(const std::shared_ptr<DBTDevice> & device, const GATTEnv & env)
+: l2cap(device, L2CAP_PSM_EATT, L2CAP_CID_UNDEF, L2CAPComm::Mode::EXT_FLOWCTL),
+  rbufferPool(number(Defaults::MAX_ATT_MTU), env.ATTPDU_POOL_SIZE),
+  attPDURing(env.ATTPDU_RING_CAPACITY),
+  mtu(number(Defaults::MIN_EATT_MTU)),
+  readerRunning(false), readerShallStop(false), reactorFd(-1)
+{ }
+
+GATTHandler::EATTBearer::EATTBearer(const int socket, const std::string & deviceString, const GATTEnv & env)
+: l2cap(socket, deviceString, L2CAPComm::Mode::EXT_FLOWCTL),
+  rbufferPool(number(Defaults::MAX_ATT_MTU), env.ATTPDU_POOL_SIZE),
+  attPDURing(env.ATTPDU_RING_CAPACITY),
+  mtu(number(Defaults::MIN_EATT_MTU)),
+  readerRunning(false), readerShallStop(false), reactorFd(-1)
+{ }
+
+GATTHandler::BearerLock::BearerLock(GATTHandler & handler)
+: prevHandler(currentHandler), prevBearer(currentBearer), bearer(nullptr)
+{
+    if( &handler == prevHandler ) {
+        // Nested transaction within this thread, keep the selected bearer
+        lock = std::unique_lock<std::recursive_mutex>( nullptr != prevBearer ? prevBearer->mtx_command : handler.mtx_command );
+        return;
+    }
+    lock = std::unique_lock<std::recursive_mutex>(handler.mtx_command, std::try_to_lock);
+    if( !lock.owns_lock() ) {
+        std::vector<std::shared_ptr<EATTBearer>> bearers;
+        {
+            const std::lock_guard<std::mutex> lockBearers(handler.mtx_eattBearers); // RAII-style acquire and relinquish via destructor
+            bearers = handler.eattBearers;
+        }
+        const unsigned int start = handler.eattBearerNext++;
+        for(size_t i=0; i<bearers.size() && !lock.owns_lock(); i++) {
+            const std::shared_ptr<EATTBearer> & b = bearers[ ( start + i ) % bearers.size() ];
+            if( !b->readerShallStop ) {
+                lock = std::unique_lock<std::recursive_mutex>(b->mtx_command, std::try_to_lock);
+                if( lock.owns_lock() ) {
+                    bearer = b;
+                }
+            }
+        }
+        if( !lock.owns_lock() ) {
+            // All bearers busy, wait for the unenhanced ATT bearer
+            lock = std::unique_lock<std::recursive_mutex>(handler.mtx_command);
+        }
+    }
+    currentHandler = &handler;
+    currentBearer = bearer.get();
+}
+
+GATTHandler::BulkTransferScope::BulkTransferScope(GATTHandler & handler, const int size)
+: handler(handler), device(nullptr)
+{
+    if( &handler == currentHandler ) {
+        // Nested within a locked bearer: No blocking HCI round trip while holding the bearer,
+        // the outermost operation's scope applies.
+        return;
+    }
+    if( 0 < handler.env.GATT_BULK_TRANSFER_THRESHOLD && handler.env.GATT_BULK_TRANSFER_THRESHOLD <= size ) {
+        device = handler.getDevice();
+        if( nullptr != device && device->beginBulkTransfer() ) {
+            // Directly, as DBTDevice::mtx_gatt must not be acquired on the GATT path
+            handler.restartRTTStats();
+        }
+    }
+}
+
+GATTHandler::BulkTransferScope::~BulkTransferScope() {
+    if( nullptr != device && device->endBulkTransfer() ) {
+        handler.restartRTTStats();
+    }
+}
+
+GATTHandler::BearerLock::~BearerLock() {
+    currentHandler = prevHandler;
+    currentBearer = prevBearer;
+}
+
 bool GATTHandler::validateConnected() {
     bool l2capIsConnected = l2cap.getIsConnected();
     bool l2capHasIOError = l2cap.getHasIOError();
@@ -96,6 +248,33 @@ bool GATTHandler::validateConnected() {
     return true;
 }
 
+/**
+ * QueuedGATTCharacteristicListener decorating an application's listener in GATTEnv::GATT_REACTOR mode,
+ * equal to its delegate for duplicate detection and removal.
+ */
+class ReactorQueuedListener : public QueuedGATTCharacteristicListener {
+    public:
+        ReactorQueuedListener(const std::shared_ptr<GATTCharacteristicListener> & delegate, const int capacity)
+        : QueuedGATTCharacteristicListener(delegate, capacity, QueuePolicy::DROP_OLDEST) {}
+
+        bool operator==(const GATTCharacteristicListener& rhs) const override
+        { return this == &rhs || *getDelegate() == rhs; }
+};
+
+/** Cancels the given listener's queue if it is a ReactorQueuedListener, releasing its pending events. */
+static void cancelReactorQueue(const std::shared_ptr<GATTCharacteristicListener> & l) {
+    ReactorQueuedListener * q = dynamic_cast<ReactorQueuedListener*>( l.get() );
+    if( nullptr != q ) {
+        q->cancel();
+    }
+}
+
+/** The single thread disconnecting GATTHandler after their reader has ended in GATTEnv::GATT_REACTOR mode, joined at exit. */
+static GATTListenerExecutor & getReactorDisconnectExecutor() {
+    static GATTListenerExecutor e(1); // Magic Statics, see GATTListenerExecutor::get()
+    return e;
+}
+
 bool GATTHandler::addCharacteristicListener(std::shared_ptr<GATTCharacteristicListener> l) {
     if( nullptr == l ) {
         throw IllegalArgumentException("GATTEventListener ref is null", E_FILE_LINE);
@@ -108,7 +287,12 @@ bool GATTHandler::addCharacteristicListener(std::shared_ptr<GATTCharacteristicLi
             ++it;
         }
     }
+    if( env.GATT_REACTOR && nullptr == dynamic_cast<QueuedGATTCharacteristicListener*>( l.get() ) ) {
+        // Not to be invoked on the reactor thread, see GATTEnv::GATT_REACTOR
+        l = std::make_shared<ReactorQueuedListener>(l, env.GATT_REACTOR_LISTENER_QUEUE_CAPACITY);
+    }
     characteristicListenerList.push_back(l);
+    updateHandleTableListener();
     return true;
 }
 
@@ -126,7 +310,9 @@ bool GATTHandler::removeCharacteristicListener(const GATTCharacteristicListener
     const std::lock_guard<std::recursive_mutex> lock(mtx_eventListenerList); // RAII-style acquire and relinquish via destructor
     for(auto it = characteristicListenerList.begin(); it != characteristicListenerList.end(); ) {
         if ( **it == *l ) {
+            cancelReactorQueue(*it);
             it = characteristicListenerList.erase(it);
+            updateHandleTableListener();
             return true;
         } else {
             ++it;
@@ -149,7 +335,9 @@ int GATTHandler::removeAllAssociatedCharacteristicListener(const GATTCharacteris
     const std::lock_guard<std::recursive_mutex> lock(mtx_eventListenerList); // RAII-style acquire and relinquish via destructor
     for(auto it = characteristicListenerList.begin(); it != characteristicListenerList.end(); ) {
         if ( (*it)->match(*associatedCharacteristic) ) {
+            cancelReactorQueue(*it);
             it = characteristicListenerList.erase(it);
+            updateHandleTableListener();
             return true;
         } else {
             ++it;
@@ -161,54 +349,256 @@ int GATTHandler::removeAllAssociatedCharacteristicListener(const GATTCharacteris
 int GATTHandler::removeAllCharacteristicListener() {
     const std::lock_guard<std::recursive_mutex> lock(mtx_eventListenerList); // RAII-style acquire and relinquish via destructor
     int count = characteristicListenerList.size();
+    for(size_t i=0; i<characteristicListenerList.size(); i++) {
+        cancelReactorQueue(characteristicListenerList[i]);
+    }
     characteristicListenerList.clear();
+    updateHandleTableListener();
     return count;
 }
 
-void GATTHandler::setSendIndicationConfirmation(const bool v) {
+void GATTHandler::dispatchMultipleNotification(const AttMultipleHandleValueNtf & a, OctetsPool & pool) {
+    /* BT Core Spec v5.2: Vol 3, Part G GATT: 4.10.2 Multiple Variable Length Notifications */
+    const uint64_t timestamp = a.ts_creation;
+    const int tupleCount = a.getTupleCount();
     const std::lock_guard<std::recursive_mutex> lock(mtx_eventListenerList); // RAII-style acquire and relinquish via destructor
-    sendIndicationConfirmation = v;
+
+    // Resolve each tuple's characteristic and listener, values remain views into the PDU
+    std::vector<GATTCharacteristicRef> decls(tupleCount, nullptr);
+    std::vector<std::vector<std::shared_ptr<GATTCharacteristicListener>>> tupleListener(tupleCount);
+    for(int t=0; t<tupleCount; t++) {
+        const std::shared_ptr<const HandleEntry> entry = getHandleEntry(a.getTupleHandle(t));
+        if( nullptr != entry && nullptr == entry->descriptor ) {
+            decls[t] = entry->characteristic;
+            tupleListener[t] = entry->listener;
+        } else if( handleTable.size() == 0 && !servicesChanged ) { // not yet built, but not stale either
+            decls[t] = findCharacterisicsByValueHandle(a.getTupleHandle(t));
+            if( nullptr != decls[t] ) {
+                for(auto itl = characteristicListenerList.begin(); itl != characteristicListenerList.end(); itl++) {
+                    if( (*itl)->match(*decls[t]) ) {
+                        tupleListener[t].push_back(*itl);
+                    }
+                }
+            }
+        }
+    }
+    // One batch per listener, legacy listener receive each value individually
+    std::vector<std::shared_ptr<TROOctets>> copies(tupleCount, nullptr);
+    for(size_t i=0; i<characteristicListenerList.size(); i++) {
+        const std::shared_ptr<GATTCharacteristicListener> l = characteristicListenerList[i];
+        std::vector<GATTCharacteristicRef> batchDecls;
+        std::vector<TROOctets> batchValues;
+        std::vector<int> batchTuples;
+        for(int t=0; t<tupleCount; t++) {
+            const std::vector<std::shared_ptr<GATTCharacteristicListener>> & tl = tupleListener[t];
+            if( std::find(tl.begin(), tl.end(), l) != tl.end() ) {
+                batchDecls.push_back(decls[t]);
+                batchValues.push_back(TROOctets(a.getTupleValuePtr(t), a.getTupleValueSize(t)));
+                batchTuples.push_back(t);
+            }
+        }
+        if( 0 == batchTuples.size() ) {
+            continue;
+        }
+        try {
+            if( !l->notificationsReceived(batchDecls, batchValues, timestamp) ) {
+                for(size_t j=0; j<batchTuples.size(); j++) {
+                    const int t = batchTuples[j];
+                    if( nullptr == copies[t] ) {
+                        std::shared_ptr<PooledOctets> b = pool.acquire();
+                        memcpy(b->get_buffer(), a.getTupleValuePtr(t), a.getTupleValueSize(t));
+                        b->setView(0, a.getTupleValueSize(t));
+                        copies[t] = b;
+                    }
+                    l->notificationReceived(decls[t], copies[t], timestamp, a.ts_received);
+                }
+            }
+        } catch (std::exception &e) {
+            ERR_PRINT("GATTHandler::notificationsReceived-CBs %zd/%zd: GATTCharacteristicListener %s: Caught exception %s",
+                    i+1, characteristicListenerList.size(),
+                    aptrHexString((void*)l.get()).c_str(), e.what());
+        }
+    }
 }
 
-bool GATTHandler::getSendIndicationConfirmation() {
+bool GATTHandler::writeClientSupportedFeatures(const uint8_t features) {
+    const uuid16_t csfType = uuid16_t(GattAttributeType::CHARACTERISTIC_CLIENT_SUPPORTED_FEATURES);
+    for(auto its = services.begin(); its != services.end(); its++) {
+        for(auto itc = (*its)->characteristicList.begin(); itc != (*its)->characteristicList.end(); itc++) {
+            const GATTCharacteristicRef & c = *itc;
+            if( csfType == *c->value_type ) {
+                POctets value(1);
+                value.put_uint8(0, features);
+                const bool res = writeValue(c->value_handle, value, true);
+                DBG_PRINT("GATTHandler::writeClientSupportedFeatures: %s -> %d: %s", value.toString().c_str(), res, deviceString.c_str());
+                return res;
+            }
+        }
+    }
+    return false;
+}
+
+bool GATTHandler::readServerSupportedFeatures(uint8_t & res) {
+    const uuid16_t ssfType = uuid16_t(GattAttributeType::CHARACTERISTIC_SERVER_SUPPORTED_FEATURES);
+    for(auto its = services.begin(); its != services.end(); its++) {
+        for(auto itc = (*its)->characteristicList.begin(); itc != (*its)->characteristicList.end(); itc++) {
+            const GATTCharacteristic & c = **itc;
+            if( ssfType == *c.value_type ) {
+                POctets value(number(Defaults::MAX_ATT_MTU), 0);
+                if( !readCharacteristicValue(c, value.resize(0)) || 0 == value.getSize() ) {
+                    return false;
+                }
+                res = value.get_uint8(0);
+                DBG_PRINT("GATTHandler::readServerSupportedFeatures: %s: %s", value.toString().c_str(), deviceString.c_str());
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void GATTHandler::configureFeatures() {
+    bool expConfigured = false; // C++11, exp as value since C++20
+    if( featuresConfigured.compare_exchange_strong(expConfigured, true) ) {
+        // Once per connection, the server keeps the features for the connection's lifetime or bonding
+        uint8_t clientFeatures = GattClientSupportedFeatures::MULTIPLE_HANDLE_VALUE_NTF;
+        if( GATTCache::get().isEnabled() ) {
+            // Change-aware client, the server reports database changes before serving stale handles
+            clientFeatures |= GattClientSupportedFeatures::ROBUST_CACHING;
+        }
+        uint8_t serverFeatures = 0;
+        eattSupported = 0 < env.GATT_EATT_BEARER_COUNT && readServerSupportedFeatures(serverFeatures) &&
+                        0 != ( serverFeatures & GattServerSupportedFeatures::EATT_SUPPORTED );
+        if( eattSupported ) {
+            // BT Core Spec v5.2: Vol 3, Part G GATT: 5.3.1: Client shall indicate EATT support before establishing an EATT bearer
+            clientFeatures |= GattClientSupportedFeatures::ENHANCED_ATT_BEARER;
+        }
+        if( !writeClientSupportedFeatures(clientFeatures) ) {
+            // Retry with the next discovery, e.g. a selective discovery may have omitted the characteristic
+            featuresConfigured = false;
+        }
+    }
+    if( eattSupported && 0 == getEATTBearerCount() ) {
+        const int count = connectEATT(env.GATT_EATT_BEARER_COUNT);
+        DBG_PRINT("GATTHandler::configureFeatures: EATT bearer %d/%d: %s", count, env.GATT_EATT_BEARER_COUNT, deviceString.c_str());
+    }
+}
+
+static const uuid16_t _SERVICE_CHANGED(GattAttributeType::CHARACTERISTIC_SERVICE_CHANGED);
+
+void GATTHandler::buildHandleTable() {
     const std::lock_guard<std::recursive_mutex> lock(mtx_eventListenerList); // RAII-style acquire and relinquish via destructor
-    return sendIndicationConfirmation;
+    // Size by the highest characteristic or descriptor handle, not by the service's end handle, which often is 0xffff.
+    size_t size = 0;
+    for(auto its = services.begin(); its != services.end(); its++) {
+        for(auto itc = (*its)->characteristicList.begin(); itc != (*its)->characteristicList.end(); itc++) {
+            const GATTCharacteristicRef & c = *itc;
+            size = std::max<size_t>(size, c->value_handle + 1);
+            for(auto itd = c->descriptorList.begin(); itd != c->descriptorList.end(); itd++) {
+                size = std::max<size_t>(size, (*itd)->handle + 1);
+            }
+        }
+    }
+    handleTable.clear();
+    handleTable.resize(size, nullptr);
+
+    for(auto its = services.begin(); its != services.end(); its++) {
+        for(auto itc = (*its)->characteristicList.begin(); itc != (*its)->characteristicList.end(); itc++) {
+            const GATTCharacteristicRef & c = *itc;
+            std::vector<std::shared_ptr<GATTCharacteristicListener>> listener;
+            for(auto itl = characteristicListenerList.begin(); itl != characteristicListenerList.end(); itl++) {
+                if( (*itl)->match(*c) ) {
+                    listener.push_back(*itl);
+                }
+            }
+            handleTable[c->value_handle] = std::shared_ptr<const HandleEntry>( new HandleEntry(c, nullptr, listener) );
+            for(auto itd = c->descriptorList.begin(); itd != c->descriptorList.end(); itd++) {
+                handleTable[(*itd)->handle] = std::shared_ptr<const HandleEntry>( new HandleEntry(c, *itd, listener) );
+            }
+        }
+    }
+    DBG_PRINT("GATTHandler::buildHandleTable: size %zd: %s", handleTable.size(), deviceString.c_str());
 }
 
-void GATTHandler::l2capReaderThreadImpl() {
-    bool ioErrorCause = false;
-    {
-        const std::lock_guard<std::mutex> lock(mtx_l2capReaderInit); // RAII-style acquire and relinquish via destructor
-        l2capReaderShallStop = false;
-        l2capReaderRunning = true;
-        DBG_PRINT("l2capReaderThreadImpl Started");
-        cv_l2capReaderInit.notify_all();
+void GATTHandler::updateHandleTableListener() {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_eventListenerList); // RAII-style acquire and relinquish via destructor
+    for(size_t i=0; i<handleTable.size(); i++) {
+        const std::shared_ptr<const HandleEntry> e = handleTable[i];
+        if( nullptr == e ) {
+            continue;
+        }
+        std::vector<std::shared_ptr<GATTCharacteristicListener>> listener;
+        for(auto itl = characteristicListenerList.begin(); itl != characteristicListenerList.end(); itl++) {
+            if( (*itl)->match(*e->characteristic) ) {
+                listener.push_back(*itl);
+            }
+        }
+        // Replace the entry, an ongoing dispatch keeps its own reference
+        handleTable[i] = std::shared_ptr<const HandleEntry>( new HandleEntry(e->characteristic, e->descriptor, listener) );
     }
+}
 
-    while( !l2capReaderShallStop ) {
-        int len;
-        if( !validateConnected() ) {
-            ERR_PRINT("GATTHandler::l2capReaderThread: Invalid IO state -> Stop");
-            l2capReaderShallStop = true;
-            break;
+void GATTHandler::clearHandleTable() {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_eventListenerList); // RAII-style acquire and relinquish via destructor
+    handleTable.clear();
+}
+
+void GATTHandler::updateServiceChangedCharacteristic() {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_eventListenerList); // RAII-style acquire and relinquish via destructor
+    for(auto its = services.begin(); its != services.end(); its++) {
+        for(auto itc = (*its)->characteristicList.begin(); itc != (*its)->characteristicList.end(); itc++) {
+            if( _SERVICE_CHANGED == *(*itc)->value_type ) {
+                serviceChangedChar = *itc;
+                return;
+            }
         }
+    }
+    // Keep a previous one, e.g. if the Generic Attribute service hasn't been selected this time
+}
 
-        len = l2cap.read(rbuffer.get_wptr(), rbuffer.getSize(), env.L2CAP_READER_THREAD_POLL_TIMEOUT);
-        if( 0 < len ) {
-            const AttPDUMsg * attPDU = AttPDUMsg::getSpecialized(rbuffer.get_ptr(), len);
-            const AttPDUMsg::Opcode opc = attPDU->getOpcode();
-
-            if( AttPDUMsg::Opcode::ATT_HANDLE_VALUE_NTF == opc ) {
-                const AttHandleValueRcv * a = static_cast<const AttHandleValueRcv*>(attPDU);
-                COND_PRINT(env.DEBUG_DATA, "GATTHandler: NTF: %s, listener %zd", a->toString().c_str(), characteristicListenerList.size());
-                GATTCharacteristicRef decl = findCharacterisicsByValueHandle(a->getHandle());
-                const std::shared_ptr<TROOctets> data(new POctets(a->getValue()));
-                const uint64_t timestamp = a->ts_creation;
+void GATTHandler::setSendIndicationConfirmation(const bool v) {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_eventListenerList); // RAII-style acquire and relinquish via destructor
+    sendIndicationConfirmation = v;
+}
+
+bool GATTHandler::getSendIndicationConfirmation() {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_eventListenerList); // RAII-style acquire and relinquish via destructor
+    return sendIndicationConfirmation;
+}
+
+void GATTHandler::processReceivedPDU(std::shared_ptr<PooledOctets> & rbuffer, const int len, const uint64_t rxTimestamp, EATTBearer * bearer) {
+    const uint8_t * rptr = rbuffer->get_buffer();
+    const AttPDUMsg::Opcode opc = static_cast<AttPDUMsg::Opcode>(rptr[0]);
+
+    if( ( AttPDUMsg::Opcode::ATT_HANDLE_VALUE_NTF == opc || AttPDUMsg::Opcode::ATT_HANDLE_VALUE_IND == opc ) && 1+2 <= len ) {
+        // ATT_HANDLE_VALUE_NTF and ATT_HANDLE_VALUE_IND: opcode + handle + value
+        const uint16_t handle = get_uint16(rptr, 1, true /* littleEndian */);
+        const uint64_t timestamp = getCurrentMilliseconds();
+        rbuffer->setView(1+2, len-1-2);
+        const std::shared_ptr<TROOctets> data = rbuffer;
+        if( AttPDUMsg::Opcode::ATT_HANDLE_VALUE_NTF == opc ) {
+            COND_PRINT(env.DEBUG_DATA, "GATTHandler: NTF: handle %s, %s, listener %zd", uint16HexString(handle).c_str(), data->toString().c_str(), characteristicListenerList.size());
+            const std::lock_guard<std::recursive_mutex> lock(mtx_eventListenerList); // RAII-style acquire and relinquish via destructor
+            const std::shared_ptr<const HandleEntry> entry = getHandleEntry(handle);
+            if( nullptr != entry && nullptr == entry->descriptor ) {
+                // O(1) dispatch to pre-resolved listener
+                for(size_t i=0; i<entry->listener.size(); i++) {
+                    const std::shared_ptr<GATTCharacteristicListener> & l = entry->listener[i];
+                    try {
+                        l->notificationReceived(entry->characteristic, data, timestamp, rxTimestamp);
+                    } catch (std::exception &e) {
+                        ERR_PRINT("GATTHandler::notificationReceived-CBs %zd/%zd: GATTCharacteristicListener %s: Caught exception %s",
+                                i+1, entry->listener.size(),
+                                aptrHexString((void*)l.get()).c_str(), e.what());
+                    }
+                }
+            } else if( handleTable.size() == 0 && !servicesChanged ) { // not yet built, but not stale either
+                GATTCharacteristicRef decl = findCharacterisicsByValueHandle(handle);
                 int i=0;
                 for_each_idx_mtx(mtx_eventListenerList, characteristicListenerList, [&](std::shared_ptr<GATTCharacteristicListener> &l) {
                     try {
-                        if( l->match(*decl) ) {
-                            l->notificationReceived(decl, data, timestamp);
+                        if( nullptr != decl && l->match(*decl) ) {
+                            l->notificationReceived(decl, data, timestamp, rxTimestamp);
                         }
                     } catch (std::exception &e) {
                         ERR_PRINT("GATTHandler::notificationReceived-CBs %d/%zd: GATTCharacteristicListener %s: Caught exception %s",
@@ -217,24 +607,37 @@ void GATTHandler::l2capReaderThreadImpl() {
                     }
                     i++;
                 });
-                attPDU = nullptr;
-            } else if( AttPDUMsg::Opcode::ATT_HANDLE_VALUE_IND == opc ) {
-                const AttHandleValueRcv * a = static_cast<const AttHandleValueRcv*>(attPDU);
-                COND_PRINT(env.DEBUG_DATA, "GATTHandler: IND: %s, sendIndicationConfirmation %d, listener %zd", a->toString().c_str(), sendIndicationConfirmation, characteristicListenerList.size());
-                bool cfmSent = false;
-                if( sendIndicationConfirmation ) {
-                    AttHandleValueCfm cfm;
-                    send(cfm);
-                    cfmSent = true;
+            }
+        } else {
+            COND_PRINT(env.DEBUG_DATA, "GATTHandler: IND: handle %s, %s, sendIndicationConfirmation %d, listener %zd", uint16HexString(handle).c_str(), data->toString().c_str(), sendIndicationConfirmation, characteristicListenerList.size());
+            bool cfmSent = false;
+            if( sendIndicationConfirmation ) {
+                AttHandleValueCfm cfm;
+                send(cfm, bearer);
+                cfmSent = true;
+            }
+            const std::lock_guard<std::recursive_mutex> lock(mtx_eventListenerList); // RAII-style acquire and relinquish via destructor
+            const std::shared_ptr<const HandleEntry> entry = getHandleEntry(handle);
+            if( nullptr != entry && nullptr == entry->descriptor ) {
+                // O(1) dispatch to pre-resolved listener
+                for(size_t i=0; i<entry->listener.size(); i++) {
+                    const std::shared_ptr<GATTCharacteristicListener> & l = entry->listener[i];
+                    try {
+                        l->indicationReceived(entry->characteristic, data, timestamp, cfmSent, rxTimestamp);
+                    } catch (std::exception &e) {
+                        ERR_PRINT("GATTHandler::indicationReceived-CBs %zd/%zd: GATTCharacteristicListener %s, cfmSent %d: Caught exception %s",
+                                i+1, entry->listener.size(),
+                                aptrHexString((void*)l.get()).c_str(), cfmSent, e.what());
+                    }
                 }
-                GATTCharacteristicRef decl = findCharacterisicsByValueHandle(a->getHandle());
-                const std::shared_ptr<TROOctets> data(new POctets(a->getValue()));
-                const uint64_t timestamp = a->ts_creation;
+            } else if( handleTable.size() == 0 ) {
+                // Not yet built or stale, only the retained Service Changed characteristic remains valid
+                GATTCharacteristicRef decl = servicesChanged ? getServiceChangedCharacteristic(handle) : findCharacterisicsByValueHandle(handle);
                 int i=0;
                 for_each_idx_mtx(mtx_eventListenerList, characteristicListenerList, [&](std::shared_ptr<GATTCharacteristicListener> &l) {
                     try {
-                        if( l->match(*decl) ) {
-                            l->indicationReceived(decl, data, timestamp, cfmSent);
+                        if( nullptr != decl && l->match(*decl) ) {
+                            l->indicationReceived(decl, data, timestamp, cfmSent, rxTimestamp);
                         }
                     } catch (std::exception &e) {
                         ERR_PRINT("GATTHandler::indicationReceived-CBs %d/%zd: GATTCharacteristicListener %s, cfmSent %d: Caught exception %s",
@@ -243,17 +646,81 @@ void GATTHandler::l2capReaderThreadImpl() {
                     }
                     i++;
                 });
-                attPDU = nullptr;
-            } else if( AttPDUMsg::Opcode::ATT_MULTIPLE_HANDLE_VALUE_NTF == opc ) {
-                // FIXME TODO ..
-                ERR_PRINT("GATTHandler: MULTI-NTF not implemented: %s", attPDU->toString().c_str());
-            } else {
-                attPDURing.putBlocking( std::shared_ptr<const AttPDUMsg>( attPDU ) );
-                attPDU = nullptr;
             }
-            if( nullptr != attPDU ) {
-                delete attPDU; // free unhandled PDU
+            if( nullptr != getServiceChangedCharacteristic(handle) ) {
+                // BT Core Spec v5.2: Vol 3, Part G GATT: 7.1 Service Changed
+                // The services are stale until rediscovered, see isServicesChanged()
+                servicesChanged = true;
+                std::shared_ptr<DBTDevice> device = getDevice();
+                if( nullptr != device ) {
+                    INFO_PRINT("GATTHandler: Service Changed -> invalidate GATTCache: %s", deviceString.c_str());
+                    GATTCache::get().invalidate(device->getAddress(), device->getAddressType());
+                }
+                clearHandleTable();
             }
+        }
+    } else {
+        AttPDUMsg * rPDU = AttPDUMsg::getSpecialized(rptr, len);
+        rPDU->ts_received = rxTimestamp;
+        const AttPDUMsg * attPDU = rPDU;
+
+        if( AttPDUMsg::Opcode::ATT_MULTIPLE_HANDLE_VALUE_NTF == opc ) {
+            const AttMultipleHandleValueNtf * a = static_cast<const AttMultipleHandleValueNtf*>(attPDU);
+            COND_PRINT(env.DEBUG_DATA, "GATTHandler: MULTI-NTF: %s, listener %zd", a->toString().c_str(), characteristicListenerList.size());
+            dispatchMultipleNotification(*a, nullptr != bearer ? bearer->rbufferPool : rbufferPool);
+        } else {
+            const std::shared_ptr<const AttPDUMsg> reply( attPDU );
+            attPDU = nullptr;
+            // Never block the reader on a full ring, allowing disconnect() to join it.
+            // At most one request per bearer awaits its reply, hence a full ring only holds unsolicited replies.
+            if( nullptr != bearer ) {
+                if( !bearer->attPDURing.put( reply ) ) {
+                    WARN_PRINT("GATTHandler::processReceivedPDU: EATT ring full, dropped %s: %s", reply->toString().c_str(), deviceString.c_str());
+                }
+            } else if( !completeAsync( reply ) && !attPDURing.put( reply ) ) {
+                WARN_PRINT("GATTHandler::processReceivedPDU: Ring full, dropped %s: %s", reply->toString().c_str(), deviceString.c_str());
+            }
+        }
+        if( nullptr != attPDU ) {
+            delete attPDU; // free unhandled PDU
+        }
+    }
+}
+
+void GATTHandler::l2capReaderThreadImpl(std::weak_ptr<GATTHandler> wself) {
+    bool ioErrorCause = false;
+    bool cancelled = false;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_l2capReaderInit); // RAII-style acquire and relinquish via destructor
+        l2capReaderShallStop = false;
+        l2capReaderRunning = true;
+        DBG_PRINT("l2capReaderThreadImpl Started");
+        cv_l2capReaderInit.notify_all();
+    }
+
+    while( !l2capReaderShallStop ) {
+        int len;
+        if( !validateConnected() ) {
+            ERR_PRINT("GATTHandler::l2capReaderThread: Invalid IO state -> Stop");
+            l2capReaderShallStop = true;
+            break;
+        }
+
+        // Receive into a pooled buffer, allowing to deliver notification values without copy
+        std::shared_ptr<PooledOctets> rbuffer = rbufferPool.acquire();
+        uint64_t rxTimestamp;
+        len = l2cap.read(rbuffer->get_buffer(), rbuffer->getCapacity(), getAsyncPollTimeout(), rxTimestamp);
+        if( 0 < len ) {
+            processReceivedPDU(rbuffer, len, rxTimestamp, nullptr);
+        } else if( ECANCELED == errno ) {
+            // woken up by disconnect(), which is in progress
+            l2capReaderShallStop = true;
+            cancelled = true;
+        } else if( ETIMEDOUT == errno && isAsyncTimedOut() ) {
+            ERR_PRINT("GATTHandler::l2capReaderThread: async reply timeout -> Stop");
+            addRTTTimeout();
+            l2capReaderShallStop = true;
+            ioErrorCause = true;
         } else if( ETIMEDOUT != errno && !l2capReaderShallStop ) { // expected exits
             ERR_PRINT("GATTHandler::l2capReaderThread: l2cap read error -> Stop");
             l2capReaderShallStop = true;
@@ -264,21 +731,320 @@ void GATTHandler::l2capReaderThreadImpl() {
     INFO_PRINT("l2capReaderThreadImpl Ended. Ring has %d entries flushed", attPDURing.getSize());
     l2capReaderRunning = false;
     attPDURing.clear();
-    disconnect(true /* disconnectDevice */, ioErrorCause);
+    if( !cancelled ) {
+        // The device disconnect may release the last reference, hence keep this instance alive.
+        // No reference is left if the destructor is in progress, joining this thread.
+        std::shared_ptr<GATTHandler> self = wself.lock();
+        if( nullptr != self ) {
+            self->disconnect(true /* disconnectDevice */, ioErrorCause);
+        }
+    }
+}
+
+bool GATTHandler::joinReaderThread(std::thread & t) {
+    if( std::this_thread::get_id() == t.get_id() ) {
+        return false; // called by the reader itself, e.g. via a listener or its own disconnect
+    }
+    if( t.joinable() ) {
+        t.join();
+    }
+    return true;
+}
+
+void GATTHandler::joinL2CAPReaderThread() {
+    std::thread t;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_l2capReaderInit); // RAII-style acquire and relinquish via destructor
+        if( std::this_thread::get_id() == l2capReaderThread.get_id() ) {
+            return; // kept for the destructor
+        }
+        t.swap(l2capReaderThread);
+    }
+    joinReaderThread(t);
+}
+
+void GATTHandler::eattReaderThreadImpl(std::shared_ptr<EATTBearer> bearer) {
+    {
+        const std::lock_guard<std::mutex> lock(mtx_l2capReaderInit); // RAII-style acquire and relinquish via destructor
+        bearer->readerRunning = true;
+        DBG_PRINT("eattReaderThreadImpl Started");
+        cv_l2capReaderInit.notify_all();
+    }
+
+    while( !bearer->readerShallStop ) {
+        if( !isConnected || !bearer->l2cap.getIsConnected() || bearer->l2cap.getHasIOError() ) {
+            ERR_PRINT("GATTHandler::eattReaderThread: Invalid IO state -> Stop");
+            break;
+        }
+        std::shared_ptr<PooledOctets> rbuffer = bearer->rbufferPool.acquire();
+        uint64_t rxTimestamp;
+        const int len = bearer->l2cap.read(rbuffer->get_buffer(), rbuffer->getCapacity(), env.L2CAP_READER_THREAD_POLL_TIMEOUT, rxTimestamp);
+        if( 0 < len ) {
+            processReceivedPDU(rbuffer, len, rxTimestamp, bearer.get());
+        } else if( ECANCELED == errno ) {
+            // woken up by stopEATTBearer(..)
+            break;
+        } else if( ETIMEDOUT != errno && !bearer->readerShallStop ) { // expected exits
+            ERR_PRINT("GATTHandler::eattReaderThread: l2cap read error -> Stop");
+            break;
+        }
+    }
+
+    INFO_PRINT("eattReaderThreadImpl Ended. Ring has %d entries flushed", bearer->attPDURing.getSize());
+    eattReaderEnded(bearer);
+}
+
+void GATTHandler::eattReaderEnded(std::shared_ptr<EATTBearer> bearer) {
+    const int fd = bearer->reactorFd.exchange(-1);
+    if( 0 <= fd ) {
+        L2CAPReactor::get().remove(fd);
+    }
+    bearer->readerShallStop = true;
+    bearer->readerRunning = false;
+    bearer->attPDURing.clear();
+    // Only this EATT bearer is lost, the unenhanced ATT bearer remains in use
+    bearer->l2cap.disconnect();
+    {
+        const std::lock_guard<std::mutex> lock(mtx_eattBearers); // RAII-style acquire and relinquish via destructor
+        eattBearers.erase(std::remove(eattBearers.begin(), eattBearers.end(), bearer), eattBearers.end());
+    }
+}
+
+bool GATTHandler::reactorReadable() {
+    if( !validateConnected() ) {
+        ERR_PRINT("GATTHandler::reactorReadable: Invalid IO state -> Stop");
+        reactorReaderEnded(false /* ioErrorCause */);
+        return false;
+    }
+    // Socket is readable, read without poll
+    std::shared_ptr<PooledOctets> rbuffer = rbufferPool.acquire();
+    uint64_t rxTimestamp;
+    const int len = l2cap.read(rbuffer->get_buffer(), rbuffer->getCapacity(), 0 /* timeoutMS */, rxTimestamp);
+    if( 0 < len ) {
+        processReceivedPDU(rbuffer, len, rxTimestamp, nullptr);
+        return true;
+    }
+    ERR_PRINT("GATTHandler::reactorReadable: l2cap read error %d -> Stop", len);
+    reactorReaderEnded(true /* ioErrorCause */);
+    return false;
+}
+
+bool GATTHandler::reactorTick() {
+    if( isAsyncTimedOut() ) {
+        ERR_PRINT("GATTHandler::reactorTick: async reply timeout -> Stop");
+        addRTTTimeout();
+        reactorReaderEnded(true /* ioErrorCause */);
+        return false;
+    }
+    return true;
+}
+
+void GATTHandler::reactorReaderEnded(const bool ioErrorCause) {
+    INFO_PRINT("GATTHandler::reactorReaderEnded: Ring has %d entries flushed", attPDURing.getSize());
+    // Deregister on the reactor thread, before the socket gets closed and its descriptor possibly reused
+    const int fd = reactorFd.exchange(-1);
+    l2capReaderShallStop = true;
+    l2capReaderRunning = false;
+    attPDURing.clear();
+    if( 0 > fd ) {
+        return; // disconnect() in progress
+    }
+    L2CAPReactor::get().remove(fd);
+
+    // The device disconnect issues blocking HCI commands and waits for mtx_command,
+    // hence it must not stall the other sockets of this reactor thread's shard.
+    std::shared_ptr<GATTHandler> self = shared_from_this();
+    getReactorDisconnectExecutor().execute([self, ioErrorCause]() {
+        self->disconnect(true /* disconnectDevice */, ioErrorCause);
+    });
+}
+
+bool GATTHandler::eattReactorReadable(std::shared_ptr<EATTBearer> bearer) {
+    if( !isConnected || !bearer->l2cap.getIsConnected() || bearer->l2cap.getHasIOError() ) {
+        ERR_PRINT("GATTHandler::eattReactorReadable: Invalid IO state -> Stop");
+        eattReaderEnded(bearer);
+        return false;
+    }
+    std::shared_ptr<PooledOctets> rbuffer = bearer->rbufferPool.acquire();
+    uint64_t rxTimestamp;
+    const int len = bearer->l2cap.read(rbuffer->get_buffer(), rbuffer->getCapacity(), 0 /* timeoutMS */, rxTimestamp);
+    if( 0 < len ) {
+        processReceivedPDU(rbuffer, len, rxTimestamp, bearer.get());
+        return true;
+    }
+    ERR_PRINT("GATTHandler::eattReactorReadable: l2cap read error %d -> Stop", len);
+    eattReaderEnded(bearer);
+    return false;
+}
+
+int GATTHandler::connectEATT(const int count) {
+    std::shared_ptr<DBTDevice> device = getDevice();
+    if( nullptr == device || !validateConnected() ) {
+        return 0;
+    }
+    int res = 0;
+    for(int i=0; i<count; i++) {
+        std::shared_ptr<EATTBearer> bearer = std::make_shared<EATTBearer>(device, env);
+        if( !bearer->l2cap.connect() ) {
+            WARN_PRINT("GATTHandler::connectEATT: Could not connect bearer %d/%d: %s", i+1, count, deviceString.c_str());
+            break;
+        }
+        // BT Core Spec v5.2: Vol 3, Part G GATT: 5.3.1: ATT_MTU is the L2CAP channel's MTU, no MTU exchange
+        const int mtu = bearer->l2cap.getMTU();
+        if( number(Defaults::MIN_EATT_MTU) > mtu ) {
+            WARN_PRINT("GATTHandler::connectEATT: Bearer %d/%d MTU %d < %d: %s", i+1, count, mtu, number(Defaults::MIN_EATT_MTU), deviceString.c_str());
+            bearer->l2cap.disconnect();
+            break;
+        }
+        bearer->mtu = std::min(number(Defaults::MAX_ATT_MTU), mtu);
+        if( !startEATTBearer(bearer) ) {
+            break;
+        }
+        DBG_PRINT("GATTHandler::connectEATT: Bearer %d/%d, MTU %d: %s", i+1, count, bearer->mtu, deviceString.c_str());
+        res++;
+    }
+    return res;
+}
+
+bool GATTHandler::addEATTBearer(const int socket, const uint16_t mtu) {
+    std::shared_ptr<EATTBearer> bearer = std::make_shared<EATTBearer>(socket, deviceString, env);
+    if( number(Defaults::MIN_EATT_MTU) > mtu || !validateConnected() ) {
+        bearer->l2cap.disconnect();
+        return false;
+    }
+    bearer->mtu = std::min<int>(number(Defaults::MAX_ATT_MTU), mtu);
+    return startEATTBearer(bearer);
+}
+
+bool GATTHandler::startEATTBearer(std::shared_ptr<EATTBearer> bearer) {
+    {
+        const std::lock_guard<std::mutex> lock(mtx_eattBearers); // RAII-style acquire and relinquish via destructor
+        eattBearers.push_back(bearer);
+    }
+    if( env.GATT_REACTOR ) {
+        const std::weak_ptr<GATTHandler> wself = shared_from_this();
+        bearer->readerShallStop = false;
+        bearer->readerRunning = true;
+        bearer->reactorFd = bearer->l2cap.dd();
+        if( !L2CAPReactor::get().add(bearer->l2cap.dd(),
+                [wself, bearer]() -> bool {
+                    std::shared_ptr<GATTHandler> self = wself.lock();
+                    return nullptr != self && self->eattReactorReadable(bearer);
+                }, nullptr) )
+        {
+            WARN_PRINT("GATTHandler::startEATTBearer: Could not register bearer with L2CAPReactor: %s", deviceString.c_str());
+            bearer->reactorFd = -1;
+            eattReaderEnded(bearer);
+            return false;
+        }
+    } else {
+        std::unique_lock<std::mutex> lock(mtx_l2capReaderInit); // RAII-style acquire and relinquish via destructor
+
+        std::thread eattReaderThread = std::thread(&GATTHandler::eattReaderThreadImpl, this, bearer);
+        DBTEnv::setAdapterThreadAffinity(eattReaderThread.native_handle(), adapterDevId);
+        {
+            // Kept until disconnectEATT(), as eattReaderThread may end early due to I/O errors
+            const std::lock_guard<std::mutex> lockBearers(mtx_eattBearers); // RAII-style acquire and relinquish via destructor
+            eattReaderThreads.push_back( std::move(eattReaderThread) );
+        }
+
+        while( false == bearer->readerRunning ) {
+            cv_l2capReaderInit.wait(lock);
+        }
+    }
+    return true;
+}
+
+int GATTHandler::getEATTBearerCount() {
+    const std::lock_guard<std::mutex> lock(mtx_eattBearers); // RAII-style acquire and relinquish via destructor
+    return eattBearers.size();
+}
+
+void GATTHandler::stopEATTBearer(EATTBearer & bearer) {
+    // Keeps the bearer alive until its reader has been stopped, while no more being selectable for new requests
+    std::shared_ptr<EATTBearer> ref;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_eattBearers); // RAII-style acquire and relinquish via destructor
+        auto it = std::find_if(eattBearers.begin(), eattBearers.end(),
+                [&bearer](const std::shared_ptr<EATTBearer> & b) -> bool { return b.get() == &bearer; });
+        if( it != eattBearers.end() ) {
+            ref = *it;
+            eattBearers.erase(it);
+        }
+    }
+    const int fd = bearer.reactorFd.exchange(-1);
+    if( 0 <= fd ) {
+        // No reader thread in reactor mode, hence release the bearer like eattReaderEnded(..)
+        L2CAPReactor::get().remove(fd);
+        bearer.readerRunning = false;
+        bearer.attPDURing.clear();
+    }
+    bearer.readerShallStop = true;
+    bearer.l2cap.disconnect(); // wakes up the bearer's reader thread
+}
+
+void GATTHandler::disconnectEATT() {
+    std::vector<std::shared_ptr<EATTBearer>> bearers;
+    std::vector<std::thread> readers;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_eattBearers); // RAII-style acquire and relinquish via destructor
+        bearers.swap(eattBearers);
+        readers.swap(eattReaderThreads);
+    }
+    for(size_t i=0; i<bearers.size(); i++) {
+        stopEATTBearer(*bearers[i]);
+    }
+    // Bearers removed before by their reader or stopEATTBearer(..) have been woken up already
+    std::vector<std::thread> kept;
+    for(size_t i=0; i<readers.size(); i++) {
+        if( !joinReaderThread(readers[i]) ) {
+            kept.push_back( std::move(readers[i]) ); // kept for the destructor
+        }
+    }
+    if( 0 < kept.size() ) {
+        const std::lock_guard<std::mutex> lock(mtx_eattBearers); // RAII-style acquire and relinquish via destructor
+        for(size_t i=0; i<kept.size(); i++) {
+            eattReaderThreads.push_back( std::move(kept[i]) );
+        }
+    }
 }
 
 GATTHandler::GATTHandler(const std::shared_ptr<DBTDevice> &device)
 : env(GATTEnv::get()),
-  wbr_device(device), deviceString(device->getAddressString()), rbuffer(number(Defaults::MAX_ATT_MTU)),
+  wbr_device(device), adapterDevId(device->getAdapter().dev_id), deviceString(device->getAddressString()), rbufferPool(number(Defaults::MAX_ATT_MTU), env.ATTPDU_POOL_SIZE),
   l2cap(device, L2CAP_PSM_UNDEF, L2CAP_CID_ATT),
   isConnected(false), hasIOError(false),
   attPDURing(env.ATTPDU_RING_CAPACITY),
-  l2capReaderThreadId(0), l2capReaderRunning(false), l2capReaderShallStop(false),
-  serverMTU(number(Defaults::MIN_ATT_MTU)), usedMTU(number(Defaults::MIN_ATT_MTU))
+  l2capReaderRunning(false), l2capReaderShallStop(false), reactorFd(-1),
+  servicesChanged(false), serverMTU(number(Defaults::MIN_ATT_MTU)), usedMTU(number(Defaults::MIN_ATT_MTU)),
+  syncInFlight(false), readMultipleVariableUnsupported(false), featuresConfigured(false), eattSupported(false),
+  dbHash(GATTCache::DB_HASH_SIZE, 0), dbHashRead(false), eattBearerNext(0)
+{ }
+
+GATTHandler::GATTHandler(const int attSocket, const std::string & deviceString)
+: env(GATTEnv::get()),
+  wbr_device(), adapterDevId(-1), deviceString(deviceString), rbufferPool(number(Defaults::MAX_ATT_MTU), env.ATTPDU_POOL_SIZE),
+  l2cap(attSocket, deviceString),
+  isConnected(false), hasIOError(false),
+  attPDURing(env.ATTPDU_RING_CAPACITY),
+  l2capReaderRunning(false), l2capReaderShallStop(false), reactorFd(-1),
+  servicesChanged(false), serverMTU(number(Defaults::MIN_ATT_MTU)), usedMTU(number(Defaults::MIN_ATT_MTU)),
+  syncInFlight(false), readMultipleVariableUnsupported(false), featuresConfigured(false), eattSupported(false),
+  dbHash(GATTCache::DB_HASH_SIZE, 0), dbHashRead(false), eattBearerNext(0)
 { }
 
 GATTHandler::~GATTHandler() {
     disconnect(false /* disconnectDevice */, false /* ioErrorCause */);
+    // disconnect() leaves the reader to a concurrent disconnect in progress, which is done by now
+    joinL2CAPReaderThread();
+    // Only a reader releasing the last reference itself remains, ending after return
+    if( l2capReaderThread.joinable() ) {
+        l2capReaderThread.detach();
+    }
+    for(size_t i=0; i<eattReaderThreads.size(); i++) {
+        eattReaderThreads[i].detach();
+    }
+    clearHandleTable();
     services.clear();
 }
 
@@ -295,6 +1061,14 @@ bool GATTHandler::connect() {
     const std::lock_guard<std::recursive_mutex> lock(mtx_command); // RAII-style acquire and relinquish via destructor
 
     hasIOError = false;
+    featuresConfigured = false;
+    eattSupported = false;
+    dbHashRead = false;
+    servicesChanged = false;
+    {
+        const std::lock_guard<std::mutex> lockStats(mtx_rttStats); // RAII-style acquire and relinquish via destructor
+        rttStats = GATTRTTStats();
+    }
     DBG_PRINT("GATTHandler::connect: Start: GattHandler[%s], l2cap[%s]: %s",
                 getStateString().c_str(), l2cap.getStateString().c_str(), deviceString.c_str());
 
@@ -303,18 +1077,34 @@ bool GATTHandler::connect() {
         return false;
     }
 
-    /**
-     * We utilize DBTManager's mgmthandler_sigaction SIGALRM handler,
-     * as we only can install one handler.
-     */
-    {
+    if( env.GATT_REACTOR ) {
+        // Weak reference only, as L2CAPReactor::remove(..) does not wait for a callback in progress
+        const std::weak_ptr<GATTHandler> wself = shared_from_this();
+        l2capReaderShallStop = false;
+        l2capReaderRunning = true;
+        reactorFd = l2cap.dd();
+        if( !L2CAPReactor::get().add(l2cap.dd(),
+                [wself]() -> bool {
+                    std::shared_ptr<GATTHandler> self = wself.lock();
+                    return nullptr != self && self->reactorReadable();
+                },
+                [wself]() -> bool {
+                    std::shared_ptr<GATTHandler> self = wself.lock();
+                    return nullptr != self && self->reactorTick();
+                }) )
+        {
+            ERR_PRINT("GATTHandler::connect: Could not register with L2CAPReactor -> disconnect: %s", deviceString.c_str());
+            reactorFd = -1;
+            l2capReaderRunning = false;
+            disconnect(true /* disconnectDevice */, false /* ioErrorCause */);
+            return false;
+        }
+    } else {
+        // The reader thread is woken up by disconnect() via l2cap.disconnect() and joined thereafter
         std::unique_lock<std::mutex> lock(mtx_l2capReaderInit); // RAII-style acquire and relinquish via destructor
 
-        std::thread l2capReaderThread = std::thread(&GATTHandler::l2capReaderThreadImpl, this);
-        l2capReaderThreadId = l2capReaderThread.native_handle();
-        // Avoid 'terminate called without an active exception'
-        // as l2capReaderThread may end due to I/O errors.
-        l2capReaderThread.detach();
+        l2capReaderThread = std::thread(&GATTHandler::l2capReaderThreadImpl, this, std::weak_ptr<GATTHandler>(shared_from_this()));
+        DBTEnv::setAdapterThreadAffinity(l2capReaderThread.native_handle(), adapterDevId);
 
         while( false == l2capReaderRunning ) {
             cv_l2capReaderInit.wait(lock);
@@ -333,9 +1123,16 @@ bool GATTHandler::connect() {
 }
 
 bool GATTHandler::disconnect(const bool disconnectDevice, const bool ioErrorCause) {
+    // Deregister from L2CAPReactor before the socket gets closed and its descriptor possibly reused
+    const int fd = reactorFd.exchange(-1);
+    if( 0 <= fd ) {
+        L2CAPReactor::get().remove(fd);
+        l2capReaderRunning = false;
+    }
     // Interrupt GATT's L2CAP ::connect(..), avoiding prolonged hang
     // and pull all underlying l2cap read operations!
     l2cap.disconnect();
+    disconnectEATT();
 
     // Avoid disconnect re-entry -> potential deadlock
     bool expConn = true; // C++11, exp as value since C++20
@@ -346,6 +1143,13 @@ bool GATTHandler::disconnect(const bool disconnectDevice, const bool ioErrorCaus
         characteristicListenerList.clear();
         return false;
     }
+    // Complete pending async requests before locking, a blocking request may wait for them
+    cancelAsyncRequests();
+
+    // Woken up by l2cap.disconnect() above. The reader either ends or, on a concurrent I/O error,
+    // calls disconnect() failing the state transition above, hence never awaits mtx_command.
+    joinL2CAPReaderThread();
+
     // Lock to avoid other threads using instance while disconnecting
     const std::lock_guard<std::recursive_mutex> lock(mtx_command); // RAII-style acquire and relinquish via destructor
 
@@ -353,20 +1157,10 @@ bool GATTHandler::disconnect(const bool disconnectDevice, const bool ioErrorCaus
     DBG_PRINT("GATTHandler::disconnect: Start: disconnectDevice %d, ioErrorCause %d: GattHandler[%s], l2cap[%s]: %s",
               disconnectDevice, ioErrorCause, getStateString().c_str(), l2cap.getStateString().c_str(), deviceString.c_str());
 
-    const pthread_t tid_self = pthread_self();
-    const pthread_t tid_l2capReader = l2capReaderThreadId;
-    l2capReaderThreadId = 0;
-    const bool is_l2capReader = tid_l2capReader == tid_self;
-    DBG_PRINT("GATTHandler.disconnect: l2capReader[running %d, shallStop %d, isReader %d, tid %p)",
-              l2capReaderRunning.load(), l2capReaderShallStop.load(), is_l2capReader, (void*)tid_l2capReader);
+    DBG_PRINT("GATTHandler.disconnect: l2capReader[running %d, shallStop %d)",
+              l2capReaderRunning.load(), l2capReaderShallStop.load());
     if( l2capReaderRunning ) {
         l2capReaderShallStop = true;
-        if( !is_l2capReader && 0 != tid_l2capReader ) {
-            int kerr;
-            if( 0 != ( kerr = pthread_kill(tid_l2capReader, SIGALRM) ) ) {
-                ERR_PRINT("GATTHandler::disconnect: pthread_kill %p FAILED: %d", (void*)tid_l2capReader, kerr);
-            }
-        }
     }
     removeAllCharacteristicListener();
 
@@ -385,17 +1179,25 @@ bool GATTHandler::disconnect(const bool disconnectDevice, const bool ioErrorCaus
     return true;
 }
 
-void GATTHandler::send(const AttPDUMsg & msg) {
+void GATTHandler::send(const AttPDUMsg & msg, EATTBearer * bearer) {
     if( !validateConnected() ) {
         throw IllegalStateException("GATTHandler::send: Invalid IO State: req "+msg.toString()+" to "+deviceString, E_FILE_LINE);
     }
-    if( msg.pdu.getSize() > usedMTU ) {
-        throw IllegalArgumentException("clientMaxMTU "+std::to_string(msg.pdu.getSize())+" > usedMTU "+std::to_string(usedMTU)+
+    const uint16_t mtu = nullptr != bearer ? bearer->mtu : usedMTU;
+    if( msg.pdu.getSize() > mtu ) {
+        throw IllegalArgumentException("clientMaxMTU "+std::to_string(msg.pdu.getSize())+" > usedMTU "+std::to_string(mtu)+
                                        " to "+deviceString, E_FILE_LINE);
     }
 
     // Thread safe l2cap.write(..) operation..
-    const int res = l2cap.write(msg.pdu.get_ptr(), msg.pdu.getSize());
+    L2CAPComm & l2capBearer = nullptr != bearer ? bearer->l2cap : l2cap;
+    const int res = l2capBearer.write(msg.pdu.get_ptr(), msg.pdu.getSize());
+    if( nullptr != bearer && res != msg.pdu.getSize() ) {
+        // Drop the failed EATT bearer only, keeping the device connected
+        ERR_PRINT("GATTHandler::send: EATT l2cap write error %d -> stop bearer: %s to %s", res, msg.toString().c_str(), deviceString.c_str());
+        stopEATTBearer(*bearer);
+        throw BluetoothException("GATTHandler::send: EATT l2cap write error: req "+msg.toString()+" to "+deviceString, E_FILE_LINE);
+    }
     if( 0 > res ) {
         ERR_PRINT("GATTHandler::send: l2cap write error -> disconnect: %s to %s", msg.toString().c_str(), deviceString.c_str());
         hasIOError = true;
@@ -412,20 +1214,324 @@ void GATTHandler::send(const AttPDUMsg & msg) {
     }
 }
 
-std::shared_ptr<const AttPDUMsg> GATTHandler::sendWithReply(const AttPDUMsg & msg, const int timeout) {
-    send( msg );
+void GATTHandler::addRTTSample(const int64_t rtt) {
+    const std::lock_guard<std::mutex> lock(mtx_rttStats); // RAII-style acquire and relinquish via destructor
+    rttStats.addSample(rtt);
+}
+
+void GATTHandler::addRTTTimeout() {
+    const std::lock_guard<std::mutex> lock(mtx_rttStats); // RAII-style acquire and relinquish via destructor
+    rttStats.addTimeout();
+}
+
+void GATTHandler::restartRTTStats() {
+    const std::lock_guard<std::mutex> lock(mtx_rttStats); // RAII-style acquire and relinquish via destructor
+    rttStats.restart();
+    DBG_PRINT("GATTHandler::restartRTTStats: %s", rttStats.toString().c_str());
+}
+
+int GATTHandler::getReplyTimeout(const int fallback) const {
+    if( !env.GATT_ADAPTIVE_COMMAND_REPLY_TIMEOUT ) {
+        return fallback;
+    }
+    const std::lock_guard<std::mutex> lock(mtx_rttStats); // RAII-style acquire and relinquish via destructor
+    return rttStats.getTimeout(fallback, env.GATT_MIN_COMMAND_REPLY_TIMEOUT, env.GATT_MAX_COMMAND_REPLY_TIMEOUT);
+}
+
+GATTRTTStats GATTHandler::getRTTStats() const {
+    const std::lock_guard<std::mutex> lock(mtx_rttStats); // RAII-style acquire and relinquish via destructor
+    return rttStats;
+}
+
+std::shared_ptr<const AttPDUMsg> GATTHandler::sendWithReply(const AttPDUMsg & msg, const int fixedTimeout, const bool adaptive) {
+    EATTBearer * bearer = getCurrentBearer();
+    const int timeout = adaptive ? getReplyTimeout(fixedTimeout) : fixedTimeout;
+    std::shared_ptr<const AttPDUMsg> res;
+    int64_t t0;
+    if( nullptr != bearer ) {
+        t0 = getCurrentMilliseconds();
+        send( msg, bearer );
+
+        // Ringbuffer read is thread safe
+        res = bearer->attPDURing.getBlocking(timeout);
+        if( nullptr == res ) {
+            // BT Core Spec v5.2: Vol 3, Part F ATT: 3.3.3 Transaction timeout closes the timed out bearer only
+            addRTTTimeout();
+            errno = ETIMEDOUT;
+            ERR_PRINT("GATTHandler::sendWithReply: EATT nullptr result (timeout %d): req %s to %s", timeout, msg.toString().c_str(), deviceString.c_str());
+            stopEATTBearer(*bearer);
+            throw BluetoothException("GATTHandler::sendWithReply: EATT nullptr result (timeout "+std::to_string(timeout)+"): req "+msg.toString()+" to "+deviceString, E_FILE_LINE);
+        }
+        if( adaptive ) {
+            addRTTSample( getCurrentMilliseconds() - t0 );
+        }
+        return res;
+    }
 
-    // Ringbuffer read is thread safe
-    std::shared_ptr<const AttPDUMsg> res = attPDURing.getBlocking(timeout);
+    beginSyncTransaction();
+    try {
+        t0 = getCurrentMilliseconds();
+        send( msg, nullptr );
+
+        // Ringbuffer read is thread safe
+        res = attPDURing.getBlocking(timeout);
+    } catch (...) {
+        endSyncTransaction();
+        throw;
+    }
+    endSyncTransaction();
     if( nullptr == res ) {
+        addRTTTimeout();
         errno = ETIMEDOUT;
         ERR_PRINT("GATTHandler::sendWithReply: nullptr result (timeout %d): req %s to %s", timeout, msg.toString().c_str(), deviceString.c_str());
         disconnect(true /* disconnectDevice */, true /* ioErrorCause */);
         throw BluetoothException("GATTHandler::sendWithReply: nullptr result (timeout "+std::to_string(timeout)+"): req "+msg.toString()+" to "+deviceString, E_FILE_LINE);
     }
+    if( adaptive ) {
+        addRTTSample( getCurrentMilliseconds() - t0 );
+    }
     return res;
 }
 
+void GATTHandler::beginSyncTransaction() {
+    std::unique_lock<std::mutex> lock(mtx_async); // RAII-style acquire and relinquish via destructor
+    syncInFlight = true;
+    while( nullptr != asyncInFlight && isConnected ) {
+        cv_async.wait(lock);
+    }
+}
+
+void GATTHandler::endSyncTransaction() {
+    bool sent;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_async); // RAII-style acquire and relinquish via destructor
+        syncInFlight = false;
+        sent = sendNextAsyncLocked();
+    }
+    if( !sent ) {
+        disconnect(true /* disconnectDevice */, true /* ioErrorCause */);
+    }
+}
+
+bool GATTHandler::sendNextAsyncLocked() {
+    if( syncInFlight || nullptr != asyncInFlight || asyncQueue.empty() || !isConnected ) {
+        return true;
+    }
+    asyncInFlight = asyncQueue.front();
+    asyncQueue.pop_front();
+    asyncInFlight->sent = getCurrentMilliseconds();
+    asyncInFlight->deadline = asyncInFlight->sent + getReplyTimeout(asyncInFlight->timeout);
+
+    const AttPDUMsg & msg = *asyncInFlight->req;
+    COND_PRINT(env.DEBUG_DATA, "GATT async send: %s", msg.toString().c_str());
+    // Thread safe l2cap.write(..) operation..
+    const int res = l2cap.write(msg.pdu.get_ptr(), msg.pdu.getSize());
+    if( res != msg.pdu.getSize() ) {
+        ERR_PRINT("GATTHandler::sendNextAsync: l2cap write error %d: %s to %s", res, msg.toString().c_str(), deviceString.c_str());
+        hasIOError = true;
+        return false;
+    }
+    return true;
+}
+
+bool GATTHandler::completeAsync(const std::shared_ptr<const AttPDUMsg> & reply) {
+    std::shared_ptr<AsyncRequest> done;
+    bool sent;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_async); // RAII-style acquire and relinquish via destructor
+        if( nullptr == asyncInFlight ) {
+            return false;
+        }
+        done = asyncInFlight;
+        asyncInFlight = nullptr;
+        addRTTSample( getCurrentMilliseconds() - done->sent );
+        // Pipeline: Send the next request before processing this reply
+        sent = sendNextAsyncLocked();
+        cv_async.notify_all();
+    }
+    COND_PRINT(env.DEBUG_DATA, "GATT async recv: %s", reply->toString().c_str());
+    try {
+        done->callback.invoke(reply);
+    } catch (std::exception &e) {
+        ERR_PRINT("GATTHandler::completeAsync: %s: Caught exception %s", done->req->toString().c_str(), e.what());
+    }
+    if( !sent ) {
+        disconnect(true /* disconnectDevice */, true /* ioErrorCause */);
+    }
+    return true;
+}
+
+void GATTHandler::cancelAsyncRequests() {
+    std::deque<std::shared_ptr<AsyncRequest>> cancelled;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_async); // RAII-style acquire and relinquish via destructor
+        cancelled.swap(asyncQueue);
+        if( nullptr != asyncInFlight ) {
+            cancelled.push_front(asyncInFlight);
+            asyncInFlight = nullptr;
+        }
+        cv_async.notify_all();
+    }
+    for(size_t i=0; i<cancelled.size(); i++) {
+        try {
+            cancelled[i]->callback.invoke(nullptr);
+        } catch (std::exception &e) {
+            ERR_PRINT("GATTHandler::cancelAsyncRequests: %s: Caught exception %s", cancelled[i]->req->toString().c_str(), e.what());
+        }
+    }
+}
+
+int GATTHandler::getAsyncPollTimeout() {
+    const std::lock_guard<std::mutex> lock(mtx_async); // RAII-style acquire and relinquish via destructor
+    if( nullptr == asyncInFlight ) {
+        return env.L2CAP_READER_THREAD_POLL_TIMEOUT;
+    }
+    const int64_t left = std::max<int64_t>(1, asyncInFlight->deadline - getCurrentMilliseconds());
+    return (int) std::min<int64_t>(left, env.L2CAP_READER_THREAD_POLL_TIMEOUT);
+}
+
+bool GATTHandler::isAsyncTimedOut() {
+    const std::lock_guard<std::mutex> lock(mtx_async); // RAII-style acquire and relinquish via destructor
+    return nullptr != asyncInFlight && getCurrentMilliseconds() >= asyncInFlight->deadline;
+}
+
+bool GATTHandler::sendAsync(const std::shared_ptr<const AttPDUMsg> & req, const GATTReplyCallback & callback, const int timeout) {
+    if( req->pdu.getSize() > usedMTU ) {
+        throw IllegalArgumentException("clientMaxMTU "+std::to_string(req->pdu.getSize())+" > usedMTU "+std::to_string(usedMTU)+
+                                       " to "+deviceString, E_FILE_LINE);
+    }
+    bool sent;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_async); // RAII-style acquire and relinquish via destructor
+        if( !isConnected ) {
+            // cancelAsyncRequests() has been or will be issued by disconnect
+            return false;
+        }
+        asyncQueue.push_back( std::make_shared<AsyncRequest>(req, callback, timeout) );
+        sent = sendNextAsyncLocked();
+    }
+    if( !sent ) {
+        disconnect(true /* disconnectDevice */, true /* ioErrorCause */);
+    }
+    return true;
+}
+
+bool GATTHandler::readValueAsync(const uint16_t handle, const GATTReadValueCallback & callback) {
+    /* BT Core Spec v5.2: Vol 3, Part G GATT: 4.8.1 Read Characteristic Value */
+    std::shared_ptr<POctets> value = std::make_shared<POctets>(number(Defaults::MAX_ATT_MTU), 0);
+    return sendAsync(std::make_shared<AttReadReq>(handle),
+                     bindStdFunc(handle, std::function<void(std::shared_ptr<const AttPDUMsg>)>(
+                         [this, handle, value, callback](std::shared_ptr<const AttPDUMsg> reply) {
+                             readValueAsyncReply(handle, value, callback, reply);
+                         })),
+                     env.GATT_READ_COMMAND_REPLY_TIMEOUT);
+}
+
+void GATTHandler::readValueAsyncReply(const uint16_t handle, std::shared_ptr<POctets> value, GATTReadValueCallback callback,
+                                      std::shared_ptr<const AttPDUMsg> reply) {
+    /* BT Core Spec v5.2: Vol 3, Part G GATT: 4.8.3 Read Long Characteristic Value */
+    bool done = true;
+    bool res = false;
+    if( nullptr == reply ) {
+        ERR_PRINT("GATT readValueAsync failed: handle %u, offset %d: %s", handle, value->getSize(), deviceString.c_str());
+    } else if( reply->getOpcode() == AttPDUMsg::ATT_READ_RSP || reply->getOpcode() == AttPDUMsg::ATT_READ_BLOB_RSP ) {
+        // AttReadRsp and AttReadBlobRsp share the same layout: opcode + value
+        const AttReadRsp * p = static_cast<const AttReadRsp*>(reply.get());
+        *value += p->getValue();
+        res = true;
+        // Another request required if a full ATT_MTU PDU was used
+        done = p->getPDUValueSize() < p->getMaxPDUValueSize(usedMTU) || 0 == p->getPDUValueSize();
+    } else if( reply->getOpcode() == AttPDUMsg::ATT_ERROR_RSP ) {
+        const AttErrorRsp * p = static_cast<const AttErrorRsp *>(reply.get());
+        if( 0 < value->getSize() && AttErrorRsp::ATTRIBUTE_NOT_LONG == p->getErrorCode() ) {
+            res = true; // OK by spec: No more data - end of communication
+        } else {
+            WARN_PRINT("GATT readValueAsync unexpected error %s", reply->toString().c_str());
+        }
+    } else {
+        WARN_PRINT("GATT readValueAsync unexpected reply %s", reply->toString().c_str());
+    }
+    if( !done ) {
+        if( sendAsync(std::make_shared<AttReadBlobReq>(handle, value->getSize()),
+                      bindStdFunc(handle, std::function<void(std::shared_ptr<const AttPDUMsg>)>(
+                          [this, handle, value, callback](std::shared_ptr<const AttPDUMsg> r) {
+                              readValueAsyncReply(handle, value, callback, r);
+                          })),
+                      env.GATT_READ_COMMAND_REPLY_TIMEOUT) ) {
+            return;
+        }
+        res = false;
+    }
+    callback.invoke(res, res ? value : nullptr);
+}
+
+bool GATTHandler::writeValueAsync(const uint16_t handle, const TROOctets & value, const GATTWriteValueCallback & callback) {
+    /* BT Core Spec v5.2: Vol 3, Part G GATT: 4.9.3 Write Characteristic Value */
+    if( value.getSize() > usedMTU - 3 ) {
+        throw IllegalArgumentException("value size "+std::to_string(value.getSize())+" > usedMTU-3 "+std::to_string(usedMTU-3)+
+                                       " to "+deviceString, E_FILE_LINE);
+    }
+    GATTWriteValueCallback cb = callback;
+    return sendAsync(std::make_shared<AttWriteReq>(handle, value),
+                     bindStdFunc(handle, std::function<void(std::shared_ptr<const AttPDUMsg>)>(
+                         [this, handle, cb](std::shared_ptr<const AttPDUMsg> reply) mutable {
+                             bool res = false;
+                             if( nullptr == reply ) {
+                                 ERR_PRINT("GATT writeValueAsync failed: handle %u: %s", handle, deviceString.c_str());
+                             } else if( reply->getOpcode() == AttPDUMsg::ATT_WRITE_RSP ) {
+                                 res = true;
+                             } else {
+                                 WARN_PRINT("GATT writeValueAsync unexpected reply %s", reply->toString().c_str());
+                             }
+                             cb.invoke(res);
+                         })),
+                     env.GATT_WRITE_COMMAND_REPLY_TIMEOUT);
+}
+
+bool GATTHandler::writeValuesPipelined(const std::vector<uint16_t> & handles, const std::vector<POctets> & values, std::vector<bool> & res) {
+    if( handles.size() != values.size() ) {
+        throw IllegalArgumentException("handles count "+std::to_string(handles.size())+" != values count "+std::to_string(values.size()), E_FILE_LINE);
+    }
+    struct PipelineState {
+        std::mutex mtx;
+        std::condition_variable cv;
+        size_t pending = 0;
+        std::vector<bool> res;
+    };
+    std::shared_ptr<PipelineState> state = std::make_shared<PipelineState>();
+    state->res.resize(handles.size(), false);
+
+    for(size_t i=0; i<handles.size(); i++) {
+        {
+            const std::lock_guard<std::mutex> lock(state->mtx); // RAII-style acquire and relinquish via destructor
+            state->pending++;
+        }
+        const bool queued = writeValueAsync(handles[i], values[i],
+                bindStdFunc(handles[i], std::function<void(bool)>( [state, i](bool ok) {
+                    const std::lock_guard<std::mutex> lock(state->mtx); // RAII-style acquire and relinquish via destructor
+                    state->res[i] = ok;
+                    state->pending--;
+                    state->cv.notify_all();
+                })));
+        if( !queued ) {
+            const std::lock_guard<std::mutex> lock(state->mtx); // RAII-style acquire and relinquish via destructor
+            state->pending--;
+            break; // not connected
+        }
+    }
+    std::unique_lock<std::mutex> lock(state->mtx); // RAII-style acquire and relinquish via destructor
+    while( 0 < state->pending ) {
+        state->cv.wait(lock);
+    }
+    res = state->res;
+    for(size_t i=0; i<res.size(); i++) {
+        if( !res[i] ) {
+            return false;
+        }
+    }
+    return true;
+}
+
 uint16_t GATTHandler::exchangeMTU(const uint16_t clientMaxMTU) {
     /***
      * BT Core Spec v5.2: Vol 3, Part G GATT: 4.3.1 Exchange MTU (Server configuration)
@@ -440,7 +1546,7 @@ uint16_t GATTHandler::exchangeMTU(const uint16_t clientMaxMTU) {
     uint16_t mtu = 0;
     DBG_PRINT("GATT send: %s", req.toString().c_str());
 
-    std::shared_ptr<const AttPDUMsg> pdu = sendWithReply(req, env.GATT_INITIAL_COMMAND_REPLY_TIMEOUT);
+    std::shared_ptr<const AttPDUMsg> pdu = sendWithReply(req, env.GATT_INITIAL_COMMAND_REPLY_TIMEOUT, false /* adaptive */);
     if( nullptr != pdu ) {
         if( pdu->getOpcode() == AttPDUMsg::ATT_EXCHANGE_MTU_RSP ) {
             const AttExchangeMTU * p = static_cast<const AttExchangeMTU*>(pdu.get());
@@ -455,6 +1561,13 @@ uint16_t GATTHandler::exchangeMTU(const uint16_t clientMaxMTU) {
 }
 
 GATTCharacteristicRef GATTHandler::findCharacterisicsByValueHandle(const uint16_t charValueHandle) {
+    {
+        const std::lock_guard<std::recursive_mutex> lock(mtx_eventListenerList); // RAII-style acquire and relinquish via destructor
+        if( handleTable.size() > 0 ) {
+            const std::shared_ptr<const HandleEntry> entry = getHandleEntry(charValueHandle);
+            return nullptr != entry && nullptr == entry->descriptor ? entry->characteristic : nullptr;
+        }
+    }
     return findCharacterisicsByValueHandle(charValueHandle, services);
 }
 
@@ -465,31 +1578,172 @@ GATTCharacteristicRef GATTHandler::findCharacterisicsByValueHandle(const uint16_
             return decl;
         }
     }
-    return nullptr;
+    return nullptr;
+}
+
+GATTCharacteristicRef GATTHandler::findCharacterisicsByValueHandle(const uint16_t charValueHandle, GATTServiceRef service) {
+    for(auto it = service->characteristicList.begin(); it != service->characteristicList.end(); it++) {
+        GATTCharacteristicRef decl = *it;
+        if( charValueHandle == decl->value_handle ) {
+            return decl;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<GATTServiceRef> & GATTHandler::discoverCompletePrimaryServices() {
+    return discoverCompletePrimaryServices(std::vector<std::shared_ptr<const uuid_t>>());
+}
+
+std::vector<GATTServiceRef> & GATTHandler::discoverCompletePrimaryServices(const std::vector<std::shared_ptr<const uuid_t>> & serviceFilter) {
+    return discoverCompletePrimaryServices(serviceFilter, std::vector<std::shared_ptr<const uuid_t>>());
+}
+
+bool GATTHandler::isSelected(const std::vector<std::shared_ptr<const uuid_t>> & filter, const uuid_t & type) {
+    if( 0 == filter.size() ) {
+        return true;
+    }
+    for(size_t i=0; i<filter.size(); i++) {
+        if( *filter.at(i) == type ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<GATTServiceRef> & GATTHandler::discoverCompletePrimaryServices(const std::vector<std::shared_ptr<const uuid_t>> & serviceFilter,
+                                                                            const std::vector<std::shared_ptr<const uuid_t>> & characteristicFilter) {
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
+    const bool selective = serviceFilter.size() > 0 || characteristicFilter.size() > 0;
+    auto isServiceFiltered = [&](const GATTServiceRef & s) -> bool {
+        return !isSelected(serviceFilter, *s->type);
+    };
+    auto isCharacteristicFiltered = [&](const GATTCharacteristicRef & c) -> bool {
+        return !isSelected(characteristicFilter, *c->value_type);
+    };
+    // Features are configured before dropping unselected characteristics, which may include the Client Supported Features
+    auto removeFilteredCharacteristics = [&]() {
+        if( characteristicFilter.size() > 0 ) {
+            for(auto it = services.begin(); it != services.end(); it++) {
+                std::vector<GATTCharacteristicRef> & characteristicList = (*it)->characteristicList;
+                characteristicList.erase(std::remove_if(characteristicList.begin(), characteristicList.end(), isCharacteristicFiltered),
+                                         characteristicList.end());
+            }
+        }
+    };
+    // A Service Changed indication received from here on applies to this discovery's result
+    servicesChanged = false;
+    clearHandleTable();
+    if( restoreCachedServices() ) {
+        services.erase(std::remove_if(services.begin(), services.end(), isServiceFiltered), services.end());
+        configureFeatures();
+        updateServiceChangedCharacteristic();
+        removeFilteredCharacteristics();
+        buildHandleTable();
+        return services;
+    }
+    if( !discoverPrimaryServices(services) ) {
+        return services;
+    }
+    services.erase(std::remove_if(services.begin(), services.end(), isServiceFiltered), services.end());
+    if( env.GATT_BATCH_DISCOVERY ) {
+        if( discoverCharacteristics(services) ) {
+            discoverDescriptors(services, characteristicFilter);
+        }
+    } else {
+        for(auto it = services.begin(); it != services.end(); it++) {
+            GATTServiceRef primSrv = *it;
+            if( discoverCharacteristics(primSrv) ) {
+                discoverDescriptors(primSrv, characteristicFilter);
+            }
+        }
+    }
+    if( !selective ) {
+        storeCachedServices();
+    }
+    configureFeatures();
+    updateServiceChangedCharacteristic();
+    removeFilteredCharacteristics();
+    buildHandleTable();
+    return services;
+}
+
+bool GATTHandler::readDatabaseHash(POctets & res) {
+    /***
+     * BT Core Spec v5.2: Vol 3, Part G GATT: 4.8.2 Read Using Characteristic UUID
+     * BT Core Spec v5.2: Vol 3, Part G GATT: 7.3 Database Hash
+     */
+    const uuid16_t dbHashType = uuid16_t(GattAttributeType::CHARACTERISTIC_DATABASE_HASH);
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
+    PERF_TS_T0();
+
+    res.resize(0);
+    const AttReadByNTypeReq req(false /* group */, 0x0001, 0xffff, dbHashType);
+    COND_PRINT(env.DEBUG_DATA, "GATT DB-HASH send: %s", req.toString().c_str());
+
+    std::shared_ptr<const AttPDUMsg> pdu = sendWithReply(req, env.GATT_READ_COMMAND_REPLY_TIMEOUT);
+    if( nullptr != pdu ) {
+        COND_PRINT(env.DEBUG_DATA, "GATT DB-HASH recv: %s", pdu->toString().c_str());
+        if( pdu->getOpcode() == AttPDUMsg::ATT_READ_BY_TYPE_RSP ) {
+            const AttReadByTypeRsp * p = static_cast<const AttReadByTypeRsp*>(pdu.get());
+            if( 0 < p->getElementCount() && GATTCache::DB_HASH_SIZE == p->getElementValueSize() ) {
+                const AttReadByTypeRsp::Element e = p->getElement(0);
+                res = TROOctets(e.getValuePtr(), e.getValueSize());
+            }
+        } else if( pdu->getOpcode() != AttPDUMsg::ATT_ERROR_RSP ) { // error: OK by spec, no Database Hash
+            WARN_PRINT("GATT readDatabaseHash unexpected reply %s", pdu->toString().c_str());
+        }
+    }
+    PERF_TS_TD("GATT readDatabaseHash");
+
+    return 0 < res.getSize();
 }
 
-GATTCharacteristicRef GATTHandler::findCharacterisicsByValueHandle(const uint16_t charValueHandle, GATTServiceRef service) {
-    for(auto it = service->characteristicList.begin(); it != service->characteristicList.end(); it++) {
-        GATTCharacteristicRef decl = *it;
-        if( charValueHandle == decl->value_handle ) {
-            return decl;
-        }
+bool GATTHandler::getDatabaseHash(POctets & res) {
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
+    if( !dbHashRead ) {
+        readDatabaseHash(dbHash); // no Database Hash is a valid result
+        dbHashRead = true;
     }
-    return nullptr;
+    res = dbHash;
+    return 0 < res.getSize();
 }
 
-std::vector<GATTServiceRef> & GATTHandler::discoverCompletePrimaryServices() {
-    const std::lock_guard<std::recursive_mutex> lock(mtx_command); // RAII-style acquire and relinquish via destructor
-    if( !discoverPrimaryServices(services) ) {
-        return services;
+bool GATTHandler::restoreCachedServices() {
+    GATTCache & cache = GATTCache::get();
+    std::shared_ptr<DBTDevice> device = getDevice();
+    if( !cache.isEnabled() || nullptr == device ) {
+        return false;
     }
-    for(auto it = services.begin(); it != services.end(); it++) {
-        GATTServiceRef primSrv = *it;
-        if( discoverCharacteristics(primSrv) ) {
-            discoverDescriptors(primSrv);
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
+    POctets cachedHash(GATTCache::DB_HASH_SIZE, 0);
+    std::vector<GATTServiceRef> cachedServices;
+    if( !cache.get(device, cachedHash, cachedServices) ) {
+        return false;
+    }
+    if( 0 < cachedHash.getSize() ) {
+        POctets hash(GATTCache::DB_HASH_SIZE, 0);
+        if( !getDatabaseHash(hash) || hash != cachedHash ) {
+            DBG_PRINT("GATTHandler::restoreCachedServices: Database Hash changed: %s", deviceString.c_str());
+            cache.invalidate(device->getAddress(), device->getAddressType());
+            return false;
         }
     }
-    return services;
+    services = cachedServices;
+    DBG_PRINT("GATTHandler::restoreCachedServices: %zd services: %s", services.size(), deviceString.c_str());
+    return services.size() > 0;
+}
+
+void GATTHandler::storeCachedServices() {
+    GATTCache & cache = GATTCache::get();
+    std::shared_ptr<DBTDevice> device = getDevice();
+    if( !cache.isEnabled() || nullptr == device || 0 == services.size() ) {
+        return;
+    }
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
+    POctets hash(GATTCache::DB_HASH_SIZE, 0);
+    getDatabaseHash(hash);
+    cache.put(device->getAddress(), device->getAddressType(), hash, services);
 }
 
 bool GATTHandler::discoverPrimaryServices(std::vector<GATTServiceRef> & result) {
@@ -501,7 +1755,7 @@ bool GATTHandler::discoverPrimaryServices(std::vector<GATTServiceRef> & result)
      * in the Read by Type Group Response is 0xFFFF.
      */
     const uuid16_t groupType = uuid16_t(GattAttributeType::PRIMARY_SERVICE);
-    const std::lock_guard<std::recursive_mutex> lock(mtx_command); // RAII-style acquire and relinquish via destructor
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
     PERF_TS_T0();
 
     std::shared_ptr<DBTDevice> device = getDevice();
@@ -566,7 +1820,7 @@ bool GATTHandler::discoverCharacteristics(GATTServiceRef & service) {
      * </p>
      */
     const uuid16_t characteristicTypeReq = uuid16_t(GattAttributeType::CHARACTERISTIC);
-    const std::lock_guard<std::recursive_mutex> lock(mtx_command); // RAII-style acquire and relinquish via destructor
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
     COND_PRINT(env.DEBUG_DATA, "GATT discoverCharacteristics Service: %s", service->toString().c_str());
 
     PERF_TS_T0();
@@ -586,17 +1840,7 @@ bool GATTHandler::discoverCharacteristics(GATTServiceRef & service) {
                 const int e_count = p->getElementCount();
 
                 for(int e_iter=0; e_iter<e_count; e_iter++) {
-                    // handle: handle for the Characteristics declaration
-                    // value: Characteristics Property, Characteristics Value Handle _and_ Characteristics UUID
-                    const int ePDUOffset = p->getElementPDUOffset(e_iter);
-                    const int esz = p->getElementTotalSize();
-                    service->characteristicList.push_back( GATTCharacteristicRef( new GATTCharacteristic(
-                        service,
-                        p->pdu.get_uint16(ePDUOffset), // Characteristics's Service Handle
-                        p->getElementHandle(e_iter), // Characteristic Handle
-                        static_cast<GATTCharacteristic::PropertyBitVal>(p->pdu.get_uint8(ePDUOffset  + 2)), // Characteristics Property
-                        p->pdu.get_uint16(ePDUOffset + 2 + 1), // Characteristics Value Handle
-                        p->pdu.get_uuid(ePDUOffset   + 2 + 1 + 2, uuid_t::toTypeSize(esz-2-1-2) ) ) ) ); // Characteristics Value Type UUID
+                    service->characteristicList.push_back( createCharacteristic(service, *p, e_iter) );
                     COND_PRINT(env.DEBUG_DATA, "GATT C discovered[%d/%d]: %s", e_iter, e_count, service->characteristicList.at(service->characteristicList.size()-1)->toString().c_str());
                 }
                 handle = p->getElementHandle(e_count-1); // Last Characteristic Handle
@@ -624,6 +1868,10 @@ bool GATTHandler::discoverCharacteristics(GATTServiceRef & service) {
 }
 
 bool GATTHandler::discoverDescriptors(GATTServiceRef & service) {
+    return discoverDescriptors(service, std::vector<std::shared_ptr<const uuid_t>>());
+}
+
+bool GATTHandler::discoverDescriptors(GATTServiceRef & service, const std::vector<std::shared_ptr<const uuid_t>> & characteristicFilter) {
     /***
      * BT Core Spec v5.2: Vol 3, Part G GATT: 4.7.1 Discover All Characteristic Descriptors
      * <p>
@@ -631,7 +1879,7 @@ bool GATTHandler::discoverDescriptors(GATTServiceRef & service) {
      * </p>
      */
     COND_PRINT(env.DEBUG_DATA, "GATT discoverDescriptors Service: %s", service->toString().c_str());
-    const std::lock_guard<std::recursive_mutex> lock(mtx_command); // RAII-style acquire and relinquish via destructor
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
     PERF_TS_T0();
 
     bool done=false;
@@ -639,6 +1887,9 @@ bool GATTHandler::discoverDescriptors(GATTServiceRef & service) {
     for(int charIter=0; !done && charIter < charCount; charIter++ ) {
         GATTCharacteristicRef charDecl = service->characteristicList[charIter];
         charDecl->clearDescriptors();
+        if( !isSelected(characteristicFilter, *charDecl->value_type) ) {
+            continue;
+        }
         COND_PRINT(env.DEBUG_DATA, "GATT discoverDescriptors Characteristic[%d/%d]: %s", charIter, charCount, charDecl->toString().c_str());
 
         uint16_t cd_handle_iter = charDecl->value_handle + 1; // Start @ Characteristic Value Handle + 1
@@ -681,16 +1932,10 @@ bool GATTHandler::discoverDescriptors(GATTServiceRef & service) {
                         break;
 
                     }
-                    if( !readDescriptorValue(*cd, 0) ) {
-                        ERR_PRINT("GATT discoverDescriptors readDescriptorValue failed: %s . %s - %s",
-                                req.toString().c_str(), cd->toString().c_str(), deviceString.c_str());
+                    if( !addDescriptor(*charDecl, cd) ) {
                         done = true;
                         break;
                     }
-                    if( cd->isClientCharacteristicConfiguration() ) {
-                        charDecl->clientCharacteristicsConfigIndex = charDecl->descriptorList.size();
-                    }
-                    charDecl->descriptorList.push_back(cd);
                     COND_PRINT(env.DEBUG_DATA, "GATT CD discovered[%d/%d]: %s", e_iter, e_count, cd->toString().c_str());
                 }
                 cd_handle_iter = p->getElementHandle(e_count-1); // Last Descriptor Handle
@@ -712,6 +1957,229 @@ bool GATTHandler::discoverDescriptors(GATTServiceRef & service) {
     return service->characteristicList.size() > 0;
 }
 
+size_t GATTHandler::getConsecutiveServicesEnd(const std::vector<GATTServiceRef> & services, const size_t start) {
+    size_t end = start;
+    while( end+1 < services.size() && services.at(end)->endHandle < 0xffff &&
+           services.at(end)->endHandle + 1 == services.at(end+1)->startHandle )
+    {
+        end++;
+    }
+    return end;
+}
+
+GATTCharacteristicRef GATTHandler::createCharacteristic(GATTServiceRef & service, const AttReadByTypeRsp & p, const int e_iter) {
+    // handle: handle for the Characteristics declaration
+    // value: Characteristics Property, Characteristics Value Handle _and_ Characteristics UUID
+    const int ePDUOffset = p.getElementPDUOffset(e_iter);
+    const int esz = p.getElementTotalSize();
+    return GATTCharacteristicRef( new GATTCharacteristic(
+        service,
+        p.pdu.get_uint16(ePDUOffset), // Characteristics's Service Handle
+        p.getElementHandle(e_iter), // Characteristic Handle
+        static_cast<GATTCharacteristic::PropertyBitVal>(p.pdu.get_uint8(ePDUOffset  + 2)), // Characteristics Property
+        p.pdu.get_uint16(ePDUOffset + 2 + 1), // Characteristics Value Handle
+        p.pdu.get_uuid(ePDUOffset   + 2 + 1 + 2, uuid_t::toTypeSize(esz-2-1-2) ) ) ); // Characteristics Value Type UUID
+}
+
+bool GATTHandler::addDescriptor(GATTCharacteristic & charDecl, GATTDescriptorRef & cd) {
+    if( !readDescriptorValue(*cd, 0) ) {
+        ERR_PRINT("GATT discoverDescriptors readDescriptorValue failed: %s . %s - %s",
+                charDecl.toString().c_str(), cd->toString().c_str(), deviceString.c_str());
+        return false;
+    }
+    if( cd->isClientCharacteristicConfiguration() ) {
+        charDecl.clientCharacteristicsConfigIndex = charDecl.descriptorList.size();
+    }
+    charDecl.descriptorList.push_back(cd);
+    return true;
+}
+
+bool GATTHandler::discoverCharacteristics(std::vector<GATTServiceRef> & services) {
+    /***
+     * BT Core Spec v5.2: Vol 3, Part G GATT: 4.6.1 Discover All Characteristics of a Service
+     *
+     * Performed over the complete handle range of consecutive services,
+     * as the ATT_READ_BY_TYPE_REQ returns the characteristic declarations sorted by handle.
+     */
+    const uuid16_t characteristicTypeReq = uuid16_t(GattAttributeType::CHARACTERISTIC);
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
+    PERF_TS_T0();
+
+    int count = 0;
+    bool failed = false;
+    for(size_t runStart = 0; !failed && runStart < services.size(); ) {
+        const size_t runEnd = getConsecutiveServicesEnd(services, runStart);
+        const uint16_t endHandle = services.at(runEnd)->endHandle;
+        for(size_t i=runStart; i<=runEnd; i++) {
+            services.at(i)->characteristicList.clear();
+        }
+        size_t sIter = runStart;
+        uint16_t handle = services.at(runStart)->startHandle;
+        bool done=false;
+
+        while(!done) {
+            const AttReadByNTypeReq req(false /* group */, handle, endHandle, characteristicTypeReq);
+            COND_PRINT(env.DEBUG_DATA, "GATT C batch discover send: %s", req.toString().c_str());
+
+            std::shared_ptr<const AttPDUMsg> pdu = sendWithReply(req, env.GATT_READ_COMMAND_REPLY_TIMEOUT);
+            if( nullptr == pdu ) {
+                ERR_PRINT("GATT discoverCharacteristics send failed: %s - %s", req.toString().c_str(), deviceString.c_str());
+                failed = true;
+                break;
+            }
+            COND_PRINT(env.DEBUG_DATA, "GATT C batch discover recv: %s", pdu->toString().c_str());
+            if( pdu->getOpcode() == AttPDUMsg::ATT_READ_BY_TYPE_RSP ) {
+                const AttReadByTypeRsp * p = static_cast<const AttReadByTypeRsp*>(pdu.get());
+                const int e_count = p->getElementCount();
+
+                for(int e_iter=0; e_iter<e_count; e_iter++) {
+                    const uint16_t c_handle = p->getElementHandle(e_iter);
+                    while( sIter < runEnd && c_handle > services.at(sIter)->endHandle ) {
+                        sIter++;
+                    }
+                    GATTServiceRef & service = services.at(sIter);
+                    if( c_handle < service->startHandle || c_handle > service->endHandle ) { // should never happen!
+                        ERR_PRINT("GATT discoverCharacteristics C handle %s not in range [%s..%s]: %s",
+                                uint16HexString(c_handle).c_str(), uint16HexString(service->startHandle).c_str(),
+                                uint16HexString(service->endHandle).c_str(), deviceString.c_str());
+                        continue;
+                    }
+                    service->characteristicList.push_back( createCharacteristic(service, *p, e_iter) );
+                    count++;
+                    COND_PRINT(env.DEBUG_DATA, "GATT C discovered[%d/%d]: %s", e_iter, e_count, service->characteristicList.at(service->characteristicList.size()-1)->toString().c_str());
+                }
+                handle = p->getElementHandle(e_count-1); // Last Characteristic Handle
+                if( handle < endHandle ) {
+                    handle++;
+                } else {
+                    done = true; // OK by spec: End of communication
+                }
+            } else if( pdu->getOpcode() == AttPDUMsg::ATT_ERROR_RSP ) {
+                done = true; // OK by spec: End of communication
+            } else {
+                WARN_PRINT("GATT discoverCharacteristics unexpected reply %s", pdu->toString().c_str());
+                done = true;
+            }
+        }
+        runStart = runEnd + 1;
+    }
+    if( failed ) {
+        for(size_t i=0; i<services.size(); i++) {
+            services.at(i)->characteristicList.clear();
+        }
+        count = 0;
+    }
+    PERF_TS_TD("GATT discoverCharacteristics (batch)");
+
+    return count > 0;
+}
+
+bool GATTHandler::discoverDescriptors(std::vector<GATTServiceRef> & services) {
+    return discoverDescriptors(services, std::vector<std::shared_ptr<const uuid_t>>());
+}
+
+bool GATTHandler::discoverDescriptors(std::vector<GATTServiceRef> & services, const std::vector<std::shared_ptr<const uuid_t>> & characteristicFilter) {
+    /***
+     * BT Core Spec v5.2: Vol 3, Part G GATT: 4.7.1 Discover All Characteristic Descriptors
+     *
+     * Performed over the complete handle range of consecutive services.
+     * The ATT_FIND_INFORMATION_RSP also contains the service, characteristic declaration and value attributes,
+     * which are skipped. All remaining attributes following a characteristic value are its descriptors.
+     */
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
+    PERF_TS_T0();
+
+    std::vector<GATTDescriptorRef> descriptors;
+    bool failed = false;
+    for(size_t runStart = 0; !failed && runStart < services.size(); ) {
+        const size_t runEnd = getConsecutiveServicesEnd(services, runStart);
+        const uint16_t endHandle = services.at(runEnd)->endHandle;
+        bool anySelected = false;
+        for(size_t i=runStart; i<=runEnd; i++) {
+            std::vector<GATTCharacteristicRef> & characteristicList = services.at(i)->characteristicList;
+            for(size_t j=0; j<characteristicList.size(); j++) {
+                characteristicList.at(j)->clearDescriptors();
+                anySelected = anySelected || isSelected(characteristicFilter, *characteristicList.at(j)->value_type);
+            }
+        }
+        if( !anySelected ) {
+            runStart = runEnd + 1;
+            continue;
+        }
+        size_t sIter = runStart;
+        size_t cIter = 0;
+        uint16_t handle = services.at(runStart)->startHandle;
+        bool done=false;
+
+        while(!done) {
+            const AttFindInfoReq req(handle, endHandle);
+            COND_PRINT(env.DEBUG_DATA, "GATT CD batch discover send: %s", req.toString().c_str());
+
+            std::shared_ptr<const AttPDUMsg> pdu = sendWithReply(req, env.GATT_READ_COMMAND_REPLY_TIMEOUT);
+            if( nullptr == pdu ) {
+                ERR_PRINT("GATT discoverDescriptors send failed: %s - %s", req.toString().c_str(), deviceString.c_str());
+                failed = true;
+                break;
+            }
+            COND_PRINT(env.DEBUG_DATA, "GATT CD batch discover recv: %s", pdu->toString().c_str());
+
+            if( pdu->getOpcode() == AttPDUMsg::ATT_FIND_INFORMATION_RSP ) {
+                const AttFindInfoRsp * p = static_cast<const AttFindInfoRsp*>(pdu.get());
+                const int e_count = p->getElementCount();
+
+                for(int e_iter=0; e_iter<e_count; e_iter++) {
+                    const uint16_t cd_handle = p->getElementHandle(e_iter);
+                    while( sIter < runEnd && cd_handle > services.at(sIter)->endHandle ) {
+                        sIter++;
+                        cIter = 0;
+                    }
+                    std::vector<GATTCharacteristicRef> & characteristicList = services.at(sIter)->characteristicList;
+                    if( 0 == characteristicList.size() ) {
+                        continue; // service w/o characteristics
+                    }
+                    while( cIter+1 < characteristicList.size() && characteristicList.at(cIter+1)->handle <= cd_handle ) {
+                        cIter++;
+                    }
+                    GATTCharacteristicRef & charDecl = characteristicList.at(cIter);
+                    if( cd_handle <= charDecl->value_handle || cd_handle > services.at(sIter)->endHandle ) {
+                        continue; // service, include or characteristic declaration or value attribute
+                    }
+                    if( !isSelected(characteristicFilter, *charDecl->value_type) ) {
+                        continue; // descriptor of an unselected characteristic, not read
+                    }
+                    // handle: handle of Characteristic Descriptor.
+                    // value: Characteristic Descriptor UUID.
+                    GATTDescriptorRef cd( new GATTDescriptor(charDecl, p->getElementValue(e_iter), cd_handle) );
+                    descriptors.push_back(cd);
+                }
+                handle = p->getElementHandle(e_count-1); // Last Descriptor Handle
+                if( handle < endHandle ) {
+                    handle++;
+                } else {
+                    done = true; // OK by spec: End of communication
+                }
+            } else if( pdu->getOpcode() == AttPDUMsg::ATT_ERROR_RSP ) {
+                done = true; // OK by spec: End of communication
+            } else {
+                WARN_PRINT("GATT discoverDescriptors unexpected opcode reply %s", pdu->toString().c_str());
+                done = true;
+            }
+        }
+        runStart = runEnd + 1;
+    }
+    for(size_t i=0; !failed && i<descriptors.size(); i++) {
+        GATTDescriptorRef & cd = descriptors.at(i);
+        GATTCharacteristicRef charDecl = cd->getCharacteristicUnchecked();
+        if( nullptr == charDecl || !addDescriptor(*charDecl, cd) ) {
+            failed = true;
+        }
+        COND_PRINT(env.DEBUG_DATA, "GATT CD discovered[%zd/%zd]: %s", i, descriptors.size(), cd->toString().c_str());
+    }
+    PERF_TS_TD("GATT discoverDescriptors (batch)");
+
+    return !failed && services.size() > 0;
+}
+
 bool GATTHandler::readDescriptorValue(GATTDescriptor & desc, int expectedLength) {
     COND_PRINT(env.DEBUG_DATA, "GATTHandler::readDescriptorValue expLen %d, desc %s", expectedLength, desc.toString().c_str());
     return readValue(desc.handle, desc.value, expectedLength);
@@ -723,20 +2191,25 @@ bool GATTHandler::readCharacteristicValue(const GATTCharacteristic & decl, POcte
 }
 
 bool GATTHandler::readValue(const uint16_t handle, POctets & res, int expectedLength) {
+    return readValue(handle, res, expectedLength, 0);
+}
+
+bool GATTHandler::readValue(const uint16_t handle, POctets & res, int expectedLength, const int initialOffset) {
     /* BT Core Spec v5.2: Vol 3, Part G GATT: 4.8.1 Read Characteristic Value */
     /* BT Core Spec v5.2: Vol 3, Part G GATT: 4.8.3 Read Long Characteristic Value */
-    const std::lock_guard<std::recursive_mutex> lock(mtx_command); // RAII-style acquire and relinquish via destructor
+    const BulkTransferScope bulk(*this, expectedLength - initialOffset);
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
     PERF2_TS_T0();
 
     bool done=false;
-    int offset=0;
+    int offset=initialOffset;
 
-    COND_PRINT(env.DEBUG_DATA, "GATTHandler::readValue expLen %d, handle %s", expectedLength, uint16HexString(handle).c_str());
+    COND_PRINT(env.DEBUG_DATA, "GATTHandler::readValue expLen %d, handle %s, offset %d", expectedLength, uint16HexString(handle).c_str(), offset);
 
     while(!done) {
         if( 0 < expectedLength && expectedLength <= offset ) {
             break; // done
-        } else if( 0 == expectedLength && 0 < offset ) {
+        } else if( 0 == expectedLength && initialOffset < offset ) {
             break; // done w/ only one request
         } // else 0 > expectedLength: implicit
 
@@ -759,7 +2232,7 @@ bool GATTHandler::readValue(const uint16_t handle, POctets & res, int expectedLe
                 const TOctetSlice & v = p->getValue();
                 res += v;
                 offset += v.getSize();
-                if( p->getPDUValueSize() < p->getMaxPDUValueSize(usedMTU) ) {
+                if( p->getPDUValueSize() < p->getMaxPDUValueSize(getBearerMTU()) ) {
                     done = true; // No full ATT_MTU PDU used - end of communication
                 }
             } else if( pdu->getOpcode() == AttPDUMsg::ATT_READ_BLOB_RSP ) {
@@ -770,7 +2243,7 @@ bool GATTHandler::readValue(const uint16_t handle, POctets & res, int expectedLe
                 } else {
                     res += v;
                     offset += v.getSize();
-                    if( p->getPDUValueSize() < p->getMaxPDUValueSize(usedMTU) ) {
+                    if( p->getPDUValueSize() < p->getMaxPDUValueSize(getBearerMTU()) ) {
                         done = true; // No full ATT_MTU PDU used - end of communication
                     }
                 }
@@ -801,7 +2274,148 @@ bool GATTHandler::readValue(const uint16_t handle, POctets & res, int expectedLe
     }
     PERF2_TS_TD("GATT readValue");
 
-    return offset > 0;
+    return offset > initialOffset;
+}
+
+bool GATTHandler::readCharacteristicValues(const std::vector<GATTCharacteristicRef> & characteristics, std::vector<POctets> & res) {
+    std::vector<uint16_t> handles;
+    handles.reserve(characteristics.size());
+    for(size_t i=0; i<characteristics.size(); i++) {
+        handles.push_back( characteristics.at(i)->value_handle );
+    }
+    return readValues(handles, res);
+}
+
+bool GATTHandler::readValues(const std::vector<uint16_t> & handles, std::vector<POctets> & res) {
+    /* BT Core Spec v5.2: Vol 3, Part G GATT: 4.8.5 Read Multiple Variable Length Characteristic Values */
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
+    PERF2_TS_T0();
+
+    res.clear();
+    res.reserve(handles.size());
+    for(size_t i=0; i<handles.size(); i++) {
+        res.push_back( POctets(0) );
+    }
+    // Request: opcode + n * handle
+    const size_t maxHandleCount = ( getBearerMTU() - 1 ) / 2;
+    bool allRead = true;
+    size_t next = 0;
+
+    while( next < handles.size() ) {
+        const size_t count = std::min(handles.size() - next, maxHandleCount);
+        if( readMultipleVariableUnsupported || AttReadMultipleReq::MIN_HANDLE_COUNT > (int)count ) {
+            allRead = readValue(handles.at(next), res.at(next)) && allRead;
+            next++;
+            continue;
+        }
+        const AttReadMultipleReq req(true /* variableLength */, std::vector<uint16_t>(handles.begin() + next, handles.begin() + next + count));
+        COND_PRINT(env.DEBUG_DATA, "GATT RMV send: %s", req.toString().c_str());
+
+        std::shared_ptr<const AttPDUMsg> pdu = sendWithReply(req, env.GATT_READ_COMMAND_REPLY_TIMEOUT);
+        COND_PRINT(env.DEBUG_DATA, "GATT RMV recv: %s", pdu->toString().c_str());
+
+        if( pdu->getOpcode() == AttPDUMsg::ATT_READ_MULTIPLE_VARIABLE_RSP ) {
+            const AttReadMultipleVariableRsp * p = static_cast<const AttReadMultipleVariableRsp*>(pdu.get());
+            const size_t tupleCount = std::min((size_t)p->getTupleCount(), count);
+            if( 0 == tupleCount ) {
+                WARN_PRINT("GATT readValues empty reply %s", pdu->toString().c_str());
+                allRead = false;
+                break;
+            }
+            for(size_t t=0; t<tupleCount; t++) {
+                POctets & v = res.at(next + t);
+                v += p->getTupleValue(t);
+                if( p->isTupleTruncated(t) ) {
+                    // BT Core Spec v5.2: Vol 3, Part G GATT: 4.8.5: Use ATT_READ_BLOB_REQ for the remaining value
+                    allRead = readValue(handles.at(next + t), v, p->getTupleLength(t), v.getSize()) && allRead;
+                }
+            }
+            next += tupleCount;
+        } else if( pdu->getOpcode() == AttPDUMsg::ATT_ERROR_RSP ) {
+            const AttErrorRsp * p = static_cast<const AttErrorRsp *>(pdu.get());
+            if( AttErrorRsp::UNSUPPORTED_REQUEST == p->getErrorCode() ) {
+                DBG_PRINT("GATT readValues: ATT_READ_MULTIPLE_VARIABLE_REQ not supported: %s", deviceString.c_str());
+                readMultipleVariableUnsupported = true;
+            } else {
+                // Error reported for the first failing handle only: read this set one by one
+                for(size_t t=0; t<count; t++) {
+                    allRead = readValue(handles.at(next + t), res.at(next + t)) && allRead;
+                }
+                next += count;
+            }
+        } else {
+            WARN_PRINT("GATT readValues unexpected reply %s", pdu->toString().c_str());
+            allRead = false;
+            break;
+        }
+    }
+    PERF2_TS_TD("GATT readValues");
+
+    return allRead && next == handles.size();
+}
+
+bool GATTHandler::readValues(const std::vector<uint16_t> & handles, const std::vector<int> & valueSizes, std::vector<POctets> & res) {
+    /* BT Core Spec v5.2: Vol 3, Part G GATT: 4.8.4 Read Multiple Characteristic Values */
+    if( handles.size() != valueSizes.size() ) {
+        throw IllegalArgumentException("handles count "+std::to_string(handles.size())+" != valueSizes count "+std::to_string(valueSizes.size()), E_FILE_LINE);
+    }
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
+    PERF2_TS_T0();
+
+    res.clear();
+    res.reserve(handles.size());
+    for(size_t i=0; i<handles.size(); i++) {
+        res.push_back( POctets(0) );
+    }
+    const int maxValueSize = getBearerMTU() - 1; // Response: opcode + values
+    const int maxHandleCount = ( getBearerMTU() - 1 ) / 2; // Request: opcode + n * handle
+    bool allRead = true;
+    size_t next = 0;
+
+    while( next < handles.size() ) {
+        // pack as many handles as fit into request and response
+        size_t count = 0;
+        int batchValueSize = 0;
+        while( next + count < handles.size() && (int)count < maxHandleCount &&
+               batchValueSize + valueSizes.at(next + count) <= maxValueSize )
+        {
+            batchValueSize += valueSizes.at(next + count);
+            count++;
+        }
+        if( AttReadMultipleReq::MIN_HANDLE_COUNT > (int)count ) {
+            allRead = readValue(handles.at(next), res.at(next)) && allRead;
+            next++;
+            continue;
+        }
+        const AttReadMultipleReq req(false /* variableLength */, std::vector<uint16_t>(handles.begin() + next, handles.begin() + next + count));
+        COND_PRINT(env.DEBUG_DATA, "GATT RM send: %s", req.toString().c_str());
+
+        std::shared_ptr<const AttPDUMsg> pdu = sendWithReply(req, env.GATT_READ_COMMAND_REPLY_TIMEOUT);
+        COND_PRINT(env.DEBUG_DATA, "GATT RM recv: %s", pdu->toString().c_str());
+
+        if( pdu->getOpcode() == AttPDUMsg::ATT_READ_MULTIPLE_RSP && batchValueSize == pdu->getPDUValueSize() ) {
+            const AttReadMultipleRsp * p = static_cast<const AttReadMultipleRsp*>(pdu.get());
+            const TOctetSlice & v = p->getValue();
+            int offset = 0;
+            for(size_t t=0; t<count; t++) {
+                const int size = valueSizes.at(next + t);
+                res.at(next + t) += TOctetSlice(v.getParent(), v.getOffset() + offset, size);
+                offset += size;
+            }
+        } else {
+            if( pdu->getOpcode() != AttPDUMsg::ATT_ERROR_RSP ) {
+                WARN_PRINT("GATT readValues unexpected reply, expected value size %d: %s", batchValueSize, pdu->toString().c_str());
+            }
+            // Error reported for the first failing handle only or value sizes mismatch: read this set one by one
+            for(size_t t=0; t<count; t++) {
+                allRead = readValue(handles.at(next + t), res.at(next + t)) && allRead;
+            }
+        }
+        next += count;
+    }
+    PERF2_TS_TD("GATT readValues (fixed)");
+
+    return allRead;
 }
 
 bool GATTHandler::writeDescriptorValue(const GATTDescriptor & cd) {
@@ -825,6 +2439,58 @@ bool GATTHandler::writeCharacteristicValueNoResp(const GATTCharacteristic & c, c
     return writeValue(c.value_handle, value, false);
 }
 
+bool GATTHandler::writeCharacteristicValueStream(const GATTCharacteristic & c, const TROOctets & data, GATTWriteStreamStats & stats) {
+    /* BT Core Spec v5.2: Vol 3, Part G GATT: 4.9.1 Write Characteristic Value Without Response */
+    COND_PRINT(env.DEBUG_DATA, "GATT writeCharacteristicValueStream decl %s, size %d", c.toString().c_str(), data.getSize());
+    return writeValueStream(c.value_handle, data, stats);
+}
+
+bool GATTHandler::writeValueStream(const uint16_t handle, const TROOctets & data, GATTWriteStreamStats & stats) {
+    /* BT Core Spec v5.2: Vol 3, Part G GATT: 4.9.1 Write Characteristic Value Without Response */
+    stats = GATTWriteStreamStats();
+    if( data.getSize() <= 0 ) {
+        WARN_PRINT("GATT writeValueStream size <= 0, no-op: %s", data.toString().c_str());
+        return false;
+    }
+    const BulkTransferScope bulk(*this, data.getSize());
+    const std::lock_guard<std::recursive_mutex> lock(mtx_stream); // RAII-style acquire and relinquish via destructor
+    const int64_t t0 = getCurrentMilliseconds();
+
+    // Command: opcode + handle + value part
+    const int maxPartSize = usedMTU - 3;
+    int offset = 0;
+    bool res = true;
+
+    while( offset < data.getSize() ) {
+        const int partSize = std::min(maxPartSize, data.getSize() - offset);
+        const AttWriteCmd req(handle, TROOctets(data.get_ptr() + offset, partSize));
+
+        // Backpressure: Wait until the send queue can take this packet, instead of blocking within write.
+        int space = l2cap.getWriteSpace();
+        while( 0 <= space && space < req.pdu.getSize() ) {
+            stats.backpressureCount++;
+            const int w = l2cap.waitWritable(env.GATT_WRITE_COMMAND_REPLY_TIMEOUT);
+            if( 0 >= w ) {
+                WARN_PRINT("GATT writeValueStream: Send queue stalled (%d) at offset %d/%d: %s",
+                        w, offset, data.getSize(), deviceString.c_str());
+                res = false;
+                break;
+            }
+            space = l2cap.getWriteSpace();
+        }
+        if( !res ) {
+            break;
+        }
+        send( req );
+        stats.packetCount++;
+        stats.byteCount += partSize;
+        offset += partSize;
+    }
+    stats.durationMS = getCurrentMilliseconds() - t0;
+    COND_PRINT(env.DEBUG_DATA, "GATT writeValueStream handle %s: %s", uint16HexString(handle).c_str(), stats.toString().c_str());
+    return res;
+}
+
 bool GATTHandler::writeValue(const uint16_t handle, const TROOctets & value, const bool withResponse) {
     /* BT Core Spec v5.2: Vol 3, Part G GATT: 3.3.3.3 Client Characteristic Configuration */
     /* BT Core Spec v5.2: Vol 3, Part G GATT: 4.9.3 Write Characteristic Value */
@@ -835,9 +2501,13 @@ bool GATTHandler::writeValue(const uint16_t handle, const TROOctets & value, con
         WARN_PRINT("GATT writeValue size <= 0, no-op: %s", value.toString().c_str());
         return false;
     }
-    const std::lock_guard<std::recursive_mutex> lock(mtx_command); // RAII-style acquire and relinquish via destructor
+    // Before locking the bearer, covering a long write below
+    const BulkTransferScope bulk(*this, withResponse ? value.getSize() : 0);
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
 
-    // FIXME TODO: Long Value if value.getSize() > ( ATT_MTU - 3 )
+    if( withResponse && value.getSize() > getBearerMTU() - 3 ) {
+        return writeLongValue(handle, value, false /* reliable */);
+    }
     PERF2_TS_T0();
 
     if( !withResponse ) {
@@ -872,6 +2542,123 @@ bool GATTHandler::writeValue(const uint16_t handle, const TROOctets & value, con
     return res;
 }
 
+bool GATTHandler::prepareWriteValue(const uint16_t handle, const TROOctets & value, const bool reliable) {
+    /* BT Core Spec v5.2: Vol 3, Part G GATT: 4.9.4 Write Long Characteristic Values */
+    /* BT Core Spec v5.2: Vol 3, Part G GATT: 4.9.5 Reliable Writes */
+    // Request: opcode + handle + offset + value part
+    const int maxPartSize = getBearerMTU() - 5;
+    int offset = 0;
+
+    // ATT is a sequential request-response protocol, only one request may be outstanding per bearer.
+    while( offset < value.getSize() ) {
+        const int partSize = std::min(maxPartSize, value.getSize() - offset);
+        const TROOctets part(value.get_ptr() + offset, partSize);
+        const AttPrepareWrite req(handle, offset, part);
+        COND_PRINT(env.DEBUG_DATA, "GATT PW send: %s", req.toString().c_str());
+
+        std::shared_ptr<const AttPDUMsg> pdu = sendWithReply(req, env.GATT_WRITE_COMMAND_REPLY_TIMEOUT);
+        COND_PRINT(env.DEBUG_DATA, "GATT PW recv: %s", pdu->toString().c_str());
+
+        if( pdu->getOpcode() == AttPDUMsg::ATT_PREPARE_WRITE_RSP ) {
+            const AttPrepareWrite * p = static_cast<const AttPrepareWrite*>(pdu.get());
+            if( p->getHandle() != handle || p->getValueOffset() != offset ) {
+                WARN_PRINT("GATT prepareWriteValue mismatch handle %s, offset %d: %s",
+                        uint16HexString(handle).c_str(), offset, p->toString().c_str());
+                return false;
+            }
+            if( reliable && ( p->getPDUValueSize() != partSize || 0 != memcmp(p->getValuePtr(), part.get_ptr(), partSize) ) ) {
+                WARN_PRINT("GATT prepareWriteValue value mismatch handle %s, offset %d: %s",
+                        uint16HexString(handle).c_str(), offset, p->toString().c_str());
+                return false;
+            }
+        } else if( pdu->getOpcode() == AttPDUMsg::ATT_ERROR_RSP ) {
+            const AttErrorRsp * p = static_cast<const AttErrorRsp *>(pdu.get());
+            WARN_PRINT("GATT prepareWriteValue unexpected error %s", p->toString().c_str());
+            return false;
+        } else {
+            WARN_PRINT("GATT prepareWriteValue unexpected reply %s", pdu->toString().c_str());
+            return false;
+        }
+        offset += partSize;
+    }
+    return true;
+}
+
+bool GATTHandler::executeWrite(const bool write) {
+    const AttExecuteWriteReq req(write);
+    COND_PRINT(env.DEBUG_DATA, "GATT EW send: %s", req.toString().c_str());
+
+    std::shared_ptr<const AttPDUMsg> pdu = sendWithReply(req, env.GATT_WRITE_COMMAND_REPLY_TIMEOUT);
+    COND_PRINT(env.DEBUG_DATA, "GATT EW recv: %s", pdu->toString().c_str());
+
+    if( pdu->getOpcode() == AttPDUMsg::ATT_EXECUTE_WRITE_RSP ) {
+        return true;
+    } else if( pdu->getOpcode() == AttPDUMsg::ATT_ERROR_RSP ) {
+        const AttErrorRsp * p = static_cast<const AttErrorRsp *>(pdu.get());
+        WARN_PRINT("GATT executeWrite unexpected error %s", p->toString().c_str());
+    } else {
+        WARN_PRINT("GATT executeWrite unexpected reply %s", pdu->toString().c_str());
+    }
+    return false;
+}
+
+bool GATTHandler::writeLongValue(const uint16_t handle, const TROOctets & value, const bool reliable) {
+    if( value.getSize() <= 0 ) {
+        WARN_PRINT("GATT writeLongValue size <= 0, no-op: %s", value.toString().c_str());
+        return false;
+    }
+    const BulkTransferScope bulk(*this, value.getSize());
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
+    PERF2_TS_T0();
+
+    bool res;
+    if( prepareWriteValue(handle, value, reliable) ) {
+        res = executeWrite(true);
+    } else {
+        executeWrite(false);
+        res = false;
+    }
+    PERF2_TS_TD("GATT writeLongValue");
+    return res;
+}
+
+bool GATTHandler::writeValues(const std::vector<uint16_t> & handles, const std::vector<POctets> & values, const bool reliable) {
+    if( handles.size() != values.size() ) {
+        throw IllegalArgumentException("handles count "+std::to_string(handles.size())+" != values count "+std::to_string(values.size()), E_FILE_LINE);
+    }
+    if( 0 == handles.size() ) {
+        return true;
+    }
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
+    PERF2_TS_T0();
+
+    bool res = true;
+    for(size_t i=0; res && i<handles.size(); i++) {
+        if( values.at(i).getSize() <= 0 ) {
+            WARN_PRINT("GATT writeValues size <= 0 for handle %s", uint16HexString(handles.at(i)).c_str());
+            res = false;
+        } else {
+            res = prepareWriteValue(handles.at(i), values.at(i), reliable);
+        }
+    }
+    if( res ) {
+        res = executeWrite(true);
+    } else {
+        executeWrite(false);
+    }
+    PERF2_TS_TD("GATT writeValues");
+    return res;
+}
+
+bool GATTHandler::writeCharacteristicValues(const std::vector<GATTCharacteristicRef> & characteristics, const std::vector<POctets> & values, const bool reliable) {
+    std::vector<uint16_t> handles;
+    handles.reserve(characteristics.size());
+    for(size_t i=0; i<characteristics.size(); i++) {
+        handles.push_back( characteristics.at(i)->value_handle );
+    }
+    return writeValues(handles, values, reliable);
+}
+
 bool GATTHandler::configNotificationIndication(GATTDescriptor & cccd, const bool enableNotification, const bool enableIndication) {
     if( !cccd.isClientCharacteristicConfiguration() ) {
         throw IllegalArgumentException("Not a ClientCharacteristicConfiguration: "+cccd.toString(), E_FILE_LINE);
@@ -922,7 +2709,7 @@ std::shared_ptr<GenericAccess> GATTHandler::getGenericAccess(std::vector<GATTCha
     AppearanceCat appearance = AppearanceCat::UNKNOWN;
     PeriphalPreferredConnectionParameters * prefConnParam = nullptr;
 
-    const std::lock_guard<std::recursive_mutex> lock(mtx_command); // RAII-style acquire and relinquish via destructor
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
 
     for(size_t i=0; i<genericAccessCharDeclList.size(); i++) {
         const GATTCharacteristic & charDecl = *genericAccessCharDeclList.at(i);
@@ -962,7 +2749,7 @@ std::shared_ptr<GenericAccess> GATTHandler::getGenericAccess(std::vector<GATTSer
 }
 
 bool GATTHandler::ping() {
-    const std::lock_guard<std::recursive_mutex> lock(mtx_command); // RAII-style acquire and relinquish via destructor
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
 
     for(size_t i=0; i<services.size(); i++) {
         std::vector<GATTCharacteristicRef> & genericAccessCharDeclList = services.at(i)->characteristicList;
@@ -999,7 +2786,7 @@ std::shared_ptr<DeviceInformation> GATTHandler::getDeviceInformation(std::vector
     PnP_ID * pnpID = nullptr;
     bool found = false;
 
-    const std::lock_guard<std::recursive_mutex> lock(mtx_command); // RAII-style acquire and relinquish via destructor
+    const BearerLock lock(*this); // RAII-style acquire and relinquish via destructor
 
     for(size_t i=0; i<characteristicDeclList.size(); i++) {
         const GATTCharacteristic & charDecl = *characteristicDeclList.at(i);
@@ -0,0 +1,226 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2020 Gothel Software e.K.
+ * Copyright (c) 2020 ZAFENA AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstring>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <vector>
+#include <cstdio>
+
+#include <dbt_debug.hpp>
+
+#include "GATTListenerQueue.hpp"
+
+using namespace direct_bt;
+
+GATTListenerExecutor::GATTListenerExecutor(const int threadCount)
+: shallStop(false)
+{
+    for(int i=0; i<threadCount; i++) {
+        threads.push_back( std::thread(&GATTListenerExecutor::workerThreadImpl, this) );
+    }
+    DBG_PRINT("GATTListenerExecutor: Started %d threads", threadCount);
+}
+
+GATTListenerExecutor::~GATTListenerExecutor() {
+    {
+        const std::lock_guard<std::mutex> lock(mtx_tasks); // RAII-style acquire and relinquish via destructor
+        shallStop = true;
+        tasks.clear();
+        cv_tasks.notify_all();
+    }
+    for(size_t i=0; i<threads.size(); i++) {
+        if( threads[i].joinable() ) {
+            threads[i].join();
+        }
+    }
+}
+
+void GATTListenerExecutor::workerThreadImpl() {
+    while( true ) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mtx_tasks); // RAII-style acquire and relinquish via destructor
+            while( !shallStop && tasks.empty() ) {
+                cv_tasks.wait(lock);
+            }
+            if( shallStop ) {
+                return;
+            }
+            task = std::move( tasks.front() );
+            tasks.pop_front();
+        }
+        try {
+            task();
+        } catch (std::exception &e) {
+            ERR_PRINT("GATTListenerExecutor: Caught exception %s", e.what());
+        }
+    }
+}
+
+void GATTListenerExecutor::execute(std::function<void()> task) {
+    const std::lock_guard<std::mutex> lock(mtx_tasks); // RAII-style acquire and relinquish via destructor
+    if( shallStop ) {
+        return;
+    }
+    tasks.push_back( std::move(task) );
+    cv_tasks.notify_one();
+}
+
+QueuedGATTCharacteristicListener::QueuedGATTCharacteristicListener(const std::shared_ptr<GATTCharacteristicListener> & delegate,
+                                                                   const int capacity, const QueuePolicy policy,
+                                                                   GATTListenerExecutor & executor)
+: delegate(delegate), capacity(capacity), policy(policy), executor(executor),
+  scheduled(false), cancelled(false), droppedCount(0), coalescedCount(0)
+{
+    if( nullptr == delegate ) {
+        throw IllegalArgumentException("GATTCharacteristicListener delegate is null", E_FILE_LINE);
+    }
+    if( 0 >= capacity ) {
+        throw IllegalArgumentException("Queue capacity "+std::to_string(capacity)+" <= 0", E_FILE_LINE);
+    }
+}
+
+int QueuedGATTCharacteristicListener::getQueueSize() {
+    const std::lock_guard<std::mutex> lock(mtx_queue); // RAII-style acquire and relinquish via destructor
+    return queue.size();
+}
+
+bool QueuedGATTCharacteristicListener::waitUntilDelivered(const int timeoutMS) {
+    std::unique_lock<std::mutex> lock(mtx_queue); // RAII-style acquire and relinquish via destructor
+    const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMS);
+    while( scheduled ) {
+        if( 0 == timeoutMS ) {
+            cv_queue.wait(lock);
+        } else if( std::cv_status::timeout == cv_queue.wait_until(lock, t0) && scheduled ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int QueuedGATTCharacteristicListener::cancel() {
+    const std::lock_guard<std::mutex> lock(mtx_queue); // RAII-style acquire and relinquish via destructor
+    const int count = queue.size();
+    cancelled = true;
+    queue.clear();
+    droppedCount += count;
+    return count;
+}
+
+bool QueuedGATTCharacteristicListener::isCancelled() {
+    const std::lock_guard<std::mutex> lock(mtx_queue); // RAII-style acquire and relinquish via destructor
+    return cancelled;
+}
+
+void QueuedGATTCharacteristicListener::enqueue(Event && e) {
+    bool schedule = false;
+    {
+        const std::lock_guard<std::mutex> lock(mtx_queue); // RAII-style acquire and relinquish via destructor
+        if( cancelled ) {
+            droppedCount++;
+            return;
+        }
+        bool coalesced = false;
+        if( QueuePolicy::KEEP_LATEST == policy ) {
+            for(auto it = queue.begin(); it != queue.end(); it++) {
+                if( it->charDecl == e.charDecl && it->indication == e.indication ) {
+                    *it = std::move(e);
+                    coalesced = true;
+                    coalescedCount++;
+                    break;
+                }
+            }
+        }
+        if( !coalesced ) {
+            if( (int)queue.size() >= capacity ) {
+                droppedCount++;
+                if( QueuePolicy::DROP_NEWEST == policy ) {
+                    return;
+                }
+                queue.pop_front();
+            }
+            queue.push_back( std::move(e) );
+        }
+        if( !scheduled ) {
+            scheduled = true;
+            schedule = true;
+        }
+    }
+    if( schedule ) {
+        std::shared_ptr<QueuedGATTCharacteristicListener> self = shared_from_this();
+        executor.execute( [self]() { self->deliver(); } );
+    }
+}
+
+void QueuedGATTCharacteristicListener::deliver() {
+    while( true ) {
+        std::unique_ptr<Event> e;
+        {
+            const std::lock_guard<std::mutex> lock(mtx_queue); // RAII-style acquire and relinquish via destructor
+            if( queue.empty() ) {
+                scheduled = false;
+                cv_queue.notify_all();
+                return;
+            }
+            e = std::unique_ptr<Event>( new Event( std::move( queue.front() ) ) );
+            queue.pop_front();
+        }
+        try {
+            if( e->indication ) {
+                delegate->indicationReceived(e->charDecl, e->charValue, e->timestamp, e->confirmationSent, e->rxTimestamp);
+            } else {
+                delegate->notificationReceived(e->charDecl, e->charValue, e->timestamp, e->rxTimestamp);
+            }
+        } catch (std::exception &ex) {
+            ERR_PRINT("QueuedGATTCharacteristicListener::deliver: GATTCharacteristicListener %s: Caught exception %s",
+                    aptrHexString((void*)delegate.get()).c_str(), ex.what());
+        }
+    }
+}
+
+void QueuedGATTCharacteristicListener::notificationReceived(GATTCharacteristicRef charDecl,
+                                                            std::shared_ptr<TROOctets> charValue, const uint64_t timestamp) {
+    enqueue( Event(charDecl, charValue, timestamp, 0 /* rxTimestamp */, false /* indication */, false /* confirmationSent */) );
+}
+
+void QueuedGATTCharacteristicListener::indicationReceived(GATTCharacteristicRef charDecl,
+                                                          std::shared_ptr<TROOctets> charValue, const uint64_t timestamp,
+                                                          const bool confirmationSent) {
+    enqueue( Event(charDecl, charValue, timestamp, 0 /* rxTimestamp */, true /* indication */, confirmationSent) );
+}
+
+void QueuedGATTCharacteristicListener::notificationReceived(GATTCharacteristicRef charDecl,
+                                                            std::shared_ptr<TROOctets> charValue, const uint64_t timestamp,
+                                                            const uint64_t rxTimestamp) {
+    enqueue( Event(charDecl, charValue, timestamp, rxTimestamp, false /* indication */, false /* confirmationSent */) );
+}
+
+void QueuedGATTCharacteristicListener::indicationReceived(GATTCharacteristicRef charDecl,
+                                                          std::shared_ptr<TROOctets> charValue, const uint64_t timestamp,
+                                                          const bool confirmationSent, const uint64_t rxTimestamp) {
+    enqueue( Event(charDecl, charValue, timestamp, rxTimestamp, true /* indication */, confirmationSent) );
+}
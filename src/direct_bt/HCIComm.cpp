@@ -46,6 +46,7 @@ extern "C" {
     #include <sys/ioctl.h>
     #include <sys/socket.h>
     #include <poll.h>
+    #include <sys/eventfd.h>
 }
 
 namespace direct_bt {
@@ -80,6 +81,18 @@ int HCIComm::hci_open_dev(const uint16_t dev_id, const uint16_t channel)
 		goto failed;
 	}
 
+	// Kernel receive timestamps, see read(..): The raw channel uses its own HCI_TIME_STAMP option
+	{
+	    const int on = 1;
+	    if( HCI_CHANNEL_RAW == channel ) {
+	        if( 0 > setsockopt(dd, SOL_HCI, HCI_TIME_STAMP, &on, sizeof(on)) ) {
+	            WARN_PRINT("HCIComm::hci_open_dev: setsockopt HCI_TIME_STAMP failed");
+	        }
+	    } else if( 0 > setsockopt(dd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) ) {
+	        WARN_PRINT("HCIComm::hci_open_dev: setsockopt SO_TIMESTAMPNS failed");
+	    }
+	}
+
 	return dd;
 
 failed:
@@ -95,7 +108,57 @@ int HCIComm::hci_close_dev(int dd)
 	return ::close(dd);
 }
 
+/** Returns the kernel receive timestamp of the given received message in nanoseconds, or zero if not available. */
+static uint64_t getReceiveTimestamp(struct msghdr & msg) {
+    for(struct cmsghdr * cmsg = CMSG_FIRSTHDR(&msg); nullptr != cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if( SOL_SOCKET == cmsg->cmsg_level && SCM_TIMESTAMPNS == cmsg->cmsg_type ) {
+            struct timespec ts;
+            memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            return (uint64_t)ts.tv_sec * 1000000000UL + (uint64_t)ts.tv_nsec;
+        } else if( SOL_HCI == cmsg->cmsg_level && HCI_CMSG_TSTAMP == cmsg->cmsg_type ) {
+            struct timeval tv;
+            memcpy(&tv, CMSG_DATA(cmsg), sizeof(tv));
+            return (uint64_t)tv.tv_sec * 1000000000UL + (uint64_t)tv.tv_usec * 1000UL;
+        }
+    }
+    return 0;
+}
+
+HCIComm::HCIComm(const uint16_t dev_id, const uint16_t channel)
+: dev_id(dev_id), channel(channel), _dd(-1), _efd(-1), _ifd(-1)
+{
+    _dd = hci_open_dev(dev_id, channel);
+    _efd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if( 0 > _efd ) {
+        ERR_PRINT("HCIComm::ctor: eventfd failed");
+    }
+    _ifd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if( 0 > _ifd ) {
+        ERR_PRINT("HCIComm::ctor: interrupt eventfd failed");
+    }
+}
+
+HCIComm::~HCIComm() {
+    close();
+    if( 0 <= _efd ) {
+        ::close(_efd);
+    }
+    if( 0 <= _ifd ) {
+        ::close(_ifd);
+    }
+}
+
+void HCIComm::interrupt() {
+    if( 0 <= _ifd && 0 != eventfd_write(_ifd, 1) ) {
+        ERR_PRINT("HCIComm::interrupt: eventfd write failed");
+    }
+}
+
 void HCIComm::close() {
+    // wakeup a pending read(..), the channel can't be reopened
+    if( 0 <= _efd && 0 != eventfd_write(_efd, 1) ) {
+        ERR_PRINT("HCIComm::close: eventfd write failed");
+    }
     const std::lock_guard<std::recursive_mutex> lock(mtx_write); // RAII-style acquire and relinquish via destructor
     if( 0 > _dd ) {
         return;
@@ -104,8 +167,15 @@ void HCIComm::close() {
     _dd = -1;
 }
 
-int HCIComm::read(uint8_t* buffer, const int capacity, const int32_t timeoutMS) {
+int HCIComm::read(uint8_t* buffer, const int capacity, const int32_t timeoutMS, uint64_t & rxTimestamp) {
     int len = 0;
+    struct iovec iov;
+    struct msghdr msg;
+    union {
+        struct cmsghdr align;
+        uint8_t data[CMSG_SPACE(sizeof(struct timespec)) + CMSG_SPACE(sizeof(struct timeval))];
+    } control;
+    rxTimestamp = 0;
     if( 0 > _dd || 0 > capacity ) {
         goto errout;
     }
@@ -114,40 +184,56 @@ int HCIComm::read(uint8_t* buffer, const int capacity, const int32_t timeoutMS)
     }
 
     if( timeoutMS ) {
-        struct pollfd p;
+        struct pollfd p[3];
         int n;
 
-        p.fd = _dd; p.events = POLLIN;
-#if 0
-        sigset_t sigmask;
-        sigemptyset(&sigmask);
-        // sigaddset(&sigmask, SIGALRM);
-        struct timespec timeout_ts;
-        timeout_ts.tv_sec=0;
-        timeout_ts.tv_nsec=(long)timeoutMS*1000000L;
-        while ((n = ppoll(&p, 1, &timeout_ts, &sigmask)) < 0) {
-#else
-        while ((n = poll(&p, 1, timeoutMS)) < 0) {
-#endif
+        p[0].fd = _dd; p[0].events = POLLIN; p[0].revents = 0;
+        p[1].fd = _efd; p[1].events = POLLIN; p[1].revents = 0;
+        p[2].fd = _ifd; p[2].events = POLLIN; p[2].revents = 0;
+        while ((n = poll(p, 3, timeoutMS)) < 0) {
             if (errno == EAGAIN || errno == EINTR ) {
                 // cont temp unavail or interruption
                 continue;
             }
             goto errout;
         }
+        if( 0 != p[1].revents ) {
+            // woken up by close()
+            errno = ECANCELED;
+            goto errout;
+        }
+        if( 0 != p[2].revents && 0 == p[0].revents ) {
+            // woken up by interrupt(), pending data is read first
+            eventfd_t v;
+            eventfd_read(_ifd, &v);
+            errno = EINTR;
+            goto errout;
+        }
         if (!n) {
             errno = ETIMEDOUT;
             goto errout;
         }
     }
 
-    while ((len = ::read(_dd, buffer, capacity)) < 0) {
+    iov.iov_base = buffer;
+    iov.iov_len = capacity;
+    bzero(&msg, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data;
+    msg.msg_controllen = sizeof(control.data);
+
+    while ((len = ::recvmsg(_dd, &msg, 0)) < 0) {
         if (errno == EAGAIN || errno == EINTR ) {
             // cont temp unavail or interruption
             continue;
         }
         goto errout;
     }
+    rxTimestamp = getReceiveTimestamp(msg);
+    if( 0 == rxTimestamp ) {
+        rxTimestamp = getWallClockNanoseconds();
+    }
 
 done:
     return len;
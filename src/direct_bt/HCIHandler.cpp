@@ -61,6 +61,7 @@ HCIEnv::HCIEnv()
   HCI_COMMAND_COMPLETE_REPLY_TIMEOUT( DBTEnv::getInt32Property("direct_bt.hci.cmd.complete.timeout", 10000, 1500 /* min */, INT32_MAX /* max */) ),
   HCI_EVT_RING_CAPACITY( DBTEnv::getInt32Property("direct_bt.hci.ringsize", 64, 64 /* min */, 1024 /* max */) ),
   DEBUG_EVENT( DBTEnv::getBooleanProperty("direct_bt.debug.hci.event", false) ),
+  HCI_LE_LINK_NEGOTIATE( DBTEnv::getBooleanProperty("direct_bt.hci.le.link.negotiate", true) ),
   HCI_READ_PACKET_MAX_RETRY( HCI_EVT_RING_CAPACITY )
 {
 }
@@ -183,6 +184,10 @@ std::shared_ptr<MgmtEvent> HCIHandler::translate(std::shared_ptr<HCIEvent> ev) {
                 const BDAddressType addrType = getBDAddressType(hciAddrType);
                 HCIConnectionRef conn = addOrUpdateTrackerConnection(ev_cc->bdaddr, addrType, ev_cc->handle);
                 if( HCIStatusCode::SUCCESS == status ) {
+                    {
+                        const std::lock_guard<std::recursive_mutex> lock(mtx_connectionList); // RAII-style acquire and relinquish via destructor
+                        conn->setConnParam(le_to_cpu(ev_cc->interval), le_to_cpu(ev_cc->latency), le_to_cpu(ev_cc->supervision_timeout));
+                    }
                     return std::shared_ptr<MgmtEvent>( new MgmtEvtDeviceConnected(dev_id, ev_cc->bdaddr, addrType, ev_cc->handle) );
                 } else {
                     std::shared_ptr<MgmtEvent> res( new MgmtEvtDeviceConnectFailed(dev_id, ev_cc->bdaddr, addrType, status) );
@@ -190,6 +195,65 @@ std::shared_ptr<MgmtEvent> HCIHandler::translate(std::shared_ptr<HCIEvent> ev) {
                     return res;
                 }
             }
+            case HCIMetaEventType::LE_CONN_UPDATE_COMPLETE: {
+                HCIStatusCode status;
+                const hci_ev_le_conn_update_complete * ev_cu = getMetaReplyStruct<hci_ev_le_conn_update_complete>(ev, mevt, &status);
+                if( nullptr == ev_cu ) {
+                    ERR_PRINT("HCIHandler::translate(reader): LE_CONN_UPDATE_COMPLETE: Null reply-struct: %s", ev->toString().c_str());
+                    return nullptr;
+                }
+                const std::lock_guard<std::recursive_mutex> lock(mtx_connectionList); // RAII-style acquire and relinquish via destructor
+                HCIConnectionRef conn = findTrackerConnection(le_to_cpu(ev_cu->handle));
+                if( nullptr != conn ) {
+                    if( HCIStatusCode::SUCCESS == status ) {
+                        conn->setConnParam(le_to_cpu(ev_cu->interval), le_to_cpu(ev_cu->latency), le_to_cpu(ev_cu->supervision_timeout));
+                        DBG_PRINT("HCIHandler::translate(reader): LE_CONN_UPDATE_COMPLETE: %s", conn->toString().c_str());
+                    } else {
+                        INFO_PRINT("HCIHandler::translate(reader): LE_CONN_UPDATE_COMPLETE: !SUCCESS[%s, %s], %s",
+                                uint8HexString(static_cast<uint8_t>(status)).c_str(), getHCIStatusCodeString(status).c_str(),
+                                conn->toString().c_str());
+                    }
+                }
+                return nullptr;
+            }
+            case HCIMetaEventType::LE_DATA_LENGTH_CHANGE: {
+                // no status field, hence not using getMetaReplyStruct(..)
+                typedef HCIStructCmdCompleteMetaEvt<hci_ev_le_data_len_change> HCIDataLenChangeEvt;
+                const HCIDataLenChangeEvt * ev_cc = static_cast<const HCIDataLenChangeEvt*>(ev.get());
+                const hci_ev_le_data_len_change * ev_dl = ev_cc->isTypeAndSizeValid(mevt) ? ev_cc->getStruct() : nullptr;
+                if( nullptr == ev_dl ) {
+                    ERR_PRINT("HCIHandler::translate(reader): LE_DATA_LENGTH_CHANGE: Null reply-struct: %s", ev->toString().c_str());
+                    return nullptr;
+                }
+                const std::lock_guard<std::recursive_mutex> lock(mtx_connectionList); // RAII-style acquire and relinquish via destructor
+                HCIConnectionRef conn = findTrackerConnection(le_to_cpu(ev_dl->handle));
+                if( nullptr != conn ) {
+                    conn->setDataLength(le_to_cpu(ev_dl->tx_len), le_to_cpu(ev_dl->rx_len));
+                    DBG_PRINT("HCIHandler::translate(reader): LE_DATA_LENGTH_CHANGE: %s", conn->toString().c_str());
+                }
+                return nullptr;
+            }
+            case HCIMetaEventType::LE_PHY_UPDATE_COMPLETE: {
+                HCIStatusCode status;
+                const hci_ev_le_phy_update_complete * ev_pu = getMetaReplyStruct<hci_ev_le_phy_update_complete>(ev, mevt, &status);
+                if( nullptr == ev_pu ) {
+                    ERR_PRINT("HCIHandler::translate(reader): LE_PHY_UPDATE_COMPLETE: Null reply-struct: %s", ev->toString().c_str());
+                    return nullptr;
+                }
+                const std::lock_guard<std::recursive_mutex> lock(mtx_connectionList); // RAII-style acquire and relinquish via destructor
+                HCIConnectionRef conn = findTrackerConnection(le_to_cpu(ev_pu->handle));
+                if( nullptr != conn ) {
+                    if( HCIStatusCode::SUCCESS == status ) {
+                        conn->setPhy(getLE_PHYs(ev_pu->tx_phy), getLE_PHYs(ev_pu->rx_phy));
+                        DBG_PRINT("HCIHandler::translate(reader): LE_PHY_UPDATE_COMPLETE: %s", conn->toString().c_str());
+                    } else {
+                        INFO_PRINT("HCIHandler::translate(reader): LE_PHY_UPDATE_COMPLETE: !SUCCESS[%s, %s], %s",
+                                uint8HexString(static_cast<uint8_t>(status)).c_str(), getHCIStatusCodeString(status).c_str(),
+                                conn->toString().c_str());
+                    }
+                }
+                return nullptr;
+            }
             default:
                 return nullptr;
         }
@@ -257,7 +321,8 @@ void HCIHandler::hciReaderThreadImpl() {
             break;
         }
 
-        len = comm.read(rbuffer.get_wptr(), rbuffer.getSize(), env.HCI_READER_THREAD_POLL_TIMEOUT);
+        uint64_t rxTimestamp;
+        len = comm.read(rbuffer.get_wptr(), rbuffer.getSize(), env.HCI_READER_THREAD_POLL_TIMEOUT, rxTimestamp);
         if( 0 < len ) {
             const uint16_t paramSize = len >= 3 ? rbuffer.get_uint8(2) : 0;
             if( len < number(HCIConstU8::EVENT_HDR_SIZE) + paramSize ) {
@@ -271,6 +336,7 @@ void HCIHandler::hciReaderThreadImpl() {
                 ERR_PRINT("HCIHandler-IO RECV Drop (non-event) %s", bytesHexString(rbuffer.get_ptr(), 0, len, true /* lsbFirst*/).c_str());
                 continue;
             }
+            event->setReceiveTimestamp(rxTimestamp);
 
             const HCIMetaEventType mec = event->getMetaEventType();
             if( HCIMetaEventType::INVALID != mec && !filter_test_metaev(mec) ) {
@@ -290,7 +356,8 @@ void HCIHandler::hciReaderThreadImpl() {
                 hciEventRing.putBlocking( event );
             } else if( event->isMetaEvent(HCIMetaEventType::LE_ADVERTISING_REPORT) ) {
                 // issue callbacks for the translated AD events
-                std::vector<std::shared_ptr<EInfoReport>> eirlist = EInfoReport::read_ad_reports(event->getParam(), event->getParamSize());
+                std::vector<std::shared_ptr<EInfoReport>> eirlist = EInfoReport::read_ad_reports(event->getParam(), event->getParamSize(),
+                                                                                              event->getReceiveTimestamp());
                 int i=0;
                 for_each_idx(eirlist, [&](std::shared_ptr<EInfoReport> &eir) {
                     // COND_PRINT(env.DEBUG_EVENT, "HCIHandler-IO RECV (AD EIR) %s", eir->toString().c_str());
@@ -424,7 +491,8 @@ HCIHandler::HCIHandler(const BTMode btMode, const uint16_t dev_id)
 : env(HCIEnv::get()),
   btMode(btMode), dev_id(dev_id), rbuffer(HCI_MAX_MTU),
   comm(dev_id, HCI_CHANNEL_RAW),
-  hciEventRing(env.HCI_EVT_RING_CAPACITY), hciReaderRunning(false), hciReaderShallStop(false)
+  hciEventRing(env.HCI_EVT_RING_CAPACITY), hciReaderRunning(false), hciReaderShallStop(false),
+  leFeatures(LE_Features::NONE), leMaxTxOctets(0), leMaxTxTime(0)
 {
     INFO_PRINT("HCIHandler.ctor: pid %d", HCIHandler::pidSelf);
     if( !comm.isOpen() ) {
@@ -437,6 +505,7 @@ HCIHandler::HCIHandler(const BTMode btMode, const uint16_t dev_id)
 
         std::thread hciReaderThread = std::thread(&HCIHandler::hciReaderThreadImpl, this);
         hciReaderThreadId = hciReaderThread.native_handle();
+        DBTEnv::setAdapterThreadAffinity(hciReaderThreadId, dev_id);
         // Avoid 'terminate called without an active exception'
         // as hciReaderThreadImpl may end due to I/O errors.
         hciReaderThread.detach();
@@ -486,6 +555,9 @@ HCIHandler::HCIHandler(const BTMode btMode, const uint16_t dev_id)
         // filter_all_metaevs(mask);
         filter_set_metaev(HCIMetaEventType::LE_CONN_COMPLETE, mask);
         filter_set_metaev(HCIMetaEventType::LE_ADVERTISING_REPORT, mask);
+        filter_set_metaev(HCIMetaEventType::LE_CONN_UPDATE_COMPLETE, mask);
+        filter_set_metaev(HCIMetaEventType::LE_DATA_LENGTH_CHANGE, mask);
+        filter_set_metaev(HCIMetaEventType::LE_PHY_UPDATE_COMPLETE, mask);
         filter_put_metaevs(mask);
     }
     // Mandatory own HCIOpcodeBit/HCIOpcode filter
@@ -499,6 +571,13 @@ HCIHandler::HCIHandler(const BTMode btMode, const uint16_t dev_id)
         filter_set_opcbit(HCIOpcodeBit::LE_SET_SCAN_PARAM, mask);
         filter_set_opcbit(HCIOpcodeBit::LE_SET_SCAN_ENABLE, mask);
         filter_set_opcbit(HCIOpcodeBit::LE_CREATE_CONN, mask);
+        filter_set_opcbit(HCIOpcodeBit::LE_CONN_UPDATE, mask);
+        filter_set_opcbit(HCIOpcodeBit::LE_READ_LOCAL_FEATURES, mask);
+        filter_set_opcbit(HCIOpcodeBit::LE_SET_DATA_LEN, mask);
+        filter_set_opcbit(HCIOpcodeBit::LE_READ_MAX_DATA_LEN, mask);
+        filter_set_opcbit(HCIOpcodeBit::LE_READ_PHY, mask);
+        filter_set_opcbit(HCIOpcodeBit::LE_SET_DEFAULT_PHY, mask);
+        filter_set_opcbit(HCIOpcodeBit::LE_SET_PHY, mask);
         filter_put_opcbit(mask);
     }
     {
@@ -514,6 +593,35 @@ HCIHandler::HCIHandler(const BTMode btMode, const uint16_t dev_id)
                 ev_lv->hci_ver, le_to_cpu(ev_lv->hci_rev), le_to_cpu(ev_lv->manufacturer),
                 ev_lv->lmp_ver, le_to_cpu(ev_lv->lmp_subver));
     }
+    if( BTMode::BREDR != btMode ) {
+        HCICommand req0(HCIOpcode::LE_READ_LOCAL_FEATURES, 0);
+        const hci_rp_le_read_local_features * ev_lf;
+        HCIStatusCode status;
+        std::shared_ptr<HCIEvent> ev = processCommandComplete(req0, &ev_lf, &status);
+        if( nullptr == ev || nullptr == ev_lf || HCIStatusCode::SUCCESS != status ) {
+            WARN_PRINT("HCIHandler::ctor: failed LE_READ_LOCAL_FEATURES: 0x%x (%s)", number(status), getHCIStatusCodeString(status).c_str());
+        } else {
+            uint64_t features = 0;
+            for(int i=7; i>=0; i--) {
+                features = ( features << 8 ) | ev_lf->features[i];
+            }
+            leFeatures = static_cast<LE_Features>(features);
+        }
+    }
+    if( isLEFeaturesBitSet(leFeatures, LE_Features::LE_DATA_PACKET_LENGTH_EXT) ) {
+        HCICommand req0(HCIOpcode::LE_READ_MAX_DATA_LEN, 0);
+        const hci_rp_le_read_max_data_len * ev_md;
+        HCIStatusCode status;
+        std::shared_ptr<HCIEvent> ev = processCommandComplete(req0, &ev_md, &status);
+        if( nullptr == ev || nullptr == ev_md || HCIStatusCode::SUCCESS != status ) {
+            WARN_PRINT("HCIHandler::ctor: failed LE_READ_MAX_DATA_LEN: 0x%x (%s)", number(status), getHCIStatusCodeString(status).c_str());
+        } else {
+            leMaxTxOctets = le_to_cpu(ev_md->tx_len);
+            leMaxTxTime = le_to_cpu(ev_md->tx_time);
+        }
+    }
+    INFO_PRINT("HCIHandler: LE features %s, max data length[tx %u octets, %u us]",
+            uint64HexString(number(leFeatures)).c_str(), leMaxTxOctets, leMaxTxTime);
 
     PERF_TS_TD("HCIHandler::open.ok");
     return;
@@ -538,14 +646,8 @@ void HCIHandler::close() {
             hciReaderRunning.load(), hciReaderShallStop.load(), is_reader, (void*)tid_reader);
     if( hciReaderRunning ) {
         hciReaderShallStop = true;
-        if( !is_reader && 0 != tid_reader ) {
-            int kerr;
-            if( 0 != ( kerr = pthread_kill(tid_reader, SIGALRM) ) ) {
-                ERR_PRINT("HCIHandler::disconnect: pthread_kill %p FAILED: %d", (void*)tid_reader, kerr);
-            }
-        }
     }
-    comm.close();
+    comm.close(); // wakes up the hciReader
     DBG_PRINT("HCIHandler::close: End");
 }
 
@@ -728,6 +830,125 @@ HCIStatusCode HCIHandler::disconnect(const bool ioErrorCause,
     return status;
 }
 
+HCIStatusCode HCIHandler::le_conn_update(const uint16_t conn_handle,
+                                         const uint16_t conn_interval_min, const uint16_t conn_interval_max,
+                                         const uint16_t conn_latency, const uint16_t supervision_timeout) {
+    const std::lock_guard<std::recursive_mutex> lock(mtx); // RAII-style acquire and relinquish via destructor
+    if( !comm.isOpen() ) {
+        ERR_PRINT("HCIHandler::le_conn_update: device not open");
+        return HCIStatusCode::INTERNAL_FAILURE;
+    }
+    const uint16_t min_ce_length = 0x0000;
+    const uint16_t max_ce_length = 0x0000;
+
+    HCIStructCommand<hci_cp_le_conn_update> req0(HCIOpcode::LE_CONN_UPDATE);
+    hci_cp_le_conn_update * cp = req0.getWStruct();
+    cp->handle = cpu_to_le(conn_handle);
+    cp->conn_interval_min = cpu_to_le(conn_interval_min);
+    cp->conn_interval_max = cpu_to_le(conn_interval_max);
+    cp->conn_latency = cpu_to_le(conn_latency);
+    cp->supervision_timeout = cpu_to_le(supervision_timeout);
+    cp->min_ce_len = cpu_to_le(min_ce_length);
+    cp->max_ce_len = cpu_to_le(max_ce_length);
+
+    HCIStatusCode status;
+    std::shared_ptr<HCIEvent> ev = processCommandStatus(req0, &status);
+    return status;
+}
+
+HCIStatusCode HCIHandler::le_set_data_len(const uint16_t conn_handle, const uint16_t tx_octets, const uint16_t tx_time) {
+    const std::lock_guard<std::recursive_mutex> lock(mtx); // RAII-style acquire and relinquish via destructor
+    if( !comm.isOpen() ) {
+        ERR_PRINT("HCIHandler::le_set_data_len: device not open");
+        return HCIStatusCode::INTERNAL_FAILURE;
+    }
+    HCIStructCommand<hci_cp_le_set_data_len> req0(HCIOpcode::LE_SET_DATA_LEN);
+    hci_cp_le_set_data_len * cp = req0.getWStruct();
+    cp->handle = cpu_to_le(conn_handle);
+    cp->tx_len = cpu_to_le(tx_octets);
+    cp->tx_time = cpu_to_le(tx_time);
+
+    const hci_rp_le_set_data_len * ev_dl;
+    HCIStatusCode status;
+    std::shared_ptr<HCIEvent> ev = processCommandComplete(req0, &ev_dl, &status);
+    return status;
+}
+
+HCIStatusCode HCIHandler::le_set_default_phy(const LE_PHYs tx_phys, const LE_PHYs rx_phys) {
+    const std::lock_guard<std::recursive_mutex> lock(mtx); // RAII-style acquire and relinquish via destructor
+    if( !comm.isOpen() ) {
+        ERR_PRINT("HCIHandler::le_set_default_phy: device not open");
+        return HCIStatusCode::INTERNAL_FAILURE;
+    }
+    HCIStructCommand<hci_cp_le_set_default_phy> req0(HCIOpcode::LE_SET_DEFAULT_PHY);
+    hci_cp_le_set_default_phy * cp = req0.getWStruct();
+    cp->all_phys = ( LE_PHYs::NONE == tx_phys ? 0x01 /* no tx preference */ : 0 ) |
+                   ( LE_PHYs::NONE == rx_phys ? 0x02 /* no rx preference */ : 0 );
+    cp->tx_phys = number(tx_phys);
+    cp->rx_phys = number(rx_phys);
+
+    const hci_rp_status * ev_status;
+    HCIStatusCode status;
+    std::shared_ptr<HCIEvent> ev = processCommandComplete(req0, &ev_status, &status);
+    return status;
+}
+
+HCIStatusCode HCIHandler::le_set_phy(const uint16_t conn_handle, const LE_PHYs tx_phys, const LE_PHYs rx_phys) {
+    const std::lock_guard<std::recursive_mutex> lock(mtx); // RAII-style acquire and relinquish via destructor
+    if( !comm.isOpen() ) {
+        ERR_PRINT("HCIHandler::le_set_phy: device not open");
+        return HCIStatusCode::INTERNAL_FAILURE;
+    }
+    HCIStructCommand<hci_cp_le_set_phy> req0(HCIOpcode::LE_SET_PHY);
+    hci_cp_le_set_phy * cp = req0.getWStruct();
+    cp->handle = cpu_to_le(conn_handle);
+    cp->all_phys = ( LE_PHYs::NONE == tx_phys ? 0x01 /* no tx preference */ : 0 ) |
+                   ( LE_PHYs::NONE == rx_phys ? 0x02 /* no rx preference */ : 0 );
+    cp->tx_phys = number(tx_phys);
+    cp->rx_phys = number(rx_phys);
+    cp->phy_opts = 0;
+
+    HCIStatusCode status;
+    std::shared_ptr<HCIEvent> ev = processCommandStatus(req0, &status);
+    return status;
+}
+
+HCIStatusCode HCIHandler::le_read_phy(const uint16_t conn_handle, LE_PHYs & resTx, LE_PHYs & resRx) {
+    const std::lock_guard<std::recursive_mutex> lock(mtx); // RAII-style acquire and relinquish via destructor
+    resTx = LE_PHYs::NONE;
+    resRx = LE_PHYs::NONE;
+    if( !comm.isOpen() ) {
+        ERR_PRINT("HCIHandler::le_read_phy: device not open");
+        return HCIStatusCode::INTERNAL_FAILURE;
+    }
+    HCIStructCommand<hci_cp_le_read_phy> req0(HCIOpcode::LE_READ_PHY);
+    hci_cp_le_read_phy * cp = req0.getWStruct();
+    cp->handle = cpu_to_le(conn_handle);
+
+    const hci_rp_le_read_phy * ev_phy;
+    HCIStatusCode status;
+    std::shared_ptr<HCIEvent> ev = processCommandComplete(req0, &ev_phy, &status);
+    if( nullptr != ev_phy && HCIStatusCode::SUCCESS == status ) {
+        resTx = getLE_PHYs(ev_phy->tx_phy);
+        resRx = getLE_PHYs(ev_phy->rx_phy);
+        const std::lock_guard<std::recursive_mutex> lock(mtx_connectionList); // RAII-style acquire and relinquish via destructor
+        HCIConnectionRef conn = findTrackerConnection(conn_handle);
+        if( nullptr != conn ) {
+            conn->setPhy(resTx, resRx);
+        }
+    }
+    return status;
+}
+
+std::shared_ptr<HCIConnection> HCIHandler::getTrackedConnection(const uint16_t conn_handle) {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_connectionList); // RAII-style acquire and relinquish via destructor
+    HCIConnectionRef conn = findTrackerConnection(conn_handle);
+    if( nullptr == conn ) {
+        return nullptr;
+    }
+    return std::shared_ptr<HCIConnection>( new HCIConnection( *conn ) );
+}
+
 std::shared_ptr<HCIEvent> HCIHandler::processCommandStatus(HCICommand &req, HCIStatusCode *status)
 {
     const std::lock_guard<std::recursive_mutex> lock(mtx_sendReply); // RAII-style acquire and relinquish via destructor
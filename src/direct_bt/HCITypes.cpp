@@ -175,7 +175,12 @@ std::string getHCIOGFString(const HCIOGF op) {
     X(LE_DEL_FROM_WHITE_LIST) \
     X(LE_CONN_UPDATE) \
     X(LE_READ_REMOTE_FEATURES) \
-    X(LE_START_ENC)
+    X(LE_START_ENC) \
+    X(LE_SET_DATA_LEN) \
+    X(LE_READ_MAX_DATA_LEN) \
+    X(LE_READ_PHY) \
+    X(LE_SET_DEFAULT_PHY) \
+    X(LE_SET_PHY)
 
 #define HCI_OPCODE_CASE_TO_STRING(V) case HCIOpcode::V: return #V;
 
@@ -187,6 +192,52 @@ std::string getHCIOpcodeString(const HCIOpcode op) {
     return "Unknown HCIOpcode";
 }
 
+std::string LEConnParam::toString() const {
+    return "LEConnParam[interval["+std::to_string(conn_interval_min)+".."+std::to_string(conn_interval_max)+
+           "], latency "+std::to_string(conn_latency)+", timeout "+std::to_string(supervision_timeout)+"]";
+}
+
+std::string getLEConnProfileString(const LEConnProfile p) {
+    switch(p) {
+        case LEConnProfile::DEFAULT: return "DEFAULT";
+        case LEConnProfile::BULK_TRANSFER: return "BULK_TRANSFER";
+        case LEConnProfile::IDLE_TELEMETRY: return "IDLE_TELEMETRY";
+        default: ; // fall through intended
+    }
+    return "Unknown LEConnProfile";
+}
+
+LEConnParam getLEConnParam(const LEConnProfile p) {
+    switch(p) {
+        case LEConnProfile::BULK_TRANSFER:
+            return LEConnParam { 0x0006, 0x0006, 0x0000, 500 };
+        case LEConnProfile::IDLE_TELEMETRY:
+            return LEConnParam { 0x0050, 0x00A0, 0x0004, 600 };
+        case LEConnProfile::DEFAULT:
+            // fall through intended
+        default:
+            return LEConnParam { 0x000F, 0x000F, 0x0000, static_cast<uint16_t>(number(HCIConstInt::LE_CONN_TIMEOUT_MS)/10) };
+    }
+}
+
+std::string getLE_PHYsString(const LE_PHYs phys) {
+    std::string out("[");
+    bool has_pre = false;
+    if( 0 != ( number(phys) & number(LE_PHYs::LE_1M) ) ) {
+        out.append("LE_1M"); has_pre = true;
+    }
+    if( 0 != ( number(phys) & number(LE_PHYs::LE_2M) ) ) {
+        if( has_pre ) { out.append(", "); }
+        out.append("LE_2M"); has_pre = true;
+    }
+    if( 0 != ( number(phys) & number(LE_PHYs::LE_CODED) ) ) {
+        if( has_pre ) { out.append(", "); }
+        out.append("LE_CODED");
+    }
+    out.append("]");
+    return out;
+}
+
 #define HCI_EVENTTYPE(X) \
     X(INVALID) \
     X(INQUIRY_COMPLETE) \
@@ -43,15 +43,17 @@
 extern "C" {
     #include <unistd.h>
     #include <sys/socket.h>
+    #include <sys/ioctl.h>
+    #include <fcntl.h>
     #include <poll.h>
-    #include <signal.h>
+    #include <sys/eventfd.h>
 }
 
 #include <dbt_debug.hpp>
 
 using namespace direct_bt;
 
-int L2CAPComm::l2cap_open_dev(const EUI48 & adapterAddress, const uint16_t psm, const uint16_t cid, const bool pubaddrAdapter) {
+int L2CAPComm::l2cap_open_dev(const EUI48 & adapterAddress, const uint16_t psm, const uint16_t cid, const bool pubaddrAdapter, const Mode mode) {
     sockaddr_l2 a;
     int dd, err;
 
@@ -63,14 +65,32 @@ int L2CAPComm::l2cap_open_dev(const EUI48 & adapterAddress, const uint16_t psm,
         ERR_PRINT("L2CAPComm::l2cap_open_dev: socket failed");
         return dd;
     }
+    // LE_FLOWCTL is the default mode of a LE PSM socket, while BT_MODE is rejected
+    // by kernels w/o enabled Enhanced Credit Based Flow Control (ENOPROTOOPT).
+    if( Mode::EXT_FLOWCTL == mode ) {
+        const int m = static_cast<int>(mode);
+        if( 0 > setsockopt(dd, SOL_BLUETOOTH, BT_MODE, &m, sizeof(m)) ) {
+            ERR_PRINT("L2CAPComm::l2cap_open_dev: setsockopt BT_MODE %d failed", m);
+            goto failed;
+        }
+    }
+
+    // Kernel receive timestamps, see read(..)
+    {
+        const int on = 1;
+        if( 0 > setsockopt(dd, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on)) ) {
+            WARN_PRINT("L2CAPComm::l2cap_open_dev: setsockopt SO_TIMESTAMPNS failed");
+        }
+    }
 
     // Bind socket to the L2CAP adapter
     // BT Core Spec v5.2: Vol 3, Part A: L2CAP_CONNECTION_REQ
+    // A credit based client channel binds w/o local PSM, its CID gets allocated on connect.
     bzero((void *)&a, sizeof(a));
     a.l2_family=AF_BLUETOOTH;
-    a.l2_psm = cpu_to_le(psm);
+    a.l2_psm = Mode::BASIC == mode ? cpu_to_le(psm) : 0;
     a.l2_bdaddr = adapterAddress;
-    a.l2_cid = cpu_to_le(cid);
+    a.l2_cid = Mode::BASIC == mode ? cpu_to_le(cid) : 0;
     a.l2_bdaddr_type = pubaddrAdapter ? BDADDR_LE_PUBLIC : BDADDR_LE_RANDOM;
     if ( bind(dd, (struct sockaddr *) &a, sizeof(a)) < 0 ) {
         ERR_PRINT("L2CAPComm::l2cap_open_dev: bind failed");
@@ -96,12 +116,85 @@ int L2CAPComm::l2cap_close_dev(int dd)
 // *************************************************
 // *************************************************
 
-L2CAPComm::L2CAPComm(std::shared_ptr<DBTDevice> device, const uint16_t psm, const uint16_t cid)
-: device(device), deviceString(device->getAddressString()), psm(psm), cid(cid),
-  _dd(-1), isConnected(false), hasIOError(false), interruptFlag(false), tid_connect(0)
-{ }
+L2CAPComm::L2CAPComm(std::shared_ptr<DBTDevice> device, const uint16_t psm, const uint16_t cid, const Mode mode)
+: device(device), deviceString(device->getAddressString()), psm(psm), cid(cid), mode(mode),
+  _dd(-1), isConnected(false), hasIOError(false), cancelGen(0), connectGen(0), rxMTU(0), rxBufferSize(0),
+  _efd( eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK) )
+{
+    if( 0 > _efd ) {
+        ERR_PRINT("L2CAPComm::ctor: eventfd failed");
+    }
+}
+
+L2CAPComm::L2CAPComm(const int dd, const std::string & deviceString, const Mode mode)
+: device(nullptr), deviceString(deviceString), psm(L2CAP_PSM_UNDEF), cid(L2CAP_CID_UNDEF), mode(mode),
+  _dd(dd), isConnected(0 <= dd), hasIOError(false), cancelGen(0), connectGen(0), rxMTU(0), rxBufferSize(0),
+  _efd( eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK) )
+{
+    if( 0 > _efd ) {
+        ERR_PRINT("L2CAPComm::ctor: eventfd failed");
+    }
+}
+
+L2CAPComm::~L2CAPComm() {
+    disconnect();
+    if( 0 <= _efd ) {
+        ::close(_efd);
+    }
+}
+
+void L2CAPComm::setFlowControlParameter(const uint16_t rxMTU, const int rxBufferSize) {
+    if( Mode::BASIC == mode ) {
+        throw IllegalStateException("L2CAPComm::setFlowControlParameter: Basic mode channel: "+deviceString, E_FILE_LINE);
+    }
+    if( 0 != rxMTU && 23 > rxMTU ) {
+        throw IllegalArgumentException("L2CAPComm::setFlowControlParameter: rxMTU "+std::to_string(rxMTU)+" < 23", E_FILE_LINE);
+    }
+    if( 0 > rxBufferSize ) {
+        throw IllegalArgumentException("L2CAPComm::setFlowControlParameter: rxBufferSize "+std::to_string(rxBufferSize)+" < 0", E_FILE_LINE);
+    }
+    const std::lock_guard<std::recursive_mutex> lock(mtx_write); // RAII-style acquire and relinquish via destructor
+    this->rxMTU = rxMTU;
+    this->rxBufferSize = rxBufferSize;
+}
+
+void L2CAPComm::wakeup() {
+    if( 0 <= _efd && 0 != eventfd_write(_efd, 1) ) {
+        ERR_PRINT("L2CAPComm::wakeup: eventfd write failed");
+    }
+}
+
+void L2CAPComm::clearWakeup() {
+    eventfd_t v;
+    if( 0 <= _efd ) {
+        eventfd_read(_efd, &v); // EAGAIN if not signaled
+    }
+}
+
+int L2CAPComm::pollOrWakeup(const short events, const int32_t timeoutMS, short & revents) {
+    struct pollfd p[2];
+    int n = 0;
+
+    p[0].fd = _dd; p[0].events = events; p[0].revents = 0;
+    p[1].fd = _efd; p[1].events = POLLIN; p[1].revents = 0;
+    while ( !isInterrupted() && (n = poll(p, 0 <= _efd ? 2 : 1, timeoutMS)) < 0 ) {
+        if ( errno == EAGAIN || errno == EINTR ) {
+            // cont temp unavail or interruption
+            continue;
+        }
+        return -1;
+    }
+    if( isInterrupted() || 0 != p[1].revents ) {
+        errno = ECANCELED;
+        return -1;
+    }
+    revents = p[0].revents;
+    return 0 < n ? 1 : 0;
+}
 
 bool L2CAPComm::connect() {
+    // A disconnect() issued from here on cancels this connect, even if it passes before the lock is acquired
+    const uint32_t gen = cancelGen;
     const std::lock_guard<std::recursive_mutex> lock(mtx_write); // RAII-style acquire and relinquish via destructor
 
     /** BT Core Spec v5.2: Vol 3, Part A: L2CAP_CONNECTION_REQ */
@@ -112,20 +205,51 @@ bool L2CAPComm::connect() {
                   getStateString().c_str(), _dd.load(), deviceString.c_str(), psm, cid, true);
         return true;
     }
+    if( nullptr == device ) {
+        ERR_PRINT("L2CAPComm::connect: No device, adopted socket has been closed: %s", deviceString.c_str());
+        isConnected = false;
+        return false;
+    }
     hasIOError = false;
+    // Drop a wakeup of a previous forced disconnect, but not of one issued since entry:
+    // Such disconnect has incremented cancelGen before signaling _efd, hence is either detected
+    // via isInterrupted() or its wakeup remains pending after clearWakeup().
+    connectGen = gen;
+    clearWakeup();
+    if( isInterrupted() ) {
+        DBG_PRINT("L2CAPComm::connect: Cancelled by disconnect: %s", deviceString.c_str());
+        isConnected = false;
+        errno = ECANCELED;
+        return false;
+    }
     DBG_PRINT("L2CAPComm::connect: Start: %s, dd %d, %s, psm %u, cid %u, pubDevice %d",
               getStateString().c_str(), _dd.load(), deviceString.c_str(), psm, cid, true);
 
     sockaddr_l2 req;
-    int err, res;
+    int err, res, flags;
     int to_retry_count=0; // ETIMEDOUT retry count
 
-    _dd = l2cap_open_dev(device->getAdapter().getAddress(), psm, cid, true /* pubaddrAdapter */);
+    _dd = l2cap_open_dev(device->getAdapter().getAddress(), psm, cid, true /* pubaddrAdapter */, mode);
     if( 0 > _dd ) {
         goto failure; // open failed
     }
 
-    tid_connect = pthread_self(); // temporary safe tid to allow interruption
+    // credit based flow control parameter must be set before connecting
+    if( 0 != rxMTU && 0 > setsockopt(_dd, SOL_BLUETOOTH, BT_RCVMTU, &rxMTU, sizeof(rxMTU)) ) {
+        ERR_PRINT("L2CAPComm::connect: setsockopt BT_RCVMTU %u failed", rxMTU);
+        goto failure;
+    }
+    if( 0 != rxBufferSize && 0 > setsockopt(_dd, SOL_SOCKET, SO_RCVBUF, &rxBufferSize, sizeof(rxBufferSize)) ) {
+        ERR_PRINT("L2CAPComm::connect: setsockopt SO_RCVBUF %d failed", rxBufferSize);
+        goto failure;
+    }
+
+    // non-blocking ::connect(..), allowing its cancellation via wakeup()
+    flags = fcntl(_dd, F_GETFL, 0);
+    if( 0 > flags || 0 > fcntl(_dd, F_SETFL, flags | O_NONBLOCK) ) {
+        ERR_PRINT("L2CAPComm::connect: fcntl O_NONBLOCK failed");
+        goto failure;
+    }
 
     // actual request to connect to remote device
     bzero((void *)&req, sizeof(req));
@@ -135,9 +259,23 @@ bool L2CAPComm::connect() {
     req.l2_cid = cpu_to_le(cid);
     req.l2_bdaddr_type = device->getAddressType();
 
-    while( !interruptFlag ) {
-        // blocking
+    while( !isInterrupted() ) {
         res = ::connect(_dd, (struct sockaddr*)&req, sizeof(req));
+        if( 0 > res && EINPROGRESS == errno ) {
+            // await completion or wakeup, the kernel's connect timeout applies
+            short revents = 0;
+            if( 0 > pollOrWakeup(POLLOUT, -1 /* infinite */, revents) ) {
+                ERR_PRINT("L2CAPComm::connect: poll failed or cancelled");
+                goto failure; // exit
+            }
+            socklen_t len = sizeof(err);
+            if( 0 > getsockopt(_dd, SOL_SOCKET, SO_ERROR, &err, &len) ) {
+                ERR_PRINT("L2CAPComm::connect: getsockopt SO_ERROR failed");
+                goto failure; // exit
+            }
+            res = 0 == err ? 0 : -1;
+            errno = err;
+        }
 
         DBG_PRINT("L2CAPComm::connect: Result %d, errno 0%X %s, %s", res, errno, strerror(errno), deviceString.c_str());
 
@@ -161,12 +299,19 @@ bool L2CAPComm::connect() {
             goto failure; // exit
         }
     }
-    tid_connect = 0;
+    if( isInterrupted() ) {
+        errno = ECANCELED;
+        goto failure;
+    }
 
+    // blocking read and write operations, see read(..) and write(..)
+    if( 0 > fcntl(_dd, F_SETFL, flags) ) {
+        ERR_PRINT("L2CAPComm::connect: fcntl restore flags failed");
+        goto failure;
+    }
     return true;
 
 failure:
-    tid_connect = 0;
     err = errno;
     disconnect();
     errno = err;
@@ -174,6 +319,10 @@ failure:
 }
 
 bool L2CAPComm::disconnect() {
+    // interrupt a pending L2CAP ::connect(..), read(..) or waitWritable(..) holding or awaiting the lock
+    cancelGen++;
+    wakeup();
+
     const std::lock_guard<std::recursive_mutex> lock(mtx_write); // RAII-style acquire and relinquish via destructor
 
     bool expConn = true; // C++11, exp as value since C++20
@@ -185,30 +334,24 @@ bool L2CAPComm::disconnect() {
     hasIOError = false;
     DBG_PRINT("L2CAPComm::disconnect: Start: %s, dd %d, %s, psm %u, cid %u, pubDevice %d",
               getStateString().c_str(), _dd.load(), deviceString.c_str(), psm, cid, true);
-    interruptFlag = true;
-
-    // interrupt L2CAP ::connect(..), avoiding prolonged hang
-    pthread_t _tid_connect = tid_connect;
-    tid_connect = 0;
-    if( 0 != _tid_connect ) {
-        pthread_t tid_self = pthread_self();
-        if( tid_self != _tid_connect ) {
-            int kerr;
-            if( 0 != ( kerr = pthread_kill(_tid_connect, SIGALRM) ) ) {
-                ERR_PRINT("L2CAP::disconnect: pthread_kill %p FAILED: %d", (void*)_tid_connect, kerr);
-            }
-        }
-    }
 
-    l2cap_close_dev(_dd);
+    if( 0 <= _dd ) {
+        l2cap_close_dev(_dd);
+    }
     _dd = -1;
-    interruptFlag = false;
     DBG_PRINT("L2CAPComm::disconnect: End: dd %d", _dd.load());
     return true;
 }
 
-int L2CAPComm::read(uint8_t* buffer, const int capacity, const int32_t timeoutMS) {
+int L2CAPComm::read(uint8_t* buffer, const int capacity, const int32_t timeoutMS, uint64_t & rxTimestamp) {
     int len = 0;
+    struct iovec iov;
+    struct msghdr msg;
+    union {
+        struct cmsghdr align;
+        uint8_t data[CMSG_SPACE(sizeof(struct timespec))];
+    } control;
+    rxTimestamp = 0;
     if( 0 > _dd || 0 > capacity ) {
         goto errout;
     }
@@ -217,15 +360,9 @@ int L2CAPComm::read(uint8_t* buffer, const int capacity, const int32_t timeoutMS
     }
 
     if( timeoutMS ) {
-        struct pollfd p;
-        int n;
-
-        p.fd = _dd; p.events = POLLIN;
-        while ( !interruptFlag && (n = poll(&p, 1, timeoutMS)) < 0 ) {
-            if ( !interruptFlag && ( errno == EAGAIN || errno == EINTR ) ) {
-                // cont temp unavail or interruption
-                continue;
-            }
+        short revents = 0;
+        const int n = pollOrWakeup(POLLIN, timeoutMS, revents);
+        if( 0 > n ) {
             goto errout;
         }
         if (!n) {
@@ -234,19 +371,42 @@ int L2CAPComm::read(uint8_t* buffer, const int capacity, const int32_t timeoutMS
         }
     }
 
-    while ((len = ::read(_dd, buffer, capacity)) < 0) {
+    iov.iov_base = buffer;
+    iov.iov_len = capacity;
+    bzero(&msg, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.data;
+    msg.msg_controllen = sizeof(control.data);
+
+    while ((len = ::recvmsg(_dd, &msg, 0)) < 0) {
         if (errno == EAGAIN || errno == EINTR ) {
             // cont temp unavail or interruption
             continue;
         }
         goto errout;
     }
+    if( 0 == len ) {
+        // orderly shutdown by the peer, never an empty PDU
+        errno = ECONNRESET;
+        goto errout;
+    }
+    for(struct cmsghdr * cmsg = CMSG_FIRSTHDR(&msg); nullptr != cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if( SOL_SOCKET == cmsg->cmsg_level && SCM_TIMESTAMPNS == cmsg->cmsg_type ) {
+            struct timespec ts;
+            memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            rxTimestamp = (uint64_t)ts.tv_sec * 1000000000UL + (uint64_t)ts.tv_nsec;
+        }
+    }
+    if( 0 == rxTimestamp ) {
+        rxTimestamp = getWallClockNanoseconds();
+    }
 
 done:
     return len;
 
 errout:
-    if( errno != ETIMEDOUT ) {
+    if( errno != ETIMEDOUT && errno != ECANCELED ) {
         hasIOError = true;
     }
     return -1;
@@ -278,3 +438,105 @@ errout:
     return -1;
 }
 
+int L2CAPComm::getWriteSpace() const {
+    if( 0 > _dd ) {
+        return -1;
+    }
+    // Bluetooth sockets report the free send buffer space via TIOCOUTQ
+    int space = 0;
+    if( 0 > ::ioctl(_dd, TIOCOUTQ, &space) ) {
+        return -1;
+    }
+    return space;
+}
+
+int L2CAPComm::getMTU() const {
+    if( 0 > _dd ) {
+        return -1;
+    }
+    uint16_t sndMTU = 0, rcvMTU = 0;
+    socklen_t len = sizeof(sndMTU);
+    if( 0 > getsockopt(_dd, SOL_BLUETOOTH, BT_SNDMTU, &sndMTU, &len) ) {
+        return -1;
+    }
+    len = sizeof(rcvMTU);
+    if( 0 > getsockopt(_dd, SOL_BLUETOOTH, BT_RCVMTU, &rcvMTU, &len) ) {
+        return -1;
+    }
+    return std::min(sndMTU, rcvMTU);
+}
+
+int L2CAPComm::getTxMTU() const {
+    if( 0 > _dd ) {
+        return -1;
+    }
+    uint16_t mtu = 0;
+    socklen_t len = sizeof(mtu);
+    if( 0 > getsockopt(_dd, SOL_BLUETOOTH, BT_SNDMTU, &mtu, &len) ) {
+        return -1;
+    }
+    return mtu;
+}
+
+int L2CAPComm::getRxMTU() const {
+    if( 0 > _dd ) {
+        return -1;
+    }
+    uint16_t mtu = 0;
+    socklen_t len = sizeof(mtu);
+    if( 0 > getsockopt(_dd, SOL_BLUETOOTH, BT_RCVMTU, &mtu, &len) ) {
+        return -1;
+    }
+    return mtu;
+}
+
+int L2CAPComm::writeStream(const uint8_t *buffer, const int length, const int32_t timeoutMS) {
+    const std::lock_guard<std::recursive_mutex> lock(mtx_write); // RAII-style acquire and relinquish via destructor
+    if( 0 > length ) {
+        throw IllegalArgumentException("L2CAPComm::writeStream: length "+std::to_string(length)+" < 0", E_FILE_LINE);
+    }
+    const int mtu = getTxMTU();
+    if( 0 >= mtu ) {
+        return -1;
+    }
+    int offset = 0;
+    while( offset < length ) {
+        const int w = waitWritable(timeoutMS);
+        if( 0 > w ) {
+            return -1;
+        } else if( 0 == w ) {
+            DBG_PRINT("L2CAPComm::writeStream: timeout or interrupted after %d/%d bytes: %s", offset, length, deviceString.c_str());
+            break;
+        }
+        const int sduLen = std::min(mtu, length - offset);
+        const int res = write(buffer + offset, sduLen);
+        if( res != sduLen ) {
+            return -1;
+        }
+        offset += sduLen;
+    }
+    return offset;
+}
+
+int L2CAPComm::waitWritable(const int32_t timeoutMS) {
+    if( 0 > _dd ) {
+        return -1;
+    }
+    short revents = 0;
+    const int n = pollOrWakeup(POLLOUT, timeoutMS, revents);
+    if( 0 > n ) {
+        if( ECANCELED == errno ) {
+            return 0;
+        }
+        hasIOError = true;
+        return -1;
+    }
+    if( 0 == n ) {
+        return 0;
+    }
+    if( 0 != ( revents & ( POLLERR | POLLHUP | POLLNVAL ) ) ) {
+        hasIOError = true;
+        return -1;
+    }
+    return 1;
+}
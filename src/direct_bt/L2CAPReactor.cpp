@@ -0,0 +1,197 @@
+/*
+ * Author: Sven Gothel <sgothel@jausoft.com>
+ * Copyright (c) 2020 Gothel Software e.K.
+ * Copyright (c) 2020 ZAFENA AB
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+ * LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+ * OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+#include <cstring>
+#include <string>
+#include <memory>
+#include <cstdint>
+#include <vector>
+#include <cstdio>
+
+#include <dbt_debug.hpp>
+
+#include "L2CAPReactor.hpp"
+
+extern "C" {
+    #include <unistd.h>
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+}
+
+using namespace direct_bt;
+
+L2CAPReactor::L2CAPReactor(const int threadCount)
+: shallStop(false)
+{
+    for(int i=0; i<threadCount; i++) {
+        std::shared_ptr<Shard> shard = std::make_shared<Shard>();
+        shard->epollFd = epoll_create1(EPOLL_CLOEXEC);
+        shard->eventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if( 0 > shard->epollFd || 0 > shard->eventFd ) {
+            ERR_PRINT("L2CAPReactor: Could not create epoll or eventfd");
+            throw InternalError("L2CAPReactor: Could not create epoll or eventfd", E_FILE_LINE);
+        }
+        struct epoll_event ev;
+        bzero(&ev, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.fd = shard->eventFd;
+        epoll_ctl(shard->epollFd, EPOLL_CTL_ADD, shard->eventFd, &ev);
+        shards.push_back(shard);
+    }
+    for(size_t i=0; i<shards.size(); i++) {
+        shards[i]->thread = std::thread(&L2CAPReactor::reactorThreadImpl, this, std::ref(*shards[i]));
+    }
+    DBG_PRINT("L2CAPReactor: Started %d threads", threadCount);
+}
+
+L2CAPReactor::~L2CAPReactor() {
+    shallStop = true;
+    for(size_t i=0; i<shards.size(); i++) {
+        const uint64_t one = 1;
+        if( sizeof(one) != ::write(shards[i]->eventFd, &one, sizeof(one)) ) {
+            ERR_PRINT("L2CAPReactor::dtor: eventfd write failed");
+        }
+    }
+    for(size_t i=0; i<shards.size(); i++) {
+        if( shards[i]->thread.joinable() ) {
+            shards[i]->thread.join();
+        }
+        {
+            const std::lock_guard<std::mutex> lock(shards[i]->mtx_entries); // RAII-style acquire and relinquish via destructor
+            shards[i]->entries.clear();
+        }
+        ::close(shards[i]->eventFd);
+        ::close(shards[i]->epollFd);
+    }
+}
+
+void L2CAPReactor::reactorThreadImpl(Shard & shard) {
+    const int maxEvents = 32;
+    struct epoll_event events[maxEvents];
+    int64_t lastTick = getCurrentMilliseconds();
+
+    while( !shallStop ) {
+        const int n = epoll_wait(shard.epollFd, events, maxEvents, TICK_MS);
+        if( 0 > n && EINTR != errno ) {
+            ERR_PRINT("L2CAPReactor::reactorThread: epoll_wait failed");
+            break;
+        }
+        for(int i=0; i<n && !shallStop; i++) {
+            if( events[i].data.fd == shard.eventFd ) {
+                uint64_t v;
+                if( 0 > ::read(shard.eventFd, &v, sizeof(v)) ) {
+                    // EAGAIN: already drained
+                }
+                continue;
+            }
+            dispatch(shard, events[i].data.fd, false /* tick */);
+        }
+        const int64_t now = getCurrentMilliseconds();
+        if( !shallStop && now - lastTick >= TICK_MS ) {
+            lastTick = now;
+            std::vector<int> fds;
+            {
+                const std::lock_guard<std::mutex> lock(shard.mtx_entries); // RAII-style acquire and relinquish via destructor
+                for(auto it = shard.entries.begin(); it != shard.entries.end(); it++) {
+                    if( nullptr != it->second->tick ) {
+                        fds.push_back(it->first);
+                    }
+                }
+            }
+            for(size_t i=0; i<fds.size(); i++) {
+                dispatch(shard, fds[i], true /* tick */);
+            }
+        }
+    }
+    DBG_PRINT("L2CAPReactor::reactorThread: Ended");
+}
+
+void L2CAPReactor::dispatch(Shard & shard, const int fd, const bool tick) {
+    std::shared_ptr<Entry> e;
+    {
+        const std::lock_guard<std::mutex> lock(shard.mtx_entries); // RAII-style acquire and relinquish via destructor
+        auto it = shard.entries.find(fd);
+        if( it == shard.entries.end() ) {
+            return;
+        }
+        e = it->second;
+    }
+    bool keep = false;
+    try {
+        keep = tick ? e->tick() : e->readable();
+    } catch (std::exception &ex) {
+        ERR_PRINT("L2CAPReactor::dispatch: fd %d: Caught exception %s", fd, ex.what());
+    }
+    if( !keep ) {
+        const std::lock_guard<std::mutex> lock(shard.mtx_entries); // RAII-style acquire and relinquish via destructor
+        auto it = shard.entries.find(fd);
+        if( it != shard.entries.end() && it->second == e ) {
+            removeLocked(shard, fd);
+        }
+    }
+}
+
+void L2CAPReactor::removeLocked(Shard & shard, const int fd) {
+    auto it = shard.entries.find(fd);
+    if( it == shard.entries.end() ) {
+        return;
+    }
+    shard.entries.erase(it);
+    if( 0 != epoll_ctl(shard.epollFd, EPOLL_CTL_DEL, fd, nullptr) ) {
+        DBG_PRINT("L2CAPReactor::remove: fd %d: epoll_ctl DEL failed, errno %d %s", fd, errno, strerror(errno));
+    }
+}
+
+bool L2CAPReactor::add(const int fd, const ReadableCallback & readable, const TickCallback & tick) {
+    if( 0 > fd || nullptr == readable ) {
+        throw IllegalArgumentException("Invalid fd "+std::to_string(fd)+" or null ReadableCallback", E_FILE_LINE);
+    }
+    Shard & shard = getShard(fd);
+    const std::lock_guard<std::mutex> lock(shard.mtx_entries); // RAII-style acquire and relinquish via destructor
+    if( shard.entries.end() != shard.entries.find(fd) ) {
+        ERR_PRINT("L2CAPReactor::add: fd %d already registered", fd);
+        return false;
+    }
+    struct epoll_event ev;
+    bzero(&ev, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    ev.data.fd = fd;
+    if( 0 != epoll_ctl(shard.epollFd, EPOLL_CTL_ADD, fd, &ev) ) {
+        ERR_PRINT("L2CAPReactor::add: fd %d: epoll_ctl ADD failed", fd);
+        return false;
+    }
+    shard.entries[fd] = std::make_shared<Entry>(readable, tick);
+    return true;
+}
+
+void L2CAPReactor::remove(const int fd) {
+    if( 0 > fd ) {
+        return;
+    }
+    Shard & shard = getShard(fd);
+    const std::lock_guard<std::mutex> lock(shard.mtx_entries); // RAII-style acquire and relinquish via destructor
+    removeLocked(shard, fd);
+}
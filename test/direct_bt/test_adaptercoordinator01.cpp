@@ -0,0 +1,85 @@
+#include <iostream>
+#include <cassert>
+#include <cinttypes>
+#include <cstring>
+
+#include <cppunit.h>
+
+#include <direct_bt/DBTAdapterCoordinator.hpp>
+
+using namespace direct_bt;
+
+static const int8_t NONE = DBTAdapterCoordinator::RSSI_NONE;
+
+// Test examples.
+class Cppunit_tests: public Cppunit {
+    void single_test() override {
+        // Adapter which haven't seen the device are never selected
+        CHECK( DBTAdapterCoordinator::selectAdapter( { 0, 0, 0 }, { NONE, -50, NONE }, -85, 0, -1 ), 1 );
+        CHECK( DBTAdapterCoordinator::selectAdapter( { 5, 0, 0 }, { -50, NONE, NONE }, -85, 0, -1 ), 0 );
+        CHECK( DBTAdapterCoordinator::selectAdapter( { 0, 0 }, { NONE, NONE }, -85, 0, -1 ), -1 );
+
+        // Least assigned adapter wins, ties broken by the better RSSI
+        CHECK( DBTAdapterCoordinator::selectAdapter( { 2, 1, 3 }, { -40, -70, -30 }, -85, 0, -1 ), 1 );
+        CHECK( DBTAdapterCoordinator::selectAdapter( { 1, 1, 1 }, { -60, -40, -70 }, -85, 0, -1 ), 1 );
+
+        // Unacceptable signal
+        CHECK( DBTAdapterCoordinator::selectAdapter( { 0, 1 }, { -90, -60 }, -85, 0, -1 ), 1 );
+        CHECK( DBTAdapterCoordinator::selectAdapter( { 0, 1 }, { -90, -86 }, -85, 0, -1 ), -1 );
+
+        // Assignment limit
+        CHECK( DBTAdapterCoordinator::selectAdapter( { 2, 3 }, { -40, -50 }, -85, 3, -1 ), 0 );
+        CHECK( DBTAdapterCoordinator::selectAdapter( { 3, 3 }, { -40, -50 }, -85, 3, -1 ), -1 );
+        CHECK( DBTAdapterCoordinator::selectAdapter( { 3, 3 }, { -40, -50 }, -85, 0, -1 ), 0 );
+
+        // Scanning adapter only as last resort
+        CHECK( DBTAdapterCoordinator::selectAdapter( { 0, 4 }, { -30, -80 }, -85, 0, 0 ), 1 );
+        CHECK( DBTAdapterCoordinator::selectAdapter( { 0, 4 }, { -30, NONE }, -85, 0, 0 ), 0 );
+        CHECK( DBTAdapterCoordinator::selectAdapter( { 0, 4 }, { -30, -80 }, -85, 4, 0 ), 0 );
+
+        // RSSI ages out per adapter
+        {
+            DBTAdapterCoordinator::DeviceInfo info(EUI48("01:02:03:04:05:06"), BDAddressType::BDADDR_LE_PUBLIC, 3);
+            info.rssi[0] = -50; info.ts_rssi[0] = 1000;
+            info.rssi[1] = -70; info.ts_rssi[1] = 9000;
+            const std::vector<int8_t> r0 = info.getRecentRSSI(10000, 10000);
+            CHECK( r0[0], -50 );
+            CHECK( r0[1], -70 );
+            CHECK( r0[2], NONE );
+            const std::vector<int8_t> r1 = info.getRecentRSSI(12000, 10000);
+            CHECK( r1[0], NONE );
+            CHECK( r1[1], -70 );
+            CHECK( r1[2], NONE );
+            CHECK( DBTAdapterCoordinator::selectAdapter( { 0, 1, 0 }, r0, -85, 0, -1 ), 0 );
+            CHECK( DBTAdapterCoordinator::selectAdapter( { 0, 1, 0 }, r1, -85, 0, -1 ), 1 );
+            const std::vector<int8_t> r2 = info.getRecentRSSI(30000, 10000);
+            CHECK( DBTAdapterCoordinator::selectAdapter( { 0, 1, 0 }, r2, -85, 0, -1 ), -1 );
+            CHECK( info.getBestRSSI(), -50 );
+        }
+
+        // Only unassigned, unconnected devices expire by their last sighting
+        {
+            DBTAdapterCoordinator::DeviceInfo info(EUI48("01:02:03:04:05:06"), BDAddressType::BDADDR_LE_PUBLIC, 2);
+            info.ts_last_seen = 5000;
+            CHECKT( !info.isExpired(15000, 10000) );
+            CHECKT( info.isExpired(15001, 10000) );
+            CHECKT( !info.isExpired(4000, 10000) );
+            info.assignedAdapter = 1;
+            CHECKT( !info.isExpired(30000, 10000) );
+            info.assignedAdapter = -1;
+            info.whitelisted = true;
+            CHECKT( !info.isExpired(30000, 10000) );
+            info.whitelisted = false;
+            info.connected = true;
+            CHECKT( !info.isExpired(30000, 10000) );
+        }
+    }
+};
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    Cppunit_tests test1;
+    return test1.run();
+}
@@ -28,6 +28,62 @@ class Cppunit_tests: public Cppunit {
 
         CHECK(req.getStartHandle(), 1);
         CHECK(req.getEndHandle(), 0xffff);
+
+        const std::vector<uint16_t> handles = { 0x0003, 0x0010, 0x0021 };
+        const AttReadMultipleReq reqRM(true /* variableLength */, handles);
+        CHECKT( reqRM.isVariableLength() );
+        CHECK(reqRM.getHandleCount(), 3);
+        CHECK(reqRM.getHandle(2), 0x0021);
+
+        // tuples: [len 2: 0x11 0x22], [len 0], [len 5, truncated: 0x33 0x44]
+        const uint8_t rspRMV[] = { AttPDUMsg::ATT_READ_MULTIPLE_VARIABLE_RSP,
+                                   0x02, 0x00, 0x11, 0x22,
+                                   0x00, 0x00,
+                                   0x05, 0x00, 0x33, 0x44 };
+        std::shared_ptr<const AttPDUMsg> pdu( AttPDUMsg::getSpecialized(rspRMV, sizeof(rspRMV)) );
+        CHECK(pdu->getOpcode(), AttPDUMsg::ATT_READ_MULTIPLE_VARIABLE_RSP);
+        const AttReadMultipleVariableRsp * p = static_cast<const AttReadMultipleVariableRsp*>(pdu.get());
+        CHECK(p->getTupleCount(), 3);
+        CHECK(p->getTupleValueSize(0), 2);
+        CHECK(p->getTupleValue(0).get_uint8(1), 0x22);
+        CHECKT( !p->isTupleTruncated(0) );
+        CHECK(p->getTupleValueSize(1), 0);
+        CHECK(p->getTupleLength(2), 5);
+        CHECK(p->getTupleValueSize(2), 2);
+        CHECKT( p->isTupleTruncated(2) );
+
+        const uint8_t value[] = { 0x01, 0x02, 0x03 };
+        const AttPrepareWrite reqPW(0x0021, 0x0012, TROOctets(value, sizeof(value)));
+        CHECK(reqPW.getOpcode(), AttPDUMsg::ATT_PREPARE_WRITE_REQ);
+        CHECK(reqPW.getHandle(), 0x0021);
+        CHECK(reqPW.getValueOffset(), 0x0012);
+        CHECK(reqPW.getPDUValueSize(), 3);
+        CHECKT( 0 == memcmp(reqPW.getValuePtr(), value, sizeof(value)) );
+
+        // response echoes the request
+        POctets rspPWData(reqPW.pdu);
+        rspPWData.put_uint8(0, AttPDUMsg::ATT_PREPARE_WRITE_RSP);
+        std::shared_ptr<const AttPDUMsg> pdu2( AttPDUMsg::getSpecialized(rspPWData.get_ptr(), rspPWData.getSize()) );
+        const AttPrepareWrite * p2 = static_cast<const AttPrepareWrite*>(pdu2.get());
+        CHECK(p2->getOpcode(), AttPDUMsg::ATT_PREPARE_WRITE_RSP);
+        CHECK(p2->getHandle(), 0x0021);
+        CHECK(p2->getValueOffset(), 0x0012);
+        CHECKT( 0 == memcmp(p2->getValuePtr(), value, sizeof(value)) );
+
+        // tuples: [handle 0x0010, len 1: 0xAA], [handle 0x0020, len 2: 0xBB 0xCC], [handle 0x0030, len 4, truncated: 0xDD]
+        const uint8_t ntfMHV[] = { AttPDUMsg::ATT_MULTIPLE_HANDLE_VALUE_NTF,
+                                   0x10, 0x00, 0x01, 0x00, 0xAA,
+                                   0x20, 0x00, 0x02, 0x00, 0xBB, 0xCC,
+                                   0x30, 0x00, 0x04, 0x00, 0xDD };
+        std::shared_ptr<const AttPDUMsg> pdu3( AttPDUMsg::getSpecialized(ntfMHV, sizeof(ntfMHV)) );
+        CHECK(pdu3->getOpcode(), AttPDUMsg::ATT_MULTIPLE_HANDLE_VALUE_NTF);
+        const AttMultipleHandleValueNtf * p3 = static_cast<const AttMultipleHandleValueNtf*>(pdu3.get());
+        CHECK(p3->getTupleCount(), 2);
+        CHECK(p3->getTupleHandle(0), 0x0010);
+        CHECK(p3->getTupleValueSize(0), 1);
+        CHECK(p3->getTupleHandle(1), 0x0020);
+        CHECK(p3->getTupleValueSize(1), 2);
+        CHECK(p3->getTupleValue(1).get_uint8(1), 0xCC);
     }
 };
 
@@ -2,11 +2,13 @@
 #include <cassert>
 #include <cinttypes>
 #include <cstring>
+#include <thread>
 
 #include <cppunit.h>
 
 #include <direct_bt/BasicTypes.hpp>
 #include <direct_bt/BTAddress.hpp>
+#include <direct_bt/OctetTypes.hpp>
 
 using namespace direct_bt;
 
@@ -65,6 +67,42 @@ class Cppunit_tests : public Cppunit {
             CHECKM("EUI48 struct and data size not matching", sizeof(EUI48), sizeof(mac01));
             CHECKM("EUI48 struct and data size not matching", sizeof(mac01), sizeof(mac01.b));
         }
+        {
+            OctetsPool pool(8, 2);
+            std::shared_ptr<PooledOctets> b0 = pool.acquire();
+            b0->get_buffer()[1] = 0x42;
+            b0->setView(1, 2);
+            CHECK(b0->getSize(), 2);
+            CHECK(b0->get_uint8(0), 0x42);
+            std::shared_ptr<TROOctets> v0 = b0;
+            b0 = nullptr;
+            std::shared_ptr<PooledOctets> b1 = pool.acquire();
+            CHECKTM("referenced buffer shall not be recycled", b1.get() != v0.get());
+            const PooledOctets * b1ptr = b1.get();
+            b1 = nullptr;
+            std::shared_ptr<PooledOctets> b2 = pool.acquire();
+            CHECKTM("released buffer shall be recycled", b2.get() == b1ptr);
+            CHECK(b2->getSize(), 0);
+            std::shared_ptr<PooledOctets> b3 = pool.acquire(); // exceeds pool size
+            CHECK(pool.getSize(), 2);
+            CHECK(pool.getFreeCount(), 0);
+            v0 = nullptr;
+            CHECK(pool.getFreeCount(), 1);
+            b3 = nullptr; // unpooled
+            CHECK(pool.getFreeCount(), 1);
+            std::thread t( [&b2]() { b2->get_buffer()[0] = 0x01; b2 = nullptr; } );
+            t.join();
+            CHECK(pool.getFreeCount(), 2);
+        }
+        {
+            std::shared_ptr<PooledOctets> b0;
+            {
+                OctetsPool pool(8, 2);
+                b0 = pool.acquire();
+            }
+            b0->get_buffer()[0] = 0x42; // outlives its pool
+            b0 = nullptr;
+        }
 
     }
 };
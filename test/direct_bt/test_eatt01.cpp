@@ -0,0 +1,191 @@
+#include <iostream>
+#include <cassert>
+#include <cinttypes>
+#include <cstring>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <memory>
+
+#include <cppunit.h>
+
+#include <direct_bt/BasicTypes.hpp>
+#include <direct_bt/ATTPDUTypes.hpp>
+#include <direct_bt/GATTHandler.hpp>
+
+extern "C" {
+    #include <unistd.h>
+    #include <sys/socket.h>
+}
+
+using namespace direct_bt;
+
+static const int REPLY_DELAY_MS = 200;
+static const uint16_t EATT_MTU = 64;
+
+/**
+ * Mock ATT server on the peer end of a local SOCK_SEQPACKET socketpair, one per bearer.
+ * <p>
+ * Answers ATT_EXCHANGE_MTU_REQ immediately and each ATT_READ_REQ after a delay
+ * with an ATT_READ_RSP carrying the requested handle, counting the requests and confirmations received.
+ * </p>
+ */
+class MockPeer {
+    public:
+        int fd;
+        std::thread thread;
+        std::atomic<int> readCount;
+        std::atomic<int> cfmCount;
+
+        MockPeer(const int fd) : fd(fd), readCount(0), cfmCount(0) {
+            thread = std::thread(&MockPeer::peerThreadImpl, this);
+        }
+
+        ~MockPeer() {
+            close();
+        }
+
+        void close() {
+            if( 0 <= fd ) {
+                ::shutdown(fd, SHUT_RDWR);
+            }
+            if( thread.joinable() ) {
+                thread.join();
+            }
+            if( 0 <= fd ) {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+
+        void peerThreadImpl() {
+            uint8_t buffer[EATT_MTU];
+            while( true ) {
+                const ssize_t len = ::read(fd, buffer, sizeof(buffer));
+                if( 0 >= len ) {
+                    break;
+                }
+                if( AttPDUMsg::ATT_EXCHANGE_MTU_REQ == buffer[0] ) {
+                    const uint8_t rsp[] = { AttPDUMsg::ATT_EXCHANGE_MTU_RSP, 23, 0 };
+                    if( sizeof(rsp) != ::write(fd, rsp, sizeof(rsp)) ) {
+                        break;
+                    }
+                } else if( AttPDUMsg::ATT_READ_REQ == buffer[0] && 3 <= len ) {
+                    readCount++;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(REPLY_DELAY_MS));
+                    const uint8_t rsp[] = { AttPDUMsg::ATT_READ_RSP, buffer[1], buffer[2] };
+                    if( sizeof(rsp) != ::write(fd, rsp, sizeof(rsp)) ) {
+                        break;
+                    }
+                } else if( AttPDUMsg::ATT_HANDLE_VALUE_CFM == buffer[0] ) {
+                    cfmCount++;
+                }
+            }
+        }
+
+        bool indicate(const uint16_t handle) {
+            const uint8_t ind[] = { AttPDUMsg::ATT_HANDLE_VALUE_IND, (uint8_t)(handle & 0xff), (uint8_t)(handle >> 8), 0x01 };
+            return sizeof(ind) == ::write(fd, ind, sizeof(ind));
+        }
+};
+
+/** Returns the local end of a new socketpair, passing the other end to a new MockPeer. */
+static int connectPeer(std::vector<std::shared_ptr<MockPeer>> & peers) {
+    int sv[2];
+    if( 0 != ::socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, sv) ) {
+        throw InternalError("socketpair failed", E_FILE_LINE);
+    }
+    peers.push_back( std::make_shared<MockPeer>(sv[1]) );
+    return sv[0];
+}
+
+/** Reads the given handles concurrently, one thread each, returning the elapsed time in milliseconds. */
+static uint64_t readConcurrently(GATTHandler & handler, const std::vector<uint16_t> & handles, std::vector<uint16_t> & results) {
+    results.assign(handles.size(), 0);
+    std::vector<std::thread> threads;
+    const uint64_t t0 = getCurrentMilliseconds();
+    for(size_t i=0; i<handles.size(); i++) {
+        threads.push_back( std::thread([&handler, &handles, &results, i]() {
+            POctets res(EATT_MTU, 0);
+            if( handler.readValue(handles[i], res) && 2 == res.getSize() ) {
+                results[i] = res.get_uint16(0);
+            }
+        }) );
+    }
+    for(size_t i=0; i<threads.size(); i++) {
+        threads[i].join();
+    }
+    return getCurrentMilliseconds() - t0;
+}
+
+class Cppunit_tests: public Cppunit {
+    void single_test() override {
+        std::vector<std::shared_ptr<MockPeer>> peers;
+        std::shared_ptr<GATTHandler> handler = std::make_shared<GATTHandler>(connectPeer(peers), "mock");
+        CHECKT( handler->connect() );
+        CHECKT( handler->isOpen() );
+        CHECK( handler->getServerMTU(), 23 );
+        CHECKT( handler->addEATTBearer(connectPeer(peers), EATT_MTU) );
+        CHECKT( handler->addEATTBearer(connectPeer(peers), EATT_MTU) );
+        CHECK( handler->getEATTBearerCount(), 2 );
+
+        // Concurrent requests select one idle bearer each, their replies are routed back to the requesting bearer,
+        // completing within about one reply delay instead of their sum.
+        {
+            std::vector<uint16_t> results;
+            const uint64_t td = readConcurrently(*handler, { 0x0010, 0x0011, 0x0012 }, results);
+            fprintf(stderr, "EATT: 3 concurrent requests in %" PRIu64 " ms\n", td);
+            CHECK( results[0], 0x0010 );
+            CHECK( results[1], 0x0011 );
+            CHECK( results[2], 0x0012 );
+            CHECKT( td < static_cast<uint64_t>( 3 * REPLY_DELAY_MS ) );
+            for(size_t i=0; i<peers.size(); i++) {
+                CHECK( peers[i]->readCount, 1 );
+            }
+        }
+
+        // An indication is confirmed on its receiving bearer
+        {
+            CHECKT( peers[2]->indicate(0x0030) );
+            for(int i=0; i<100 && 0 == peers[2]->cfmCount; i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            CHECK( peers[2]->cfmCount, 1 );
+            CHECK( peers[1]->cfmCount, 0 );
+            CHECK( peers[0]->cfmCount, 0 );
+        }
+
+        // A lost EATT bearer ends its reader and is removed, the remaining bearers stay usable.
+        {
+            peers[1]->close();
+            for(int i=0; i<100 && 1 != handler->getEATTBearerCount(); i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+            CHECK( handler->getEATTBearerCount(), 1 );
+            CHECKT( handler->isOpen() );
+            std::vector<uint16_t> results;
+            const uint64_t td = readConcurrently(*handler, { 0x0020, 0x0021 }, results);
+            CHECK( results[0], 0x0020 );
+            CHECK( results[1], 0x0021 );
+            CHECKT( td < static_cast<uint64_t>( 2 * REPLY_DELAY_MS ) );
+            CHECK( peers[0]->readCount, 2 );
+            CHECK( peers[1]->readCount, 1 );
+            CHECK( peers[2]->readCount, 2 );
+        }
+
+        // Disconnect joins all reader threads and closes all bearers
+        CHECKT( handler->disconnect(false /* disconnectDevice */, false /* ioErrorCause */) );
+        CHECKT( !handler->isOpen() );
+        CHECK( handler->getEATTBearerCount(), 0 );
+        handler = nullptr;
+        peers.clear();
+    }
+};
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    Cppunit_tests test1;
+    return test1.run();
+}
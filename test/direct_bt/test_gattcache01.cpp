@@ -0,0 +1,94 @@
+#include <iostream>
+#include <cassert>
+#include <cinttypes>
+#include <cstring>
+
+#include <cppunit.h>
+
+#include <direct_bt/UUID.hpp>
+#include <direct_bt/GATTTypes.hpp>
+#include <direct_bt/GATTCache.hpp>
+
+using namespace direct_bt;
+
+// Test examples.
+class Cppunit_tests: public Cppunit {
+    void single_test() override {
+        const std::shared_ptr<DBTDevice> noDevice = nullptr;
+        std::vector<GATTServiceRef> services;
+
+        GATTServiceRef s0( new GATTService(noDevice, true, 0x0001, 0x0009, std::shared_ptr<const uuid_t>( new uuid16_t(0x1801) ) ) );
+        GATTCharacteristicRef c0( new GATTCharacteristic(s0, 0x0001, 0x0002,
+                static_cast<GATTCharacteristic::PropertyBitVal>(GATTCharacteristic::Indicate), 0x0003,
+                std::shared_ptr<const uuid_t>( new uuid16_t(0x2A05) ) ) );
+        GATTDescriptorRef d0( new GATTDescriptor(c0, GATTDescriptor::getStaticType(GATTDescriptor::TYPE_CCC_DESC), 0x0004) );
+        d0->value.resize(2, 2);
+        d0->value.put_uint16(0, 0x0002);
+        c0->clientCharacteristicsConfigIndex = 0;
+        c0->descriptorList.push_back(d0);
+        s0->characteristicList.push_back(c0);
+        services.push_back(s0);
+
+        GATTServiceRef s1( new GATTService(noDevice, true, 0x000A, 0xFFFF,
+                std::shared_ptr<const uuid_t>( new uuid128_t("d0ca6bf3-3d50-4760-98e5-fc5883e93712") ) ) );
+        GATTCharacteristicRef c1( new GATTCharacteristic(s1, 0x000A, 0x000B,
+                static_cast<GATTCharacteristic::PropertyBitVal>(GATTCharacteristic::Read | GATTCharacteristic::WriteWithAck), 0x000C,
+                std::shared_ptr<const uuid_t>( new uuid128_t("d0ca6bf3-3d52-4760-98e5-fc5883e93712") ) ) );
+        GATTDescriptorRef d1( new GATTDescriptor(c1, GATTDescriptor::getStaticType(GATTDescriptor::TYPE_USER_DESC), 0x000D) );
+        d1->value.resize(4, 4);
+        d1->value.put_string(0, "temp", 4, false);
+        c1->descriptorList.push_back(d1);
+        s1->characteristicList.push_back(c1);
+        services.push_back(s1);
+
+        uint8_t hashBytes[GATTCache::DB_HASH_SIZE];
+        for(int i=0; i<GATTCache::DB_HASH_SIZE; i++) { hashBytes[i] = i; }
+        const TROOctets hash(hashBytes, GATTCache::DB_HASH_SIZE);
+
+        POctets data(0);
+        GATTCache::write(data, hash, services);
+        CHECKT( 0 < data.getSize() );
+
+        POctets hash2(GATTCache::DB_HASH_SIZE, 0);
+        std::vector<GATTServiceRef> services2;
+        CHECKT( GATTCache::read(data, noDevice, hash2, services2) );
+        CHECKT( hash == hash2 );
+        CHECK( services2.size(), services.size() );
+
+        for(size_t s=0; s<services.size(); s++) {
+            const GATTService & a = *services.at(s);
+            const GATTService & b = *services2.at(s);
+            CHECKT( a == b );
+            CHECKT( *a.type == *b.type );
+            CHECK( b.characteristicList.size(), a.characteristicList.size() );
+            for(size_t c=0; c<a.characteristicList.size(); c++) {
+                const GATTCharacteristic & ca = *a.characteristicList.at(c);
+                const GATTCharacteristic & cb = *b.characteristicList.at(c);
+                CHECK( cb.service_handle, ca.service_handle );
+                CHECK( cb.handle, ca.handle );
+                CHECK( cb.properties, ca.properties );
+                CHECK( cb.value_handle, ca.value_handle );
+                CHECKT( *ca.value_type == *cb.value_type );
+                CHECK( cb.clientCharacteristicsConfigIndex, ca.clientCharacteristicsConfigIndex );
+                CHECK( cb.descriptorList.size(), ca.descriptorList.size() );
+                CHECKT( cb.getServiceUnchecked() == services2.at(s) );
+            }
+        }
+        // CCC descriptor value is volatile state, restored as disabled
+        CHECK( services2.at(0)->characteristicList.at(0)->descriptorList.at(0)->value.get_uint16(0), 0 );
+        CHECKT( services2.at(1)->characteristicList.at(0)->descriptorList.at(0)->value == d1->value );
+
+        // Corrupted or truncated data shall be rejected
+        const TROOctets truncated(data.get_ptr(), data.getSize()-1);
+        CHECKT( !GATTCache::read(truncated, noDevice, hash2, services2) );
+        CHECK( services2.size(), 0 );
+    }
+};
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    Cppunit_tests test1;
+    return test1.run();
+}
@@ -0,0 +1,198 @@
+#include <iostream>
+#include <cassert>
+#include <cinttypes>
+#include <cstring>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <memory>
+
+#include <cppunit.h>
+
+#include <direct_bt/GATTListenerQueue.hpp>
+
+using namespace direct_bt;
+
+/**
+ * Records all delivered values in order, optionally blocking within each delivery until released.
+ */
+class RecordingListener : public GATTCharacteristicListener {
+    public:
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::vector<uint8_t> values;
+        std::vector<bool> indications;
+        bool blocked = false;
+        bool busy = false;
+
+        void block() {
+            const std::lock_guard<std::mutex> lock(mtx);
+            blocked = true;
+        }
+        void release() {
+            const std::lock_guard<std::mutex> lock(mtx);
+            blocked = false;
+            cv.notify_all();
+        }
+        /** Waits until a delivery is blocked. */
+        bool waitBusy() {
+            std::unique_lock<std::mutex> lock(mtx);
+            return cv.wait_for(lock, std::chrono::seconds(2), [this]() { return busy; });
+        }
+        std::vector<uint8_t> getValues() {
+            const std::lock_guard<std::mutex> lock(mtx);
+            return values;
+        }
+
+        void received(std::shared_ptr<TROOctets> charValue, const bool indication) {
+            std::unique_lock<std::mutex> lock(mtx);
+            values.push_back(charValue->get_uint8(0));
+            indications.push_back(indication);
+            busy = true;
+            cv.notify_all();
+            cv.wait(lock, [this]() { return !blocked; });
+            busy = false;
+        }
+
+        void notificationReceived(GATTCharacteristicRef charDecl,
+                                  std::shared_ptr<TROOctets> charValue, const uint64_t timestamp) override {
+            (void)charDecl; (void)timestamp;
+            received(charValue, false);
+        }
+
+        void indicationReceived(GATTCharacteristicRef charDecl,
+                                std::shared_ptr<TROOctets> charValue, const uint64_t timestamp,
+                                const bool confirmationSent) override {
+            (void)charDecl; (void)timestamp; (void)confirmationSent;
+            received(charValue, true);
+        }
+};
+
+static std::shared_ptr<TROOctets> value(const uint8_t v) {
+    std::shared_ptr<POctets> res = std::make_shared<POctets>(1);
+    res->put_uint8(0, v);
+    return res;
+}
+
+static GATTCharacteristicRef characteristic(const uint16_t handle) {
+    return GATTCharacteristicRef( new GATTCharacteristic(nullptr, 0x0001, handle, GATTCharacteristic::PropertyBitVal::Notify, handle+1,
+                                                        std::shared_ptr<const uuid_t>( new uuid16_t(0x2A37) ) ) );
+}
+
+// Test examples.
+class Cppunit_tests: public Cppunit {
+    void single_test() override {
+        GATTListenerExecutor executor(2);
+        CHECK( executor.getThreadCount(), 2 );
+        const GATTCharacteristicRef c1 = characteristic(0x0010);
+        const GATTCharacteristicRef c2 = characteristic(0x0020);
+
+        // Delivery in received order
+        {
+            std::shared_ptr<RecordingListener> rec = std::make_shared<RecordingListener>();
+            std::shared_ptr<QueuedGATTCharacteristicListener> q =
+                    std::make_shared<QueuedGATTCharacteristicListener>(rec, 64, QueuedGATTCharacteristicListener::QueuePolicy::DROP_NEWEST, executor);
+            for(int i=0; i<50; i++) {
+                if( 0 == i % 5 ) {
+                    q->indicationReceived(c2, value(i), 0, true);
+                } else {
+                    q->notificationReceived(i % 2 ? c1 : c2, value(i), 0);
+                }
+            }
+            CHECKT( q->waitUntilDelivered(2000) );
+            const std::vector<uint8_t> v = rec->getValues();
+            CHECK( v.size(), 50 );
+            for(size_t i=0; i<v.size(); i++) {
+                CHECK( v[i], i );
+                CHECK( rec->indications[i], 0 == i % 5 );
+            }
+            CHECK( q->getQueueSize(), 0 );
+            CHECK( q->getDroppedCount(), 0 );
+        }
+
+        // A blocked delegate neither blocks the caller nor waiting beyond the timeout,
+        // while the bounded queue drops according to its policy.
+        {
+            std::shared_ptr<RecordingListener> rec = std::make_shared<RecordingListener>();
+            std::shared_ptr<QueuedGATTCharacteristicListener> q =
+                    std::make_shared<QueuedGATTCharacteristicListener>(rec, 2, QueuedGATTCharacteristicListener::QueuePolicy::DROP_OLDEST, executor);
+            rec->block();
+            q->notificationReceived(c1, value(1), 0);
+            CHECKT( rec->waitBusy() );
+            const uint64_t t0 = getCurrentMilliseconds();
+            for(int i=2; i<=5; i++) {
+                q->notificationReceived(c1, value(i), 0);
+            }
+            CHECKT( getCurrentMilliseconds() - t0 < 100 );
+            CHECK( q->getQueueSize(), 2 );
+            CHECK( q->getDroppedCount(), 2 );
+
+            const uint64_t t1 = getCurrentMilliseconds();
+            CHECKT( !q->waitUntilDelivered(100) );
+            CHECKT( getCurrentMilliseconds() - t1 >= 100 );
+
+            rec->release();
+            CHECKT( q->waitUntilDelivered(2000) );
+            const std::vector<uint8_t> v = rec->getValues();
+            CHECK( v.size(), 3 );
+            CHECK( v[0], 1 );
+            CHECK( v[1], 4 );
+            CHECK( v[2], 5 );
+        }
+
+        // Coalescing keeps the latest value per characteristic at its queue position
+        {
+            std::shared_ptr<RecordingListener> rec = std::make_shared<RecordingListener>();
+            std::shared_ptr<QueuedGATTCharacteristicListener> q =
+                    std::make_shared<QueuedGATTCharacteristicListener>(rec, 4, QueuedGATTCharacteristicListener::QueuePolicy::KEEP_LATEST, executor);
+            rec->block();
+            q->notificationReceived(c1, value(1), 0);
+            CHECKT( rec->waitBusy() );
+            q->notificationReceived(c1, value(2), 0);
+            q->notificationReceived(c2, value(3), 0);
+            q->notificationReceived(c1, value(4), 0);
+            CHECK( q->getQueueSize(), 2 );
+            CHECK( q->getCoalescedCount(), 1 );
+            rec->release();
+            CHECKT( q->waitUntilDelivered(2000) );
+            const std::vector<uint8_t> v = rec->getValues();
+            CHECK( v.size(), 3 );
+            CHECK( v[0], 1 );
+            CHECK( v[1], 4 );
+            CHECK( v[2], 3 );
+        }
+
+        // Cancellation drops queued and later events, the running delivery completes
+        {
+            std::shared_ptr<RecordingListener> rec = std::make_shared<RecordingListener>();
+            std::shared_ptr<QueuedGATTCharacteristicListener> q =
+                    std::make_shared<QueuedGATTCharacteristicListener>(rec, 8, QueuedGATTCharacteristicListener::QueuePolicy::DROP_OLDEST, executor);
+            rec->block();
+            q->notificationReceived(c1, value(1), 0);
+            CHECKT( rec->waitBusy() );
+            q->notificationReceived(c1, value(2), 0);
+            q->notificationReceived(c2, value(3), 0);
+            CHECKT( !q->isCancelled() );
+            CHECK( q->cancel(), 2 );
+            CHECKT( q->isCancelled() );
+            CHECK( q->getQueueSize(), 0 );
+            q->notificationReceived(c1, value(4), 0);
+            CHECK( q->getQueueSize(), 0 );
+            CHECK( q->getDroppedCount(), 3 );
+            rec->release();
+            CHECKT( q->waitUntilDelivered(2000) );
+            const std::vector<uint8_t> v = rec->getValues();
+            CHECK( v.size(), 1 );
+            CHECK( v[0], 1 );
+        }
+    }
+};
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    Cppunit_tests test1;
+    return test1.run();
+}
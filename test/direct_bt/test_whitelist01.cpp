@@ -0,0 +1,149 @@
+#include <iostream>
+#include <cassert>
+#include <cinttypes>
+#include <cstring>
+
+#include <cppunit.h>
+
+#include <direct_bt/DBTWhitelist.hpp>
+
+using namespace direct_bt;
+
+static DBTWhitelist::Element elem(const int dev_id, const EUI48 & address) {
+    return DBTWhitelist::Element{dev_id, address, BDAddressType::BDADDR_LE_PUBLIC, HCIWhitelistConnectType::HCI_AUTO_CONN_ALWAYS,
+                                 false /* hasConnParam */, MgmtConnParam(), DBTWhitelist::State::HOST_SIDE, 0};
+}
+
+// Test examples.
+class Cppunit_tests: public Cppunit {
+    void single_test() override {
+        const EUI48 a1("01:02:03:04:05:01");
+        const EUI48 a2("01:02:03:04:05:02");
+        const EUI48 a3("01:02:03:04:05:03");
+        const EUI48 a4("01:02:03:04:05:04");
+
+        // Hashed lookup per (dev_id, address), duplicates rejected
+        {
+            DBTWhitelist wl(2);
+            CHECKT( nullptr != wl.add( elem(0, a1) ) );
+            CHECKT( nullptr != wl.add( elem(1, a1) ) );
+            CHECKT( nullptr == wl.add( elem(0, a1) ) );
+            CHECK( wl.size(), 2 );
+            CHECKT( nullptr != wl.find(0, a1) );
+            CHECKT( nullptr == wl.find(0, a2) );
+            CHECKT( wl.remove(1, a1) );
+            CHECKT( !wl.remove(1, a1) );
+            CHECKT( nullptr == wl.find(1, a1) );
+            CHECK( wl.size(), 1 );
+        }
+
+        // Capacity accounting: Slots are occupied while adding, in controller and evicting
+        DBTWhitelist wl(2);
+        DBTWhitelist::Element * e1 = wl.add( elem(0, a1) );
+        DBTWhitelist::Element * e2 = wl.add( elem(0, a2) );
+        DBTWhitelist::Element * e3 = wl.add( elem(0, a3) );
+        wl.add( elem(1, a1) );
+        CHECKT( wl.hasCapacity(0) );
+        wl.setAdding(*e1);
+        wl.setAdding(*e2);
+        CHECK( wl.getControllerCount(0), 2 );
+        CHECK( wl.getControllerCount(1), 0 );
+        CHECKT( !wl.hasCapacity(0) );
+        CHECKT( wl.hasCapacity(1) );
+        CHECKT( nullptr == wl.getEvictionCandidate(0) ); // adds still in flight
+        CHECK( wl.getRotationCandidates(0).size(), 0 );
+
+        wl.setInController(*e1);
+        wl.setInController(*e2);
+        wl.setInController(*e2); // idempotent
+        CHECK( wl.getControllerCount(0), 2 );
+
+        // LRU eviction skips connected or connecting devices
+        wl.setLastSeen(*e1, 100);
+        wl.setLastSeen(*e2, 200);
+        wl.setLastSeen(*e3, 300);
+        CHECKT( e1 == wl.getEvictionCandidate(0) );
+        CHECK( wl.getCount(0, DBTWhitelist::State::IN_CONTROLLER), 2 );
+        CHECK( wl.getCount(0, DBTWhitelist::State::HOST_SIDE), 1 );
+        CHECK( wl.getCount(1, DBTWhitelist::State::HOST_SIDE), 1 );
+
+        // Seeing a device moves it to the end of the eviction order
+        wl.setLastSeen(*e1, 400);
+        CHECKT( e2 == wl.getEvictionCandidate(0) );
+        wl.setLastSeen(*e1, 100);
+        CHECKT( e1 == wl.getEvictionCandidate(0) );
+        wl.setConnected(0, a1, true);
+        CHECKT( wl.isConnected(0, a1) );
+        CHECKT( e2 == wl.getEvictionCandidate(0) );
+        wl.setConnected(0, a2, true);
+        CHECKT( nullptr == wl.getEvictionCandidate(0) );
+        wl.setConnected(0, a2, false);
+        CHECKT( e2 == wl.getEvictionCandidate(0) );
+        wl.setConnected(0, a1, false);
+        CHECKT( e1 == wl.getEvictionCandidate(0) ); // re-inserted in seen order
+        wl.setConnected(0, a1, true);
+
+        // Failed eviction keeps the slot
+        wl.setEvicting(*e2);
+        CHECK( wl.getCount(0, DBTWhitelist::State::EVICTING), 1 );
+        CHECK( wl.getControllerCount(0), 2 );
+        CHECKT( !wl.hasCapacity(0) );
+        CHECKT( nullptr == wl.getEvictionCandidate(0) );
+        wl.setInController(*e2);
+        CHECK( wl.getControllerCount(0), 2 );
+
+        // Successful eviction frees the slot for the most recently seen host-side device
+        wl.setEvicting(*e2);
+        wl.setHostSide(*e2);
+        CHECK( wl.getControllerCount(0), 1 );
+        CHECK( wl.getCount(0, DBTWhitelist::State::EVICTING), 0 );
+        CHECK( wl.getCount(0, DBTWhitelist::State::HOST_SIDE), 2 );
+        {
+            std::vector<DBTWhitelist::Element*> r = wl.getRotationCandidates(0);
+            CHECK( r.size(), 1 );
+            CHECKT( e3 == r[0] );
+            wl.setAdding(*r[0]);
+            CHECKT( !wl.hasCapacity(0) );
+        }
+
+        // Removal releases the slot
+        CHECKT( wl.remove(0, a3) );
+        CHECK( wl.getControllerCount(0), 1 );
+        wl.add( elem(0, a4) );
+        {
+            std::vector<DBTWhitelist::Element*> r = wl.getRotationCandidates(0);
+            CHECK( r.size(), 1 ); // a2 and a4 host-side, one slot free
+        }
+        wl.setConnected(0, a1, false);
+        CHECKT( e1 == wl.getEvictionCandidate(0) );
+        CHECKT( wl.remove(0, a1) );
+        CHECKT( nullptr == wl.getEvictionCandidate(0) );
+        CHECK( wl.getControllerCount(0), 0 );
+        wl.removeAll(0);
+        CHECK( wl.getControllerCount(0), 0 );
+        CHECK( wl.getCount(0, DBTWhitelist::State::HOST_SIDE), 0 );
+        CHECK( wl.size(), 1 );
+        wl.clear();
+        CHECK( wl.size(), 0 );
+
+        // Unlimited capacity
+        {
+            DBTWhitelist wl0(0);
+            for(int i=0; i<8; i++) {
+                EUI48 a(a1);
+                a.b[0] = i;
+                wl0.setAdding( *wl0.add( elem(0, a) ) );
+            }
+            CHECKT( wl0.hasCapacity(0) );
+            CHECK( wl0.getControllerCount(0), 8 );
+        }
+    }
+};
+
+int main(int argc, char *argv[]) {
+    (void)argc;
+    (void)argv;
+
+    Cppunit_tests test1;
+    return test1.run();
+}